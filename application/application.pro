@@ -99,6 +99,7 @@ INCLUDEPATH += ../libraries/include ..              \
                ../dct_widgets/com_ctrl              \
                ../dct_widgets/com_ctrl/devices      \
                ../dct_widgets/csvwrapper            \
+               ../dct_widgets/profilewrapper        \
                ../dct_widgets/connectdialog         \
                ../dct_widgets/settingsdialog        \
                ../dct_widgets/infodialog            \
@@ -131,10 +132,15 @@ SOURCES += ../dct_widgets/mcceqbox/mcceqbox.cpp                             \
            ../dct_widgets/com_ctrl/devices/IronSDI_Device.cpp               \
            ../dct_widgets/roibox/roibox.cpp                                 \
            ../dct_widgets/wbbox/wbbox.cpp                                   \
+           ../dct_widgets/wbbox/wb_calibration.cpp                          \
+           ../dct_widgets/wbbox/wb_calibration_dialog.cpp                   \
            ../dct_widgets/infobox/infobox.cpp                               \
            ../dct_widgets/blacklevelbox/blacklevelbox.cpp                   \
            ../dct_widgets/lutbox/lutbox.cpp                                 \
            ../dct_widgets/lutbox/cubic_interpolation.cpp                    \
+           ../dct_widgets/lutbox/cube_export.cpp                            \
+           ../dct_widgets/lutbox/pipeline_preview.cpp                       \
+           ../dct_widgets/lutbox/curve_graph.cpp                            \
            ../dct_widgets/inoutbox/inoutbox.cpp                             \
            ../dct_widgets/outbox/outbox.cpp                                 \
            ../dct_widgets/updatebox/updatebox.cpp                           \
@@ -144,6 +150,7 @@ SOURCES += ../dct_widgets/mcceqbox/mcceqbox.cpp                             \
            ../dct_widgets/kneebox/knee_interpolation.cpp                    \
            ../dct_widgets/dpccbox/dpccbox.cpp                               \
            ../dct_widgets/lensdriverbox/lensdriverbox.cpp                   \
+           ../dct_widgets/lensdriverbox/lensprofilestore.cpp               \
            ../dct_widgets/connectdialog/connectdialog.cpp                   \
            ../dct_widgets/settingsdialog/settingsdialog.cpp                 \
            ../dct_widgets/infodialog/infodialog.cpp                         \
@@ -162,6 +169,10 @@ SOURCES += ../dct_widgets/mcceqbox/mcceqbox.cpp                             \
            ../dct_widgets/com_ctrl/ProVideoProtocol.cpp                     \
            ../dct_widgets/com_ctrl/ComChannel.cpp                           \
            ../dct_widgets/com_ctrl/ComChannelRSxxx.cpp                      \
+           ../dct_widgets/com_ctrl/ComLog.cpp                               \
+           ../dct_widgets/com_ctrl/ComCache.cpp                             \
+           ../dct_widgets/com_ctrl/CommandScheduler.cpp                     \
+           ../dct_widgets/com_ctrl/SignalCoalescer.cpp                      \
            ../dct_widgets/com_ctrl/ProVideoSystemItf.cpp                    \
            ../dct_widgets/com_ctrl/IspItf.cpp                               \
            ../dct_widgets/com_ctrl/CprocItf.cpp                             \
@@ -182,6 +193,7 @@ SOURCES += ../dct_widgets/mcceqbox/mcceqbox.cpp                             \
            ../dct_widgets/com_ctrl/LensItf.cpp                              \
            ../dct_widgets/com_ctrl/devices/ProVideoDevice.cpp               \
            ../dct_widgets/csvwrapper/csvwrapper.cpp                         \
+           ../dct_widgets/profilewrapper/profilewrapper.cpp                 \
            ../dct_widgets/textviewer/textviewer.cpp                         \
            ../dct_widgets/debugterminal/debugterminal.cpp                   \
            ../libraries/ctrl_channel/ctrl_channel.c                         \
@@ -205,6 +217,9 @@ SOURCES += ../dct_widgets/mcceqbox/mcceqbox.cpp                             \
            ../libraries/ctrl_protocol/ctrl_protocol_lens.c                  \
            ../libraries/provideo_protocol/provideo_protocol.c               \
            ../libraries/provideo_protocol/provideo_protocol_common.cpp      \
+           ../libraries/provideo_protocol/provideo_protocol_codec.c         \
+           ../libraries/provideo_protocol/provideo_protocol_reader.c        \
+           ../libraries/provideo_protocol/provideo_protocol_timing.c        \
            ../libraries/provideo_protocol/provideo_protocol_system.c        \
            ../libraries/provideo_protocol/provideo_protocol_isp.c           \
            ../libraries/provideo_protocol/provideo_protocol_cproc.c         \
@@ -224,16 +239,21 @@ SOURCES += ../dct_widgets/mcceqbox/mcceqbox.cpp                             \
            ../libraries/provideo_protocol/provideo_protocol_lens.c          \
            ../libraries/simple_math/rgb2ycbcr.c                             \
            ../libraries/simple_math/xyz2ct.c                                \
+           ../libraries/simple_math/ct_table.c                              \
            ../libraries/simple_math/cubic.c                                 \
            ../libraries/simple_math/knee.c                                  \
            ../libraries/simple_math/gamma.c                                 \
+           ../libraries/simple_math/gamma_table.c                           \
+           ../libraries/simple_math/isp_pipeline.c                          \
            ../libraries/simple_math/float.c                                 \
            ../libraries/csv/csvparser.c                                     \
            ../libraries/csv/csvwriter.c                                     \
+           ../libraries/profile/profile.c                                   \
            ../libraries/qcustomplot/qcustomplot.cpp                         \
            ../libraries/xmodem/crc16-xmodem.c                               \
            ../libraries/xmodem/transfer.cpp                                 \
            mainwindow.cpp                                                   \
+           startupprofile.cpp                                               \
            main.cpp
 
 
@@ -242,10 +262,15 @@ HEADERS  += ../libraries/include
             ../dct_widgets/mcceqbox/mcceqbox.h                                  \
             ../dct_widgets/roibox/roibox.h                                      \
             ../dct_widgets/wbbox/wbbox.h                                        \
+            ../dct_widgets/wbbox/wb_calibration.h                               \
+            ../dct_widgets/wbbox/wb_calibration_dialog.h                        \
             ../dct_widgets/infobox/infobox.h                                    \
             ../dct_widgets/blacklevelbox/blacklevelbox.h                        \
             ../dct_widgets/lutbox/lutbox.h                                      \
             ../dct_widgets/lutbox/cubic_interpolation.h                         \
+            ../dct_widgets/lutbox/cube_export.h                                 \
+            ../dct_widgets/lutbox/pipeline_preview.h                            \
+            ../dct_widgets/lutbox/curve_graph.h                                 \
             ../dct_widgets/inoutbox/inoutbox.h                                  \
             ../dct_widgets/outbox/outbox.h                                      \
             ../dct_widgets/fltbox/fltbox.h                                      \
@@ -256,6 +281,7 @@ HEADERS  += ../libraries/include
             ../dct_widgets/kneebox/knee_interpolation.h                         \
             ../dct_widgets/dpccbox/dpccbox.h                                    \
             ../dct_widgets/lensdriverbox/lensdriverbox.h                        \
+            ../dct_widgets/lensdriverbox/lensprofilestore.h                    \
             ../dct_widgets/btnarraybox/btnarraybox.h                            \
             ../dct_widgets/singlechannelknobbox/singlechannelknobbox.h          \
             ../dct_widgets/triplechannelknobbox/triplechannelknobbox.h          \
@@ -290,16 +316,22 @@ HEADERS  += ../libraries/include
             ../dct_widgets/com_ctrl/LensItf.h                                   \
             ../dct_widgets/com_ctrl/ComChannel.h                                \
             ../dct_widgets/com_ctrl/ComChannelRSxxx.h                           \
+            ../dct_widgets/com_ctrl/ComLog.h                                    \
+            ../dct_widgets/com_ctrl/ComCache.h                                  \
+            ../dct_widgets/com_ctrl/CommandScheduler.h                          \
+            ../dct_widgets/com_ctrl/SignalCoalescer.h                           \
             ../dct_widgets/com_ctrl/ComProtocol.h                               \
             ../dct_widgets/com_ctrl/ProVideoProtocol.h                          \
             ../dct_widgets/com_ctrl/common.h                                    \
             ../dct_widgets/com_ctrl/defines.h                                   \
             ../dct_widgets/csvwrapper/csvwrapper.h                              \
+            ../dct_widgets/profilewrapper/profilewrapper.h                      \
             ../dct_widgets/textviewer/textviewer.h                              \
             ../dct_widgets/debugterminal/debugterminal.h                        \
             ../dct_widgets/dct_widgets_base.h                                   \
             ../libraries/include/csv/csvparser.h                                \
             ../libraries/include/csv/csvwriter.h                                \
+            ../libraries/include/profile/profile.h                              \
             ../libraries/include/xmodem/crc16-xmodem.h                          \
             ../libraries/include/xmodem/transfer.h                              \
             ../libraries/qcustomplot/qcustomplot.h                              \
@@ -329,11 +361,17 @@ HEADERS  += ../libraries/include
             ../libraries/include/simple_math/knee.h                             \
             ../libraries/include/simple_math/rgb2ycbcr.h                        \
             ../libraries/include/simple_math/xyz2ct.h                           \
+            ../libraries/include/simple_math/ct_table.h                         \
             ../libraries/include/simple_math/gamma.h                            \
+            ../libraries/include/simple_math/gamma_table.h                      \
+            ../libraries/include/simple_math/isp_pipeline.h                     \
             ../libraries/include/simple_math/float.h                            \
             ../libraries/include/provideo_protocol/provideo_protocol_auto.h     \
             ../libraries/include/provideo_protocol/provideo_protocol_cam.h      \
             ../libraries/include/provideo_protocol/provideo_protocol_chain.h    \
+            ../libraries/include/provideo_protocol/provideo_protocol_codec.h    \
+            ../libraries/include/provideo_protocol/provideo_protocol_reader.h   \
+            ../libraries/include/provideo_protocol/provideo_protocol_timing.h   \
             ../libraries/include/provideo_protocol/provideo_protocol_common.h   \
             ../libraries/include/provideo_protocol/provideo_protocol_cproc.h    \
             ../libraries/include/provideo_protocol/provideo_protocol_dpcc.h     \
@@ -349,7 +387,8 @@ HEADERS  += ../libraries/include
             ../libraries/include/provideo_protocol/provideo_protocol_system.h   \
             ../libraries/include/provideo_protocol/provideo_protocol_tflt.h     \
             ../libraries/include/provideo_protocol/provideo_protocol_lens.h     \
-            mainwindow.h
+            mainwindow.h                                                        \
+            startupprofile.h
 
 FORMS    += ../dct_widgets/mcceqbox/mcceqbox.ui                             \
             ../dct_widgets/roibox/roibox.ui                                 \
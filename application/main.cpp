@@ -28,9 +28,12 @@
 #include "connectdialog.h"
 
 #include "mainwindow.h"
+#include "startupprofile.h"
 
 
 #include <QThread>
+#include <QTimer>
+#include <QScopedPointer>
 
 /******************************************************************************
  * main 
@@ -39,7 +42,10 @@ int main(int argc, char *argv[])
 {
     int res;
 
+    StartupProfile::start();
+
     QApplication app(argc, argv);
+    StartupProfile::mark( "application created" );
 
     // register meta operators
     qRegisterMetaTypeStreamOperators<QList<int> >("QList<int>");
@@ -50,12 +56,17 @@ int main(int argc, char *argv[])
     f.open( QFile::ReadOnly );
     QTextStream ts( &f );
     app.setStyleSheet( ts.readAll() );
+    StartupProfile::mark( "style sheet loaded" );
 
     // Create the connection dialog
     ConnectDialog dlg;
+    StartupProfile::mark( "connect dialog created" );
 
-    // Create the main application window
-    MainWindow w( &dlg );
+    /* The main application window is created once the event loop runs and
+     * the connect dialog is on screen. No device can be connected before.
+     * Its heavy tabs (in/out and the plot tabs) are only built when a device
+     * which supports them is connected. */
+    QScopedPointer<MainWindow> w;
 
     /*
      * Autoconnection uses RS485. Currently this feature is not avaolable in IronSDI.
@@ -69,15 +80,29 @@ int main(int argc, char *argv[])
     // If the connection can be established automatically directly show the main window
     if ( connected )
     {
-        w.show();
+        w.reset( new MainWindow( &dlg ) );
+        StartupProfile::mark( "main window created" );
+        StartupProfile::report();
+
+        w->show();
         res = app.exec();
     }
     // If no connection was established, show the connect dialog
     else
     {
         dlg.show();
+        StartupProfile::mark( "connect dialog shown" );
+
+        QTimer::singleShot( 0, [&w, &dlg]()
+        {
+            StartupProfile::mark( "event loop running" );
+            w.reset( new MainWindow( &dlg ) );
+            StartupProfile::mark( "main window created" );
+            StartupProfile::report();
+        } );
+
         res = app.exec();
-        if ( dlg.result() == QDialog::Rejected )
+        if ( (dlg.result() == QDialog::Rejected) || w.isNull() )
         {
             // dialog closed with cancel
             return ( res );
@@ -85,7 +110,7 @@ int main(int argc, char *argv[])
         else
         {
             // Show the (now connected) main window
-            w.show();
+            w->show();
             res = app.exec();
         }
     }
@@ -23,18 +23,29 @@
 #include <QLabel>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QPushButton>
 #include <QProgressDialog>
 #include <QDockWidget>
 #include <QDesktopWidget>
 #include <QScrollBar>
 #include <QGuiApplication>
 #include <QScreen>
+#include <QSaveFile>
 
 #include <ProVideoDevice.h>
 #include <infodialog.h>
+#include <inoutbox.h>
+#include <kneebox.h>
+#include <lutbox.h>
+#include <roibox.h>
+#include <cube_export.h>
+#include <pipeline_preview.h>
+#include <profilewrapper.h>
+#include <CommandScheduler.h>
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "startupprofile.h"
 
 #include <defines.h>
 
@@ -59,6 +70,21 @@
 #define UI_SETTING_WIDGET_MODE              ( "widget_mode" )
 #define UI_SETTING_SHOW_DEBUG_TERMINAL      ( "show_debug_terminal" )
 #define UI_SETTING_ENABLE_CONNECTION_CHECK  ( "enable_connection_check" )
+#define UI_SETTING_CONNECTION_IDLE_TIME     ( "connection_idle_time" )
+
+/******************************************************************************
+ * Connection check
+ *****************************************************************************/
+#define CONNECTION_CHECK_INTERVAL           ( 500 )     // ms, only reads a counter
+#define CONNECTION_IDLE_TIME_DEFAULT        ( 5000 )    // ms without response before a keepalive
+#define CONNECTION_IDLE_TIME_MIN            ( 1000 )
+#define RECONNECT_DELAY_MIN                 ( 1000 )    // ms, doubled after each failed attempt
+#define RECONNECT_DELAY_MAX                 ( 32000 )
+
+/******************************************************************************
+ * Background synchronization of tabs which are not shown yet
+ *****************************************************************************/
+#define RESYNC_BACKGROUND_INTERVAL          ( 20 )      // ms between two subsystems
 
 /******************************************************************************
  * MainWindow::MainWindow
@@ -66,22 +92,40 @@
 MainWindow::MainWindow( ConnectDialog * connectDialog, QWidget * parent )
     : QMainWindow( parent )
     , m_ui( new Ui::MainWindow )
+    , m_inoutBox( nullptr )
+    , m_kneeBox( nullptr )
+    , m_lutBox( nullptr )
+    , m_roiBox( nullptr )
     , m_ConnectDlg( nullptr )
     , m_SettingsDlg( nullptr )
     , m_DebugTerminal( nullptr )
+    , m_PreviewDock( nullptr )
     , m_cbxConnectedDevices( nullptr )
     , m_dev ( nullptr )
     , m_resizeTimer()
     , m_checkConnectionTimer()
+    , m_reconnectTimer()
+    , m_connectionIdleTimer()
+    , m_connectionResponses( 0u )
+    , m_reconnectDelay( RECONNECT_DELAY_MIN )
+    , m_resyncTimer()
+    , m_resyncPending()
+    , m_connectTime()
+    , m_cache()
+    , m_fingerprintPending( false )
+    , m_cacheFile()
     , m_ScrollbarsNeeded( false )
     , m_WidgetMode( DctWidgetBox::Normal )
     , m_ShowDebugTerminal( false )
     , m_EnableConnectionCheck( false )
+    , m_ConnectionIdleTime( CONNECTION_IDLE_TIME_DEFAULT )
     , m_userSetComboBox( nullptr )
     , m_bUserSetComboBox(true)
 {
-    // Create ui
+    // Create ui, this builds the light device tabs, the others are built
+    // when a device which supports them is connected
     m_ui->setupUi( this );
+    StartupProfile::mark( "main window tabs created" );
 
     // Setup the connect and setting dialogs
     setConnectDlg(connectDialog);
@@ -91,6 +135,15 @@ MainWindow::MainWindow( ConnectDialog * connectDialog, QWidget * parent )
     /* Note: This has to be done after setting the Settings Dialog, because the
      * debug terminal is connected to signals / slots of the settings dialog */
     setDebugTerminal(new DebugTerminal( this ));
+    StartupProfile::mark( "settings dialog and debug terminal created" );
+
+    // Setup the pipeline preview as a dock widget, it follows the colour
+    // settings collected for the 3D LUT export (set on connect)
+    m_PreviewDock = new QDockWidget( tr("Preview"), this );
+    m_PreviewDock->setAllowedAreas( Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea );
+    m_PreviewDock->setWidget( new PipelinePreview( this ) );
+    m_PreviewDock->hide();
+    addDockWidget( Qt::RightDockWidgetArea, m_PreviewDock );
 
     /* GUI has to be locked down during update procedure, also the reconnect timer
      * has to be disabled with the "BootIntoUpdateMode" event and re-enabled with
@@ -124,6 +177,17 @@ MainWindow::MainWindow( ConnectDialog * connectDialog, QWidget * parent )
      * will be stopped when the connection is lost. */
     connect( &m_checkConnectionTimer, SIGNAL(timeout()), this, SLOT(onCheckConnection()) );
 
+    // Configure the reconnect timer, restarted with a growing delay until the device answers
+    m_reconnectTimer.setSingleShot( true );
+    connect( &m_reconnectTimer, SIGNAL(timeout()), this, SLOT(onReconnect()) );
+
+    // Configure the resync timer, synchronizes one subsystem per timeout so the GUI stays responsive
+    m_resyncTimer.setSingleShot( true );
+    connect( &m_resyncTimer, SIGNAL(timeout()), this, SLOT(onResyncPending()) );
+
+    // Tabs which are not synchronized yet are synchronized when they are shown
+    connect( m_ui->tabWidget, SIGNAL(currentChanged(int)), this, SLOT(onTabChange(int)) );
+
     // Try to load main window settings from file
     QString m_SettingsFile = QDir::homePath() + "/" + QString(SETTINGS_FILE_NAME);
 
@@ -135,8 +199,8 @@ MainWindow::MainWindow( ConnectDialog * connectDialog, QWidget * parent )
     }
 
     // Set window title with current version
-    QString title = this->windowTitle() + ' ' + QString(KAYA_COMMERCIAL_VERSION);
-    this->setWindowTitle(title);
+    m_WindowTitle = this->windowTitle() + ' ' + QString(KAYA_COMMERCIAL_VERSION);
+    this->setWindowTitle(m_WindowTitle);
 }
 
 /******************************************************************************
@@ -150,7 +214,15 @@ MainWindow::~MainWindow()
     saveUiSettings( settings );
 
     delete m_SettingsDlg;
+
+    // Detach traffic log before the debug terminal goes away
+    m_ConnectDlg->getChannelRS232()->setLog( nullptr );
+    m_ConnectDlg->getChannelRS485()->setLog( nullptr );
     delete m_DebugTerminal;
+
+    // Detach the response cache, it is a member of this window
+    m_ConnectDlg->getChannelRS232()->setCache( nullptr );
+    m_ConnectDlg->getChannelRS485()->setCache( nullptr );
     delete m_ui;
 }
 
@@ -222,6 +294,17 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
     m_ui->toolBar->addAction(m_ui->actionSaveToFile);
     m_ui->toolBar->addAction(m_ui->actionLoadFromFile);
 
+    // The preview needs the colour settings of the 3D LUT export
+    if (deviceFeatures.hasLutItf)
+    {
+        m_ui->toolBar->addSeparator();
+        m_ui->toolBar->addAction(m_PreviewDock->toggleViewAction());
+    }
+    else
+    {
+        m_PreviewDock->hide();
+    }
+
     // Add a combo box for device selection if the connect dialog has a list
     QVector<ConnectDialog::detectedRS485Device> connectedRS485Devices = m_ConnectDlg->getDetectedRS485Devices();
     int currentRS485DeviceIndex = m_ConnectDlg->getCurrentRs485DeviceIndex();
@@ -285,7 +368,7 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
     }
 
     // Add only those tabs, which are supported by the device, add them to the active widget list
-    m_activeWidgets.append(m_ui->inoutBox);
+    m_activeWidgets.append(inoutBox());
     m_ui->tabWidget->addTab(m_ui->tabInOut, QIcon(":/images/tab/inout.png"), "");
     if (deviceFeatures.hasLensItf)
     {
@@ -314,12 +397,12 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
     }
     if (deviceFeatures.hasKneeItf)
     {
-        m_activeWidgets.append(m_ui->kneeBox);
+        m_activeWidgets.append(kneeBox());
         m_ui->tabWidget->addTab(m_ui->tabKnee, QIcon(":/images/tab/knee.png"), "");
     }
     if (deviceFeatures.hasLutItf)
     {
-        m_activeWidgets.append(m_ui->lutBox);
+        m_activeWidgets.append(lutBox());
         m_ui->tabWidget->addTab(m_ui->tabGamma, QIcon(":/images/tab/gamma.png"), "");
     }
     if (deviceFeatures.hasDpccItf)
@@ -329,7 +412,7 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
     }
     if (deviceFeatures.hasROIItf)
     {
-        m_activeWidgets.append(m_ui->roiBox);
+        m_activeWidgets.append(roiBox());
         m_ui->tabWidget->addTab(m_ui->tabROI, QIcon(":/images/tab/roi.png"), "");
     }
     if (deviceFeatures.hasIspConversion)
@@ -348,30 +431,33 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
         m_ui->tabWidget->addTab(m_ui->tabUpdate, QIcon(":/images/tab/update.png"), "");
     }
 
+    // the in/out tab and the plot tabs of this device are built now
+    qDebug() << "device tabs built after" << m_connectTime.elapsed() << "ms";
+
     // when aec is disabled, exposure, gain and aperture have to be resynced for actual values
     if (deviceFeatures.hasIspItf && deviceFeatures.hasCamItf)
     {
-        connect( m_ui->inoutBox, SIGNAL(ResyncRequest()), this, SLOT(onAecResyncRequest()), Qt::UniqueConnection );
+        connect( inoutBox(), SIGNAL(ResyncRequest()), this, SLOT(onAecResyncRequest()), Qt::UniqueConnection );
     }
 
 
     // Enable / disable elements inside the tabs
     // InOut Tab
-    m_ui->inoutBox->setCameraSettingsVisible(deviceFeatures.hasCamItf);
-    m_ui->inoutBox->setAutoExposureSettingsVisible(deviceFeatures.hasAutoItf);
-    m_ui->inoutBox->setLensChadingCorrectionSettingsVisible(deviceFeatures.hasIspLsc);
-    m_ui->inoutBox->setApartureVisible(deviceFeatures.hasIrisItf);
-    m_ui->inoutBox->setSdi2ModeVisible(deviceFeatures.hasChainSdi2Mode);
-    m_ui->inoutBox->setDownscaleModeVisible(deviceFeatures.hasChainDownscale);
-    m_ui->inoutBox->setGenLockVisible(deviceFeatures.hasChainGenLock);
-    m_ui->inoutBox->setGenLockTermCrosslockOffsetVisible(deviceFeatures.hasChainGenLock && deviceFeatures.hasChainGenLockTermCrosslockOffset);
-    m_ui->inoutBox->setTimeCodeVisible(deviceFeatures.hasChainTimeCode, deviceFeatures.hasChainTimeCodeHold);
-    m_ui->inoutBox->setFlipModeVisible(deviceFeatures.hasChainFlipVertical, deviceFeatures.hasChainFlipHorizontal);
-    //    m_ui->inoutBox->setLogModeVisible(deviceFeatures.hasLutItf);
+    inoutBox()->setCameraSettingsVisible(deviceFeatures.hasCamItf);
+    inoutBox()->setAutoExposureSettingsVisible(deviceFeatures.hasAutoItf);
+    inoutBox()->setLensChadingCorrectionSettingsVisible(deviceFeatures.hasIspLsc);
+    inoutBox()->setApartureVisible(deviceFeatures.hasIrisItf);
+    inoutBox()->setSdi2ModeVisible(deviceFeatures.hasChainSdi2Mode);
+    inoutBox()->setDownscaleModeVisible(deviceFeatures.hasChainDownscale);
+    inoutBox()->setGenLockVisible(deviceFeatures.hasChainGenLock);
+    inoutBox()->setGenLockTermCrosslockOffsetVisible(deviceFeatures.hasChainGenLock && deviceFeatures.hasChainGenLockTermCrosslockOffset);
+    inoutBox()->setTimeCodeVisible(deviceFeatures.hasChainTimeCode, deviceFeatures.hasChainTimeCodeHold);
+    inoutBox()->setFlipModeVisible(deviceFeatures.hasChainFlipVertical, deviceFeatures.hasChainFlipHorizontal);
+    //    inoutBox()->setLogModeVisible(deviceFeatures.hasLutItf);
     //    Override visibility because of hasLutItf flag controls LUT box
-    m_ui->inoutBox->setLogModeVisible(false);
-    m_ui->inoutBox->setTestPatternVisible(deviceFeatures.hasOsdTestPattern);
-    m_ui->inoutBox->setAudioVisible(deviceFeatures.hasChainAudio);
+    inoutBox()->setLogModeVisible(false);
+    inoutBox()->setTestPatternVisible(deviceFeatures.hasOsdTestPattern);
+    inoutBox()->setAudioVisible(deviceFeatures.hasChainAudio);
 
     // BlackBox Tab
     m_ui->blackBox->setFlareLevelVisible(deviceFeatures.hasIspFlare);
@@ -382,7 +468,10 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
     m_ui->wbBox->setColorProcessingSettingsVisible(deviceFeatures.hasCprocItfHue);
 
     // LutBox Tab
-    m_ui->lutBox->setLutBitWidth(deviceFeatures.lutBitWidth);
+    if (deviceFeatures.hasLutItf)
+    {
+        lutBox()->setLutBitWidth(deviceFeatures.lutBitWidth);
+    }
 
     // Dpcc Tab
     m_ui->dpccBox->setFullDpccFeatureSetVisible(deviceFeatures.hasDpccFullFeautureSet);
@@ -440,6 +529,72 @@ void MainWindow::setupUI(ProVideoDevice::features deviceFeatures)
     onResizeMainWindow( true );
 }
 
+/******************************************************************************
+ * MainWindow::inoutBox
+ *****************************************************************************/
+InOutBox * MainWindow::inoutBox()
+{
+    if ( !m_inoutBox )
+    {
+        m_inoutBox = new InOutBox( m_ui->tabInOut );
+        addBox( m_ui->tabInOut, m_inoutBox, "inoutBox" );
+    }
+
+    return ( m_inoutBox );
+}
+
+/******************************************************************************
+ * MainWindow::kneeBox
+ *****************************************************************************/
+KneeBox * MainWindow::kneeBox()
+{
+    if ( !m_kneeBox )
+    {
+        m_kneeBox = new KneeBox( m_ui->tabKnee );
+        addBox( m_ui->tabKnee, m_kneeBox, "kneeBox" );
+    }
+
+    return ( m_kneeBox );
+}
+
+/******************************************************************************
+ * MainWindow::lutBox
+ *****************************************************************************/
+LutBox * MainWindow::lutBox()
+{
+    if ( !m_lutBox )
+    {
+        m_lutBox = new LutBox( m_ui->tabGamma );
+        addBox( m_ui->tabGamma, m_lutBox, "lutBox" );
+    }
+
+    return ( m_lutBox );
+}
+
+/******************************************************************************
+ * MainWindow::roiBox
+ *****************************************************************************/
+ROIBox * MainWindow::roiBox()
+{
+    if ( !m_roiBox )
+    {
+        m_roiBox = new ROIBox( m_ui->tabROI );
+        addBox( m_ui->tabROI, m_roiBox, "roiBox" );
+    }
+
+    return ( m_roiBox );
+}
+
+/******************************************************************************
+ * MainWindow::addBox
+ *****************************************************************************/
+void MainWindow::addBox( QWidget * page, DctWidgetBox * box, const QString & name )
+{
+    // the name is used by the command scheduler and in its error messages
+    box->setObjectName( name );
+    page->layout()->addWidget( box );
+}
+
 /******************************************************************************
  * MainWindow::fileExists
  *****************************************************************************/
@@ -475,6 +630,8 @@ void MainWindow::loadUiSettings( QSettings &s )
     // connection check
     m_EnableConnectionCheck = s.value( UI_SETTING_ENABLE_CONNECTION_CHECK, m_EnableConnectionCheck ).toBool();
     m_SettingsDlg->setConnectionCheckChecked( m_EnableConnectionCheck );
+    m_ConnectionIdleTime = qMax( s.value( UI_SETTING_CONNECTION_IDLE_TIME, m_ConnectionIdleTime ).toInt(),
+                                 CONNECTION_IDLE_TIME_MIN );
 
     /* Note connection check is started at the end of connectToDevice() */
 
@@ -491,6 +648,7 @@ void MainWindow::saveUiSettings( QSettings &s )
     s.setValue( UI_SETTING_WIDGET_MODE, m_WidgetMode );
     s.setValue( UI_SETTING_SHOW_DEBUG_TERMINAL, m_ShowDebugTerminal );
     s.setValue( UI_SETTING_ENABLE_CONNECTION_CHECK, m_EnableConnectionCheck );
+    s.setValue( UI_SETTING_CONNECTION_IDLE_TIME, m_ConnectionIdleTime );
     s.endGroup();
 }
 
@@ -538,6 +696,23 @@ void MainWindow::updateDeviceList()
  *****************************************************************************/
 void MainWindow::connectToDevice( ProVideoDevice * dev )
 {
+    m_connectTime.start();
+
+    // Stop synchronizing the previous device
+    m_resyncTimer.stop();
+    m_resyncPending.clear();
+
+    // The response cache belongs to the previous device
+    m_ConnectDlg->getChannelRS232()->setCache( nullptr );
+    m_ConnectDlg->getChannelRS485()->setCache( nullptr );
+    m_cache.clear();
+    m_cacheFile.clear();
+    m_fingerprintPending = false;
+
+    // Updates of the previous device are dropped
+    m_updates.clear();
+    m_updates.resetCounters();
+
     // Show a message box to indicate connection is ongoing
     InfoDialog infoDlg( QString(":/icons/cog-64.png"), QString("Connect Dialog"), QString("Loading Device Settings..."), this->parentWidget() );
     infoDlg.show();
@@ -553,31 +728,33 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     // Enable / disable UI elements, as they are supported by the device
     setupUI(deviceFeatures);
 
-    // Connect all needed Slots and Signals according to the device features
+    // Connect all needed Slots and Signals according to the device features,
+    // signals which come in bursts during a resync (statistics, tables, LUT
+    // samples, colour matrices) are coalesced per UI tick by m_updates
     //////////////////////////
     // inout widget
     //////////////////////////
     if (deviceFeatures.hasCamItf)
     {
         // connect camera info
-        connect( dev->GetCamItf(), SIGNAL(CameraInfoChanged(int,int,int,int,int)), m_ui->inoutBox, SLOT(onCameraInfoChange(int,int,int,int,int)) );
+        connect( dev->GetCamItf(), SIGNAL(CameraInfoChanged(int,int,int,int,int)), inoutBox(), SLOT(onCameraInfoChange(int,int,int,int,int)) );
 
         // connect camera gain
-        connect( dev->GetCamItf(), SIGNAL(CameraGainChanged(int)), m_ui->inoutBox, SLOT(onCameraGainChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(CameraGainChanged(int)), dev->GetCamItf(), SLOT(onCameraGainChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(ResyncAnalogGain()), dev->GetCamItf(), SLOT(onAnalogGainResyncRequest()) );
+        connect( dev->GetCamItf(), SIGNAL(CameraGainChanged(int)), inoutBox(), SLOT(onCameraGainChange(int)) );
+        connect( inoutBox(), SIGNAL(CameraGainChanged(int)), dev->GetCamItf(), SLOT(onCameraGainChange(int)) );
+        connect( inoutBox(), SIGNAL(ResyncAnalogGain()), dev->GetCamItf(), SLOT(onAnalogGainResyncRequest()) );
 
         // connect camera exposure
-        connect( dev->GetCamItf(), SIGNAL(CameraExposureChanged(int)), m_ui->inoutBox, SLOT(onCameraExposureChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(CameraExposureChanged(int)), dev->GetCamItf(), SLOT(onCameraExposureChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(ResyncMaxExposure()), dev->GetCamItf(), SLOT(onMaxExposureResyncRequest()) );
+        connect( dev->GetCamItf(), SIGNAL(CameraExposureChanged(int)), inoutBox(), SLOT(onCameraExposureChange(int)) );
+        connect( inoutBox(), SIGNAL(CameraExposureChanged(int)), dev->GetCamItf(), SLOT(onCameraExposureChange(int)) );
+        connect( inoutBox(), SIGNAL(ResyncMaxExposure()), dev->GetCamItf(), SLOT(onMaxExposureResyncRequest()) );
 
         // connect camera ROI offset info & ROI offset
-        connect( dev->GetCamItf(), SIGNAL(CameraRoiOffsetInfoChanged(int,int,int,int)), m_ui->inoutBox, SLOT(onCameraRoiOffsetInfoChange(int,int,int,int)) );
-        connect( dev->GetCamItf(), SIGNAL(CameraRoiOffsetChanged(int,int)), m_ui->inoutBox, SLOT(onCameraRoiOffsetChange(int,int)) );
-        connect( m_ui->inoutBox, SIGNAL(CameraRoiOffsetChanged(int,int)), dev->GetCamItf(), SLOT(onCameraRoiOffsetChange(int,int)) );
+        connect( dev->GetCamItf(), SIGNAL(CameraRoiOffsetInfoChanged(int,int,int,int)), inoutBox(), SLOT(onCameraRoiOffsetInfoChange(int,int,int,int)) );
+        connect( dev->GetCamItf(), SIGNAL(CameraRoiOffsetChanged(int,int)), inoutBox(), SLOT(onCameraRoiOffsetChange(int,int)) );
+        connect( inoutBox(), SIGNAL(CameraRoiOffsetChanged(int,int)), dev->GetCamItf(), SLOT(onCameraRoiOffsetChange(int,int)) );
 
-        connect( m_ui->inoutBox, SIGNAL(CameraDownscalerChange()), dev->GetCamItf(), SLOT(onDownscalerChange()) );
+        connect( inoutBox(), SIGNAL(CameraDownscalerChange()), dev->GetCamItf(), SLOT(onDownscalerChange()) );
     }
 
 
@@ -586,81 +763,81 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         if ( deviceFeatures.hasIspLsc )
         {
             // connect lens shading correction
-            connect( dev->GetIspItf(), SIGNAL(LscChanged(QVector<uint>)), m_ui->inoutBox, SLOT(onLscChange(QVector<uint>)) );
-            connect( m_ui->inoutBox, SIGNAL(LscChanged(QVector<uint>)), dev->GetIspItf(), SLOT(onLscChange(QVector<uint>)) );
+            connect( dev->GetIspItf(), SIGNAL(LscChanged(QVector<uint>)), inoutBox(), SLOT(onLscChange(QVector<uint>)) );
+            connect( inoutBox(), SIGNAL(LscChanged(QVector<uint>)), dev->GetIspItf(), SLOT(onLscChange(QVector<uint>)) );
         }
     }
 
     if (deviceFeatures.hasChainItf)
     {
         // connect video mode
-        connect( dev->GetChainItf(), SIGNAL(ChainVideoModeChanged(int)), m_ui->inoutBox, SLOT(onChainVideoModeChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(ChainVideoModeChanged(int)), dev->GetChainItf(), SLOT(onChainVideoModeChange(int)) );
+        connect( dev->GetChainItf(), SIGNAL(ChainVideoModeChanged(int)), inoutBox(), SLOT(onChainVideoModeChange(int)) );
+        connect( inoutBox(), SIGNAL(ChainVideoModeChanged(int)), dev->GetChainItf(), SLOT(onChainVideoModeChange(int)) );
 
         if (deviceFeatures.hasChainSdi2Mode)
         {
-            connect( dev->GetChainItf(), SIGNAL(ChainSdi2ModeChanged(int)), m_ui->inoutBox, SLOT(onChainSdi2ModeChange(int)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainSdi2ModeChanged(int)), dev->GetChainItf(), SLOT(onChainSdi2ModeChange(int)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainSdi2ModeChanged(int)), inoutBox(), SLOT(onChainSdi2ModeChange(int)) );
+            connect( inoutBox(), SIGNAL(ChainSdi2ModeChanged(int)), dev->GetChainItf(), SLOT(onChainSdi2ModeChange(int)) );
         }
         if (deviceFeatures.hasChainDownscale)
         {
-            connect( dev->GetChainItf(), SIGNAL(ChainDownscaleModeChanged(int,bool,bool)), m_ui->inoutBox, SLOT(onChainDownscaleModeChange(int,bool,bool)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainDownscaleModeChanged(int,bool,bool)), dev->GetChainItf(), SLOT(onChainDownscaleModeChange(int,bool,bool)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainDownscaleModeChanged(int,bool,bool)), inoutBox(), SLOT(onChainDownscaleModeChange(int,bool,bool)) );
+            connect( inoutBox(), SIGNAL(ChainDownscaleModeChanged(int,bool,bool)), dev->GetChainItf(), SLOT(onChainDownscaleModeChange(int,bool,bool)) );
         }
         if (deviceFeatures.hasChainFlipVertical || deviceFeatures.hasChainFlipHorizontal)
         {
-            connect( dev->GetChainItf(), SIGNAL(ChainFlipModeChanged(int)), m_ui->inoutBox, SLOT(onChainFlipModeChange(int)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainFlipModeChanged(int)), dev->GetChainItf(), SLOT(onChainFlipModeChange(int)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainFlipModeChanged(int)), inoutBox(), SLOT(onChainFlipModeChange(int)) );
+            connect( inoutBox(), SIGNAL(ChainFlipModeChanged(int)), dev->GetChainItf(), SLOT(onChainFlipModeChange(int)) );
         }
         if (deviceFeatures.hasChainGenLock)
         {
             // connect gen-lock mode
-            connect( dev->GetChainItf(), SIGNAL(ChainGenlockModeChanged(int)), m_ui->inoutBox, SLOT(onChainGenlockModeChange(int)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainGenlockModeChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockModeChange(int)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainGenlockModeChanged(int)), inoutBox(), SLOT(onChainGenlockModeChange(int)) );
+            connect( inoutBox(), SIGNAL(ChainGenlockModeChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockModeChange(int)) );
 
-            connect( dev->GetChainItf(), SIGNAL(ChainGenlockStatusChanged(int)), m_ui->inoutBox, SLOT(onChainGenlockStatusChange(int)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainGenLockStatusRefresh()), dev->GetChainItf(), SLOT(onChainGenlockStatusRefresh()) );
+            connect( dev->GetChainItf(), SIGNAL(ChainGenlockStatusChanged(int)), inoutBox(), SLOT(onChainGenlockStatusChange(int)) );
+            connect( inoutBox(), SIGNAL(ChainGenLockStatusRefresh()), dev->GetChainItf(), SLOT(onChainGenlockStatusRefresh()) );
 
-            connect( dev->GetChainItf(), SIGNAL(ChainGenlockLOLFilterChanged(int)), m_ui->inoutBox, SLOT(onChainGenlockLOLFilterChange(int)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainGenlockLOLFilterChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockLOLFilterChange(int)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainGenlockLOLFilterChanged(int)), inoutBox(), SLOT(onChainGenlockLOLFilterChange(int)) );
+            connect( inoutBox(), SIGNAL(ChainGenlockLOLFilterChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockLOLFilterChange(int)) );
 
             if (deviceFeatures.hasChainGenLockTermCrosslockOffset)
             {
-                connect( dev->GetChainItf(), SIGNAL(ChainGenlockCrosslockChanged(int)), m_ui->inoutBox, SLOT(onChainGenlockCrosslockChange(int)) );
-                connect( m_ui->inoutBox, SIGNAL(ChainGenlockCrosslockChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockCrosslockChange(int)) );
+                connect( dev->GetChainItf(), SIGNAL(ChainGenlockCrosslockChanged(int)), inoutBox(), SLOT(onChainGenlockCrosslockChange(int)) );
+                connect( inoutBox(), SIGNAL(ChainGenlockCrosslockChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockCrosslockChange(int)) );
 
-                connect( dev->GetChainItf(), SIGNAL(ChainGenlockTerminationChanged(int)), m_ui->inoutBox, SLOT(onChainGenlockTerminationChange(int)) );
-                connect( m_ui->inoutBox, SIGNAL(ChainGenlockTerminationChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockTerminationChange(int)) );
+                connect( dev->GetChainItf(), SIGNAL(ChainGenlockTerminationChanged(int)), inoutBox(), SLOT(onChainGenlockTerminationChange(int)) );
+                connect( inoutBox(), SIGNAL(ChainGenlockTerminationChanged(int)), dev->GetChainItf(), SLOT(onChainGenlockTerminationChange(int)) );
 
-                connect( dev->GetChainItf(), SIGNAL(ChainGenlockOffsetChanged(int, int)), m_ui->inoutBox, SLOT(onChainGenlockOffsetChange(int, int)) );
-                connect( m_ui->inoutBox, SIGNAL(ChainGenlockOffsetChanged(int, int)), dev->GetChainItf(), SLOT(onChainGenlockOffsetChange(int, int)) );
-                connect( dev->GetChainItf(), SIGNAL(ChainGenlockOffsetMaxChanged(int, int)), m_ui->inoutBox, SLOT(onChainGenlockOffsetMaxChange(int, int)) );
+                connect( dev->GetChainItf(), SIGNAL(ChainGenlockOffsetChanged(int, int)), inoutBox(), SLOT(onChainGenlockOffsetChange(int, int)) );
+                connect( inoutBox(), SIGNAL(ChainGenlockOffsetChanged(int, int)), dev->GetChainItf(), SLOT(onChainGenlockOffsetChange(int, int)) );
+                connect( dev->GetChainItf(), SIGNAL(ChainGenlockOffsetMaxChanged(int, int)), inoutBox(), SLOT(onChainGenlockOffsetMaxChange(int, int)) );
 
                 // if video mode changed
-                connect( m_ui->inoutBox, SIGNAL(GenlockSyncRequested()), dev->GetChainItf(), SLOT(onChainGenlockSyncRequested()) );
+                connect( inoutBox(), SIGNAL(GenlockSyncRequested()), dev->GetChainItf(), SLOT(onChainGenlockSyncRequested()) );
                 // if Genlock mode changed
-                connect( m_ui->inoutBox, SIGNAL(GenlockCrosslockSyncRequested()), dev->GetChainItf(), SLOT(onChainGenlockCrosslockSyncRequested()) );
-                connect( m_ui->inoutBox, SIGNAL(GenlockOffsetSyncRequested()), dev->GetChainItf(), SLOT(onChainGenlockOffsetSyncRequested()) );
+                connect( inoutBox(), SIGNAL(GenlockCrosslockSyncRequested()), dev->GetChainItf(), SLOT(onChainGenlockCrosslockSyncRequested()) );
+                connect( inoutBox(), SIGNAL(GenlockOffsetSyncRequested()), dev->GetChainItf(), SLOT(onChainGenlockOffsetSyncRequested()) );
             }
         }
         if (deviceFeatures.hasChainTimeCode)
         {
             // Timecode
-            connect( dev->GetChainItf(), SIGNAL(ChainTimecodeChanged(QVector<int>)), m_ui->inoutBox, SLOT(onChainTimecodeChange(QVector<int>)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainTimecodeSetChanged(QVector<int>)), dev->GetChainItf(), SLOT(onChainTimecodeChange(QVector<int>)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainTimecodeChanged(QVector<int>)), inoutBox(), SLOT(onChainTimecodeChange(QVector<int>)) );
+            connect( inoutBox(), SIGNAL(ChainTimecodeSetChanged(QVector<int>)), dev->GetChainItf(), SLOT(onChainTimecodeChange(QVector<int>)) );
 
-            connect( m_ui->inoutBox, SIGNAL(ChainTimecodeGetRequested()), dev->GetChainItf(), SLOT(onChainTimecodeGetRequest()) );
+            connect( inoutBox(), SIGNAL(ChainTimecodeGetRequested()), dev->GetChainItf(), SLOT(onChainTimecodeGetRequest()) );
 
-            connect( dev->GetChainItf(), SIGNAL(ChainTimecodeHoldChanged(bool)), m_ui->inoutBox, SLOT(onChainTimecodeHoldChange(bool)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainTimecodeHoldChanged(bool)), dev->GetChainItf(), SLOT(onChainTimecodeHoldChange(bool)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainTimecodeHoldChanged(bool)), inoutBox(), SLOT(onChainTimecodeHoldChange(bool)) );
+            connect( inoutBox(), SIGNAL(ChainTimecodeHoldChanged(bool)), dev->GetChainItf(), SLOT(onChainTimecodeHoldChange(bool)) );
         }
         if (deviceFeatures.hasChainAudio)
         {
-            connect( dev->GetChainItf(), SIGNAL(ChainAudioEnableChanged(bool)), m_ui->inoutBox, SLOT(onChainAudioEnableChange(bool)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainAudioEnableChanged(bool)), dev->GetChainItf(), SLOT(onChainAudioEnableChange(bool)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainAudioEnableChanged(bool)), inoutBox(), SLOT(onChainAudioEnableChange(bool)) );
+            connect( inoutBox(), SIGNAL(ChainAudioEnableChanged(bool)), dev->GetChainItf(), SLOT(onChainAudioEnableChange(bool)) );
 
-            connect( dev->GetChainItf(), SIGNAL(ChainAudioGainChanged(double)), m_ui->inoutBox, SLOT(onChainAudioGainChange(double)) );
-            connect( m_ui->inoutBox, SIGNAL(ChainAudioGainChanged(double)), dev->GetChainItf(), SLOT(onChainAudioGainChange(double)) );
+            connect( dev->GetChainItf(), SIGNAL(ChainAudioGainChanged(double)), inoutBox(), SLOT(onChainAudioGainChange(double)) );
+            connect( inoutBox(), SIGNAL(ChainAudioGainChanged(double)), dev->GetChainItf(), SLOT(onChainAudioGainChange(double)) );
         }
     }
 
@@ -668,23 +845,23 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     {
         if (deviceFeatures.hasOsdTestPattern)
         {
-            connect( dev->GetOsdItf(), SIGNAL(TestPatternChanged(int)), m_ui->inoutBox, SLOT(onOsdTestPatternChange(int)) );
-            connect( m_ui->inoutBox, SIGNAL(OsdTestPatternChanged(int)), dev->GetOsdItf(), SLOT(onTestPatternChange(int)) );
+            connect( dev->GetOsdItf(), SIGNAL(TestPatternChanged(int)), inoutBox(), SLOT(onOsdTestPatternChange(int)) );
+            connect( inoutBox(), SIGNAL(OsdTestPatternChanged(int)), dev->GetOsdItf(), SLOT(onTestPatternChange(int)) );
         }
     }
 
     if (deviceFeatures.hasAutoItf)
     {
         // Auto Exposure
-        connect( dev->GetAutoItf(), SIGNAL(AecEnableChanged(int)),m_ui->inoutBox, SLOT(onAecEnableChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(AecEnableChanged(int)), dev->GetAutoItf(), SLOT(onAecEnableChange(int)) );
+        connect( dev->GetAutoItf(), SIGNAL(AecEnableChanged(int)),inoutBox(), SLOT(onAecEnableChange(int)) );
+        connect( inoutBox(), SIGNAL(AecEnableChanged(int)), dev->GetAutoItf(), SLOT(onAecEnableChange(int)) );
 
-        connect( dev->GetAutoItf(), SIGNAL(AecSetupChanged(QVector<int>)), m_ui->inoutBox, SLOT(onAecSetupChange(QVector<int>)) );
-        connect( m_ui->inoutBox, SIGNAL(AecSetupChanged(QVector<int>)), dev->GetAutoItf(), SLOT(onAecSetupChange(QVector<int>)) );
-        connect( m_ui->inoutBox, SIGNAL(GetAecSetup()), dev->GetAutoItf(), SLOT(onGetAecSetup()) );
+        connect( dev->GetAutoItf(), SIGNAL(AecSetupChanged(QVector<int>)), inoutBox(), SLOT(onAecSetupChange(QVector<int>)) );
+        connect( inoutBox(), SIGNAL(AecSetupChanged(QVector<int>)), dev->GetAutoItf(), SLOT(onAecSetupChange(QVector<int>)) );
+        connect( inoutBox(), SIGNAL(GetAecSetup()), dev->GetAutoItf(), SLOT(onGetAecSetup()) );
 
-        connect( dev->GetAutoItf(), SIGNAL(AecWeightsChanged(QVector<int>)), m_ui->inoutBox, SLOT(onAecWeightsChange(QVector<int>)) );
-        connect( m_ui->inoutBox, SIGNAL(AecWeightChanged(int,int)), dev->GetAutoItf(), SLOT(onAecWeightChange(int,int)) );
+        connect( dev->GetAutoItf(), SIGNAL(AecWeightsChanged(QVector<int>)), inoutBox(), SLOT(onAecWeightsChange(QVector<int>)) );
+        connect( inoutBox(), SIGNAL(AecWeightChanged(int,int)), dev->GetAutoItf(), SLOT(onAecWeightChange(int,int)) );
 
 
     }
@@ -692,11 +869,11 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     if (deviceFeatures.hasIrisItf)
     {
         // Auto Iris
-        connect( dev->GetIrisItf(), SIGNAL(IrisSetupChanged(QVector<int>)), m_ui->inoutBox, SLOT(onIrisSetupChange(QVector<int>)) );
-        connect( dev->GetIrisItf(), SIGNAL(IrisAptChanged(int)), m_ui->inoutBox, SLOT(onIrisAptChange(int)) );
-        connect( dev->GetIrisItf(), SIGNAL(IrisAptError()), m_ui->inoutBox, SLOT(onIrisAptError()) );
+        connect( dev->GetIrisItf(), SIGNAL(IrisSetupChanged(QVector<int>)), inoutBox(), SLOT(onIrisSetupChange(QVector<int>)) );
+        connect( dev->GetIrisItf(), SIGNAL(IrisAptChanged(int)), inoutBox(), SLOT(onIrisAptChange(int)) );
+        connect( dev->GetIrisItf(), SIGNAL(IrisAptError()), inoutBox(), SLOT(onIrisAptError()) );
 
-        connect( m_ui->inoutBox, SIGNAL(IrisAptChanged(int)), dev->GetIrisItf(), SLOT(onIrisAptChange(int)) );
+        connect( inoutBox(), SIGNAL(IrisAptChanged(int)), dev->GetIrisItf(), SLOT(onIrisAptChange(int)) );
     }
 
     //////////////////////////
@@ -713,6 +890,8 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         connect( dev->GetLensItf(), SIGNAL(LensActiveChanged(bool)), m_ui->lensDriverBox, SLOT(onLensActiveChange(bool)) );
         connect( m_ui->lensDriverBox, SIGNAL(LensActiveChanged(bool)), dev->GetLensItf(), SLOT(onLensActiveChange(bool)) );
         connect(m_ui->lensDriverBox,SIGNAL(SmallResyncRequest(void)),dev->GetLensItf(),SLOT(onSmallResyncRequest(void)) );
+        connect( m_ui->lensDriverBox, SIGNAL(LensPositionFollowRequest(void)), dev->GetLensItf(), SLOT(onLensPositionFollowRequest(void)) );
+        connect( dev->GetLensItf(), SIGNAL(LensPositionFollowIntervalChanged(int)), m_ui->lensDriverBox, SLOT(onLensPositionFollowIntervalChange(int)) );
 
         // lens  Invert
         connect( dev->GetLensItf(), SIGNAL(LensInvertChanged( QVector<int> ) ), m_ui->lensDriverBox, SLOT( onLensInvertChange( QVector<int> )) );
@@ -775,8 +954,8 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         if (deviceFeatures.hasCamItf)
         {
             // connect bayer pattern
-            connect( m_ui->inoutBox, SIGNAL(BayerPatternChanged(int)), dev->GetIspItf(), SLOT(onBayerPatternChange(int)) );
-            connect( dev->GetIspItf(), SIGNAL(BayerPatternChanged(int)), m_ui->inoutBox, SLOT(onBayerPatternChange(int)) );
+            connect( inoutBox(), SIGNAL(BayerPatternChanged(int)), dev->GetIspItf(), SLOT(onBayerPatternChange(int)) );
+            connect( dev->GetIspItf(), SIGNAL(BayerPatternChanged(int)), inoutBox(), SLOT(onBayerPatternChange(int)) );
         }
 
         // connect RED black level
@@ -852,14 +1031,16 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         // connect Button-Array Box
         connect( dev->GetAutoItf(), SIGNAL(NoWbPresetsChanged(int)), m_ui->wbBox, SLOT(onNoWbPresetsChange(int)) );
         connect( dev->GetAutoItf(), SIGNAL(WbPresetsChanged(int,QString,int)), m_ui->wbBox, SLOT(onWbPresetsChange(int,QString,int)) );
-        connect( dev->GetAutoItf(), SIGNAL(StatRGBChanged(int,int,int)), m_ui->wbBox, SLOT(onStatRGBChange(int,int,int)) );
-        connect( dev->GetAutoItf(), SIGNAL(StatXYZChanged(int,int,int)), m_ui->wbBox, SLOT(onStatXYZChange(int,int,int)) );
-        connect( dev->GetAutoItf(), SIGNAL(ColorXYZChanged(int,int,int,int,int,int,int,int,int)),
-                 m_ui->wbBox, SLOT(onColorXYZChange(int,int,int,int,int,int,int,int,int)) );
+        m_updates.connect( dev->GetAutoItf(), SIGNAL(StatRGBChanged(int,int,int)), m_ui->wbBox, SLOT(onStatRGBChange(int,int,int)) );
+        m_updates.connect( dev->GetAutoItf(), SIGNAL(StatXYZChanged(int,int,int)), m_ui->wbBox, SLOT(onStatXYZChange(int,int,int)) );
+        m_updates.connect( dev->GetAutoItf(), SIGNAL(ColorXYZChanged(int,int,int,int,int,int,int,int,int)),
+                           m_ui->wbBox, SLOT(onColorXYZChange(int,int,int,int,int,int,int,int,int)) );
 
         connect( m_ui->wbBox, SIGNAL(WbChanged()), dev->GetAutoItf(), SLOT(onWbChange()) );
         connect( m_ui->wbBox, SIGNAL(WbPresetChanged(int)), dev->GetAutoItf(), SLOT(onWbPresetChange(int)) );
         connect( m_ui->wbBox, SIGNAL(StatisticChanged()), dev->GetAutoItf(), SLOT(onNotifyWhiteBalanceUpdate()) );
+        connect( m_ui->wbBox, SIGNAL(StatXYZRequested()), dev->GetAutoItf(), SLOT(onGetStatXYZ()) );
+        connect( m_ui->wbBox, SIGNAL(ColorXYZRequested()), dev->GetAutoItf(), SLOT(onGetColorXYZ()) );
     }
 
     if (deviceFeatures.hasIspGain)
@@ -917,7 +1098,7 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         connect( m_ui->mccEqBox, SIGNAL(MccOperationModeChanged(int,int)), dev->GetMccItf(), SLOT(onMccOperationModeChange(int,int)) );
 
         // connect phase changes
-        connect( dev->GetMccItf(), SIGNAL(MccPhaseChanged(int,int,int)), m_ui->mccEqBox, SLOT(onMccPhaseChange(int,int,int)) );
+        m_updates.connect( dev->GetMccItf(), SIGNAL(MccPhaseChanged(int,int,int)), m_ui->mccEqBox, SLOT(onMccPhaseChange(int,int,int)), 1 );
         connect( m_ui->mccEqBox, SIGNAL(MccPhaseChanged(int,int,int)), dev->GetMccItf(), SLOT(onMccPhaseChange(int,int,int)) );
         connect( m_ui->mccEqBox, SIGNAL(MccPhaseIndexChanged(int)), dev->GetMccItf(), SLOT(onMccPhaseSelectionChange(int)) );
     }
@@ -927,8 +1108,8 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     //////////////////////////
     if (deviceFeatures.hasKneeItf)
     {
-        connect( dev->GetKneeItf(), SIGNAL(KneeConfigChanged(int,int,int,int)), m_ui->kneeBox, SLOT(onKneeConfigChange(int,int,int,int)) );
-        connect( m_ui->kneeBox, SIGNAL(KneeConfigChanged(int,int,int,int)), dev->GetKneeItf(), SLOT(onKneeConfigChange(int,int,int,int)) );
+        m_updates.connect( dev->GetKneeItf(), SIGNAL(KneeConfigChanged(int,int,int,int)), kneeBox(), SLOT(onKneeConfigChange(int,int,int,int)) );
+        connect( kneeBox(), SIGNAL(KneeConfigChanged(int,int,int,int)), dev->GetKneeItf(), SLOT(onKneeConfigChange(int,int,int,int)) );
     }
 
     //////////////////////////
@@ -936,12 +1117,12 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     //////////////////////////
     if (deviceFeatures.hasROIItf)
     {
-        connect( dev->GetROIItf(), SIGNAL(StatROIInfoChanged(int,int,int,int)), m_ui->roiBox, SLOT(onStatROIInfoChange(int,int,int,int)) );
-        connect( dev->GetROIItf(), SIGNAL(StatROIChanged(int,int,int,int)), m_ui->roiBox, SLOT(onStatROIChange(int,int,int,int)) );
-        connect( m_ui->roiBox, SIGNAL(StatROIChanged(int,int,int,int)), dev->GetROIItf(), SLOT(onStatROIChange(int,int,int,int)) );
+        connect( dev->GetROIItf(), SIGNAL(StatROIInfoChanged(int,int,int,int)), roiBox(), SLOT(onStatROIInfoChange(int,int,int,int)) );
+        m_updates.connect( dev->GetROIItf(), SIGNAL(StatROIChanged(int,int,int,int)), roiBox(), SLOT(onStatROIChange(int,int,int,int)) );
+        connect( roiBox(), SIGNAL(StatROIChanged(int,int,int,int)), dev->GetROIItf(), SLOT(onStatROIChange(int,int,int,int)) );
 
         // video mode changed
-        connect( m_ui->inoutBox, SIGNAL(ROIVideoModeChanged()), dev->GetROIItf(), SLOT(onROIVideoModeChanged()) );
+        connect( inoutBox(), SIGNAL(ROIVideoModeChanged()), dev->GetROIItf(), SLOT(onROIVideoModeChanged()) );
     }
 
     //////////////////////////
@@ -949,74 +1130,86 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     //////////////////////////
     if (deviceFeatures.hasLutItf)
     {
-        connect( dev->GetLutItf(), SIGNAL(LutEnableChanged(int,int)), m_ui->lutBox, SLOT(onLutEnableChange(int,int)) );
-        connect( m_ui->lutBox, SIGNAL(LutEnableChanged(int,int)), dev->GetLutItf(), SLOT(onLutEnableChange(int,int)) );
+        connect( dev->GetLutItf(), SIGNAL(LutEnableChanged(int,int)), lutBox(), SLOT(onLutEnableChange(int,int)) );
+        connect( lutBox(), SIGNAL(LutEnableChanged(int,int)), dev->GetLutItf(), SLOT(onLutEnableChange(int,int)) );
 
-        connect( dev->GetLutItf(), SIGNAL(LutModeChanged(int)), m_ui->lutBox, SLOT(onLutModeChange(int)) );
-        connect( m_ui->lutBox, SIGNAL(LutModeChanged(int)), dev->GetLutItf(), SLOT(onLutModeChange(int)) );
+        connect( dev->GetLutItf(), SIGNAL(LutModeChanged(int)), lutBox(), SLOT(onLutModeChange(int)) );
+        connect( lutBox(), SIGNAL(LutModeChanged(int)), dev->GetLutItf(), SLOT(onLutModeChange(int)) );
 
-        connect( dev->GetLutItf(), SIGNAL(LutFixedModeChanged(int)), m_ui->lutBox, SLOT(onLutFixedModeChange(int)) );
-        connect( m_ui->lutBox, SIGNAL(LutFixedModeChanged(int)), dev->GetLutItf(), SLOT(onLutFixedModeChange(int)) );
+        connect( dev->GetLutItf(), SIGNAL(LutFixedModeChanged(int)), lutBox(), SLOT(onLutFixedModeChange(int)) );
+        connect( lutBox(), SIGNAL(LutFixedModeChanged(int)), dev->GetLutItf(), SLOT(onLutFixedModeChange(int)) );
 
-        connect( dev->GetLutItf(), SIGNAL(LogModeChanged(int)), m_ui->inoutBox, SLOT(onLogModeChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(LogModeChanged(int)), dev->GetLutItf(), SLOT(onLogModeChange(int)) );
-        connect( dev->GetLutItf(), SIGNAL(LogModeChanged(int)), m_ui->lutBox, SLOT(onLogModeChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(LogModeChanged(int)),  m_ui->lutBox, SLOT(onLogModeChange(int)) );
+        connect( dev->GetLutItf(), SIGNAL(LogModeChanged(int)), inoutBox(), SLOT(onLogModeChange(int)) );
+        connect( inoutBox(), SIGNAL(LogModeChanged(int)), dev->GetLutItf(), SLOT(onLogModeChange(int)) );
+        connect( dev->GetLutItf(), SIGNAL(LogModeChanged(int)), lutBox(), SLOT(onLogModeChange(int)) );
+        connect( inoutBox(), SIGNAL(LogModeChanged(int)),  lutBox(), SLOT(onLogModeChange(int)) );
 
-        connect( dev->GetLutItf(), SIGNAL(PQMaxBrightnessChanged(int)), m_ui->inoutBox, SLOT(onPQMaxBrightnessChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(PQMaxBrightnessChanged(int)), dev->GetLutItf(), SLOT(onPQMaxBrightnessChange(int)) );
+        connect( dev->GetLutItf(), SIGNAL(PQMaxBrightnessChanged(int)), inoutBox(), SLOT(onPQMaxBrightnessChange(int)) );
+        connect( inoutBox(), SIGNAL(PQMaxBrightnessChanged(int)), dev->GetLutItf(), SLOT(onPQMaxBrightnessChange(int)) );
 
-        connect( dev->GetIspItf(), SIGNAL(ColorSpaceChanged(int)), m_ui->inoutBox, SLOT(onColorSpaceChange(int)) );
-        connect( m_ui->inoutBox, SIGNAL(ColorSpaceChanged(int)), dev->GetIspItf(), SLOT(onColorSpaceChange(int)) );
+        connect( dev->GetIspItf(), SIGNAL(ColorSpaceChanged(int)), inoutBox(), SLOT(onColorSpaceChange(int)) );
+        connect( inoutBox(), SIGNAL(ColorSpaceChanged(int)), dev->GetIspItf(), SLOT(onColorSpaceChange(int)) );
 
-        connect( dev->GetLutItf(), SIGNAL(LutPresetChanged(int)), m_ui->lutBox, SLOT(onLutPresetChange(int)) );
-        connect( m_ui->lutBox, SIGNAL(LutPresetChanged(int)), dev->GetLutItf(), SLOT(onLutPresetChange(int)) );
+        connect( dev->GetLutItf(), SIGNAL(LutPresetChanged(int)), lutBox(), SLOT(onLutPresetChange(int)) );
+        connect( lutBox(), SIGNAL(LutPresetChanged(int)), dev->GetLutItf(), SLOT(onLutPresetChange(int)) );
 
-        connect( dev->GetLutItf(), SIGNAL(LutSampleValuesRedChanged(QVector<int>,QVector<int>)),
-                 m_ui->lutBox, SLOT(onLutSampleValuesRedChange(QVector<int>,QVector<int>)) );
-        connect( dev->GetLutItf(), SIGNAL(LutSampleValuesGreenChanged(QVector<int>,QVector<int>)),
-                 m_ui->lutBox, SLOT(onLutSampleValuesGreenChange(QVector<int>,QVector<int>)) );
-        connect( dev->GetLutItf(), SIGNAL(LutSampleValuesBlueChanged(QVector<int>,QVector<int>)),
-                 m_ui->lutBox, SLOT(onLutSampleValuesBlueChange(QVector<int>,QVector<int>)) );
-        connect( dev->GetLutItf(), SIGNAL(LutSampleValuesMasterChanged(QVector<int>,QVector<int>)),
-                 m_ui->lutBox, SLOT(onLutSampleValuesMasterChange(QVector<int>,QVector<int>)) );
+        m_updates.connect( dev->GetLutItf(), SIGNAL(LutSampleValuesRedChanged(QVector<int>,QVector<int>)),
+                           lutBox(), SLOT(onLutSampleValuesRedChange(QVector<int>,QVector<int>)) );
+        m_updates.connect( dev->GetLutItf(), SIGNAL(LutSampleValuesGreenChanged(QVector<int>,QVector<int>)),
+                           lutBox(), SLOT(onLutSampleValuesGreenChange(QVector<int>,QVector<int>)) );
+        m_updates.connect( dev->GetLutItf(), SIGNAL(LutSampleValuesBlueChanged(QVector<int>,QVector<int>)),
+                           lutBox(), SLOT(onLutSampleValuesBlueChange(QVector<int>,QVector<int>)) );
+        m_updates.connect( dev->GetLutItf(), SIGNAL(LutSampleValuesMasterChanged(QVector<int>,QVector<int>)),
+                           lutBox(), SLOT(onLutSampleValuesMasterChange(QVector<int>,QVector<int>)) );
 
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesChanged(QVector<int>, QVector<int>)),
+        connect( lutBox(), SIGNAL(LutSampleValuesChanged(QVector<int>, QVector<int>)),
                  dev->GetLutItf(), SLOT(onLutSampleValuesChange(QVector<int>, QVector<int>)) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesRedChanged(QVector<int>, QVector<int>)),
+        connect( lutBox(), SIGNAL(LutSampleValuesRedChanged(QVector<int>, QVector<int>)),
                  dev->GetLutItf(), SLOT(onLutSampleValuesRedChange(QVector<int>, QVector<int>)) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesGreenChanged(QVector<int>, QVector<int>)),
+        connect( lutBox(), SIGNAL(LutSampleValuesGreenChanged(QVector<int>, QVector<int>)),
                  dev->GetLutItf(), SLOT(onLutSampleValuesGreenChange(QVector<int>, QVector<int>)) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesBlueChanged(QVector<int>, QVector<int>)),
+        connect( lutBox(), SIGNAL(LutSampleValuesBlueChanged(QVector<int>, QVector<int>)),
                  dev->GetLutItf(), SLOT(onLutSampleValuesBlueChange(QVector<int>, QVector<int>)) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesMasterChanged(QVector<int>, QVector<int>)),
+        connect( lutBox(), SIGNAL(LutSampleValuesMasterChanged(QVector<int>, QVector<int>)),
                  dev->GetLutItf(), SLOT(onLutSampleValuesMasterChange(QVector<int>, QVector<int>)) );
 
-        connect( m_ui->lutBox, SIGNAL(LutRec709Changed(int,int,int,int,int,int)),
+        connect( lutBox(), SIGNAL(LutRec709Changed(int,int,int,int,int,int)),
                  dev->GetLutItf(), SLOT(onLutRec709Change(int,int,int,int,int,int)) );
 
-        connect( m_ui->lutBox, SIGNAL(LutResetChanged()), dev->GetLutItf(), SLOT(onLutReset()) );
-        connect( m_ui->lutBox, SIGNAL(LutResetRedChanged()), dev->GetLutItf(), SLOT(onLutResetRed()) );
-        connect( m_ui->lutBox, SIGNAL(LutResetGreenChanged()), dev->GetLutItf(), SLOT(onLutResetGreen()) );
-        connect( m_ui->lutBox, SIGNAL(LutResetBlueChanged()), dev->GetLutItf(), SLOT(onLutResetBlue()) );
-        connect( m_ui->lutBox, SIGNAL(LutResetMasterChanged()), dev->GetLutItf(), SLOT(onLutResetMaster()) );
+        connect( lutBox(), SIGNAL(LutResetChanged()), dev->GetLutItf(), SLOT(onLutReset()) );
+        connect( lutBox(), SIGNAL(LutResetRedChanged()), dev->GetLutItf(), SLOT(onLutResetRed()) );
+        connect( lutBox(), SIGNAL(LutResetGreenChanged()), dev->GetLutItf(), SLOT(onLutResetGreen()) );
+        connect( lutBox(), SIGNAL(LutResetBlueChanged()), dev->GetLutItf(), SLOT(onLutResetBlue()) );
+        connect( lutBox(), SIGNAL(LutResetMasterChanged()), dev->GetLutItf(), SLOT(onLutResetMaster()) );
 
-        connect( m_ui->lutBox, SIGNAL(LutInterpolateChanged()), dev->GetLutItf(), SLOT(onLutInterpolate()) );
-        connect( m_ui->lutBox, SIGNAL(LutInterpolateRedChanged()), dev->GetLutItf(), SLOT(onLutInterpolateRed()) );
-        connect( m_ui->lutBox, SIGNAL(LutInterpolateGreenChanged()), dev->GetLutItf(), SLOT(onLutInterpolateGreen()) );
-        connect( m_ui->lutBox, SIGNAL(LutInterpolateBlueChanged()), dev->GetLutItf(), SLOT(onLutInterpolateBlue()) );
+        connect( lutBox(), SIGNAL(LutInterpolateChanged()), dev->GetLutItf(), SLOT(onLutInterpolate()) );
+        connect( lutBox(), SIGNAL(LutInterpolateRedChanged()), dev->GetLutItf(), SLOT(onLutInterpolateRed()) );
+        connect( lutBox(), SIGNAL(LutInterpolateGreenChanged()), dev->GetLutItf(), SLOT(onLutInterpolateGreen()) );
+        connect( lutBox(), SIGNAL(LutInterpolateBlueChanged()), dev->GetLutItf(), SLOT(onLutInterpolateBlue()) );
 
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesRedRequested()),
+        connect( lutBox(), SIGNAL(LutSampleValuesRedRequested()),
                  dev->GetLutItf(), SLOT(onLutSampleValuesRedRequest()) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesGreenRequested()),
+        connect( lutBox(), SIGNAL(LutSampleValuesGreenRequested()),
                  dev->GetLutItf(), SLOT(onLutSampleValuesGreenRequest()) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesBlueRequested()),
+        connect( lutBox(), SIGNAL(LutSampleValuesBlueRequested()),
                  dev->GetLutItf(), SLOT(onLutSampleValuesBlueRequest()) );
-        connect( m_ui->lutBox, SIGNAL(LutSampleValuesMasterRequested()),
+        connect( lutBox(), SIGNAL(LutSampleValuesMasterRequested()),
                  dev->GetLutItf(), SLOT(onLutSampleValuesMasterRequest()) );
 
-        connect( dev->GetLutItf(), SIGNAL(LutFastGammaChanged(int)), m_ui->lutBox, SLOT(onLutFastGammaChange(int)) );
-        connect( m_ui->lutBox, SIGNAL(LutFastGammaChanged(int)), dev->GetLutItf(), SLOT(onLutFastGammaChange(int)) );
+        connect( lutBox(), SIGNAL(LutPresetSampleValuesRequested(int)),
+                 dev->GetLutItf(), SLOT(onLutPresetSampleValuesRequest(int)) );
+        m_updates.connect( dev->GetLutItf(), SIGNAL(LutPresetSampleValuesChanged(int,int,QVector<int>,QVector<int>)),
+                           lutBox(), SLOT(onLutPresetSampleValuesChange(int,int,QVector<int>,QVector<int>)), 2 );
+
+        // snapshot of the inactive chain
+        connect( this, SIGNAL(ChainSnapshotRequested(int)), dev->GetLutItf(), SLOT(onLutSnapshotRequest(int)) );
+        connect( dev->GetLutItf(), SIGNAL(LutSnapshotChanged(int,int,int,int,int)),
+                 lutBox(), SLOT(onLutSnapshotChange(int,int,int,int,int)) );
+        m_updates.connect( dev->GetLutItf(), SIGNAL(LutSnapshotSampleValuesChanged(int,int,int,QVector<int>,QVector<int>)),
+                           lutBox(), SLOT(onLutSnapshotSampleValuesChange(int,int,int,QVector<int>,QVector<int>)), 3 );
+
+        connect( dev->GetLutItf(), SIGNAL(LutFastGammaChanged(int)), lutBox(), SLOT(onLutFastGammaChange(int)) );
+        connect( lutBox(), SIGNAL(LutFastGammaChanged(int)), dev->GetLutItf(), SLOT(onLutFastGammaChange(int)) );
     }
 
     //////////////////////////
@@ -1051,14 +1244,14 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
             connect( m_ui->dpccBox, SIGNAL(DpccRestoreTableFromFlash()), dev->GetDpccItf(), SLOT(onDpccLoadTable()) );
 
             // position table
-            connect( dev->GetDpccItf(), SIGNAL(DpccTableChanged(QVector<int>,QVector<int>)), m_ui->dpccBox, SLOT(onDpccTableFromCameraLoaded(QVector<int>,QVector<int>)) );
+            m_updates.connect( dev->GetDpccItf(), SIGNAL(DpccTableChanged(QVector<int>,QVector<int>)), m_ui->dpccBox, SLOT(onDpccTableFromCameraLoaded(QVector<int>,QVector<int>)) );
             connect( m_ui->dpccBox, SIGNAL(DpccLoadTableFromRam()), dev->GetDpccItf(), SLOT(onDpccGetTable()) );
             connect( m_ui->dpccBox, SIGNAL(DpccWriteTableToRam(QVector<int>&,QVector<int>&)), dev->GetDpccItf(), SLOT(onDpccSetTable(QVector<int>&,QVector<int>&)) );
         }
 
         // video mode
         connect( dev->GetChainItf(), SIGNAL(ChainVideoModeChanged(int)), m_ui->dpccBox, SLOT(onDpccVideoModeChanged(int)) );
-        connect( m_ui->inoutBox, SIGNAL(ChainVideoModeChanged(int)), m_ui->dpccBox, SLOT(onDpccVideoModeChanged(int)) );
+        connect( inoutBox(), SIGNAL(ChainVideoModeChanged(int)), m_ui->dpccBox, SLOT(onDpccVideoModeChanged(int)) );
     }
 
     //////////////////////////
@@ -1067,12 +1260,76 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     if (deviceFeatures.hasIspConversion)
     {
         // conversion matrix
-        connect( dev->GetIspItf(), SIGNAL(ColorConversionMatrixChanged(int,int,int,int,int,int,int,int,int)),
-                 m_ui->outBox, SLOT(onColorConversionMatrixChange(int,int,int,int,int,int,int,int,int)) );
+        m_updates.connect( dev->GetIspItf(), SIGNAL(ColorConversionMatrixChanged(int,int,int,int,int,int,int,int,int)),
+                           m_ui->outBox, SLOT(onColorConversionMatrixChange(int,int,int,int,int,int,int,int,int)) );
         connect( m_ui->outBox, SIGNAL(ColorConversionMatrixChanged(int,int,int,int,int,int,int,int,int)),
                  dev->GetIspItf(), SLOT(onColorConversionMatrixChange(int,int,int,int,int,int,int,int,int)) );
-        connect( m_ui->inoutBox, SIGNAL(ColorConversionMatrixRequested()),
+        connect( inoutBox(), SIGNAL(ColorConversionMatrixRequested()),
                  dev->GetIspItf(), SLOT(onColorConversionMatrixRequested()) );
+
+        // snapshot of the inactive chain
+        connect( this, SIGNAL(ChainSnapshotRequested(int)), dev->GetIspItf(), SLOT(onColorConversionMatrixSnapshotRequest(int)) );
+        connect( dev->GetIspItf(), SIGNAL(ColorConversionMatrixSnapshotChanged(int,int,int,int,int,int,int,int,int,int)),
+                 m_ui->outBox, SLOT(onColorConversionMatrixSnapshotChange(int,int,int,int,int,int,int,int,int,int)) );
+    }
+
+    //////////////////////////
+    // 3D LUT export
+    //////////////////////////
+    if (deviceFeatures.hasLutItf)
+    {
+        // the export follows the device and the widgets, set commands are not echoed
+        CubeExport * cube = lutBox()->cubeExport();
+        static_cast<PipelinePreview *>(m_PreviewDock->widget())->setSource( cube );
+
+        m_updates.connect( dev->GetIspItf(), SIGNAL(ColorCorrectionChanged(int,int,int,int,int,int,int,int,int,int,int,int)),
+                           cube, SLOT(onColorCorrectionChange(int,int,int,int,int,int,int,int,int,int,int,int)) );
+
+        if (deviceFeatures.hasIspGain)
+        {
+            connect( dev->GetIspItf(), SIGNAL(RedGainChanged(int)), cube, SLOT(onRedGainChange(int)) );
+            connect( dev->GetIspItf(), SIGNAL(GreenGainChanged(int)), cube, SLOT(onGreenGainChange(int)) );
+            connect( dev->GetIspItf(), SIGNAL(BlueGainChanged(int)), cube, SLOT(onBlueGainChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(RedGainChanged(int)), cube, SLOT(onRedGainChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(GreenGainChanged(int)), cube, SLOT(onGreenGainChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(BlueGainChanged(int)), cube, SLOT(onBlueGainChange(int)) );
+        }
+
+        if (deviceFeatures.hasIspConversion)
+        {
+            m_updates.connect( dev->GetIspItf(), SIGNAL(ColorConversionMatrixChanged(int,int,int,int,int,int,int,int,int)),
+                               cube, SLOT(onColorConversionMatrixChange(int,int,int,int,int,int,int,int,int)) );
+            connect( m_ui->outBox, SIGNAL(ColorConversionMatrixChanged(int,int,int,int,int,int,int,int,int)),
+                     cube, SLOT(onColorConversionMatrixChange(int,int,int,int,int,int,int,int,int)) );
+        }
+
+        if (deviceFeatures.hasKneeItf)
+        {
+            m_updates.connect( dev->GetKneeItf(), SIGNAL(KneeConfigChanged(int,int,int,int)), cube, SLOT(onKneeConfigChange(int,int,int,int)) );
+            connect( kneeBox(), SIGNAL(KneeConfigChanged(int,int,int,int)), cube, SLOT(onKneeConfigChange(int,int,int,int)) );
+        }
+
+        if (deviceFeatures.hasMccItf)
+        {
+            connect( dev->GetMccItf(), SIGNAL(MccEnableChanged(int)), cube, SLOT(onMccEnableChange(int)) );
+            connect( dev->GetMccItf(), SIGNAL(MccOperationModeChanged(int,int)), cube, SLOT(onMccOperationModeChange(int,int)) );
+            m_updates.connect( dev->GetMccItf(), SIGNAL(MccPhaseChanged(int,int,int)), cube, SLOT(onMccPhaseChange(int,int,int)), 1 );
+            connect( m_ui->mccEqBox, SIGNAL(MccEnableChanged(int)), cube, SLOT(onMccEnableChange(int)) );
+            connect( m_ui->mccEqBox, SIGNAL(MccOperationModeChanged(int,int)), cube, SLOT(onMccOperationModeChange(int,int)) );
+            connect( m_ui->mccEqBox, SIGNAL(MccPhaseChanged(int,int,int)), cube, SLOT(onMccPhaseChange(int,int,int)) );
+        }
+
+        if (deviceFeatures.hasCprocItf)
+        {
+            connect( dev->GetCprocItf(), SIGNAL(BrightnessChanged(int)), cube, SLOT(onBrightnessChange(int)) );
+            connect( dev->GetCprocItf(), SIGNAL(ContrastChanged(int)), cube, SLOT(onContrastChange(int)) );
+            connect( dev->GetCprocItf(), SIGNAL(SaturationChanged(int)), cube, SLOT(onSaturationChange(int)) );
+            connect( dev->GetCprocItf(), SIGNAL(HueChanged(int)), cube, SLOT(onHueChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(BrightnessChanged(int)), cube, SLOT(onBrightnessChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(ContrastChanged(int)), cube, SLOT(onContrastChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(SaturationChanged(int)), cube, SLOT(onSaturationChange(int)) );
+            connect( m_ui->wbBox, SIGNAL(HueChanged(int)), cube, SLOT(onHueChange(int)) );
+        }
     }
 
     if ( deviceFeatures.hasChainSdiSettings || deviceFeatures.hasChainHdmiSettings )
@@ -1088,6 +1345,9 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         // sdi white
         connect( dev->GetChainItf(), SIGNAL(ChainSdiWhiteLevelChanged(int)), m_ui->outBox, SLOT(onSdiWhiteChange(int)) );
         connect( m_ui->outBox, SIGNAL(SdiWhiteChanged(int)), dev->GetChainItf(), SLOT(onChainSdiWhiteLevelChange(int)) );
+
+        // snapshot of the inactive chain
+        connect( dev->GetChainItf(), SIGNAL(ChainSdiSnapshotChanged(int,int,int,int)), m_ui->outBox, SLOT(onSdiSnapshotChange(int,int,int,int)) );
     }
 
     if ( deviceFeatures.hasChainRawMode )
@@ -1095,6 +1355,9 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         // raw mode
         connect( dev->GetChainItf(), SIGNAL(ChainRawModeChanged(int)), m_ui->outBox, SLOT(onRawModeChange(int)) );
         connect( m_ui->outBox, SIGNAL(RawModeChanged(int)), dev->GetChainItf(), SLOT(onChainRawModeChange(int)) );
+
+        // snapshot of the inactive chain
+        connect( dev->GetChainItf(), SIGNAL(ChainRawModeSnapshotChanged(int,int)), m_ui->outBox, SLOT(onRawModeSnapshotChange(int,int)) );
     }
 
     //////////////////////////
@@ -1171,9 +1434,13 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
         // chain selection
         connect( dev->GetChainItf(), SIGNAL(ChainSelectedChainChanged(int)), this, SLOT(onSdiOutChange(int)) );
         connect( this, SIGNAL(SdiOutChanged(int)), dev->GetChainItf(), SLOT(onChainSelectedChainChange(int)) );
+        connect( this, SIGNAL(ChainSnapshotRequested(int)), dev->GetChainItf(), SLOT(onChainOutputSnapshotRequest(int)) );
 
         // the lut box and out box also need to know the current chain, because each chain has its own lut / out settings
-        connect( dev->GetChainItf(), SIGNAL(ChainSelectedChainChanged(int)), m_ui->lutBox, SLOT(onSdiOutChange(int)) );
+        if (deviceFeatures.hasLutItf)
+        {
+            connect( dev->GetChainItf(), SIGNAL(ChainSelectedChainChanged(int)), lutBox(), SLOT(onSdiOutChange(int)) );
+        }
         connect( dev->GetChainItf(), SIGNAL(ChainSelectedChainChanged(int)), m_ui->outBox, SLOT(onSdiOutChange(int)) );
     }
     if (deviceFeatures.hasIspSplitScreen)
@@ -1238,18 +1505,255 @@ void MainWindow::connectToDevice( ProVideoDevice * dev )
     //////////////////////////
     // Synchronize with the new device
     //////////////////////////
-    m_dev->resync();
+    /* Only the system settings, the chain selection and the settings of the
+     * current tab are read before the window is usable. The other tabs are
+     * synchronized when they are shown first, or in the background in tab
+     * order. */
+    m_dev->resyncSystem();
+
+    /* The responses of the last full synchronization of this device and
+     * firmware are cached on disk. If there is a cache, all widgets are
+     * filled from it at once and the settings dump of the device tells
+     * whether the cached values are still current. If they are not, all
+     * subsystems are read again in the background, which also refreshes
+     * the cache. */
+    bool cached = false;
+    if ( !m_dev->getDeviceId().isEmpty() )
+    {
+        m_cacheFile = ComCache::fileName( m_dev->getDeviceId(), m_dev->getDeviceVersion() );
+        cached = m_cache.load( m_cacheFile );
+        m_dev->getComChannel()->setCache( &m_cache );
+    }
+
+    if ( cached )
+    {
+        m_cache.setReplay( true );
+        for ( int i = ProVideoDevice::SubsystemIsp; i < ProVideoDevice::SubsystemMax; i++ )
+        {
+            m_dev->resyncSubsystem( static_cast<ProVideoDevice::Subsystem>(i) );
+        }
+        m_cache.setReplay( false );
 
-    // Start the check connection timer, check if device is still connected every 2 seconds
+        QByteArray fingerprint = m_dev->GetProVideoSystemItf()->GetSettingsFingerprint();
+        if ( fingerprint.isEmpty() || (fingerprint != m_cache.fingerprint()) )
+        {
+            // the background pass refreshes the cache of these settings
+            m_cache.setFingerprint( fingerprint );
+            queueResync();
+        }
+    }
+    else
+    {
+        // the settings dump for the cache is read after the shown tab,
+        // as the first step of the background pass
+        m_fingerprintPending = !m_cacheFile.isEmpty();
+        queueResync();
+        resyncSubsystems( QList<ProVideoDevice::Subsystem>() << ProVideoDevice::SubsystemChain );
+        resyncSubsystems( tabSubsystems( m_ui->tabWidget->currentWidget() ) );
+    }
+
+    qDebug() << "device interactive after" << m_connectTime.elapsed() << "ms,"
+             << (cached ? "filled from cache," : "")
+             << m_resyncPending.length() << "subsystems left to synchronize,"
+             << m_updates.delivered() << "widget updates delivered,"
+             << m_updates.coalesced() << "coalesced";
+
+    if ( !m_resyncPending.isEmpty() )
+    {
+        m_resyncTimer.start( RESYNC_BACKGROUND_INTERVAL );
+    }
+
+    // Start the check connection timer
     if ( m_EnableConnectionCheck )
     {
-        m_checkConnectionTimer.start( 2000 );
+        startConnectionCheck();
     }
 
     // Close message box
     infoDlg.close();
 }
 
+/******************************************************************************
+ * MainWindow::tabSubsystems
+ *****************************************************************************/
+QList<ProVideoDevice::Subsystem> MainWindow::tabSubsystems( QWidget * page ) const
+{
+    QList<ProVideoDevice::Subsystem> subsystems;
+
+    // Subsystems whose signals are connected to the widget of a tab page
+    if ( page == m_ui->tabInOut )
+    {
+        subsystems << ProVideoDevice::SubsystemCam << ProVideoDevice::SubsystemIsp
+                   << ProVideoDevice::SubsystemAuto << ProVideoDevice::SubsystemChain
+                   << ProVideoDevice::SubsystemLut << ProVideoDevice::SubsystemROI;
+    }
+    else if ( page == m_ui->lensDriverBox )
+    {
+        subsystems << ProVideoDevice::SubsystemLens;
+    }
+    else if ( (page == m_ui->tabBlack) || (page == m_ui->tabFlt) )
+    {
+        subsystems << ProVideoDevice::SubsystemIsp;
+    }
+    else if ( page == m_ui->tabWb )
+    {
+        subsystems << ProVideoDevice::SubsystemIsp << ProVideoDevice::SubsystemCproc
+                   << ProVideoDevice::SubsystemAuto;
+    }
+    else if ( page == m_ui->tabMcc )
+    {
+        subsystems << ProVideoDevice::SubsystemMcc;
+    }
+    else if ( page == m_ui->tabKnee )
+    {
+        subsystems << ProVideoDevice::SubsystemKnee;
+    }
+    else if ( page == m_ui->tabGamma )
+    {
+        subsystems << ProVideoDevice::SubsystemLut << ProVideoDevice::SubsystemChain;
+    }
+    else if ( page == m_ui->tabROI )
+    {
+        subsystems << ProVideoDevice::SubsystemROI;
+    }
+    else if ( page == m_ui->tabDpcc )
+    {
+        subsystems << ProVideoDevice::SubsystemDpcc << ProVideoDevice::SubsystemChain;
+    }
+    else if ( page == m_ui->tabOut )
+    {
+        subsystems << ProVideoDevice::SubsystemIsp << ProVideoDevice::SubsystemChain;
+    }
+
+    // info and update tab only show system settings, which are always synchronized
+    return ( subsystems );
+}
+
+/******************************************************************************
+ * MainWindow::queueResync
+ *****************************************************************************/
+void MainWindow::queueResync()
+{
+    // Subsystems of the tabs in tab order
+    for ( int i = 0; i < m_ui->tabWidget->count(); i++ )
+    {
+        foreach ( ProVideoDevice::Subsystem s, tabSubsystems( m_ui->tabWidget->widget( i ) ) )
+        {
+            if ( !m_resyncPending.contains( s ) )
+            {
+                m_resyncPending.append( s );
+            }
+        }
+    }
+
+    // Settings which are not shown in a tab are kept up to date as before
+    for ( int i = ProVideoDevice::SubsystemIsp; i < ProVideoDevice::SubsystemMax; i++ )
+    {
+        ProVideoDevice::Subsystem s = static_cast<ProVideoDevice::Subsystem>(i);
+        if ( !m_resyncPending.contains( s ) )
+        {
+            m_resyncPending.append( s );
+        }
+    }
+}
+
+/******************************************************************************
+ * MainWindow::resyncSubsystems
+ *****************************************************************************/
+void MainWindow::resyncSubsystems( const QList<ProVideoDevice::Subsystem> & subsystems )
+{
+    foreach ( ProVideoDevice::Subsystem s, subsystems )
+    {
+        if ( m_resyncPending.removeAll( s ) )
+        {
+            m_dev->resyncSubsystem( s );
+        }
+    }
+}
+
+/******************************************************************************
+ * MainWindow::completeResync
+ *****************************************************************************/
+void MainWindow::completeResync()
+{
+    // Saving or applying all settings needs the values of every tab
+    m_resyncTimer.stop();
+    if ( m_resyncPending.isEmpty() )
+    {
+        return;
+    }
+
+    if ( m_fingerprintPending )
+    {
+        takeFingerprint();
+    }
+
+    while ( !m_resyncPending.isEmpty() )
+    {
+        m_dev->resyncSubsystem( m_resyncPending.takeFirst() );
+    }
+
+    // The widgets have to show the values just read
+    m_updates.flush();
+
+    saveCache();
+}
+
+/******************************************************************************
+ * MainWindow::resyncAll
+ *****************************************************************************/
+void MainWindow::resyncAll()
+{
+    m_resyncTimer.stop();
+    m_resyncPending.clear();
+
+    takeFingerprint();
+
+    m_dev->resync();
+
+    // The widgets have to show the values just read
+    m_updates.flush();
+
+    qDebug() << "resync:" << m_updates.delivered() << "widget updates delivered,"
+             << m_updates.coalesced() << "coalesced";
+
+    saveCache();
+}
+
+/******************************************************************************
+ * MainWindow::takeFingerprint
+ *****************************************************************************/
+void MainWindow::takeFingerprint()
+{
+    m_fingerprintPending = false;
+
+    if ( !m_cacheFile.isEmpty() )
+    {
+        m_cache.setFingerprint( m_dev->GetProVideoSystemItf()->GetSettingsFingerprint() );
+    }
+}
+
+/******************************************************************************
+ * MainWindow::saveCache
+ *****************************************************************************/
+void MainWindow::saveCache()
+{
+    if ( m_cacheFile.isEmpty() )
+    {
+        return;
+    }
+
+    /* The fingerprint was taken when the pass which filled the cache
+     * started (on a cold connect right after the shown tab was read). A
+     * setting changed since then makes the device differ from it, so the
+     * next connect reads the device again instead of trusting entries a
+     * set command may have left behind. */
+    if ( !m_cache.save( m_cacheFile ) )
+    {
+        qWarning() << "could not save response cache to" << m_cacheFile;
+    }
+}
+
 /******************************************************************************
  * MainWindow::onResolutionMaskChange
  *****************************************************************************/
@@ -1257,8 +1761,8 @@ void MainWindow::onResolutionMaskChange( uint32_t id0, uint32_t id1, uint32_t id
 {
     bool supported = false;
 
-    m_ui->inoutBox->clearAllVideoModes();
-    m_ui->inoutBox->clearAllGenlockCrosslockVideoModes();
+    inoutBox()->clearAllVideoModes();
+    inoutBox()->clearAllGenlockCrosslockVideoModes();
 
     // fill video-mode and genlock crosslock vmode combo boxes
     for ( int i=VideoModeFirst; i<VideoModeMax; i++ )
@@ -1280,7 +1784,7 @@ void MainWindow::onResolutionMaskChange( uint32_t id0, uint32_t id1, uint32_t id
 
         if ( supported )
         {
-            m_ui->inoutBox->addVideoMode( GetVideoModeName( static_cast<VideoMode>(i) ), i );
+            inoutBox()->addVideoMode( GetVideoModeName( static_cast<VideoMode>(i) ), i );
 
 
         }
@@ -1289,7 +1793,7 @@ void MainWindow::onResolutionMaskChange( uint32_t id0, uint32_t id1, uint32_t id
     {
         QString name = GetGenlockCrosslockVmodeName( static_cast<GenlockCrosslockVmode>(i) );
         if(!name.isEmpty())
-            m_ui->inoutBox->addGenlockCrosslockVideoMode( GetGenlockCrosslockVmodeName( static_cast<GenlockCrosslockVmode>(i) ), i);
+            inoutBox()->addGenlockCrosslockVideoMode( GetGenlockCrosslockVmodeName( static_cast<GenlockCrosslockVmode>(i) ), i);
     }
 }
 
@@ -1318,8 +1822,9 @@ void MainWindow::onLockCurrentTabPage( bool lock )
  *****************************************************************************/
 void MainWindow::onBootIntoUpdateMode()
 {
-    // When booting into update mode, stop the reconnect timer
+    // When booting into update mode, stop the connection check and reconnect timers
     m_checkConnectionTimer.stop();
+    m_reconnectTimer.stop();
 }
 
 /******************************************************************************
@@ -1332,7 +1837,7 @@ void MainWindow::onReopenSerialConnection()
      * restarted, if it is enabled in the settings. */
     if ( m_EnableConnectionCheck )
     {
-        m_checkConnectionTimer.start( 2000 );
+        startConnectionCheck();
     }
 }
 
@@ -1357,42 +1862,139 @@ void MainWindow::onResizeMainWindow( bool force )
     }
 }
 
+/******************************************************************************
+ * MainWindow::startConnectionCheck
+ *****************************************************************************/
+void MainWindow::startConnectionCheck()
+{
+    // Count from now, the responses seen so far are known
+    m_connectionResponses = ctrl_channel_get_response_count( m_dev->getComChannel()->GetInstance() );
+    m_connectionIdleTimer.start();
+    m_reconnectTimer.stop();
+    setWindowTitle( m_WindowTitle );
+
+    m_checkConnectionTimer.start( CONNECTION_CHECK_INTERVAL );
+}
+
 /******************************************************************************
  * MainWindow::onCheckConnection
  *****************************************************************************/
 void MainWindow::onCheckConnection()
 {
-    if ( m_ConnectDlg && !m_ConnectDlg->isConnected() )
+    if ( !m_dev || !m_ConnectDlg )
+    {
+        return;
+    }
+
+    /* The link is alive as long as the device answers the commands the GUI
+     * sends anyway, so checking it is only a look at the response counter of
+     * the channel. */
+    uint32_t responses = ctrl_channel_get_response_count( m_dev->getComChannel()->GetInstance() );
+    if ( responses != m_connectionResponses )
+    {
+        m_connectionResponses = responses;
+        m_connectionIdleTimer.start();
+        return;
+    }
+
+    // Send a keepalive only if the link has been idle for a while
+    if ( (m_connectionIdleTimer.elapsed() < m_ConnectionIdleTime) ||
+         m_ConnectDlg->isVisible() || m_SettingsDlg->isVisible() )
+    {
+        return;
+    }
+
+    if ( m_ConnectDlg->isConnected() )
     {
-        if ( !m_ConnectDlg->isVisible() && !m_SettingsDlg->isVisible() )
+        m_connectionResponses = ctrl_channel_get_response_count( m_dev->getComChannel()->GetInstance() );
+        m_connectionIdleTimer.start();
+        return;
+    }
+
+    // Connection to device lost, reconnect in the background
+    qWarning() << "connection to device lost, trying to reconnect";
+
+    m_checkConnectionTimer.stop();
+    m_reconnectDelay = RECONNECT_DELAY_MIN;
+    m_reconnectTimer.start( m_reconnectDelay );
+
+    setWindowTitle( m_WindowTitle + " - connection lost, reconnecting..." );
+}
+
+/******************************************************************************
+ * MainWindow::onReconnect
+ *****************************************************************************/
+void MainWindow::onReconnect()
+{
+    // The user is connecting manually, wait until the dialogs are closed
+    if ( !m_ConnectDlg->isVisible() && !m_SettingsDlg->isVisible() )
+    {
+        ComChannel * channel = m_dev->getComChannel();
+
+        // Reopen the port, it may have vanished (e.g. USB adapter unplugged)
+        if ( channel->isOpen() )
         {
-            // Connection to device lost, stop check connection timer
-            m_checkConnectionTimer.stop();
+            channel->Close();
+        }
+        channel->ReOpen();
 
-            // Ask user if he wants to reconnect
-            QMessageBox msgBox;
-            msgBox.setWindowTitle( "Connection lost" );
-            msgBox.setText( "The connection to the device has been lost. Maybe the device is turned off or "
-                            "its serial port settings got changed.");
-            msgBox.setInformativeText( "Do you want to open the Connect Dialog now?\n\n"
-                                       "If you want to disable the device connection check, click the 'Ignore' button. "
-                                       "You can later enable it again in the Settings Dialog." );
-            msgBox.setStandardButtons( QMessageBox::Yes | QMessageBox::No | QMessageBox::Ignore );
-            msgBox.setDefaultButton( QMessageBox::Yes );
-            int ret = msgBox.exec();
+        if ( m_ConnectDlg->isConnected() )
+        {
+            qDebug() << "reconnected to device";
 
-            if ( ret == QMessageBox::Yes )
-            {
-                // Call on connect clicked to reconnect
-                onConnectClicked();
-            }
-            else if ( ret == QMessageBox::Ignore )
-            {
-                // Disable connection check, also uncheck it in the settings dialog
-                onConnectionCheckChange( false );
-                m_SettingsDlg->setConnectionCheckChecked( false );
-            }
+            // The device may have been power cycled, get the current settings
+            resyncAll();
+
+            startConnectionCheck();
+            return;
         }
+
+        // Exponential backoff, the device may take a while to boot
+        m_reconnectDelay = qMin( m_reconnectDelay * 2, RECONNECT_DELAY_MAX );
+    }
+
+    m_reconnectTimer.start( m_reconnectDelay );
+}
+
+/******************************************************************************
+ * MainWindow::onTabChange
+ *****************************************************************************/
+void MainWindow::onTabChange( int index )
+{
+    if ( m_dev && !m_resyncPending.isEmpty() )
+    {
+        resyncSubsystems( tabSubsystems( m_ui->tabWidget->widget( index ) ) );
+    }
+}
+
+/******************************************************************************
+ * MainWindow::onResyncPending
+ *****************************************************************************/
+void MainWindow::onResyncPending()
+{
+    if ( !m_dev || m_resyncPending.isEmpty() )
+    {
+        return;
+    }
+
+    // the settings dump takes a tick of its own
+    if ( m_fingerprintPending )
+    {
+        takeFingerprint();
+        m_resyncTimer.start( RESYNC_BACKGROUND_INTERVAL );
+        return;
+    }
+
+    m_dev->resyncSubsystem( m_resyncPending.takeFirst() );
+
+    if ( m_resyncPending.isEmpty() )
+    {
+        qDebug() << "device synchronized after" << m_connectTime.elapsed() << "ms";
+        saveCache();
+    }
+    else
+    {
+        m_resyncTimer.start( RESYNC_BACKGROUND_INTERVAL );
     }
 }
 
@@ -1463,11 +2065,11 @@ void MainWindow::setDebugTerminal( DebugTerminal * dlg )
     if ( m_DebugTerminal )
     {
         // Connect debug terminal with RS232 channel
-        connect( m_ConnectDlg->getChannelRS232(), SIGNAL(dataReceived(QString)), m_DebugTerminal, SLOT(onDataReceived(QString)) );
+        m_ConnectDlg->getChannelRS232()->setLog( m_DebugTerminal->getLog() );
         connect( m_DebugTerminal, SIGNAL(sendData(QString, int)), m_ConnectDlg->getChannelRS232(), SLOT(onSendData(QString, int)) );
 
         // Connect debug terminal with RS485 channel
-        connect( m_ConnectDlg->getChannelRS485(), SIGNAL(dataReceived(QString)), m_DebugTerminal, SLOT(onDataReceived(QString)) );
+        m_ConnectDlg->getChannelRS485()->setLog( m_DebugTerminal->getLog() );
         connect( m_DebugTerminal, SIGNAL(sendData(QString, int)), m_ConnectDlg->getChannelRS485(), SLOT(onSendData(QString, int)) );
 
         // Setup the Debug Terminal as a dock widget
@@ -1671,7 +2273,7 @@ void MainWindow::onLoadSettingsClicked()
     {
         QApplication::setOverrideCursor( Qt::WaitCursor );
         emit LoadSettings(m_bUserSetComboBox ? m_userSetComboBox->currentIndex() : 0);
-        m_dev->resync();
+        resyncAll();
         QApplication::setOverrideCursor( Qt::ArrowCursor );
     }
 }
@@ -1743,7 +2345,7 @@ void MainWindow::onLoadFromFileClicked2()
     m_filename = dialog.getOpenFileName(
         this, tr("Load Device Settings"),
         directory,
-        "Setting Files (*.dct);;All files (*.*)"
+        "Setting Files (*.dct);;Binary Profiles (*.dctp);;All files (*.*)"
     );
 
     if ( nullptr != m_filename )
@@ -1757,8 +2359,8 @@ void MainWindow::onLoadFromFileClicked2()
         if ( fileExists(m_filename) )
         {
 
-            // Open settings
-            QSettings settings( m_filename, QSettings::IniFormat );
+            // Open settings (INI or binary profile)
+            QSettings settings( m_filename, profileFormatOf( m_filename ) );
 
             // Load the device name and platform from the settings file
             settings.beginGroup( MAIN_SETTINGS_SECTION_NAME );
@@ -1778,23 +2380,8 @@ void MainWindow::onLoadFromFileClicked2()
             else
             {
                 // Load the settings of all visible tabs
-                // Get number of tabs which settinsg have to be loaded
-                int progressSteps = m_activeWidgets.length();
-                if ( m_dev->getSupportedFeatures().hasChainSelection )
-                {
-                    // Settings for the lutbox and outbox have to be loaded twice (once for each chain)
-                    if ( m_activeWidgets.contains(m_ui->lutBox) )
-                    {
-                        progressSteps++;
-                    }
-                    if ( m_activeWidgets.contains(m_ui->outBox) )
-                    {
-                        progressSteps++;
-                    }
-                }
-
                 // Create progress dialog
-                QProgressDialog progressDialog( "Loading Settings...", "", 0, progressSteps, this );
+                QProgressDialog progressDialog( "Loading Settings...", "", 0, 0, this );
                 progressDialog.setCancelButton( nullptr );
                 progressDialog.setWindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint);
                 progressDialog.show();
@@ -1807,61 +2394,14 @@ void MainWindow::onLoadFromFileClicked2()
                 // Disable updpates of the GUI
                 this->setUpdatesEnabled( false );
 
-                // Load settings for all widgets for the currently active chain
-                int i;
-                for ( i = 0; i < m_activeWidgets.length(); i++ )
-                {
-                    progressDialog.setValue( i );
-                    QApplication::processEvents();
-                    m_activeWidgets[i]->load( settings );
-                }
-
-                // If this device has a second chain, load settings for it too
-                if ( m_dev->getSupportedFeatures().hasChainSelection )
-                {
-                    // Check which chain is currently used and switch to the other one
-                    if ( m_ui->actionSelectSdi1->isChecked() )
-                    {
-                        emit SdiOutChanged( 2 );
-                    }
-                    else
-                    {
-                        emit SdiOutChanged( 1 );
-                    }
-
-                    // Load lutbox settings for other chain
-                    if ( m_activeWidgets.contains(m_ui->lutBox) )
-                    {
-                        progressDialog.setValue( i );
-                        i++;
-                        QApplication::processEvents();
-                        m_ui->lutBox->load( settings );
-                    }
-
-                    // Load outbox settings for other chain
-                    if ( m_activeWidgets.contains(m_ui->outBox) )
-                    {
-                        progressDialog.setValue( i );
-                        QApplication::processEvents();
-                        m_ui->outBox->load( settings );
-                    }
-
-                    // Return to previous chain
-                    if ( m_ui->actionSelectSdi1->isChecked() )
-                    {
-                        emit SdiOutChanged( 1 );
-                    }
-                    else
-                    {
-                        emit SdiOutChanged( 2 );
-                    }
-                }
+                // Load settings for all widgets of both chains
+                applyScheduled( progressDialog, [&settings]( DctWidgetBox * box ) { box->load( settings ); } );
 
                 // Resync settings
-                m_dev->resync();
+                resyncAll();
 
                 // Set dialog to 100%
-                progressDialog.setValue( progressSteps );
+                progressDialog.setValue( progressDialog.maximum() );
                 QApplication::processEvents();
 
                 // Re-enable updpates of the GUI
@@ -1881,7 +2421,7 @@ void MainWindow::onLoadFromFileClicked()
     QFileDialog dialog( this );
     dialog.setDefaultSuffix( "kyscp" );
     m_filename = dialog.getOpenFileName( this, tr("Load Device Settings"),
-                 directory, "Setting Files (*.kyscp);;All files (*.*)" );
+                 directory, "Setting Files (*.kyscp);;Binary Profiles (*.dctp);;All files (*.*)" );
 
     if ( nullptr != m_filename )
     {
@@ -1891,11 +2431,11 @@ void MainWindow::onLoadFromFileClicked()
             m_filename += ".kyscp";
         }
 
+        // command dump or binary profile holding a command dump
+        QStringList commands;
         if ( fileExists(m_filename) )
         {
-            QFile file( m_filename );
-
-            if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            if ( !loadCommands( m_filename, commands ) )
             {
                 QMessageBox::warning( this,
                                       "Can not open file for reading.",
@@ -1918,20 +2458,10 @@ void MainWindow::onLoadFromFileClicked()
                 // Disable updpates of the GUI
                 this->setUpdatesEnabled( false );
 
-                QString settings;
-                QTextStream stream(&file);
-                settings.append(stream.readAll());
-
-                int rem_index = settings.lastIndexOf("=");
-                settings.remove(0, rem_index + 3);
-
                 progressDialog.setValue( 20 );
 
-                while( !settings.isEmpty() )
+                foreach ( const QString & command, commands )
                 {
-                    int index =  settings.indexOf(QRegExp("\n"), 0);
-                    QString command = settings.left(index);
-
                     // Load settings
                     m_dev->GetProVideoSystemItf()->LoadSavedSettingsFromFile(command);
 
@@ -1941,17 +2471,12 @@ void MainWindow::onLoadFromFileClicked()
                         m_dev->GetLutItf()->LutResetMasterSettingsMode();
                         QThread::msleep( 100 );
                     }
-
-                    // Remove sent command
-                    settings.remove(0, index + 1);
                 }
 
                 progressDialog.setValue( 50 );
 
-                file.close();
-
                 // Resync settings
-                m_dev->resync();
+                resyncAll();
 
                 // Set dialog to 100%
                 progressDialog.setValue( 100 );
@@ -1983,29 +2508,65 @@ void MainWindow::onSaveToFileClicked2()
     m_filename = dialog.getSaveFileName(
         this, tr("Save Device Settings"),
         directory,
-        "Setting Files (*.dct);;All files (*.*)"
+        "Setting Files (*.dct);;Binary Profiles (*.dctp);;All files (*.*)"
     );
     QApplication::processEvents();
 
     QApplication::setOverrideCursor( Qt::WaitCursor );
     if ( nullptr != m_filename )
     {
+        int active = m_ui->actionSelectSdi1->isChecked() ? 1 : 2;
+        int other  = (active == 1) ? 2 : 1;
+
+        // The device can only address the other chain through the output
+        // selection, so reading it switches the output for a moment
+        bool saveOther = false;
+        if ( m_dev->getSupportedFeatures().hasChainSelection &&
+             (m_activeWidgets.contains(m_lutBox) || m_activeWidgets.contains(m_ui->outBox)) )
+        {
+            QApplication::setOverrideCursor( Qt::ArrowCursor );
+            QMessageBox msgBox( this );
+            msgBox.setWindowTitle( tr("Save Device Settings") );
+            msgBox.setIcon( QMessageBox::Question );
+            msgBox.setText( tr("The LUT and output settings of SDI %1 can only be read by switching "
+                               "the output to SDI %1. The output shows SDI %1 briefly while it is read.\n\n"
+                               "Save the settings of both chains?").arg( other ) );
+            QPushButton * both       = msgBox.addButton( tr("Both Chains"), QMessageBox::AcceptRole );
+            QPushButton * activeOnly = msgBox.addButton( tr("SDI %1 Only").arg( active ), QMessageBox::AcceptRole );
+            msgBox.addButton( QMessageBox::Cancel );
+            msgBox.setDefaultButton( both );
+            msgBox.exec();
+
+            if ( msgBox.clickedButton() == both )
+            {
+                saveOther = true;
+            }
+            else if ( msgBox.clickedButton() != activeOnly )
+            {
+                return;
+            }
+            QApplication::setOverrideCursor( Qt::WaitCursor );
+        }
+
+        // Read the settings of tabs which are not synchronized yet
+        completeResync();
+
         QFileInfo file( m_filename );
         if ( file.suffix().isEmpty() )
         {
             m_filename += ".dct";
         }
 
-        // Open settings file and make sure it is clean
-        QSettings settings( m_filename, QSettings::IniFormat );
+        // Open settings file (INI or binary profile) and make sure it is clean
+        QSettings settings( m_filename, profileFormatOf( m_filename ) );
         settings.clear();
 
         // Get number of tabs which settinsg have to be saved
         int progressSteps = m_activeWidgets.length();
-        if ( m_dev->getSupportedFeatures().hasChainSelection )
+        if ( saveOther )
         {
             // Settings for the lutbox and outbox have to be saved twice (once for each chain)
-            if ( m_activeWidgets.contains(m_ui->lutBox) )
+            if ( m_activeWidgets.contains(m_lutBox) )
             {
                 progressSteps++;
             }
@@ -2015,8 +2576,14 @@ void MainWindow::onSaveToFileClicked2()
             }
         }
 
-        // Create progress dialog
-        QProgressDialog progressDialog( "Saving Settings...", "", 0, progressSteps, this );
+        // Create progress dialog, the device can only read the active LUT
+        // preset, so presets which are not cached yet are activated shortly
+        QString label = tr( "Saving Settings..." );
+        if ( m_activeWidgets.contains(m_lutBox) )
+        {
+            label += tr( "\nLUT presets not read yet are activated briefly on the output." );
+        }
+        QProgressDialog progressDialog( label, "", 0, progressSteps, this );
         progressDialog.setCancelButton( nullptr );
         progressDialog.setWindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint);
         progressDialog.show();
@@ -2044,28 +2611,22 @@ void MainWindow::onSaveToFileClicked2()
         }
 
         // If this device has a second chain, save settings for it too
-        if ( m_dev->getSupportedFeatures().hasChainSelection )
+        bool otherComplete = true;
+        if ( saveOther )
         {
-            // Check which chain is currently used and switch to the other one
-            if ( m_ui->actionSelectSdi1->isChecked() )
-            {
-                emit SdiOutChanged( 2 );
-            }
-            else
-            {
-                emit SdiOutChanged( 1 );
-            }
-
-            // Resync settings of this chain
-            m_dev->resyncChainSpecific();
+            // Address the other chain only for reading its settings, the
+            // widgets keep showing the active chain and need no resync
+            emit SdiOutChanged( other );
+            emit ChainSnapshotRequested( other );
+            emit SdiOutChanged( active );
 
             // Save lutbox settings for other chain
-            if ( m_activeWidgets.contains(m_ui->lutBox) )
+            if ( m_activeWidgets.contains(m_lutBox) )
             {
                 progressDialog.setValue( i );
                 i++;
                 QApplication::processEvents();
-                m_ui->lutBox->save( settings );
+                otherComplete &= lutBox()->saveSnapshot( settings, other );
             }
 
             // Save outbox settings for other chain
@@ -2073,19 +2634,8 @@ void MainWindow::onSaveToFileClicked2()
             {
                 progressDialog.setValue( i );
                 QApplication::processEvents();
-                m_ui->outBox->save( settings );
-            }
-
-            // Return to previous chain and resync
-            if ( m_ui->actionSelectSdi1->isChecked() )
-            {
-                emit SdiOutChanged( 1 );
+                otherComplete &= m_ui->outBox->saveSnapshot( settings, other );
             }
-            else
-            {
-                emit SdiOutChanged( 2 );
-            }
-            m_dev->resyncChainSpecific();
         }
 
         // Set dialog to 100%
@@ -2094,6 +2644,14 @@ void MainWindow::onSaveToFileClicked2()
 
         // Re-enable updpates of the GUI
         this->setUpdatesEnabled( true );
+
+        if ( !otherComplete )
+        {
+            QApplication::setOverrideCursor( Qt::ArrowCursor );
+            QMessageBox::warning( this, tr("Save Device Settings"),
+                tr("The settings of SDI %1 could not be read completely. The missing "
+                   "settings are not saved and keep their device values on load.").arg( other ) );
+        }
     }
     QApplication::setOverrideCursor( Qt::ArrowCursor );
 }
@@ -2117,7 +2675,7 @@ void MainWindow::onSaveToFileClicked()
     m_filename = dialog.getSaveFileName(
         this, tr("Save Device Settings"),
         directory,
-        "Setting Files (*.kyscp);;All files (*.*)"
+        "Setting Files (*.kyscp);;Binary Profiles (*.dctp);;All files (*.*)"
     );
 
     QApplication::processEvents();
@@ -2145,17 +2703,11 @@ void MainWindow::onSaveToFileClicked()
             m_filename += ".txt";
         }
 
-        QFile file( m_filename );
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        // header and command dump are streamed into the file, or for a
+        // binary profile into the command section of the settings
+        auto saveDump = [this]( QIODevice & dump ) -> bool
         {
-            QMessageBox::warning( this,
-                                  "Can not open file for writing.",
-                                  QString("The file %1 can not opened for writing. Do you have write access for the "
-                                          "selected folder?").arg(m_filename) );
-        }
-        else
-        {
-            QTextStream out(&file);
+            QTextStream out(&dump);
 
             //// Write the device name and platform into the settings file
             out << "Device Platform : " << m_dev->getSystemPlatform() << endl << endl;
@@ -2165,10 +2717,45 @@ void MainWindow::onSaveToFileClicked()
             out << "Schema Version : " << MAIN_SETTINGS_FILE_SCHEMA << endl << endl;
             out << "Date : " << QDate::currentDate().toString() << " " << QTime::currentTime().toString() << endl << endl;
             out << "===================================" << endl << endl;
+            out.flush();
 
-            m_dev->GetProVideoSystemItf()->GetSavedSettingsToFile(file);
+            return ( m_dev->GetProVideoSystemItf()->GetSavedSettingsToFile(dump) );
+        };
 
-            file.close();
+        // a failed device read is reported by the interface, the file is
+        // left untouched then
+        bool read    = true;
+        bool written = false;
+        if ( profileFormatOf( m_filename ) == profileFormat() )
+        {
+            QSettings settings( m_filename, profileFormat() );
+            CommandDumpWriter dump( settings );
+            dump.open( QIODevice::WriteOnly | QIODevice::Text );
+            read = saveDump( dump );
+            if ( read )
+            {
+                settings.clear();
+                dump.commit();
+                settings.sync();
+                written = ( settings.status() == QSettings::NoError );
+            }
+        }
+        else
+        {
+            QSaveFile file( m_filename );
+            if ( file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+            {
+                read    = saveDump( file );
+                written = read && file.commit();
+            }
+        }
+
+        if ( read && !written )
+        {
+            QMessageBox::warning( this,
+                                  "Can not open file for writing.",
+                                  QString("The file %1 can not opened for writing. Do you have write access for the "
+                                          "selected folder?").arg(m_filename) );
         }
     }
 
@@ -2219,51 +2806,34 @@ void MainWindow::onBroadcastClicked()
 }
 
 /******************************************************************************
- * MainWindow::onSyncSettingsClicked
+ * MainWindow::applyScheduled - runs op on all active widgets (and the chain
+ * specific ones of the second chain), the set commands they issue are merged
+ * and pipelined to the device, progress is the number of acknowledged commands
  *****************************************************************************/
-void MainWindow::onSyncSettingsClicked()
+void MainWindow::applyScheduled( QProgressDialog & progressDialog, const std::function<void(DctWidgetBox *)> & op )
 {
-    // Get number of tabs which settinsg have to be loaded
-    int progressSteps = m_activeWidgets.length();
-    if ( m_dev->getSupportedFeatures().hasChainSelection )
+    CommandScheduler scheduler( m_dev->GetProVideoSystemItf() );
+    connect( &scheduler, &CommandScheduler::progress, [&progressDialog]( int acked, int queued )
     {
-        // Settings for the lutbox and outbox have to be loaded twice (once for each chain)
-        if ( m_activeWidgets.contains(m_ui->lutBox) )
-        {
-            progressSteps++;
-        }
-        if ( m_activeWidgets.contains(m_ui->outBox) )
-        {
-            progressSteps++;
-        }
-    }
-
-    // Create progress dialog
-    QProgressDialog progressDialog( "Synchronising Settings...", "", 0, progressSteps, this );
-    progressDialog.setCancelButton( nullptr );
-    progressDialog.setWindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint);
-    progressDialog.show();
+        progressDialog.setMaximum( queued );
+        progressDialog.setValue( acked );
+        QApplication::processEvents();
+    } );
 
-    // sleep for 100ms and refresh progress bar, this ensures that the progress bar is correctly shown under linux
-    QThread::msleep( 100 );
-    progressDialog.setValue( 0 );
-    QApplication::processEvents(QEventLoop::WaitForMoreEvents);
+    scheduler.begin();
 
-    // Disable updpates of the GUI
-    this->setUpdatesEnabled( false );
-
-    // Apply the settings of all visible tabs
-    int i;
-    for ( i = 0; i < m_activeWidgets.length(); i++ )
+    for ( int i = 0; i < m_activeWidgets.length(); i++ )
     {
-        progressDialog.setValue( i );
-        QApplication::processEvents();
-        m_activeWidgets[i]->apply();
+        scheduler.beginBatch( m_activeWidgets[i]->objectName() );
+        op( m_activeWidgets[i] );
     }
 
-    // If this device has a second chain, sync settings for it too
+    // If this device has a second chain, apply the chain specific widgets to it too
     if ( m_dev->getSupportedFeatures().hasChainSelection )
     {
+        // Commands must not be reordered across a chain switch
+        scheduler.flush();
+
         // Check which chain is currently used and switch to the other one
         if ( m_ui->actionSelectSdi1->isChecked() )
         {
@@ -2273,23 +2843,20 @@ void MainWindow::onSyncSettingsClicked()
         {
             emit SdiOutChanged( 1 );
         }
+        scheduler.flush();
 
-        // Sync lutbox settings for other chain
-        if ( m_activeWidgets.contains(m_ui->lutBox) )
+        if ( m_activeWidgets.contains(m_lutBox) )
         {
-            progressDialog.setValue( i );
-            i++;
-            QApplication::processEvents();
-            m_ui->lutBox->apply();
+            scheduler.beginBatch( lutBox()->objectName() );
+            op( lutBox() );
         }
 
-        // Load outbox settings for other chain
         if ( m_activeWidgets.contains(m_ui->outBox) )
         {
-            progressDialog.setValue( i );
-            QApplication::processEvents();
-            m_ui->outBox->apply();
+            scheduler.beginBatch( m_ui->outBox->objectName() );
+            op( m_ui->outBox );
         }
+        scheduler.flush();
 
         // Return to previous chain
         if ( m_ui->actionSelectSdi1->isChecked() )
@@ -2302,8 +2869,48 @@ void MainWindow::onSyncSettingsClicked()
         }
     }
 
+    if ( scheduler.end() )
+    {
+        QStringList failed = scheduler.failed();
+        int more = failed.size() - 10;
+        if ( more > 0 )
+        {
+            failed = failed.mid( 0, 10 );
+            failed.append( QString( "... and %1 more" ).arg( more ) );
+        }
+
+        QMessageBox::warning( this, "Apply Settings",
+                              "The device rejected some settings:\n\n" + failed.join( "\n" ) );
+    }
+}
+
+/******************************************************************************
+ * MainWindow::onSyncSettingsClicked
+ *****************************************************************************/
+void MainWindow::onSyncSettingsClicked()
+{
+    // All tabs are applied, so all of them need the device values
+    completeResync();
+
+    // Create progress dialog
+    QProgressDialog progressDialog( "Synchronising Settings...", "", 0, 0, this );
+    progressDialog.setCancelButton( nullptr );
+    progressDialog.setWindowFlags(Qt::Dialog | Qt::FramelessWindowHint | Qt::WindowTitleHint);
+    progressDialog.show();
+
+    // sleep for 100ms and refresh progress bar, this ensures that the progress bar is correctly shown under linux
+    QThread::msleep( 100 );
+    progressDialog.setValue( 0 );
+    QApplication::processEvents(QEventLoop::WaitForMoreEvents);
+
+    // Disable updpates of the GUI
+    this->setUpdatesEnabled( false );
+
+    // Apply the settings of all visible tabs of both chains
+    applyScheduled( progressDialog, []( DctWidgetBox * box ) { box->apply(); } );
+
     // Set dialog to 100%
-    progressDialog.setValue( progressSteps );
+    progressDialog.setValue( progressDialog.maximum() );
     QApplication::processEvents();
 
     // Re-enable updpates of the GUI
@@ -2367,13 +2974,15 @@ void MainWindow::onWidgetModeChange( DctWidgetBox::Mode mode )
 void MainWindow::onConnectionCheckChange( bool enable )
 {
     // Start or stop connection timer
-    if ( enable && !m_checkConnectionTimer.isActive() )
+    if ( enable && !m_checkConnectionTimer.isActive() && !m_reconnectTimer.isActive() )
     {
-        m_checkConnectionTimer.start( 2000 );
+        startConnectionCheck();
     }
-    else
+    else if ( !enable )
     {
         m_checkConnectionTimer.stop();
+        m_reconnectTimer.stop();
+        setWindowTitle( m_WindowTitle );
     }
 
     // Store check connection flag
@@ -2469,7 +3078,7 @@ void MainWindow::onResyncRequest()
     if ( m_dev )
     {
         QApplication::setOverrideCursor( Qt::WaitCursor );
-        m_dev->resync();
+        resyncAll();
         QApplication::setOverrideCursor( Qt::ArrowCursor );
     }
 }
@@ -28,17 +28,28 @@
 #include <QList>
 #include <QComboBox>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QProgressDialog>
+
+#include <functional>
 
 #include <dct_widgets_base.h>
 #include "ProVideoDevice.h"
 #include "connectdialog.h"
 #include "settingsdialog.h"
 #include "debugterminal.h"
+#include "ComCache.h"
+#include "SignalCoalescer.h"
 
 namespace Ui {
     class MainWindow;
 }
 
+class InOutBox;
+class KneeBox;
+class LutBox;
+class ROIBox;
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -62,6 +73,7 @@ signals:
     void SaveSettingsToFileRequest();
 
     void SdiOutChanged( int value );
+    void ChainSnapshotRequested( int chain );
 
     // copy settings
     void CopySettings( int fromIdx, int toIdx );
@@ -119,22 +131,43 @@ private slots:
     void onReopenSerialConnection();
     void onResizeMainWindow( bool force = false );
     void onCheckConnection();
+    void onReconnect();
+    void onTabChange( int index );
+    void onResyncPending();
 
 private:
     Ui::MainWindow *        m_ui;
+    InOutBox *              m_inoutBox;
+    KneeBox *               m_kneeBox;
+    LutBox *                m_lutBox;
+    ROIBox *                m_roiBox;
     ConnectDialog *         m_ConnectDlg;
     SettingsDialog *        m_SettingsDlg;
     DebugTerminal *         m_DebugTerminal;
+    QDockWidget *           m_PreviewDock;
     QComboBox *             m_cbxConnectedDevices;
     ProVideoDevice *        m_dev;
     QString                 m_filename;
     QList<DctWidgetBox *>   m_activeWidgets;
     QTimer                  m_resizeTimer;
     QTimer                  m_checkConnectionTimer;
+    QTimer                  m_reconnectTimer;
+    QElapsedTimer           m_connectionIdleTimer;
+    uint32_t                m_connectionResponses;
+    int                     m_reconnectDelay;
+    QTimer                  m_resyncTimer;
+    QList<ProVideoDevice::Subsystem> m_resyncPending;
+    QElapsedTimer           m_connectTime;
+    ComCache                m_cache;
+    bool                    m_fingerprintPending;
+    SignalCoalescer         m_updates;
+    QString                 m_cacheFile;
     bool                    m_ScrollbarsNeeded;
     DctWidgetBox::Mode      m_WidgetMode;
     bool                    m_ShowDebugTerminal;
     bool                    m_EnableConnectionCheck;
+    int                     m_ConnectionIdleTime;
+    QString                 m_WindowTitle;
     QComboBox *             m_userSetComboBox;
     bool                    m_bUserSetComboBox;
 
@@ -143,11 +176,29 @@ private:
     void setSettingsDlg( SettingsDialog * );
     void setDebugTerminal( DebugTerminal * );
     void setupUI(ProVideoDevice::features deviceFeatures);
+
+    // the in/out tab and the tabs with plots are built on first use, i.e.
+    // when a device which supports them is connected, not with the ui
+    InOutBox * inoutBox();
+    KneeBox * kneeBox();
+    LutBox * lutBox();
+    ROIBox * roiBox();
+    void addBox( QWidget * page, DctWidgetBox * box, const QString & name );
     bool fileExists( QString & path );
     void loadUiSettings( QSettings &s );
     void saveUiSettings( QSettings &s );
 
     void updateDeviceList();
+    void startConnectionCheck();
+
+    QList<ProVideoDevice::Subsystem> tabSubsystems( QWidget * page ) const;
+    void queueResync();
+    void resyncSubsystems( const QList<ProVideoDevice::Subsystem> & subsystems );
+    void completeResync();
+    void resyncAll();
+    void takeFingerprint();
+    void saveCache();
+    void applyScheduled( QProgressDialog & progressDialog, const std::function<void(DctWidgetBox *)> & op );
 };
 
 #endif // __MAINWINDOW_H__
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    startupprofile.cpp
+ *
+ * @brief   Implementation of the startup timeline
+ *
+ *****************************************************************************/
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QtDebug>
+
+#include "startupprofile.h"
+
+/******************************************************************************
+ * recorded steps
+ *****************************************************************************/
+static QElapsedTimer                        timeline;
+static QList< QPair<QString, qint64> >      steps;
+static bool                                 recording = false;
+
+/******************************************************************************
+ * StartupProfile::start
+ *****************************************************************************/
+void StartupProfile::start()
+{
+    steps.clear();
+    timeline.start();
+    recording = true;
+}
+
+/******************************************************************************
+ * StartupProfile::mark
+ *****************************************************************************/
+void StartupProfile::mark( const QString & step )
+{
+    if ( recording )
+    {
+        steps.append( qMakePair( step, timeline.elapsed() ) );
+    }
+}
+
+/******************************************************************************
+ * StartupProfile::report
+ *****************************************************************************/
+void StartupProfile::report()
+{
+    if ( !recording )
+    {
+        return;
+    }
+
+    recording = false;
+
+    qDebug() << "startup timeline:";
+
+    qint64 last = 0;
+    for ( int i = 0; i < steps.size(); i++ )
+    {
+        qDebug().noquote() << QString( "  %1 ms (+%2 ms) %3" )
+                              .arg( steps[i].second, 6 )
+                              .arg( steps[i].second - last, 5 )
+                              .arg( steps[i].first );
+        last = steps[i].second;
+    }
+}
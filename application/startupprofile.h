@@ -0,0 +1,46 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    startupprofile.h
+ *
+ * @brief   Timeline of the application startup
+ *
+ * @note    The steps of the startup are marked with their name, report()
+ *          prints the timeline to the debug output, with the time since
+ *          start() and the duration of every step. Marks after the report
+ *          are ignored, so marking is free in the rest of the session.
+ *
+ *****************************************************************************/
+#ifndef __STARTUP_PROFILE_H__
+#define __STARTUP_PROFILE_H__
+
+#include <QString>
+
+class StartupProfile
+{
+public:
+    // start the timeline, call first thing in main
+    static void start();
+
+    // a step of the startup is done
+    static void mark( const QString & step );
+
+    // print the timeline and stop recording
+    static void report();
+};
+
+#endif // __STARTUP_PROFILE_H__
@@ -491,6 +491,22 @@ void AutoItf::onNotifyWhiteBalanceUpdate()
     GetStatRGB();
 }
 
+/******************************************************************************
+ * AutoItf::onGetStatXYZ
+ *****************************************************************************/
+void AutoItf::onGetStatXYZ()
+{
+    GetStatXYZ();
+}
+
+/******************************************************************************
+ * AutoItf::onGetColorXYZ
+ *****************************************************************************/
+void AutoItf::onGetColorXYZ()
+{
+    GetColorXYZ();
+}
+
 /******************************************************************************
  * AutoItf::onAecEnableChange
  *****************************************************************************/
@@ -102,6 +102,10 @@ public slots:
 
     // notifier slot for white-balance update 
     void onNotifyWhiteBalanceUpdate();
+
+    // statistics polled by the white-balance calibration
+    void onGetStatXYZ();
+    void onGetColorXYZ();
 };
 
 #endif // _AUTO_INTERFACE_H_
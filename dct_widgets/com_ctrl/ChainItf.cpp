@@ -618,6 +618,50 @@ void ChainItf::onChainSdiWhiteLevelChange( int value )
     HANDLE_ERROR( res );
 }
 
+/******************************************************************************
+ * ChainItf::onChainOutputSnapshotRequest
+ *****************************************************************************/
+void ChainItf::onChainOutputSnapshotRequest( int chain )
+{
+    // Is there a signal listener
+    if ( receivers(SIGNAL(ChainSdiSnapshotChanged(int,int,int,int))) > 0 )
+    {
+        uint8_t mode;
+        int8_t  black;
+        int8_t  white;
+
+        // read SDI settings of the addressed chain from device
+        int res = ctrl_protocol_get_sdi_range( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &mode );
+        HANDLE_ERROR( res );
+
+        res = ctrl_protocol_get_sdi_black( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &black );
+        HANDLE_ERROR( res );
+
+        res = ctrl_protocol_get_sdi_white( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &white );
+        HANDLE_ERROR( res );
+
+        // emit a ChainSdiSnapshotChanged signal
+        emit ChainSdiSnapshotChanged( chain, (int)mode, (int)black, (int)white );
+    }
+
+    // Is there a signal listener
+    if ( receivers(SIGNAL(ChainRawModeSnapshotChanged(int,int))) > 0 )
+    {
+        uint8_t value;
+
+        // read raw mode of the addressed chain from device
+        int res = ctrl_protocol_get_raw_mode( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &value );
+        HANDLE_ERROR( res );
+
+        // emit a ChainRawModeSnapshotChanged signal
+        emit ChainRawModeSnapshotChanged( chain, (int)value );
+    }
+}
+
 /******************************************************************************
  * ChainItf::onChainGenlockModeChange
  *****************************************************************************/
@@ -132,6 +132,10 @@ signals:
     
     // sdi white level
     void ChainSdiWhiteLevelChanged( int value );
+
+    // output settings of an addressed chain (settings snapshot)
+    void ChainSdiSnapshotChanged( int chain, int mode, int black, int white );
+    void ChainRawModeSnapshotChanged( int chain, int value );
     
     // genlock mode
     void ChainGenlockModeChanged( int value );
@@ -176,6 +180,7 @@ public slots:
     void onChainSdiModeChange( int value );
     void onChainSdiBlackLevelChange( int value );
     void onChainSdiWhiteLevelChange( int value );
+    void onChainOutputSnapshotRequest( int chain );
     void onChainGenlockModeChange( int value );
     void onChainGenlockStatusRefresh();
     void onChainGenlockCrosslockChange( int value );
@@ -0,0 +1,440 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    ComCache.cpp
+ *
+ * @brief   Implementation of the control channel response cache
+ *
+ *****************************************************************************/
+#include <cstring>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+#include "defines.h"
+#include "ComCache.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define COM_CACHE_MAGIC             ( 0x44435443u )     // "DCTC"
+#define COM_CACHE_FILE_VERSION      ( 2u )
+#define COM_CACHE_MAX_RESPONSE      ( 64 * 1024 )       // larger responses are not cached
+#define COM_CACHE_CONTEXT_END       ( '\x1f' )         // ends the context part of a key
+
+/******************************************************************************
+ * commands which address the values of other commands
+ *****************************************************************************/
+static const char * const addressingCommands[] =
+{
+    "out",          // chain of the chain specific commands
+    "lut_preset",   // preset of the LUT commands
+};
+
+#define NO_ADDRESSING_COMMANDS  ( static_cast<int>(sizeof(addressingCommands) / sizeof(addressingCommands[0])) )
+
+/******************************************************************************
+ * requestLines - lines of a request or response without line breaks
+ *****************************************************************************/
+static QList<QByteArray> requestLines( const QByteArray & data )
+{
+    QList<QByteArray> lines;
+
+    foreach ( const QByteArray & line, data.split( '\n' ) )
+    {
+        QByteArray s = line.simplified();
+        if ( !s.isEmpty() )
+        {
+            lines.append( s );
+        }
+    }
+
+    return ( lines );
+}
+
+/******************************************************************************
+ * ComCache::ComCache
+ *****************************************************************************/
+ComCache::ComCache()
+    : m_entries()
+    , m_lines()
+    , m_selected()
+    , m_request()
+    , m_response()
+    , m_pending()
+    , m_pendingPos( 0 )
+    , m_replay( false )
+    , m_fingerprint()
+{
+}
+
+/******************************************************************************
+ * ComCache::fileName
+ *****************************************************************************/
+QString ComCache::fileName( const QString & deviceId, const QString & version )
+{
+    QString name = deviceId + "_" + version;
+    name.replace( QRegularExpression( "[^A-Za-z0-9._-]" ), "_" );
+
+    return ( QDir::homePath() + "/" + QString(CACHE_DIR_NAME) + "/" + name + ".bin" );
+}
+
+/******************************************************************************
+ * ComCache::load
+ *****************************************************************************/
+bool ComCache::load( const QString & fileName )
+{
+    clear();
+
+    QFile file( fileName );
+    if ( !file.open( QIODevice::ReadOnly ) )
+    {
+        return ( false );
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_0 );
+
+    quint32 magic = 0u;
+    quint32 version = 0u;
+    QByteArray fingerprint;
+    QByteArray compressed;
+
+    stream >> magic >> version >> fingerprint >> compressed;
+    if ( (stream.status() != QDataStream::Ok) ||
+         (magic != COM_CACHE_MAGIC) || (version != COM_CACHE_FILE_VERSION) )
+    {
+        return ( false );
+    }
+
+    // the entries are stored compressed, responses are plain text
+    QByteArray data = qUncompress( compressed );
+    QDataStream entryStream( data );
+    entryStream.setVersion( QDataStream::Qt_5_0 );
+    QHash<QByteArray, QByteArray> entries;
+    entryStream >> entries;
+    if ( entryStream.status() != QDataStream::Ok )
+    {
+        return ( false );
+    }
+
+    for ( QHash<QByteArray, QByteArray>::const_iterator it = entries.constBegin(); it != entries.constEnd(); ++it )
+    {
+        insert( it.key(), it.value() );
+    }
+
+    m_fingerprint = fingerprint;
+
+    return ( true );
+}
+
+/******************************************************************************
+ * ComCache::save
+ *****************************************************************************/
+bool ComCache::save( const QString & fileName )
+{
+    // the last recorded response is complete by now
+    commit();
+
+    if ( !QDir().mkpath( QFileInfo( fileName ).absolutePath() ) )
+    {
+        return ( false );
+    }
+
+    QByteArray entries;
+    QDataStream entryStream( &entries, QIODevice::WriteOnly );
+    entryStream.setVersion( QDataStream::Qt_5_0 );
+    entryStream << m_entries;
+
+    // write to a temporary file, a crash never leaves a broken cache behind
+    QSaveFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly ) )
+    {
+        return ( false );
+    }
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_0 );
+    stream << quint32(COM_CACHE_MAGIC) << quint32(COM_CACHE_FILE_VERSION)
+           << m_fingerprint << qCompress( entries );
+
+    return ( (stream.status() == QDataStream::Ok) && file.commit() );
+}
+
+/******************************************************************************
+ * ComCache::clear
+ *****************************************************************************/
+void ComCache::clear()
+{
+    m_entries.clear();
+    m_lines.clear();
+    m_selected.clear();
+    m_request.clear();
+    m_response.clear();
+    m_pending.clear();
+    m_pendingPos = 0;
+    m_fingerprint.clear();
+}
+
+/******************************************************************************
+ * ComCache::setReplay
+ *****************************************************************************/
+void ComCache::setReplay( bool enable )
+{
+    m_replay = enable;
+    if ( !enable )
+    {
+        m_pending.clear();
+        m_pendingPos = 0;
+    }
+}
+
+/******************************************************************************
+ * ComCache::request
+ *****************************************************************************/
+bool ComCache::request( const char * data, int len )
+{
+    // a new request terminates the previous response
+    commit();
+
+    QByteArray command( data, len );
+    QByteArray key = context() + command;
+
+    if ( m_replay )
+    {
+        QHash<QByteArray, QByteArray>::const_iterator it = m_entries.constFind( key );
+        if ( it != m_entries.constEnd() )
+        {
+            m_pending = it.value();
+            m_pendingPos = 0;
+
+            // a replayed chain or preset is selected like a read one
+            foreach ( const QByteArray & line, requestLines( m_pending ) )
+            {
+                select( line );
+            }
+
+            return ( true );
+        }
+    }
+
+    // the request goes to the device, a set drops the gets it changes
+    foreach ( const QByteArray & line, requestLines( command ) )
+    {
+        invalidate( line );
+        select( line );
+    }
+
+    m_pending.clear();
+    m_pendingPos = 0;
+    m_request = key;
+
+    return ( false );
+}
+
+/******************************************************************************
+ * ComCache::response
+ *****************************************************************************/
+int ComCache::response( char * data, int len )
+{
+    int n = qMin( len, m_pending.size() - m_pendingPos );
+    if ( n <= 0 )
+    {
+        return ( 0 );
+    }
+
+    memcpy( data, m_pending.constData() + m_pendingPos, static_cast<size_t>(n) );
+    m_pendingPos += n;
+
+    return ( n );
+}
+
+/******************************************************************************
+ * ComCache::record
+ *****************************************************************************/
+void ComCache::record( const char * data, int len )
+{
+    if ( m_request.isEmpty() || (len <= 0) )
+    {
+        return;
+    }
+
+    if ( (m_response.size() + len) > COM_CACHE_MAX_RESPONSE )
+    {
+        // too large to be worth caching, drop the request
+        m_request.clear();
+        m_response.clear();
+        return;
+    }
+
+    m_response.append( data, len );
+}
+
+/******************************************************************************
+ * ComCache::commit
+ *****************************************************************************/
+void ComCache::commit()
+{
+    if ( m_request.isEmpty() )
+    {
+        return;
+    }
+
+    // only successful responses with data are kept
+    bool ok = false;
+    bool hasData = false;
+
+    foreach ( const QByteArray & line, m_response.split( '\n' ) )
+    {
+        QByteArray s = line.trimmed();
+        if ( s.isEmpty() )
+        {
+            continue;
+        }
+
+        if ( s == "OK" )
+        {
+            ok = true;
+        }
+        else if ( (s == "FAIL") || s.startsWith( "ERROR" ) )
+        {
+            hasData = false;
+            break;
+        }
+        else
+        {
+            hasData = true;
+        }
+    }
+
+    if ( ok && hasData )
+    {
+        insert( m_request, m_response );
+
+        // a read chain or preset addresses the following requests
+        foreach ( const QByteArray & line, requestLines( m_response ) )
+        {
+            select( line );
+        }
+    }
+    else
+    {
+        // a request which no longer answers with data is not replayed
+        remove( m_request );
+    }
+
+    m_request.clear();
+    m_response.clear();
+}
+
+/******************************************************************************
+ * ComCache::insert
+ *****************************************************************************/
+void ComCache::insert( const QByteArray & key, const QByteArray & response )
+{
+    remove( key );
+
+    m_entries.insert( key, response );
+
+    // the context is not part of the request lines
+    foreach ( const QByteArray & line, requestLines( key.mid( key.indexOf( COM_CACHE_CONTEXT_END ) + 1 ) ) )
+    {
+        m_lines.insert( line, key );
+    }
+}
+
+/******************************************************************************
+ * ComCache::remove
+ *****************************************************************************/
+void ComCache::remove( const QByteArray & key )
+{
+    if ( !m_entries.remove( key ) )
+    {
+        return;
+    }
+
+    foreach ( const QByteArray & line, requestLines( key.mid( key.indexOf( COM_CACHE_CONTEXT_END ) + 1 ) ) )
+    {
+        m_lines.remove( line, key );
+    }
+}
+
+/******************************************************************************
+ * ComCache::invalidate - drop the cached gets a set command changes, in all
+ * contexts, the context of the first reads after connect is not known yet
+ *****************************************************************************/
+void ComCache::invalidate( const QByteArray & line )
+{
+    QList<QByteArray> words = line.split( ' ' );
+
+    QByteArray get = words[0];
+    for ( int i = 1; i < words.size(); i++ )
+    {
+        foreach ( const QByteArray & key, m_lines.values( get ) )
+        {
+            remove( key );
+        }
+
+        get += ' ';
+        get += words[i];
+    }
+}
+
+/******************************************************************************
+ * ComCache::select - remember the chain or preset a line addresses
+ *****************************************************************************/
+void ComCache::select( const QByteArray & line )
+{
+    QList<QByteArray> words = line.split( ' ' );
+    if ( words.size() != 2 )
+    {
+        return;
+    }
+
+    for ( int i = 0; i < NO_ADDRESSING_COMMANDS; i++ )
+    {
+        if ( words[0] == addressingCommands[i] )
+        {
+            m_selected.insert( words[0], words[1] );
+            return;
+        }
+    }
+}
+
+/******************************************************************************
+ * ComCache::context - key prefix of the selected chain and preset
+ *****************************************************************************/
+QByteArray ComCache::context() const
+{
+    QByteArray prefix;
+
+    for ( QMap<QByteArray, QByteArray>::const_iterator it = m_selected.constBegin(); it != m_selected.constEnd(); ++it )
+    {
+        prefix += it.key() + ' ' + it.value() + ';';
+    }
+
+    if ( !prefix.isEmpty() )
+    {
+        prefix += COM_CACHE_CONTEXT_END;
+    }
+
+    return ( prefix );
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    ComCache.h
+ *
+ * @brief   Persistent request/response cache of the control channel
+ *
+ * @note    While recording, every get command whose response carries data
+ *          (at least one line besides the "OK" terminator) is stored with
+ *          its response. While replaying, a cached request is answered from
+ *          the cache without touching the line, other requests are sent to
+ *          the device and recorded. Set commands only get an "OK" and are
+ *          never replayed.
+ *
+ *          A set command drops the cached gets it changes, i.e. every get
+ *          whose words are a leading part of the set command ("lut_mode 1"
+ *          drops "lut_mode", "mcc_phase 3 100 200" drops "mcc_phase 3").
+ *
+ *          The chain ("out") and LUT preset ("lut_preset") address the
+ *          values of other commands. The last selected chain and preset are
+ *          part of the key, so reads of another chain or preset never
+ *          replace the entries of the active ones.
+ *
+ *          A cache belongs to one device and one firmware version, it is
+ *          stored in a small binary file together with a fingerprint of the
+ *          device settings taken when the pass which filled the cache started.
+ *
+ *****************************************************************************/
+#ifndef _COM_CACHE_H_
+#define _COM_CACHE_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMultiHash>
+#include <QString>
+
+class ComCache
+{
+public:
+    explicit ComCache();
+
+    // cache file of a device and firmware version
+    static QString fileName( const QString & deviceId, const QString & version );
+
+    // load from / save to a cache file, false on error
+    bool load( const QString & fileName );
+    bool save( const QString & fileName );
+
+    // drop all cached responses
+    void clear();
+
+    int size() const
+    {
+        return ( m_entries.size() );
+    }
+
+    // answer cached requests from the cache
+    void setReplay( bool enable );
+
+    bool isReplaying() const
+    {
+        return ( m_replay );
+    }
+
+    // fingerprint of the device settings the cache was taken from
+    QByteArray fingerprint() const
+    {
+        return ( m_fingerprint );
+    }
+
+    void setFingerprint( const QByteArray & fingerprint )
+    {
+        m_fingerprint = fingerprint;
+    }
+
+    // channel side: a request is sent, returns true if it is answered from the cache
+    bool request( const char * data, int len );
+
+    // channel side: copy up to len bytes of a cached response, returns the number of bytes
+    int response( char * data, int len );
+
+    // channel side: data received from the device
+    void record( const char * data, int len );
+
+private:
+    void commit();
+    void insert( const QByteArray & key, const QByteArray & response );
+    void remove( const QByteArray & key );
+    void invalidate( const QByteArray & line );
+    void select( const QByteArray & line );
+    QByteArray context() const;
+
+    QHash<QByteArray, QByteArray>   m_entries;      /**< context and request -> response */
+    QMultiHash<QByteArray, QByteArray> m_lines;     /**< request line -> keys holding it */
+    QMap<QByteArray, QByteArray>    m_selected;     /**< addressing command -> value */
+    QByteArray                      m_request;      /**< request being recorded */
+    QByteArray                      m_response;     /**< response being recorded */
+    QByteArray                      m_pending;      /**< cached response being replayed */
+    int                             m_pendingPos;   /**< bytes of m_pending already read */
+    bool                            m_replay;       /**< replay enabled */
+    QByteArray                      m_fingerprint;  /**< fingerprint of device settings */
+};
+
+#endif // _COM_CACHE_H_
@@ -30,6 +30,8 @@
  * ComChannel::ComChannel
  *****************************************************************************/
 ComChannel::ComChannel()
+    : m_log( nullptr )
+    , m_cache( nullptr )
 {
     size_t size = static_cast<size_t>(ctrl_channel_get_instance_size());
 
@@ -28,6 +28,9 @@
 // generic control channel layer
 #include <ctrl_channel/ctrl_channel.h>
 
+#include "ComLog.h"
+#include "ComCache.h"
+
 class ComChannel : public QObject
 {
     Q_OBJECT
@@ -49,14 +52,69 @@ public:
 
     void Close();
 
-signals:
-    void dataReceived( QString data );
+    // line rate in bits/s, 0 if the channel has no fixed rate
+    virtual uint32_t getBaudRate() const
+    {
+        return ( 0u );
+    }
+
+    // traffic log (e.g. for the debug terminal), nullptr disables logging
+    ComLog * getLog() const
+    {
+        return ( m_log );
+    }
+
+    void setLog( ComLog * log )
+    {
+        m_log = log;
+    }
+
+    void logData( char const * data, int len )
+    {
+        if ( m_log )
+        {
+            m_log->append( data, len );
+        }
+    }
+
+    // response cache (e.g. for a fast reconnect), nullptr disables caching
+    ComCache * getCache() const
+    {
+        return ( m_cache );
+    }
+
+    void setCache( ComCache * cache )
+    {
+        m_cache = cache;
+    }
+
+    // returns true if the request is answered from the cache
+    bool cacheRequest( char const * data, int len )
+    {
+        return ( m_cache && m_cache->request( data, len ) );
+    }
+
+    // returns the number of bytes of a cached response, 0 if there is none
+    int cachedResponse( char * data, int len )
+    {
+        return ( m_cache ? m_cache->response( data, len ) : 0 );
+    }
+
+    void cacheData( char const * data, int len )
+    {
+        if ( m_cache )
+        {
+            m_cache->record( data, len );
+        }
+    }
 
 public slots:
     virtual void onSendData( QString data, int responseWaitTime ) = 0;
 
 private:
     ctrl_channel_handle_t   m_channel;      // control channel instance
+    ComLog *                m_log;          // traffic log
+    ComCache *              m_cache;        // response cache
 };
 
 #endif // _COM_CHANNEL_H_
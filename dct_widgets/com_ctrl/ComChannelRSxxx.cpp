@@ -21,6 +21,8 @@
  *
  *****************************************************************************/
 #include <cerrno>
+#include <cstdio>
+#include <cstring>
 
 #include "common.h"
 #include "ComChannelRSxxx.h"
@@ -28,6 +30,42 @@
 #include <QThread>
 #include <QElapsedTimer>
 
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <termios.h>
+#endif
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+/* The transceivers of a RS485 bus need some time to switch from sending to
+ * receiving. The device does not see a request which starts before its own
+ * transceiver has turned around, so a request is delayed by 3.5 character
+ * times (the frame gap of RS485 field buses) after the last received data,
+ * but at least by 250 us which has proven to be enough for the device down
+ * to 38400 baud. */
+#define RS485_TURNAROUND_BITS           ( 35 )
+#define RS485_TURNAROUND_MIN_NS         ( 250000 )
+
+// additional time to wait for a request to leave the port in RTS mode
+#define RS485_DRAIN_TIMEOUT_MS          ( 100 )
+
+/******************************************************************************
+ * drain_port - wait until all data has left the transmit shift register
+ *****************************************************************************/
+static void drain_port( QSerialPort * port, int timeout_ms )
+{
+    // QSerialPort only knows when the data is handed to the driver
+    port->waitForBytesWritten( timeout_ms );
+
+#ifdef Q_OS_WIN
+    FlushFileBuffers( port->handle() );
+#else
+    tcdrain( port->handle() );
+#endif
+}
+
 /******************************************************************************
  * ctrl_channel_qtserial_get_no_ports
  *****************************************************************************/
@@ -132,36 +170,15 @@ static int ctrl_channel_qtserial_rs232_open
     if ( port )
     {
         QSerialPort::DataBits b = QSerialPort::UnknownDataBits;
-        QSerialPort::BaudRate r = QSerialPort::UnknownBaud;
         QSerialPort::Parity   p = QSerialPort::UnknownParity;
         QSerialPort::StopBits s = QSerialPort::UnknownStopBits;
 
-        // check parameter
-        switch ( conf->baudrate )
+        // check parameter, QSerialPort sets up non-standard baudrates as
+        // custom rates (BOTHER on linux), the adapter decides if it can do it
+        if ( !CTRL_CHANNEL_BAUDRATE_VALID( conf->baudrate ) )
         {
-            case CTRL_CHANNEL_BAUDRATE_9600:
-                r = QSerialPort::Baud9600;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_19200: 
-                r = QSerialPort::Baud19200;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_38400: 
-                r = QSerialPort::Baud38400;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_57600: 
-                r = QSerialPort::Baud57600;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_115200: 
-                r = QSerialPort::Baud115200;
-                break;
-
-            default:    // unsupported 
-                delete port;
-                return ( -EINVAL );
+            delete port;
+            return ( -EINVAL );
         }
 
         switch ( conf->data )
@@ -237,7 +254,7 @@ static int ctrl_channel_qtserial_rs232_open
             return ( -EFAULT );
         }
 
-        if ( !port->setBaudRate( r ) )
+        if ( !port->setBaudRate( static_cast<qint32>(conf->baudrate) ) )
         {
             qDebug() << port->errorString();
             delete port;
@@ -271,6 +288,7 @@ static int ctrl_channel_qtserial_rs232_open
         com->setParity( conf->parity );
         com->setNoStopBits( conf->stop );
         com->setBaudRate( conf->baudrate );
+        ctrl_channel_set_line_rate( com->GetInstance(), conf->baudrate );
         com->setReOpenAble( true );
         com->setPort( port );
 
@@ -320,9 +338,14 @@ static int ctrl_channel_qtserial_rs232_send_request
         QSerialPort * port = com->getPort();
         if ( port )
         {
-            /* We call the "emit data received" function here, although this is actually a data send.
-             * This is done to have a local echo functionality in the debug terminal. */
-            com->emitDataRecieved( reinterpret_cast<char *>(data) );
+            // answered from the response cache, nothing to send
+            if ( com->cacheRequest( reinterpret_cast<char *>(data), len ) )
+            {
+                return ( len );
+            }
+
+            // local echo of the request in the traffic log (debug terminal)
+            com->logData( reinterpret_cast<char *>(data), len );
 
             res = static_cast<int>(port->write( reinterpret_cast<const char *>(data), len ));
         }
@@ -350,15 +373,22 @@ static int ctrl_channel_qtserial_rs232_receive_response
         QSerialPort * port = com->getPort();
         if ( port )
         {
+            // response of a cached request
+            res = com->cachedResponse( reinterpret_cast<char *>(data), len );
+            if ( res > 0 )
+            {
+                return ( res );
+            }
+
             // Check if bytes are available, otherwise wait 1ms for new data to arrive
             if( port->bytesAvailable() > 0 || port->waitForReadyRead(1) )
             {
                 res = static_cast<int>(port->read( reinterpret_cast<char *>(data), len ));
 
-                /* Call the emitDataReceived function which will emit a dataRecieved signal, if a slot
-                 * is registered for that event. This is used for the debugging terminal, it is not needed
-                 * for communication with the device */
-                com->emitDataRecieved( reinterpret_cast<char *>(data) );
+                /* Copy the response into the traffic log. This is used for the debugging terminal,
+                 * it is not needed for communication with the device */
+                com->logData( reinterpret_cast<char *>(data), res );
+                com->cacheData( reinterpret_cast<char *>(data), res );
             }
         }
     }
@@ -403,36 +433,15 @@ static int ctrl_channel_qtserial_rs4xx_open
     if ( port )
     {
         QSerialPort::DataBits b = QSerialPort::UnknownDataBits;
-        QSerialPort::BaudRate r = QSerialPort::UnknownBaud;
         QSerialPort::Parity   p = QSerialPort::UnknownParity;
         QSerialPort::StopBits s = QSerialPort::UnknownStopBits;
 
-        // check parameter
-        switch ( conf->baudrate )
+        // check parameter, QSerialPort sets up non-standard baudrates as
+        // custom rates (BOTHER on linux), the adapter decides if it can do it
+        if ( !CTRL_CHANNEL_BAUDRATE_VALID( conf->baudrate ) )
         {
-            case CTRL_CHANNEL_BAUDRATE_9600:
-                r = QSerialPort::Baud9600;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_19200: 
-                r = QSerialPort::Baud19200;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_38400: 
-                r = QSerialPort::Baud38400;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_57600: 
-                r = QSerialPort::Baud57600;
-                break;
-
-            case CTRL_CHANNEL_BAUDRATE_115200: 
-                r = QSerialPort::Baud115200;
-                break;
-
-            default:    // unsupported 
-                delete port;
-                return ( -EINVAL );
+            delete port;
+            return ( -EINVAL );
         }
 
         switch ( conf->data )
@@ -508,7 +517,7 @@ static int ctrl_channel_qtserial_rs4xx_open
             return ( -EFAULT );
         }
 
-        if ( !port->setBaudRate( r ) )
+        if ( !port->setBaudRate( static_cast<qint32>(conf->baudrate) ) )
         {
             qDebug() << port->errorString();
             delete port;
@@ -542,6 +551,7 @@ static int ctrl_channel_qtserial_rs4xx_open
         com->setParity( conf->parity );
         com->setNoStopBits( conf->stop );
         com->setBaudRate( conf->baudrate );
+        ctrl_channel_set_line_rate( com->GetInstance(), conf->baudrate );
         com->setDeviceAddress( conf->dev_addr );
         com->setReOpenAble( true );
         com->setPort( port );
@@ -592,18 +602,58 @@ static int ctrl_channel_qtserial_rs4xx_send_request
         QSerialPort * port = com->getPort();
         if ( port )
         {
-            // send slave address
-            QString s;
-            s.sprintf("%d ", com->getDeviceAddress() );
-            port->write( s.toUtf8() );
+            // answered from the response cache, nothing to send
+            if ( com->cacheRequest( reinterpret_cast<char *>(data), len ) )
+            {
+                return ( len );
+            }
 
-            /* We call the "emit data received" function here, although this is actually a data send.
-             * This is done to have a local echo functionality in the debug terminal. */
-            com->emitDataRecieved( s.toLocal8Bit().constData() );
-            com->emitDataRecieved( reinterpret_cast<char *>(data) );
+            // the bus turns around once per request, not per received chunk
+            com->waitTurnaround();
 
-            // send command
-            res = static_cast<int>(port->write( reinterpret_cast<const char *>(data), len ));
+            if ( com->getDirectionControl() == ComChannelRS4xx::DirectionRts )
+            {
+                port->setRequestToSend( true );
+            }
+
+            // slave address
+            char addr[16];
+            int n = snprintf( addr, sizeof(addr), "%u ", com->getDeviceAddress() );
+            int sent = 0;
+
+            // every command of a pipelined request is addressed
+            for ( int i = 0; i < len; )
+            {
+                const char * line = reinterpret_cast<const char *>(&data[i]);
+                const char * eol  = static_cast<const char *>(memchr( line, '\n', static_cast<size_t>(len - i) ));
+                int l = eol ? static_cast<int>(eol - line) + 1 : (len - i);
+
+                port->write( addr, n );
+                sent += n;
+
+                // local echo of the request in the traffic log (debug terminal)
+                com->logData( addr, n );
+                com->logData( line, l );
+
+                // send command
+                qint64 written = port->write( line, l );
+                if ( written < 0 )
+                {
+                    res = static_cast<int>(written);
+                    break;
+                }
+                res  += static_cast<int>(written);
+                sent += l;
+                i    += l;
+            }
+
+            // release the bus as soon as the last stop bit is out
+            if ( com->getDirectionControl() == ComChannelRS4xx::DirectionRts )
+            {
+                int line_ms = static_cast<int>(sent * 10 * 1000 / qMax( com->getBaudRate(), 1u ));
+                drain_port( port, line_ms + RS485_DRAIN_TIMEOUT_MS );
+                port->setRequestToSend( false );
+            }
         }
     }
 
@@ -631,22 +681,24 @@ static int ctrl_channel_qtserial_rs4xx_receive_response
         // Check if bytes are available, otherwise wait 1ms for new data to arrive
         if ( port )
         {
+            // response of a cached request
+            res = com->cachedResponse( reinterpret_cast<char *>(data), len );
+            if ( res > 0 )
+            {
+                return ( res );
+            }
+
             if ( port->bytesAvailable() > 0 || port->waitForReadyRead(1) )
             {
                 res = static_cast<int>(port->read( reinterpret_cast<char *>(data), len ));
-                /* Mahr: After reading data, wait 250 us to give the RS485 tx/rx chips time
-                 * to switch from write to read. This fixes problems where the device would not
-                 * receive some commands.
-                 * This problem is related to the baudrate, this fix only works for baudrates down
-                 * to 38400. But the other baudrates are usually unused anyway. If the sleep value is
-                 * increased to 30000 us, the problem also seems to be fixed for baudrates down to 9600
-                 * but this also increases the latency of the GUI to unreasonable amounts. */
-                QThread::usleep(250);
-
-                /* Call the emitDataReceived function which will emit a dataRecieved signal, if a slot
-                 * is registered for that event. This is used for the debugging terminal, it is not needed
-                 * for communication with the device */
-                com->emitDataRecieved( reinterpret_cast<char *>(data) );
+
+                // the next request has to wait for the transceivers to switch
+                com->restartTurnaround();
+
+                /* Copy the response into the traffic log. This is used for the debugging terminal,
+                 * it is not needed for communication with the device */
+                com->logData( reinterpret_cast<char *>(data), res );
+                com->cacheData( reinterpret_cast<char *>(data), res );
             }
         }
     }
@@ -670,17 +722,6 @@ int ComChannelSerial::getPortName( int idx, ctrl_channel_name_t name )
     return ( ctrl_channel_get_port_name( GetInstance(), idx, name ) );
 }
 
-/******************************************************************************
- * ComChannelSerial::emitDataRecieved
- *****************************************************************************/
-void ComChannelSerial::emitDataRecieved( char const * data )
-{
-    if ( receivers(SIGNAL(dataReceived(QString))) > 0 )
-    {
-        emit dataReceived( QString(data) );
-    }
-}
-
 /******************************************************************************
  * ComChannelSerial::onSendData
  *****************************************************************************/
@@ -691,15 +732,15 @@ void ComChannelSerial::onSendData( QString data, int responseWaitTime )
     if (m_port && m_port->isOpen() )
     {
         // Write data to port
-        m_port->write( data.toLocal8Bit().constData(), data.length() );
+        QByteArray request = data.toLocal8Bit();
+        m_port->write( request.constData(), request.length() );
 
-        // Emit data received event for local echo
-        emit dataReceived( data );
+        // Local echo in the traffic log
+        logData( request.constData(), request.length() );
 
         // Get reply from device
         char buffer[500];
-        memset( buffer, 0, sizeof(buffer) );
-        QString readString;
+        QByteArray readString;
 
         // Start a timer to measure how long command has been running
         QElapsedTimer timer;
@@ -725,17 +766,14 @@ void ComChannelSerial::onSendData( QString data, int responseWaitTime )
         while ( m_port->bytesAvailable() > 0 || m_port->waitForReadyRead( 50 ) ||
                 (readString == "\r\n" && timer.elapsed() <= responseWaitTime) )
         {
-            memset( buffer, 0, sizeof(buffer) );
             int result = static_cast<int>(m_port->read( buffer, sizeof(buffer) ));
 
             if ( result > 0 )
             {
-                readString.append( buffer );
+                readString.append( buffer, result );
+                logData( buffer, result );
             }
         }
-
-        // Emit data received event
-        emit dataReceived( readString );
     }
 }
 
@@ -787,6 +825,8 @@ void ComChannelRS232::ReOpen()
  *****************************************************************************/
 ComChannelRS4xx::ComChannelRS4xx( unsigned int dev_addr )
     : m_dev_addr( dev_addr )
+    , m_direction( DirectionAuto )
+    , m_lastReceive()
 {
     // register functions 
     int res = ctrl_channel_register( GetInstance(), this,
@@ -805,6 +845,41 @@ ComChannelRS4xx::ComChannelRS4xx( unsigned int dev_addr )
     }
 }
 
+/******************************************************************************
+ * ComChannelRS4xx::getTurnaroundTime
+ *****************************************************************************/
+qint64 ComChannelRS4xx::getTurnaroundTime() const
+{
+    qint64 ns = RS485_TURNAROUND_MIN_NS;
+
+    if ( getBaudRate() )
+    {
+        ns = qMax( ns, (Q_INT64_C(1000000000) * RS485_TURNAROUND_BITS) / getBaudRate() );
+    }
+
+    return ( ns );
+}
+
+/******************************************************************************
+ * ComChannelRS4xx::waitTurnaround
+ *****************************************************************************/
+void ComChannelRS4xx::waitTurnaround()
+{
+    if ( !m_lastReceive.isValid() )
+    {
+        return;
+    }
+
+    // usually the response has been evaluated in the meantime, so no wait is needed
+    qint64 remaining = getTurnaroundTime() - m_lastReceive.nsecsElapsed();
+    if ( remaining > 0 )
+    {
+        QThread::usleep( static_cast<unsigned long>((remaining + 999) / 1000) );
+    }
+
+    m_lastReceive.invalidate();
+}
+
 /******************************************************************************
  * ComChannelRS4xx::ReOpen
  *****************************************************************************/
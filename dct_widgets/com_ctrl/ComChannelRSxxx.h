@@ -25,6 +25,7 @@
 
 #include <QObject>
 #include <QSemaphore>
+#include <QElapsedTimer>
 
 #include <QtSerialPort/QtSerialPort>
 #include <QtSerialPort/QSerialPortInfo>
@@ -101,7 +102,7 @@ public:
         m_stop = stop;
     }
 
-    uint32_t getBaudRate() const
+    uint32_t getBaudRate() const override
     {
         return ( m_baudrate );
     }
@@ -139,8 +140,6 @@ public:
         return ( QString() );
     }
 
-    void emitDataRecieved( char const * data );
-
 public slots:
     void onSendData( QString data , int responseWaitTime ) override;
 
@@ -171,6 +170,13 @@ class ComChannelRS4xx: public ComChannelSerial
     Q_OBJECT
 
 public:
+    // who switches the bus transceiver of the host between sending and receiving
+    enum DirectionControl
+    {
+        DirectionAuto = 0,      /**< the adapter switches on its own (default) */
+        DirectionRts  = 1,      /**< RTS is raised while sending */
+    };
+
     explicit ComChannelRS4xx( unsigned int dev_addr = 1u );
     
     void ReOpen() override;
@@ -185,8 +191,32 @@ public:
         return ( m_dev_addr );
     }
 
+    DirectionControl getDirectionControl() const
+    {
+        return ( m_direction );
+    }
+
+    void setDirectionControl( DirectionControl direction )
+    {
+        m_direction = direction;
+    }
+
+    // time the transceivers need to switch direction at the current baudrate
+    qint64 getTurnaroundTime() const;
+
+    // wait until the bus has turned around after the last received data
+    void waitTurnaround();
+
+    // data has been received, the bus turns around from now on
+    void restartTurnaround()
+    {
+        m_lastReceive.start();
+    }
+
 private:
-    unsigned int m_dev_addr;
+    unsigned int        m_dev_addr;
+    DirectionControl    m_direction;        /**< direction control of the host transceiver */
+    QElapsedTimer       m_lastReceive;      /**< time since the last received data */
 };
 
 
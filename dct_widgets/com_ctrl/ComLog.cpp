@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    ComLog.cpp
+ *
+ * @brief   Implementation of the control channel traffic log
+ *
+ *****************************************************************************/
+#include <cstring>
+
+#include <QtGlobal>
+
+#include "ComLog.h"
+
+/******************************************************************************
+ * ComLog::ComLog
+ *****************************************************************************/
+ComLog::ComLog( int size )
+    : m_head( 0u )
+    , m_tail( 0u )
+{
+    int n = 1;
+    while ( n < size )
+    {
+        n <<= 1;
+    }
+
+    m_buffer.resize( n );
+    m_mask = static_cast<quint64>(n - 1);
+}
+
+/******************************************************************************
+ * ComLog::append
+ *****************************************************************************/
+void ComLog::append( const char * data, int len )
+{
+    if ( !data || (len <= 0) )
+    {
+        return;
+    }
+
+    // only the writer modifies m_head
+    quint64 head = m_head.loadAcquire();
+    quint64 end  = head + static_cast<quint64>(len);
+
+    // only the last size() bytes of a huge chunk survive anyway
+    if ( len > size() )
+    {
+        data += (len - size());
+        len   = size();
+    }
+
+    quint64 pos   = end - static_cast<quint64>(len);
+    int     idx   = static_cast<int>(pos & m_mask);
+    int     chunk = qMin( len, size() - idx );
+
+    memcpy( m_buffer.data() + idx, data, static_cast<size_t>(chunk) );
+    if ( chunk < len )
+    {
+        memcpy( m_buffer.data(), data + chunk, static_cast<size_t>(len - chunk) );
+    }
+
+    // publish the new data
+    m_head.storeRelease( end );
+}
+
+/******************************************************************************
+ * ComLog::first
+ *****************************************************************************/
+quint64 ComLog::first() const
+{
+    quint64 head   = m_head.loadAcquire();
+    quint64 oldest = (head > static_cast<quint64>(size())) ? (head - static_cast<quint64>(size())) : 0u;
+
+    return ( qMax( oldest, m_tail.loadAcquire() ) );
+}
+
+/******************************************************************************
+ * ComLog::read
+ *****************************************************************************/
+quint64 ComLog::read( quint64 pos, QByteArray & out, int max ) const
+{
+    quint64 head  = m_head.loadAcquire();
+    quint64 start = qMin( qMax( pos, first() ), head );
+    int     len   = static_cast<int>(qMin( head - start, static_cast<quint64>(qMax( max, 0 )) ));
+    int     idx   = static_cast<int>(start & m_mask);
+    int     chunk = qMin( len, size() - idx );
+
+    out.resize( len );
+    memcpy( out.data(), m_buffer.constData() + idx, static_cast<size_t>(chunk) );
+    if ( chunk < len )
+    {
+        memcpy( out.data() + chunk, m_buffer.constData(), static_cast<size_t>(len - chunk) );
+    }
+
+    // the writer may have wrapped over the copied range in the meantime
+    head = m_head.loadAcquire();
+    if ( head > static_cast<quint64>(size()) )
+    {
+        quint64 oldest = head - static_cast<quint64>(size());
+        if ( oldest > start )
+        {
+            out.remove( 0, static_cast<int>(qMin( oldest - start, static_cast<quint64>(len) )) );
+        }
+    }
+
+    return ( start + static_cast<quint64>(len) );
+}
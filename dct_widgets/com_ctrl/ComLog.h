@@ -0,0 +1,76 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    ComLog.h
+ *
+ * @brief   Bounded ring-buffer log of the raw control channel traffic
+ *
+ * @note    The log has one writer (the control channel) and any number of
+ *          readers which keep their own read position. Positions are
+ *          monotonic byte counters, the buffer holds the last size() bytes.
+ *          Writing never blocks and never allocates.
+ *
+ *****************************************************************************/
+#ifndef _COM_LOG_H_
+#define _COM_LOG_H_
+
+#include <QAtomicInteger>
+#include <QByteArray>
+
+#define COM_LOG_DEFAULT_SIZE    ( 1 << 20 )     /**< 1 MiB, roughly 10000 lines */
+
+class ComLog
+{
+public:
+    // size is rounded up to the next power of two
+    explicit ComLog( int size = COM_LOG_DEFAULT_SIZE );
+
+    int size() const
+    {
+        return ( m_buffer.size() );
+    }
+
+    // append raw channel data (writer side)
+    void append( const char * data, int len );
+
+    // position of the oldest byte still held in the log
+    quint64 first() const;
+
+    // position behind the newest byte
+    quint64 last() const
+    {
+        return ( m_head.loadAcquire() );
+    }
+
+    // copy up to max bytes starting at pos, returns the position behind the
+    // copied data (bytes already overwritten by the writer are skipped)
+    quint64 read( quint64 pos, QByteArray & out, int max ) const;
+
+    // drop all logged data
+    void clear()
+    {
+        m_tail.storeRelease( m_head.loadAcquire() );
+    }
+
+private:
+    QByteArray              m_buffer;   /**< ring-buffer memory */
+    quint64                 m_mask;     /**< m_buffer.size() - 1 */
+    QAtomicInteger<quint64> m_head;     /**< write position */
+    QAtomicInteger<quint64> m_tail;     /**< clear position */
+};
+
+#endif // _COM_LOG_H_
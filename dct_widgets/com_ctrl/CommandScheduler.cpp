@@ -0,0 +1,271 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    CommandScheduler.cpp
+ *
+ * @brief   Implementation of the set-command scheduler
+ *
+ *****************************************************************************/
+#include <cerrno>
+
+#include <QVector>
+
+#include <ctrl_protocol/ctrl_protocol_system.h>
+
+#include "CommandScheduler.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define SCHEDULER_CHUNK_SIZE        ( 16 )      // commands per progress step
+
+/******************************************************************************
+ * ordering rules, a batch holding a "first" command goes before a batch
+ * holding a "then" command (prefixes of the command line)
+ *****************************************************************************/
+static const struct
+{
+    const char *    first;
+    const char *    then;
+} orderRules[] =
+{
+    { "video_mode "     , "genlock"         },
+    { "sdi2 "           , "genlock"         },
+    { "lut_mode "       , "lut_sample"      },
+    { "lut_mode "       , "lut_write_addr"  },
+    { "lut_fixed_mode " , "lut_sample"      },
+    { "lut_preset "     , "lut_sample"      },
+    { "lut_preset "     , "lut_interpolate" },
+};
+
+#define NO_ORDER_RULES  ( static_cast<int>(sizeof(orderRules) / sizeof(orderRules[0])) )
+
+/******************************************************************************
+ * CommandScheduler::CommandScheduler
+ *****************************************************************************/
+CommandScheduler::CommandScheduler( ProVideoSystemItf * itf, QObject * parent )
+    : QObject( parent )
+    , m_itf( itf )
+    , m_active( false )
+    , m_linkError( false )
+    , m_queued( 0 )
+    , m_acked( 0 )
+{
+}
+
+/******************************************************************************
+ * CommandScheduler::~CommandScheduler
+ *****************************************************************************/
+CommandScheduler::~CommandScheduler()
+{
+    if ( m_active )
+    {
+        end();
+    }
+}
+
+/******************************************************************************
+ * CommandScheduler::begin
+ *****************************************************************************/
+void CommandScheduler::begin()
+{
+    m_batches.clear();
+    m_failed.clear();
+    m_linkError = false;
+    m_queued    = 0;
+    m_acked     = 0;
+
+    m_active = !ctrl_channel_set_defer( GET_CHANNEL_INSTANCE(m_itf), deferCommand, flushCommands, this );
+}
+
+/******************************************************************************
+ * CommandScheduler::beginBatch
+ *****************************************************************************/
+void CommandScheduler::beginBatch( const QString & source )
+{
+    Batch batch;
+    batch.source  = source;
+    batch.leads   = 0u;
+    batch.follows = 0u;
+
+    m_batches.append( batch );
+}
+
+/******************************************************************************
+ * CommandScheduler::deferCommand - called by the control channel
+ *****************************************************************************/
+int CommandScheduler::deferCommand( void * const priv, uint8_t const * const data, int const len, int const tmo_ms )
+{
+    CommandScheduler * s = static_cast<CommandScheduler *>( priv );
+
+    if ( s->m_batches.isEmpty() )
+    {
+        s->beginBatch( QString() );
+    }
+
+    Batch & batch = s->m_batches.last();
+
+    Command command;
+    command.cmd    = QByteArray( reinterpret_cast<const char *>(data), len );
+    command.tmo_ms = tmo_ms;
+
+    for ( int i = 0; i < NO_ORDER_RULES; i++ )
+    {
+        if ( command.cmd.startsWith( orderRules[i].first ) )
+        {
+            batch.leads |= (1u << i);
+        }
+        if ( command.cmd.startsWith( orderRules[i].then ) )
+        {
+            batch.follows |= (1u << i);
+        }
+    }
+
+    batch.commands.append( command );
+    s->m_queued++;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * CommandScheduler::flushCommands - called by the control channel before a
+ * request which is not deferred
+ *****************************************************************************/
+void CommandScheduler::flushCommands( void * const priv )
+{
+    static_cast<CommandScheduler *>( priv )->flush();
+}
+
+/******************************************************************************
+ * CommandScheduler::ordered - batches in dependency order, otherwise in the
+ * order they were collected
+ *****************************************************************************/
+QList<CommandScheduler::Batch> CommandScheduler::ordered() const
+{
+    QList<Batch> pending = m_batches;
+    QList<Batch> result;
+
+    while ( !pending.isEmpty() )
+    {
+        int next = 0;
+
+        // first batch which no other pending batch has to precede
+        for ( int i = 0; i < pending.size(); i++ )
+        {
+            bool blocked = false;
+            for ( int k = 0; k < pending.size() && !blocked; k++ )
+            {
+                blocked = ( k != i ) && ( pending[k].leads & pending[i].follows );
+            }
+
+            if ( !blocked )
+            {
+                next = i;
+                break;
+            }
+        }
+
+        // a cycle keeps the collected order
+        result.append( pending.takeAt( next ) );
+    }
+
+    return ( result );
+}
+
+/******************************************************************************
+ * CommandScheduler::flush
+ *****************************************************************************/
+void CommandScheduler::flush()
+{
+    if ( m_batches.isEmpty() )
+    {
+        return;
+    }
+
+    const QList<Batch> batches = ordered();
+    m_batches.clear();
+
+    QVector<ctrl_protocol_cmd_t> cmds;
+    QVector<int> source;
+    for ( int b = 0; b < batches.size(); b++ )
+    {
+        for ( int i = 0; i < batches[b].commands.size(); i++ )
+        {
+            const Command & c = batches[b].commands[i];
+
+            ctrl_protocol_cmd_t cmd;
+            cmd.cmd    = c.cmd.constData();
+            cmd.len    = c.cmd.size();
+            cmd.tmo_ms = c.tmo_ms;
+            cmd.res    = -EILSEQ;
+
+            cmds.append( cmd );
+            source.append( b );
+        }
+    }
+
+    // our own requests are sent directly
+    ctrl_channel_set_defer( GET_CHANNEL_INSTANCE(m_itf), nullptr, nullptr, nullptr );
+
+    for ( int first = 0; (first < cmds.size()) && !m_linkError; first += SCHEDULER_CHUNK_SIZE )
+    {
+        int n = qMin( SCHEDULER_CHUNK_SIZE, cmds.size() - first );
+
+        int res = ctrl_protocol_send_commands( GET_PROTOCOL_INSTANCE(m_itf),
+                        GET_CHANNEL_INSTANCE(m_itf), n, reinterpret_cast<uint8_t *>(&cmds[first]) );
+        if ( res < 0 )
+        {
+            // the device stopped answering, the rest is reported as failed
+            m_linkError = true;
+        }
+        else
+        {
+            m_acked += res;
+        }
+
+        emit progress( m_acked, m_queued );
+    }
+
+    for ( int i = 0; i < cmds.size(); i++ )
+    {
+        if ( cmds[i].res )
+        {
+            m_failed.append( QString( "%1: %2 (%3)" )
+                             .arg( batches[source[i]].source )
+                             .arg( QString::fromLatin1( cmds[i].cmd, cmds[i].len ).trimmed() )
+                             .arg( cmds[i].res ) );
+        }
+    }
+
+    if ( m_active )
+    {
+        ctrl_channel_set_defer( GET_CHANNEL_INSTANCE(m_itf), deferCommand, flushCommands, this );
+    }
+}
+
+/******************************************************************************
+ * CommandScheduler::end
+ *****************************************************************************/
+int CommandScheduler::end()
+{
+    flush();
+
+    ctrl_channel_set_defer( GET_CHANNEL_INSTANCE(m_itf), nullptr, nullptr, nullptr );
+    m_active = false;
+
+    return ( m_failed.size() );
+}
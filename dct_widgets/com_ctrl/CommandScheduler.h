@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    CommandScheduler.h
+ *
+ * @brief   Merges the set-commands of several widgets and pipelines them
+ *
+ * @note    Between begin() and end() the set-commands of all interfaces are
+ *          not sent but collected in batches, one batch per widget (see
+ *          beginBatch). On flush the batches are ordered by the known
+ *          dependencies between device commands, e.g. a video mode change
+ *          goes before genlock settings, and sent as pipelined stream.
+ *          Inside a batch the order of the widget is kept.
+ *
+ *          Any other request (a get-command) flushes the collected commands
+ *          first, so it reads the same state as with direct sending. Errors
+ *          of deferred commands are not reported by the interfaces, they are
+ *          collected in failed().
+ *
+ *****************************************************************************/
+#ifndef _COMMAND_SCHEDULER_H_
+#define _COMMAND_SCHEDULER_H_
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "ProVideoSystemItf.h"
+
+class CommandScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CommandScheduler( ProVideoSystemItf * itf, QObject * parent = nullptr );
+    ~CommandScheduler();
+
+    // start collecting set-commands
+    void begin();
+
+    // following set-commands belong to the batch of source
+    void beginBatch( const QString & source );
+
+    // send the collected commands, batches are not reordered across a flush
+    void flush();
+
+    // send the remaining commands and stop collecting, returns the number
+    // of failed commands
+    int end();
+
+    int queued() const
+    {
+        return ( m_queued );
+    }
+
+    int acked() const
+    {
+        return ( m_acked );
+    }
+
+    // failed commands as "source: command (error-code)"
+    QStringList failed() const
+    {
+        return ( m_failed );
+    }
+
+signals:
+    // sent while flushing, acked of queued commands are acknowledged
+    void progress( int acked, int queued );
+
+private:
+    struct Command
+    {
+        QByteArray  cmd;
+        int         tmo_ms;
+    };
+
+    struct Batch
+    {
+        QString         source;
+        QList<Command>  commands;
+        quint32         leads;      // rules this batch has to go first for
+        quint32         follows;    // rules this batch has to wait for
+    };
+
+    static int deferCommand( void * const priv, uint8_t const * const data, int const len, int const tmo_ms );
+    static void flushCommands( void * const priv );
+
+    QList<Batch> ordered() const;
+
+    ProVideoSystemItf * m_itf;
+    QList<Batch>        m_batches;
+    bool                m_active;
+    bool                m_linkError;
+    int                 m_queued;
+    int                 m_acked;
+    QStringList         m_failed;
+};
+
+#endif // _COMMAND_SCHEDULER_H_
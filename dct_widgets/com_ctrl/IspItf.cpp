@@ -985,3 +985,28 @@ void IspItf::onColorConversionMatrixRequested()
     GetColorConversionMatrix();
 }
 
+/******************************************************************************
+ * IspItf::onColorConversionMatrixSnapshotRequest
+ *****************************************************************************/
+void IspItf::onColorConversionMatrixSnapshotRequest( int chain )
+{
+    // Is there a signal listener
+    if ( receivers(SIGNAL(ColorConversionMatrixSnapshotChanged(int,int,int,int,int,int,int,int,int,int))) > 0 )
+    {
+        // matrix coefficients
+        int16_t c[NO_VALUES_COLOR_CONVERSION];
+
+        // get color conversion matrix of the addressed chain
+        int res = ctrl_protocol_get_color_conv(
+                        GET_PROTOCOL_INSTANCE(this), GET_CHANNEL_INSTANCE(this),
+                        NO_VALUES_COLOR_CONVERSION, c );
+        HANDLE_ERROR( res );
+
+        // emit a ColorConversionMatrixSnapshotChanged signal
+        emit ColorConversionMatrixSnapshotChanged( chain,
+                                                   (int)c[0], (int)c[1], (int)c[2],
+                                                   (int)c[3], (int)c[4], (int)c[5],
+                                                   (int)c[6], (int)c[7], (int)c[8] );
+    }
+}
+
@@ -133,6 +133,12 @@ signals:
                                        int c3, int c4, int c5,
                                        int c6, int c7, int c8 );
 
+    // yuv conversion of an addressed chain (settings snapshot)
+    void ColorConversionMatrixSnapshotChanged( int chain,
+                                               int c0, int c1, int c2,
+                                               int c3, int c4, int c5,
+                                               int c6, int c7, int c8 );
+
     // color space
     void ColorSpaceChanged( int value );
 
@@ -187,6 +193,7 @@ public slots:
                                         int c6, int c7, int c8 );
 
     void onColorConversionMatrixRequested();
+    void onColorConversionMatrixSnapshotRequest( int chain );
 
     // color space
     void onColorSpaceChange( int value );
@@ -30,27 +30,226 @@
 
 #include <QtDebug>
 
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// values read on resync
+#define LENS_STATE_RESYNC                                       \
+    ( CTRL_PROTOCOL_LENS_STATE_SETTINGS                         \
+    | CTRL_PROTOCOL_LENS_STATE_ACTIVE                           \
+    | CTRL_PROTOCOL_LENS_STATE_INVERT                           \
+    | CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION                   \
+    | CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS                       \
+    | CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION                    \
+    | CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION                    \
+    | CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION                  \
+    | CTRL_PROTOCOL_LENS_STATE_IRIS_SETUP                       \
+    | CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS                   \
+    | CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS                    \
+    | CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS                    \
+    | CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS )
+
+// values read on a small resync
+#define LENS_STATE_SMALL_RESYNC                                 \
+    ( CTRL_PROTOCOL_LENS_STATE_INVERT                           \
+    | CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION                   \
+    | CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION                    \
+    | CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION                    \
+    | CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION                  \
+    | CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS                   \
+    | CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS                       \
+    | CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS                    \
+    | CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS                    \
+    | CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS )
+
+// size of a position follow poll on the wire, three times
+// "lens_driver_focus_position\n" + "lens_driver_focus_position 1000\r\nOK\r\n"
+#define POSITION_FOLLOW_BYTES           ( 3 * 72 )
+
+// bits per transmitted character (start + 8 data + stop)
+#define POSITION_FOLLOW_BITS_PER_BYTE   ( 10 )
+
+// maximal share of the link bandwidth used while a motor moves (in percent)
+#define POSITION_FOLLOW_LINK_SHARE      ( 25 )
+
+// lens state flag of a value if its signal has a listener
+#define LISTENED( sig, flag )           ( (receivers(SIGNAL(sig)) > 0) ? (flag) : 0u )
+
+// limits of the position follow interval (in ms)
+#define POSITION_FOLLOW_MIN_INTERVAL    ( 50 )
+#define POSITION_FOLLOW_MAX_INTERVAL    ( 500 )
+
+/******************************************************************************
+ * toVector - convert a value array of a lens state
+ *****************************************************************************/
+static QVector<int> toVector( const int32_t * values, int no )
+{
+    QVector<int> v( no );
+    for ( int i = 0; i < no; i++ )
+    {
+        v[i] = values[i];
+    }
+
+    return ( v );
+}
+
 /******************************************************************************
  * LensItf::resync()
  *****************************************************************************/
 void LensItf::resync()
 {
-    GetLensSettings();
-    GetLensActive();
-    GetLensInvert();
+    // one pipelined readout, values it did not deliver are read one by one
+    uint32_t valid = GetLensState( LENS_STATE_RESYNC );
+
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_SETTINGS) )         GetLensSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_ACTIVE) )           GetLensActive();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_INVERT) )           GetLensInvert();
+
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION) )   GetLensFocusPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS) )       GetLensFineFocus();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION) )    GetLensZoomPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION) )    GetLensIrisPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION) )  GetLensFilterPosition();
 
-    GetLensFocusPosition();
-    GetLensFineFocus();
-    GetLensZoomPosition();
-    GetLensIrisPosition();
-    GetLensFilterPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_IRIS_SETUP) )       GetLensIrisSetup();
 
-    GetLensIrisSetup();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS) )   GetLensFocusSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS) )    GetLensZoomSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS) )    GetLensIrisSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS) )  GetLensFilterSettings();
 
-    GetLensFocusSettings();
-    GetLensZoomSettings();
-    GetLensIrisSettings();
-    GetLensFilterSettings();
+    GetLensPositionFollowInterval();
+}
+
+/******************************************************************************
+ * LensItf::GetLensState
+ *****************************************************************************/
+uint32_t LensItf::GetLensState( uint32_t request )
+{
+    ctrl_protocol_lens_state_t state;
+
+    memset( &state, 0, sizeof(state) );
+
+    // only values with a signal listener are read
+    state.request = LISTENED( LensSettingsChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_SETTINGS )
+                  | LISTENED( LensActiveChanged(bool), CTRL_PROTOCOL_LENS_STATE_ACTIVE )
+                  | LISTENED( LensInvertChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_INVERT )
+                  | LISTENED( LensFocusPositionChanged(int), CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION )
+                  | LISTENED( LensFocusFineChanged(bool), CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS )
+                  | LISTENED( LensZoomPositionChanged(int), CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION )
+                  | LISTENED( LensIrisPositionChanged(int), CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION )
+                  | LISTENED( LensFilterPositionChanged(int), CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION )
+                  | LISTENED( LensIrisApertureChanged(int), CTRL_PROTOCOL_LENS_STATE_IRIS_APERTURE )
+                  | LISTENED( LensIrisSetupChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_IRIS_SETUP )
+                  | LISTENED( LensFocusSettingsChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS )
+                  | LISTENED( LensZoomSettingsChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS )
+                  | LISTENED( LensIrisSettingsChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS )
+                  | LISTENED( LensFilterSettingsChanged(QVector<int>), CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS );
+
+    state.request &= request;
+    if ( !state.request )
+    {
+        return ( 0u );
+    }
+
+    // no error popup, the caller reads missing values one by one
+    int res = ctrl_protocol_get_lens_state( GET_PROTOCOL_INSTANCE(this),
+                GET_CHANNEL_INSTANCE(this), sizeof(state), (uint8_t *)&state );
+    if ( res )
+    {
+        return ( 0u );
+    }
+
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_SETTINGS )
+    {
+        emit LensSettingsChanged( toVector( state.settings, NO_VALUES_LENS_SETTINGS ) );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_ACTIVE )
+    {
+        emit LensActiveChanged( state.active == 1 );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_INVERT )
+    {
+        emit LensInvertChanged( toVector( state.invert, NO_VALUES_LENS_INVERT ) );
+    }
+
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION )
+    {
+        m_FocusPosition = state.focus_position;
+        emit LensFocusPositionChanged( state.focus_position );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS )
+    {
+        emit LensFocusFineChanged( state.fine_focus == 1 );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION )
+    {
+        m_ZoomPosition = state.zoom_position;
+        emit LensZoomPositionChanged( state.zoom_position );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION )
+    {
+        m_IrisPosition = state.iris_position;
+        emit LensIrisPositionChanged( state.iris_position );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION )
+    {
+        emit LensFilterPositionChanged( state.filter_position );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_IRIS_APERTURE )
+    {
+        emit LensIrisApertureChanged( state.iris_aperture );
+    }
+
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_IRIS_SETUP )
+    {
+        emit LensIrisSetupChanged( toVector( state.iris_setup, NO_VALUES_LENS_IRIS_SETUP ) );
+    }
+
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS )
+    {
+        emit LensFocusSettingsChanged( toVector( state.focus_settings, NO_VALUES_LENS_FOCUS_SETTINGS ) );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS )
+    {
+        emit LensZoomSettingsChanged( toVector( state.zoom_settings, NO_VALUES_LENS_ZOOM_SETTINGS ) );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS )
+    {
+        emit LensIrisSettingsChanged( toVector( state.iris_settings, NO_VALUES_LENS_IRIS_SETTINGS ) );
+    }
+    if ( state.valid & CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS )
+    {
+        emit LensFilterSettingsChanged( toVector( state.filter_settings, NO_VALUES_LENS_FILTER_SETTINGS ) );
+    }
+
+    return ( state.valid );
+}
+
+/******************************************************************************
+ * LensItf::GetLensPositionFollowInterval
+ *****************************************************************************/
+void LensItf::GetLensPositionFollowInterval()
+{
+    // Is there a signal listener
+    if ( receivers(SIGNAL(LensPositionFollowIntervalChanged(int))) > 0 )
+    {
+        int interval = POSITION_FOLLOW_MIN_INTERVAL;
+
+        // Spend at most POSITION_FOLLOW_LINK_SHARE percent of the link on
+        // position polls while a motor moves.
+        uint32_t baudrate = GetComChannel()->getBaudRate();
+        if ( baudrate > 0u )
+        {
+            uint32_t rtt = (POSITION_FOLLOW_BYTES * POSITION_FOLLOW_BITS_PER_BYTE * 1000u) / baudrate;
+            interval = static_cast<int>((rtt * 100u) / POSITION_FOLLOW_LINK_SHARE);
+        }
+
+        interval = qBound( POSITION_FOLLOW_MIN_INTERVAL, interval, POSITION_FOLLOW_MAX_INTERVAL );
+
+        // emit a LensPositionFollowIntervalChanged signal
+        emit LensPositionFollowIntervalChanged( interval );
+    }
 }
 
 /******************************************************************************
@@ -157,6 +356,8 @@ void LensItf::GetLensFocusPosition()
 
 
 
+        m_FocusPosition = value;
+
         // emit a IrisSetupChanged signal
         emit LensFocusPositionChanged( value );
     }
@@ -202,6 +403,8 @@ void LensItf::GetLensZoomPosition()
 
 
 
+        m_ZoomPosition = value;
+
         // emit a IrisSetupChanged signal
         emit LensZoomPositionChanged( value );
     }
@@ -226,6 +429,8 @@ void LensItf::GetLensIrisPosition()
 
 
 
+        m_IrisPosition = value;
+
         // emit a IrisSetupChanged signal
         emit LensIrisPositionChanged( value );
     }
@@ -677,17 +882,72 @@ void LensItf::onLensFilterSettingsChange( QVector<int> values )
  *****************************************************************************/
 void LensItf::onSmallResyncRequest( void )
 {
-    GetLensInvert();
-    GetLensFocusPosition();
-    GetLensZoomPosition();
-    GetLensIrisPosition();
-    GetLensFilterPosition();
-
-    GetLensFocusSettings();
-    GetLensFineFocus();
-    GetLensZoomSettings();
-    GetLensIrisSettings();
-    GetLensFilterSettings();
+    uint32_t valid = GetLensState( LENS_STATE_SMALL_RESYNC );
+
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_INVERT) )           GetLensInvert();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION) )   GetLensFocusPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION) )    GetLensZoomPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION) )    GetLensIrisPosition();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION) )  GetLensFilterPosition();
+
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS) )   GetLensFocusSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS) )       GetLensFineFocus();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS) )    GetLensZoomSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS) )    GetLensIrisSettings();
+    if ( !(valid & CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS) )  GetLensFilterSettings();
+}
+
+/******************************************************************************
+ * LensItf::onLensPositionFollowRequest
+ *****************************************************************************/
+void LensItf::onLensPositionFollowRequest( void )
+{
+    ctrl_protocol_lens_state_t state;
+
+    memset( &state, 0, sizeof(state) );
+    state.request = CTRL_PROTOCOL_LENS_STATE_POSITIONS;
+
+    int res = ctrl_protocol_get_lens_state( GET_PROTOCOL_INSTANCE(this),
+                GET_CHANNEL_INSTANCE(this), sizeof(state), (uint8_t *)&state );
+    if ( res == -EOPNOTSUPP )
+    {
+        // driver without pipelined readout
+        if ( !ctrl_protocol_get_lens_focus_position( GET_PROTOCOL_INSTANCE(this),
+                    GET_CHANNEL_INSTANCE(this), &state.focus_position ) )
+        {
+            state.valid |= CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION;
+        }
+        if ( !ctrl_protocol_get_lens_zoom_position( GET_PROTOCOL_INSTANCE(this),
+                    GET_CHANNEL_INSTANCE(this), &state.zoom_position ) )
+        {
+            state.valid |= CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION;
+        }
+        if ( !ctrl_protocol_get_lens_iris_position( GET_PROTOCOL_INSTANCE(this),
+                    GET_CHANNEL_INSTANCE(this), &state.iris_position ) )
+        {
+            state.valid |= CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION;
+        }
+    }
+
+    // A failed poll shows no error, the next poll picks up the position.
+    // Only moved motors are reported, so the widgets repaint once per step.
+    if ( (state.valid & CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION) && (state.focus_position != m_FocusPosition) )
+    {
+        m_FocusPosition = state.focus_position;
+        emit LensFocusPositionChanged( state.focus_position );
+    }
+
+    if ( (state.valid & CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION) && (state.zoom_position != m_ZoomPosition) )
+    {
+        m_ZoomPosition = state.zoom_position;
+        emit LensZoomPositionChanged( state.zoom_position );
+    }
+
+    if ( (state.valid & CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION) && (state.iris_position != m_IrisPosition) )
+    {
+        m_IrisPosition = state.iris_position;
+        emit LensIrisPositionChanged( state.iris_position );
+    }
 }
 
 
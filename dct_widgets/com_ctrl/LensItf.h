@@ -35,12 +35,22 @@ class LensItf : public ProVideoItf
 
 public:
     explicit LensItf( ComChannel * c, ComProtocol * p )
-        : ProVideoItf( c, p )
+        : ProVideoItf( c, p ),
+          m_FocusPosition( -1 ),
+          m_ZoomPosition( -1 ),
+          m_IrisPosition( -1 )
     { }
  
     // resync all settings
     void resync() override;
 
+    // read all listened values in pipelined batches, returns the values
+    // which were read (CTRL_PROTOCOL_LENS_STATE_*)
+    uint32_t GetLensState( uint32_t request );
+
+    // motor position poll interval while a lens motor moves
+    void GetLensPositionFollowInterval();
+
     void GetLensSettings();
     void GetLensActive();
     void GetLensInvert();
@@ -78,6 +88,8 @@ signals:
     void LensIrisSetupChanged( QVector<int> values );
     void LensFilterSettingsChanged( QVector<int> values );
 
+    void LensPositionFollowIntervalChanged( int ms );
+
 public slots:
     void onLensSettingsChange( QVector<int> values );
     void onLensActiveChange( bool active );
@@ -97,6 +109,12 @@ public slots:
     void onLensFilterSettingsChange( QVector<int> values );
 
     void onSmallResyncRequest(void);
+    void onLensPositionFollowRequest(void);
+
+private:
+    int32_t m_FocusPosition;    // last reported motor positions, -1 if unknown
+    int32_t m_ZoomPosition;
+    int32_t m_IrisPosition;
 };
 
 #endif // _LENS_INTERFACE_H_
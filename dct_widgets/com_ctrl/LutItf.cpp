@@ -37,6 +37,10 @@
  *****************************************************************************/
 void LutItf::resync()
 {
+    // a resync may follow a device change, drop all cached tables
+    m_cache.preset = -1;
+    invalidateLutPreset( -1 );
+
     // enable status for each chain
     /* Note: On some devices not all chains will be available, in this case GetLutEnable
      * will report an error, but that is no problem */
@@ -181,6 +185,8 @@ void LutItf::GetLutPreset()
         int res = ctrl_protocol_get_lut_preset( GET_PROTOCOL_INSTANCE(this),
             GET_CHANNEL_INSTANCE(this), &value );
         HANDLE_ERROR( res );
+
+        m_cache.preset = static_cast<int>(value);
         
         // emit a LutPresetChanged signal
         emit LutPresetChanged( static_cast<int>(value) );
@@ -273,24 +279,13 @@ void LutItf::GetLutSampleValuesRed()
     // Is there a signal listener
     if ( receivers(SIGNAL(LutSampleValuesRedChanged(QVector<int>, QVector<int>))) > 0 )
     {
-        ctrl_protocol_samples_t v;
-
-        memset( &v, 0, sizeof(v) );
-        v.no = MAX_NO_SAMPLE_POINTS;
+        QVector<int> x;
+        QVector<int> y;
 
         // read red samples from device
-        int res = ctrl_protocol_get_lut_sample_red( GET_PROTOCOL_INSTANCE(this),
-            GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+        int res = readLutSamples( Red, x, y );
         HANDLE_ERROR( res );
-        
-        QVector<int> x( static_cast<int>(v.no) );
-        QVector<int> y( static_cast<int>(v.no) );
-        for( int i = 0u; i < static_cast<int>(v.no); i++ )
-        {
-            x[i] = static_cast<unsigned short>(v.x_i[i]);
-            y[i] = static_cast<unsigned short>(v.y_i[i]);
-        }
-        
+
         // emit a LutSampleValuesRedChanged signal
         emit LutSampleValuesRedChanged( x, y );
     }
@@ -304,24 +299,13 @@ void LutItf::GetLutSampleValuesGreen()
     // Is there a signal listener
     if ( receivers(SIGNAL(LutSampleValuesGreenChanged(QVector<int>, QVector<int>))) > 0 )
     {
-        ctrl_protocol_samples_t v;
-
-        memset( &v, 0, sizeof(v) );
-        v.no = MAX_NO_SAMPLE_POINTS;
+        QVector<int> x;
+        QVector<int> y;
 
         // read green samples from device
-        int res = ctrl_protocol_get_lut_sample_green( GET_PROTOCOL_INSTANCE(this),
-            GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+        int res = readLutSamples( Green, x, y );
         HANDLE_ERROR( res );
-        
-        QVector<int> x( static_cast<int>(v.no) );
-        QVector<int> y( static_cast<int>(v.no) );
-        for( int i = 0u; i < static_cast<int>(v.no); i++ )
-        {
-            x[i] = static_cast<unsigned short>(v.x_i[i]);
-            y[i] = static_cast<unsigned short>(v.y_i[i]);
-        }
-        
+
         // emit a LutSampleValuesGreenChanged signal
         emit LutSampleValuesGreenChanged( x, y );
     }
@@ -335,24 +319,13 @@ void LutItf::GetLutSampleValuesBlue()
     // Is there a signal listener
     if ( receivers(SIGNAL(LutSampleValuesBlueChanged(QVector<int>, QVector<int>))) > 0 )
     {
-        ctrl_protocol_samples_t v;
-
-        memset( &v, 0, sizeof(v) );
-        v.no = MAX_NO_SAMPLE_POINTS;
+        QVector<int> x;
+        QVector<int> y;
 
         // read blue samples from device
-        int res = ctrl_protocol_get_lut_sample_blue( GET_PROTOCOL_INSTANCE(this),
-            GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+        int res = readLutSamples( Blue, x, y );
         HANDLE_ERROR( res );
-        
-        QVector<int> x( static_cast<int>(v.no) );
-        QVector<int> y( static_cast<int>(v.no) );
-        for( int i = 0u; i < static_cast<int>(v.no); i++ )
-        {
-            x[i] = static_cast<unsigned short>(v.x_i[i]);
-            y[i] = static_cast<unsigned short>(v.y_i[i]);
-        }
-        
+
         // emit a LutSampleValuesBlueChanged signal
         emit LutSampleValuesBlueChanged( x, y );
     }
@@ -366,25 +339,14 @@ void LutItf::GetLutSampleValuesMaster()
     // Is there a signal listener
     if ( receivers(SIGNAL(LutSampleValuesMasterChanged(QVector<int>, QVector<int>))) > 0 )
     {
-        ctrl_protocol_samples_t v;
+        QVector<int> x;
+        QVector<int> y;
 
-        memset( &v, 0, sizeof(v) );
-        v.no = MAX_NO_SAMPLE_POINTS;
-
-        // read blue samples from device
-        int res = ctrl_protocol_get_lut_sample_master( GET_PROTOCOL_INSTANCE(this),
-            GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+        // read master samples from device
+        int res = readLutSamples( Master, x, y );
         HANDLE_ERROR( res );
-        
-        QVector<int> x( static_cast<int>(v.no) );
-        QVector<int> y( static_cast<int>(v.no) );
-        for( int i = 0u; i < static_cast<int>(v.no); i++ )
-        {
-            x[i] = static_cast<unsigned short>(v.x_i[i]);
-            y[i] = static_cast<unsigned short>(v.y_i[i]);
-        }
 
-        // emit a LutSampleValuesBlueChanged signal
+        // emit a LutSampleValuesMasterChanged signal
         emit LutSampleValuesMasterChanged( x, y );
     }
 }
@@ -481,6 +443,9 @@ void LutItf::onLogModeChange( int mode )
      * current lut mode and lut fixed mode. */
     if ( res == 0 )
     {
+        // LOG mode may load other tables, drop all cached tables
+        invalidateLutPreset( -1 );
+
         // Notify other interfaces that LOG mode got changed
         emit NotifyLogModeChanged();
 
@@ -517,6 +482,8 @@ void LutItf::onLutPresetChange( int value )
     int res = ctrl_protocol_set_lut_preset( GET_PROTOCOL_INSTANCE(this),
         GET_CHANNEL_INSTANCE(this), static_cast<uint8_t>(value) );
     HANDLE_ERROR( res );
+
+    m_cache.preset = value;
     
     // sync sample data 
     GetLutSampleValuesMaster();
@@ -595,6 +562,9 @@ void LutItf::onLutRec709Change
         GET_CHANNEL_INSTANCE(this), sizeof(ctrl_protocol_rec709_t), reinterpret_cast<uint8_t *>(&values) );
     HANDLE_ERROR( res );
 
+    // device computes new samples for the active preset
+    invalidateLutPreset( m_cache.preset );
+
     // sync sample data 
     //GetLutSampleValuesRed();
     //GetLutSampleValuesGreen();
@@ -629,6 +599,8 @@ void LutItf::onLutSampleValuesChange( QVector<int> x, QVector<int> y )
         res = ctrl_protocol_set_lut_sample( GET_PROTOCOL_INSTANCE(this),
             GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
         HANDLE_ERROR( res );
+
+        invalidateLutPreset( m_cache.preset );
     }
 }
 
@@ -659,6 +631,8 @@ void LutItf::onLutSampleValuesRedChange( QVector<int> x, QVector<int> y )
         res = ctrl_protocol_set_lut_sample_red( GET_PROTOCOL_INSTANCE(this),
             GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
         HANDLE_ERROR( res );
+
+        cacheLutSamples( Red, x, y );
     }
 }
 
@@ -689,6 +663,8 @@ void LutItf::onLutSampleValuesGreenChange( QVector<int> x, QVector<int> y )
         res = ctrl_protocol_set_lut_sample_green( GET_PROTOCOL_INSTANCE(this),
             GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
         HANDLE_ERROR( res );
+
+        cacheLutSamples( Green, x, y );
     }
 }
 
@@ -719,6 +695,8 @@ void LutItf::onLutSampleValuesBlueChange( QVector<int> x, QVector<int> y )
         res = ctrl_protocol_set_lut_sample_blue( GET_PROTOCOL_INSTANCE(this),
             GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
         HANDLE_ERROR( res );
+
+        cacheLutSamples( Blue, x, y );
     }
 }
 
@@ -749,6 +727,8 @@ void LutItf::onLutSampleValuesMasterChange( QVector<int> x, QVector<int> y )
         res = ctrl_protocol_set_lut_sample_master( GET_PROTOCOL_INSTANCE(this),
             GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
         HANDLE_ERROR( res );
+
+        cacheLutSamples( Master, x, y );
     }
 }
 
@@ -784,6 +764,96 @@ void LutItf::onLutSampleValuesMasterRequest()
     GetLutSampleValuesMaster();
 }
 
+/******************************************************************************
+ * LutItf::onLutPresetSampleValuesRequest
+ *****************************************************************************/
+void LutItf::onLutPresetSampleValuesRequest( int preset )
+{
+    if ( (preset < 0) || (preset >= LUT_ITF_NO_PRESETS) )
+    {
+        return;
+    }
+
+    // Is there a signal listener
+    if ( receivers(SIGNAL(LutPresetSampleValuesChanged(int, int, QVector<int>, QVector<int>))) <= 0 )
+    {
+        return;
+    }
+
+    int res = readLutPreset( preset );
+    HANDLE_ERROR( res );
+
+    for ( int ch = Master; ch < LutChannelMax; ch++ )
+    {
+        // emit a LutPresetSampleValuesChanged signal
+        emit LutPresetSampleValuesChanged( preset, ch,
+                m_cache.samples[preset][ch].x, m_cache.samples[preset][ch].y );
+    }
+}
+
+/******************************************************************************
+ * LutItf::onLutSnapshotRequest
+ *****************************************************************************/
+void LutItf::onLutSnapshotRequest( int chain )
+{
+    // Is there a signal listener
+    if ( receivers(SIGNAL(LutSnapshotChanged(int,int,int,int,int))) <= 0 )
+    {
+        return;
+    }
+
+    // the addressed chain has its own presets, keep the cache of the active chain
+    LutCache active = m_cache;
+    m_cache = LutCache();
+
+    uint8_t mode       = 0u;
+    uint8_t fixed_mode = 0u;
+    uint8_t preset     = 0u;
+    int16_t gamma      = 0;
+
+    int res = ctrl_protocol_get_lut_mode( GET_PROTOCOL_INSTANCE(this),
+        GET_CHANNEL_INSTANCE(this), &mode );
+    if ( !res )
+    {
+        res = ctrl_protocol_get_lut_fixed_mode( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &fixed_mode );
+    }
+    if ( !res )
+    {
+        res = ctrl_protocol_get_lut_preset( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &preset );
+        m_cache.preset = static_cast<int>(preset);
+    }
+    if ( !res )
+    {
+        res = ctrl_protocol_get_lut_fast_gamma( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &gamma );
+    }
+
+    if ( !res )
+    {
+        // emit a LutSnapshotChanged signal
+        emit LutSnapshotChanged( chain, static_cast<int>(mode), static_cast<int>(fixed_mode),
+                                 static_cast<int>(preset), static_cast<int>(gamma) );
+    }
+
+    for ( int p = 0; (p < LUT_ITF_NO_PRESETS) && !res; p++ )
+    {
+        res = readLutPreset( p );
+
+        for ( int ch = Master; (ch < LutChannelMax) && !res; ch++ )
+        {
+            // emit a LutSnapshotSampleValuesChanged signal
+            emit LutSnapshotSampleValuesChanged( chain, p, ch,
+                    m_cache.samples[p][ch].x, m_cache.samples[p][ch].y );
+        }
+    }
+
+    m_cache = active;
+
+    HANDLE_ERROR( res );
+}
+
 /******************************************************************************
  * LutItf::onLutInterpolate
  *****************************************************************************/
@@ -838,6 +908,8 @@ void LutItf::onLutReset( void )
         GET_CHANNEL_INSTANCE(this) );
     HANDLE_ERROR( res );
 
+    invalidateLutPreset( m_cache.preset );
+
     // sync sample data 
     GetLutSampleValuesRed();
     GetLutSampleValuesGreen();
@@ -854,6 +926,8 @@ void LutItf::onLutResetRed( void )
         GET_CHANNEL_INSTANCE(this) );
     HANDLE_ERROR( res );
 
+    invalidateLutSamples( Red );
+
     // sync sample data 
     GetLutSampleValuesRed();
 }
@@ -868,6 +942,8 @@ void LutItf::onLutResetGreen( void )
         GET_CHANNEL_INSTANCE(this) );
     HANDLE_ERROR( res );
 
+    invalidateLutSamples( Green );
+
     // sync sample data 
     GetLutSampleValuesGreen();
 }
@@ -882,6 +958,8 @@ void LutItf::onLutResetBlue( void )
         GET_CHANNEL_INSTANCE(this) );
     HANDLE_ERROR( res );
 
+    invalidateLutSamples( Blue );
+
     // sync sample data 
     GetLutSampleValuesBlue();
 }
@@ -896,6 +974,8 @@ void LutItf::onLutResetMaster( void )
         GET_CHANNEL_INSTANCE(this) );
     HANDLE_ERROR( res );
 
+    invalidateLutSamples( Master );
+
     // sync sample data 
     GetLutSampleValuesMaster();
 }
@@ -909,6 +989,8 @@ void LutItf::LutResetMasterSettingsMode( void )
     int res = ctrl_protocol_set_lut_reset_master( GET_PROTOCOL_INSTANCE(this),
         GET_CHANNEL_INSTANCE(this) );
     HANDLE_ERROR( res );
+
+    invalidateLutSamples( Master );
 }
 
 /******************************************************************************
@@ -921,3 +1003,184 @@ void LutItf::onLutFastGammaChange( int gamma )
         GET_CHANNEL_INSTANCE(this), static_cast<int16_t>(gamma) );
     HANDLE_ERROR( res );
 }
+
+/******************************************************************************
+ * LutItf::readLutSamples
+ *****************************************************************************/
+int LutItf::readLutSamples( LutChannel ch, QVector<int> & x, QVector<int> & y )
+{
+    ctrl_protocol_samples_t v;
+    int res;
+
+    memset( &v, 0, sizeof(v) );
+    v.no = MAX_NO_SAMPLE_POINTS;
+
+    // read samples of the active preset from device
+    switch ( ch )
+    {
+        case Red:
+            res = ctrl_protocol_get_lut_sample_red( GET_PROTOCOL_INSTANCE(this),
+                GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+            break;
+
+        case Green:
+            res = ctrl_protocol_get_lut_sample_green( GET_PROTOCOL_INSTANCE(this),
+                GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+            break;
+
+        case Blue:
+            res = ctrl_protocol_get_lut_sample_blue( GET_PROTOCOL_INSTANCE(this),
+                GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+            break;
+
+        default:
+            res = ctrl_protocol_get_lut_sample_master( GET_PROTOCOL_INSTANCE(this),
+                GET_CHANNEL_INSTANCE(this), sizeof(v), reinterpret_cast<uint8_t *>(&v) );
+            break;
+    }
+
+    if ( res )
+    {
+        return ( res );
+    }
+
+    x.resize( static_cast<int>(v.no) );
+    y.resize( static_cast<int>(v.no) );
+    for( int i = 0u; i < static_cast<int>(v.no); i++ )
+    {
+        x[i] = static_cast<unsigned short>(v.x_i[i]);
+        y[i] = static_cast<unsigned short>(v.y_i[i]);
+    }
+
+    cacheLutSamples( ch, x, y );
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * LutItf::readLutPreset
+ *****************************************************************************/
+int LutItf::readLutPreset( int preset )
+{
+    int res = 0;
+
+    if ( isLutPresetCached( preset ) )
+    {
+        return ( 0 );
+    }
+
+    if ( m_cache.preset < 0 )
+    {
+        uint8_t value = 0u;
+
+        // read active preset number from device
+        res = ctrl_protocol_get_lut_preset( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), &value );
+        if ( res )
+        {
+            return ( res );
+        }
+
+        m_cache.preset = static_cast<int>(value);
+    }
+
+    int active = m_cache.preset;
+
+    /* Note: The protocol has no command to read an inactive preset, so
+     * an uncached preset is loaded once without notifying the widgets and
+     * the active preset is restored immediately. Afterwards the preset is
+     * served from the cache, which is kept up to date by all writes. */
+    if ( preset != active )
+    {
+        res = ctrl_protocol_set_lut_preset( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), static_cast<uint8_t>(preset) );
+        if ( res )
+        {
+            return ( res );
+        }
+
+        m_cache.preset = preset;
+    }
+
+    for ( int ch = Master; (ch < LutChannelMax) && !res; ch++ )
+    {
+        if ( !m_cache.samples[preset][ch].valid )
+        {
+            QVector<int> x;
+            QVector<int> y;
+
+            res = readLutSamples( static_cast<LutChannel>(ch), x, y );
+        }
+    }
+
+    if ( preset != active )
+    {
+        int res_restore = ctrl_protocol_set_lut_preset( GET_PROTOCOL_INSTANCE(this),
+            GET_CHANNEL_INSTANCE(this), static_cast<uint8_t>(active) );
+        m_cache.preset = res_restore ? -1 : active;
+        if ( res_restore )
+        {
+            return ( res_restore );
+        }
+    }
+
+    return ( res );
+}
+
+/******************************************************************************
+ * LutItf::cacheLutSamples
+ *****************************************************************************/
+void LutItf::cacheLutSamples( LutChannel ch, const QVector<int> & x, const QVector<int> & y )
+{
+    // samples belong to the active preset
+    if ( (m_cache.preset >= 0) && (m_cache.preset < LUT_ITF_NO_PRESETS) )
+    {
+        m_cache.samples[m_cache.preset][ch].valid = true;
+        m_cache.samples[m_cache.preset][ch].x     = x;
+        m_cache.samples[m_cache.preset][ch].y     = y;
+    }
+}
+
+/******************************************************************************
+ * LutItf::invalidateLutSamples
+ *****************************************************************************/
+void LutItf::invalidateLutSamples( LutChannel ch )
+{
+    if ( (m_cache.preset >= 0) && (m_cache.preset < LUT_ITF_NO_PRESETS) )
+    {
+        m_cache.samples[m_cache.preset][ch].valid = false;
+    }
+}
+
+/******************************************************************************
+ * LutItf::invalidateLutPreset (-1 invalidates all presets)
+ *****************************************************************************/
+void LutItf::invalidateLutPreset( int preset )
+{
+    for ( int i = 0; i < LUT_ITF_NO_PRESETS; i++ )
+    {
+        if ( (preset < 0) || (preset == i) )
+        {
+            for ( int ch = Master; ch < LutChannelMax; ch++ )
+            {
+                m_cache.samples[i][ch].valid = false;
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * LutItf::isLutPresetCached
+ *****************************************************************************/
+bool LutItf::isLutPresetCached( int preset ) const
+{
+    for ( int ch = Master; ch < LutChannelMax; ch++ )
+    {
+        if ( !m_cache.samples[preset][ch].valid )
+        {
+            return ( false );
+        }
+    }
+
+    return ( true );
+}
@@ -30,11 +30,23 @@
 
 #include "ProVideoItf.h"
 
+#define LUT_ITF_NO_PRESETS      ( 5 )
+
 class LutItf : public ProVideoItf
 {
     Q_OBJECT
 
 public:
+    // sample tables, same order as in LutBox
+    enum LutChannel
+    {
+        Master = 0,
+        Red = 1,
+        Green = 2,
+        Blue = 3,
+        LutChannelMax
+    };
+
     explicit LutItf( ComChannel * c, ComProtocol * p )
         : ProVideoItf( c, p )
     { }
@@ -100,6 +112,13 @@ signals:
     void LutSampleValuesBlueChanged( QVector<int> x, QVector<int> y );
     void LutSampleValuesMasterChanged( QVector<int> x, QVector<int> y );
 
+    // sample values of a preset (active or inactive)
+    void LutPresetSampleValuesChanged( int preset, int ch, QVector<int> x, QVector<int> y );
+
+    // settings of an addressed chain (settings snapshot)
+    void LutSnapshotChanged( int chain, int mode, int fixed_mode, int preset, int fast_gamma );
+    void LutSnapshotSampleValuesChanged( int chain, int preset, int ch, QVector<int> x, QVector<int> y );
+
     // fast gamma
     void LutFastGammaChanged( int gamma );
 
@@ -142,6 +161,13 @@ public slots:
     void onLutSampleValuesBlueRequest();
     void onLutSampleValuesMasterRequest();
 
+    // request sample values of a preset, an uncached inactive preset is
+    // activated on the device while it is read and restored afterwards
+    void onLutPresetSampleValuesRequest( int preset );
+
+    // request settings of the addressed chain
+    void onLutSnapshotRequest( int chain );
+
     // interpolate
     void onLutInterpolate();
     void onLutInterpolateRed();
@@ -157,6 +183,31 @@ public slots:
 
     // fast gamma
     void onLutFastGammaChange( int gamma );
+
+private:
+    // cached sample table
+    struct LutSamples
+    {
+        bool            valid = false;
+        QVector<int>    x;
+        QVector<int>    y;
+    };
+
+    // cached sample tables of all presets
+    struct LutCache
+    {
+        int             preset = -1;                                // active preset on device, -1 if unknown
+        LutSamples      samples[LUT_ITF_NO_PRESETS][LutChannelMax];
+    };
+
+    int readLutSamples( LutChannel ch, QVector<int> & x, QVector<int> & y );
+    void cacheLutSamples( LutChannel ch, const QVector<int> & x, const QVector<int> & y );
+    void invalidateLutSamples( LutChannel ch );
+    void invalidateLutPreset( int preset );
+    bool isLutPresetCached( int preset ) const;
+    int readLutPreset( int preset );
+
+    LutCache    m_cache;    // sample tables of the addressed chain
 };
 
 #endif // _LUT_INTERFACE_H_
@@ -30,6 +30,22 @@
 #include "common.h"
 #include "PlayBackItf.h"
 
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// size of a position poll on the wire: "pos\n" + "pos 123456\r\nOK\r\n"
+#define POSITION_SYNC_BYTES             ( 24 )
+
+// bits per transmitted character (start + 8 data + stop)
+#define POSITION_SYNC_BITS_PER_BYTE     ( 10 )
+
+// maximal share of the link bandwidth used for position polls (in percent)
+#define POSITION_SYNC_LINK_SHARE        ( 10 )
+
+// limits of the position sync interval (in ms)
+#define POSITION_SYNC_MIN_INTERVAL      ( 100 )
+#define POSITION_SYNC_MAX_INTERVAL      ( 1000 )
+
 /******************************************************************************
  * PlayBackItf::resync()
  *****************************************************************************/
@@ -67,6 +83,9 @@ void PlayBackItf::resync()
     
     // sync position
     GetPosition();
+
+    // sync position poll interval
+    GetPositionSyncInterval();
 }
 
 /******************************************************************************
@@ -278,6 +297,29 @@ void PlayBackItf::GetPosition()
     }
 }
 
+/******************************************************************************
+ * PlayBackItf::GetPositionSyncInterval
+ *****************************************************************************/
+void PlayBackItf::GetPositionSyncInterval()
+{
+    // Derived from the link without a device request, so it is always emitted
+    int interval = POSITION_SYNC_MIN_INTERVAL;
+
+    // Spend at most POSITION_SYNC_LINK_SHARE percent of the link on
+    // position polls, the playhead is extrapolated in between.
+    uint32_t baudrate = GetComChannel()->getBaudRate();
+    if ( baudrate > 0u )
+    {
+        uint32_t rtt = (POSITION_SYNC_BYTES * POSITION_SYNC_BITS_PER_BYTE * 1000u) / baudrate;
+        interval = static_cast<int>((rtt * 100u) / POSITION_SYNC_LINK_SHARE);
+    }
+
+    interval = qBound( POSITION_SYNC_MIN_INTERVAL, interval, POSITION_SYNC_MAX_INTERVAL );
+
+    // emit a PositionSyncIntervalChanged signal
+    emit PositionSyncIntervalChanged( interval );
+}
+
 /******************************************************************************
  * PlayBackItf::onBankDefaultChange
  *****************************************************************************/
@@ -72,6 +72,9 @@ public:
     // play-back position
     void GetPosition();
 
+    // play-back position sync interval
+    void GetPositionSyncInterval();
+
 signals:
     void MaxFramesChanged( int value );
     void BankChanged(int id, int start, int end );
@@ -85,6 +88,9 @@ signals:
     void PausedChanged( bool flag );
     void PositionUpdate();
     void PositionChanged( int value );
+    // poll interval of the position, connect to PlayBackBox::onPositionSyncIntervalChange
+    // together with PositionChanged, otherwise the box polls at its default rate
+    void PositionSyncIntervalChanged( int ms );
     
 public slots:
     void onBankDefaultChange( int value );
@@ -32,6 +32,7 @@
 #include <QThread>
 #include <QRegularExpression>
 #include <QTextStream>
+#include <QCryptographicHash>
 
 /******************************************************************************
  * ProVideoSystemItf::resync()
@@ -683,6 +684,16 @@ bool ProVideoSystemItf::isConnected()
     return ( res ? false : true );
 }
 
+/******************************************************************************
+ * ProVideoSystemItf::SetRS232BaudRate
+ *****************************************************************************/
+int ProVideoSystemItf::SetRS232BaudRate( uint32_t baudrate )
+{
+    // the device may switch before its answer is complete, so no error popup
+    return ( ctrl_protocol_set_rs232_baud( GET_PROTOCOL_INSTANCE(this),
+                    GET_CHANNEL_INSTANCE(this), baudrate ) );
+}
+
 /******************************************************************************
  * ProVideoSystemItf::flushDeviceBuffers
  *****************************************************************************/
@@ -1108,22 +1119,85 @@ void ProVideoSystemItf::onCopySettings( int src, int dest )
     HANDLE_ERROR( res );
 }
 
+/******************************************************************************
+ * writeSettingsLine - line handler, writes a line of the settings dump
+ *****************************************************************************/
+static int writeSettingsLine( void * const priv, char const * const line, int const len )
+{
+    QIODevice * file = static_cast<QIODevice *>( priv );
+
+    return ( (file->write( line, len ) == len) ? 0 : -EIO );
+}
+
+/******************************************************************************
+ * SettingsHash - hash and size of a settings dump
+ *****************************************************************************/
+struct SettingsHash
+{
+    SettingsHash()
+        : hash( QCryptographicHash::Sha1 )
+        , size( 0 )
+    {
+    }
+
+    QCryptographicHash  hash;
+    qint64              size;
+};
+
+/******************************************************************************
+ * hashSettingsLine - line handler, adds a line of the settings dump to a hash
+ *****************************************************************************/
+static int hashSettingsLine( void * const priv, char const * const line, int const len )
+{
+    SettingsHash * h = static_cast<SettingsHash *>( priv );
+
+    h->hash.addData( line, len );
+    h->size += len;
+
+    return ( 0 );
+}
+
 /******************************************************************************
  * ProVideoSystemItf::GetSavedSettingsToFile
  *****************************************************************************/
-void ProVideoSystemItf::GetSavedSettingsToFile(QFile & file)
+bool ProVideoSystemItf::GetSavedSettingsToFile(QIODevice & file)
+{
+    ctrl_protocol_line_reader_t reader;
+    reader.handler = writeSettingsLine;
+    reader.priv    = &file;
+
+    // the dump is written line by line as it arrives
+    int res = ctrl_protocol_read_settings( GET_PROTOCOL_INSTANCE(this),
+              GET_CHANNEL_INSTANCE(this), sizeof(reader), (uint8_t *)&reader );
+    if ( res )
+    {
+        showError( res, __FILE__, __FUNCTION__, __LINE__ );
+        return ( false );
+    }
+
+    return ( true );
+}
+
+/******************************************************************************
+ * ProVideoSystemItf::GetSettingsFingerprint
+ *****************************************************************************/
+QByteArray ProVideoSystemItf::GetSettingsFingerprint()
 {
-    ctrl_protocol_system_settings_desc_t settings;
-    //memset( settings, 0, sizeof(settings) );
+    SettingsHash settings;
 
-    // read current system string
-    int res = ctrl_protocol_save_settings_to_file( GET_PROTOCOL_INSTANCE(this),
-              GET_CHANNEL_INSTANCE(this), sizeof(settings), (uint8_t *)&settings );
-    HANDLE_ERROR( res );
+    ctrl_protocol_line_reader_t reader;
+    reader.handler = hashSettingsLine;
+    reader.priv    = &settings;
 
-    QTextStream stream(&file);
+    // one command instead of reading every setting, no error popup if unsupported
+    int res = ctrl_protocol_read_settings( GET_PROTOCOL_INSTANCE(this),
+              GET_CHANNEL_INSTANCE(this), sizeof(reader), (uint8_t *)&reader );
+    if ( res || !settings.size )
+    {
+        return ( QByteArray() );
+    }
 
-    stream << settings;
+    return ( settings.hash.result() );
 }
 
 /******************************************************************************
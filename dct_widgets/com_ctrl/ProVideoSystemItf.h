@@ -27,6 +27,7 @@
 
 #include <QObject>
 #include <QFile>
+#include <QByteArray>
 
 #include "ProVideoItf.h"
 #include <ctrl_protocol/ctrl_protocol_system.h>
@@ -143,12 +144,20 @@ public:
 
     void GetDefaultSettings();
 
-    void GetSavedSettingsToFile(QFile & file);
+    // write the settings dump as it arrives, false on error
+    bool GetSavedSettingsToFile(QIODevice & file);
+
+    // hash of the settings dump, empty if the device does not support it
+    QByteArray GetSettingsFingerprint();
+
     void LoadSavedSettingsFromFile(QString setting );
 
     // check for connection to device
     bool isConnected();
 
+    // change the RS232 baud-rate without error popup (baud-rate negotiation)
+    int SetRS232BaudRate( uint32_t baudrate );
+
     // flush device buffers
     void flushDeviceBuffers();
 
@@ -0,0 +1,257 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    SignalCoalescer.cpp
+ *
+ * @brief   Implementation of the signal coalescer
+ *
+ *****************************************************************************/
+#include <QMetaType>
+#include <QVariant>
+#include <QtDebug>
+
+#include "SignalCoalescer.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define COALESCER_FRAME_INTERVAL    ( 16 )      // ms, one UI tick
+
+/******************************************************************************
+ * SignalCoalescer::SignalCoalescer
+ *****************************************************************************/
+SignalCoalescer::SignalCoalescer( QObject * parent )
+    : QObject( parent )
+    , m_delivered( 0 )
+    , m_coalesced( 0 )
+{
+    m_tick.setSingleShot( true );
+    m_tick.setInterval( COALESCER_FRAME_INTERVAL );
+    QObject::connect( &m_tick, &QTimer::timeout, [this]() { flush(); } );
+}
+
+/******************************************************************************
+ * SignalCoalescer::~SignalCoalescer
+ *****************************************************************************/
+SignalCoalescer::~SignalCoalescer()
+{
+    clear();
+}
+
+/******************************************************************************
+ * SignalCoalescer::connect
+ *****************************************************************************/
+bool SignalCoalescer::connect( const QObject * sender, const char * signal,
+                               const QObject * receiver, const char * slot,
+                               int keyArgs )
+{
+    if ( !sender || !signal || !receiver || !slot )
+    {
+        return ( false );
+    }
+
+    // skip the SIGNAL() and SLOT() code
+    QByteArray sig = QMetaObject::normalizedSignature( signal + 1 );
+    QByteArray met = QMetaObject::normalizedSignature( slot + 1 );
+
+    int signalIndex = sender->metaObject()->indexOfSignal( sig.constData() );
+    int slotIndex   = receiver->metaObject()->indexOfMethod( met.constData() );
+    if ( (signalIndex < 0) || (slotIndex < 0) ||
+         !QMetaObject::checkConnectArgs( sig.constData(), met.constData() ) )
+    {
+        qWarning() << "SignalCoalescer: cannot connect" << sig << "to" << met;
+        return ( false );
+    }
+
+    QMetaMethod method = sender->metaObject()->method( signalIndex );
+
+    Route route;
+    route.receiver = const_cast<QObject *>( receiver );
+    route.slot     = slotIndex;
+    route.keyArgs  = qBound( 0, keyArgs, method.parameterCount() );
+    for ( int i = 0; i < method.parameterCount(); i++ )
+    {
+        int type = method.parameterType( i );
+        if ( type == QMetaType::UnknownType )
+        {
+            // arguments which can not be copied are passed on directly
+            return ( QObject::connect( sender, signal, receiver, slot ) );
+        }
+        route.types.append( type );
+    }
+
+    // our own methods come first, the routes follow
+    route.connection = QMetaObject::connect( sender, signalIndex, this,
+                                             QObject::staticMetaObject.methodCount() + m_routes.size(),
+                                             Qt::DirectConnection );
+    if ( !route.connection )
+    {
+        return ( false );
+    }
+
+    m_routes.append( route );
+
+    return ( true );
+}
+
+/******************************************************************************
+ * SignalCoalescer::clear
+ *****************************************************************************/
+void SignalCoalescer::clear()
+{
+    m_tick.stop();
+
+    for ( int i = 0; i < m_held.size(); i++ )
+    {
+        destroyValues( m_held[i] );
+    }
+    m_held.clear();
+    m_heldIndex.clear();
+    m_updated.clear();
+
+    for ( int i = 0; i < m_routes.size(); i++ )
+    {
+        QObject::disconnect( m_routes[i].connection );
+    }
+    m_routes.clear();
+}
+
+/******************************************************************************
+ * SignalCoalescer::flush
+ *****************************************************************************/
+void SignalCoalescer::flush()
+{
+    m_tick.stop();
+
+    // slots may cause new updates, they belong to the next frame
+    QList<Update> held = m_held;
+    m_held.clear();
+    m_heldIndex.clear();
+    m_updated.clear();
+
+    for ( int i = 0; i < held.size(); i++ )
+    {
+        QVector<void *> args;
+        args.append( nullptr );
+        args += held[i].values;
+
+        deliver( held[i].route, args.data() );
+        destroyValues( held[i] );
+    }
+}
+
+/******************************************************************************
+ * SignalCoalescer::qt_metacall
+ *****************************************************************************/
+int SignalCoalescer::qt_metacall( QMetaObject::Call call, int id, void ** args )
+{
+    id = QObject::qt_metacall( call, id, args );
+    if ( id < 0 )
+    {
+        return ( id );
+    }
+
+    if ( (call == QMetaObject::InvokeMetaMethod) && (id < m_routes.size()) )
+    {
+        onSignal( id, args );
+    }
+
+    return ( -1 );
+}
+
+/******************************************************************************
+ * SignalCoalescer::onSignal
+ *****************************************************************************/
+void SignalCoalescer::onSignal( int route, void ** args )
+{
+    QByteArray key = propertyKey( route, args );
+
+    // first update of the property in this frame
+    if ( !m_updated.contains( key ) )
+    {
+        m_updated.insert( key );
+        if ( !m_tick.isActive() )
+        {
+            m_tick.start();
+        }
+
+        deliver( route, args );
+        return;
+    }
+
+    Update update;
+    update.route = route;
+    for ( int i = 0; i < m_routes[route].types.size(); i++ )
+    {
+        update.values.append( QMetaType::create( m_routes[route].types[i], args[i + 1] ) );
+    }
+
+    // a newer value replaces the held one
+    QHash<QByteArray, int>::const_iterator it = m_heldIndex.constFind( key );
+    if ( it != m_heldIndex.constEnd() )
+    {
+        destroyValues( m_held[it.value()] );
+        m_held[it.value()] = update;
+        m_coalesced++;
+    }
+    else
+    {
+        m_heldIndex.insert( key, m_held.size() );
+        m_held.append( update );
+    }
+}
+
+/******************************************************************************
+ * SignalCoalescer::deliver
+ *****************************************************************************/
+void SignalCoalescer::deliver( int route, void ** args )
+{
+    QObject * receiver = m_routes[route].receiver.data();
+    if ( receiver )
+    {
+        m_delivered++;
+        QMetaObject::metacall( receiver, QMetaObject::InvokeMetaMethod, m_routes[route].slot, args );
+    }
+}
+
+/******************************************************************************
+ * SignalCoalescer::propertyKey
+ *****************************************************************************/
+QByteArray SignalCoalescer::propertyKey( int route, void ** args ) const
+{
+    QByteArray key = QByteArray::number( route );
+
+    for ( int i = 0; i < m_routes[route].keyArgs; i++ )
+    {
+        key += ':';
+        key += QVariant( m_routes[route].types[i], args[i + 1] ).toString().toUtf8();
+    }
+
+    return ( key );
+}
+
+/******************************************************************************
+ * SignalCoalescer::destroyValues
+ *****************************************************************************/
+void SignalCoalescer::destroyValues( Update & update ) const
+{
+    for ( int i = 0; i < update.values.size(); i++ )
+    {
+        QMetaType::destroy( m_routes[update.route].types[i], update.values[i] );
+    }
+    update.values.clear();
+}
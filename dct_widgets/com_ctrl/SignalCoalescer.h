@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    SignalCoalescer.h
+ *
+ * @brief   Coalesces repeated interface signals before they reach the widgets
+ *
+ * @note    A signal connected through the coalescer is forwarded to its slot
+ *          at once if the same property was not updated in the current frame.
+ *          A frame starts with the first update and ends with the next UI
+ *          tick (COALESCER_FRAME_INTERVAL). Further updates of a property in
+ *          the frame are held back, a newer one replaces an older one, and
+ *          the latest values of all held properties are delivered together
+ *          at the end of the frame.
+ *
+ *          A property is a connection and the values of its leading key
+ *          arguments, e.g. the phase index of MccPhaseChanged(int,int,int),
+ *          so updates of different phases are never merged.
+ *
+ *          Held updates are delivered in the order they were first held.
+ *          Code which reads widget state right after a resync has to call
+ *          flush() first.
+ *
+ *****************************************************************************/
+#ifndef _SIGNAL_COALESCER_H_
+#define _SIGNAL_COALESCER_H_
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMetaMethod>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+class SignalCoalescer : public QObject
+{
+public:
+    explicit SignalCoalescer( QObject * parent = nullptr );
+    ~SignalCoalescer();
+
+    // like QObject::connect with SIGNAL() and SLOT(), the first keyArgs
+    // arguments of the signal identify the property, false on error
+    bool connect( const QObject * sender, const char * signal,
+                  const QObject * receiver, const char * slot,
+                  int keyArgs = 0 );
+
+    // disconnect all signals and drop held updates
+    void clear();
+
+    // deliver all held updates now
+    void flush();
+
+    // number of updates passed to a slot, and of updates replaced by a
+    // newer one before they were delivered
+    int delivered() const
+    {
+        return ( m_delivered );
+    }
+
+    int coalesced() const
+    {
+        return ( m_coalesced );
+    }
+
+    void resetCounters()
+    {
+        m_delivered = 0;
+        m_coalesced = 0;
+    }
+
+    // signals of the connected senders arrive here
+    int qt_metacall( QMetaObject::Call call, int id, void ** args ) override;
+
+private:
+    struct Route
+    {
+        QPointer<QObject>           receiver;
+        int                         slot;       // method index in receiver
+        QVector<int>                types;      // meta types of the arguments
+        int                         keyArgs;
+        QMetaObject::Connection     connection;
+    };
+
+    struct Update
+    {
+        int                         route;
+        QVector<void *>             values;     // copies of the arguments
+    };
+
+    void onSignal( int route, void ** args );
+    void deliver( int route, void ** args );
+    QByteArray propertyKey( int route, void ** args ) const;
+    void destroyValues( Update & update ) const;
+
+    QVector<Route>                  m_routes;
+    QList<Update>                   m_held;
+    QHash<QByteArray, int>          m_heldIndex;    // property -> index in m_held
+    QSet<QByteArray>                m_updated;      // properties updated in this frame
+    QTimer                          m_tick;
+    int                             m_delivered;
+    int                             m_coalesced;
+};
+
+#endif // _SIGNAL_COALESCER_H_
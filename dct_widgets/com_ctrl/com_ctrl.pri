@@ -9,6 +9,8 @@ SOURCES += ../../com_ctrl/common.cpp \
            ../../com_ctrl/ComChannel.cpp \
            ../../com_ctrl/ComChannelRSxxx.cpp \
            ../../com_ctrl/ProVideoSystemItf.cpp \
+           ../../com_ctrl/CommandScheduler.cpp \
+           ../../com_ctrl/SignalCoalescer.cpp \
            ../../com_ctrl/IspItf.cpp \
            ../../com_ctrl/CprocItf.cpp \
            ../../com_ctrl/AutoItf.cpp \
@@ -29,6 +31,8 @@ SOURCES += ../../com_ctrl/common.cpp \
 HEADERS +=  ../../com_ctrl/ProVideoDevice.h \
 			../../com_ctrl/ProVideoItf.h \
             ../../com_ctrl/ProVideoSystemItf.h \
+            ../../com_ctrl/CommandScheduler.h \
+            ../../com_ctrl/SignalCoalescer.h \
             ../../com_ctrl/IspItf.h \
             ../../com_ctrl/CprocItf.h \
             ../../com_ctrl/AutoItf.h \
@@ -63,6 +67,9 @@ SOURCES += ../../../ctrl_channel/ctrl_channel.c \
            ../../../ctrl_protocol/ctrl_protocol_dpcc.c \
            ../../../provideo_protocol/provideo_protocol.c \
            ../../../provideo_protocol/provideo_protocol_common.c \
+           ../../../provideo_protocol/provideo_protocol_codec.c \
+           ../../../provideo_protocol/provideo_protocol_reader.c \
+           ../../../provideo_protocol/provideo_protocol_timing.c \
            ../../../provideo_protocol/provideo_protocol_system.c \
            ../../../provideo_protocol/provideo_protocol_isp.c \
            ../../../provideo_protocol/provideo_protocol_cproc.c \
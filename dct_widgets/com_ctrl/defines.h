@@ -31,6 +31,7 @@
 #define MAX_NUM_CHAINS                  ( 1 ) // TODO: set according to chain number
 #define MAX_DEVICE_ID                   ( 99 )
 #define SETTINGS_FILE_NAME              ( ".kaya-sdi-gui.ini" )
+#define CACHE_DIR_NAME                  ( ".kaya-sdi-gui-cache" )
 
 /******************************************************************************
  * lens shading correction segmentation mode
@@ -435,17 +435,66 @@ void IronSDI_Device::resync()
 {
     ProVideoDevice::resync();
 
-    GetIspItf()     ->resync();
-    GetCprocItf()   ->resync();
-    GetCamItf()     ->resync();
-    GetAutoItf()    ->resync();
-    GetMccItf()     ->resync();
-    GetLutItf()     ->resync();
-    GetChainItf()   ->resync();
-    GetLensItf()    ->resync();
-    GetKneeItf()    ->resync();
-    GetROIItf()     ->resync();
-    GetDpccItf()    ->resync();
+    for ( int i = SubsystemIsp; i < SubsystemMax; i++ )
+    {
+        resyncSubsystem( static_cast<Subsystem>(i) );
+    }
+}
+
+/******************************************************************************
+ * IronSDI_Device::resyncSubsystem()
+ *****************************************************************************/
+void IronSDI_Device::resyncSubsystem( Subsystem s )
+{
+    switch ( s )
+    {
+        case SubsystemIsp:
+            GetIspItf()->resync();
+            break;
+
+        case SubsystemCproc:
+            GetCprocItf()->resync();
+            break;
+
+        case SubsystemCam:
+            GetCamItf()->resync();
+            break;
+
+        case SubsystemAuto:
+            GetAutoItf()->resync();
+            break;
+
+        case SubsystemMcc:
+            GetMccItf()->resync();
+            break;
+
+        case SubsystemLut:
+            GetLutItf()->resync();
+            break;
+
+        case SubsystemChain:
+            GetChainItf()->resync();
+            break;
+
+        case SubsystemLens:
+            GetLensItf()->resync();
+            break;
+
+        case SubsystemKnee:
+            GetKneeItf()->resync();
+            break;
+
+        case SubsystemROI:
+            GetROIItf()->resync();
+            break;
+
+        case SubsystemDpcc:
+            GetDpccItf()->resync();
+            break;
+
+        default:
+            break;
+    }
 }
 
 /******************************************************************************
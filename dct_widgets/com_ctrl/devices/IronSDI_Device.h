@@ -25,6 +25,9 @@ public:
     // resync all settings
     void resync() override;
 
+    // resync the settings of a single subsystem
+    void resyncSubsystem( Subsystem s ) override;
+
     // resync only chain specific settings
     void resyncChainSpecific() override;
 
@@ -45,6 +45,7 @@ public:
         m_systemPlatform = "unknown platform";
         m_deviceName = "unknown device";
         m_deviceVersion = "unknown version";
+        m_deviceId = "";
         m_broadcastAddress = 0;
         m_isBroadcastMaster = false;
         m_ProVideoSystemItf = new ProVideoSystemItf( c, p );
@@ -58,6 +59,7 @@ public:
     QString m_systemPlatform;
     QString m_deviceName;
     QString m_deviceVersion;
+    QString m_deviceId;
     unsigned int m_broadcastAddress;
     bool m_isBroadcastMaster;
     QList<rs485Device> m_deviceList;
@@ -75,6 +77,7 @@ ProVideoDevice::ProVideoDevice( ComChannel * c, ComProtocol * p )
     connect( GetProVideoSystemItf(), SIGNAL(SystemPlatformChanged(QString)), this, SLOT(onSystemPlatformChange(QString)) );
     connect( GetProVideoSystemItf(), SIGNAL(DeviceNameChanged(QString)), this, SLOT(onDeviceNameChange(QString)) );
     connect( GetProVideoSystemItf(), SIGNAL(DeviceVersionChanged(QString)), this, SLOT(onDeviceVersionChange(QString)) );
+    connect( GetProVideoSystemItf(), SIGNAL(DeviceIdChanged(uint32_t,uint32_t,uint32_t,uint32_t)), this, SLOT(onDeviceIdChange(uint32_t,uint32_t,uint32_t,uint32_t)) );
     connect( GetProVideoSystemItf(), SIGNAL(RS485BroadcastAddressChanged(uint32_t)), this, SLOT(onBroadcastAddressChange(uint32_t)) );
     connect( GetProVideoSystemItf(), SIGNAL(RS485BroadcastMasterChanged(uint8_t)), this, SLOT(onBroadcastMasterModeChange(uint8_t)) );
     connect( GetProVideoSystemItf(), SIGNAL(DeviceListChanged(QList<rs485Device>)), this, SLOT(onDeviceListChange(QList<rs485Device>)) );
@@ -248,10 +251,28 @@ void ProVideoDevice::setComChannel( ComChannel * c )
  * ProVideoDevice::resync()
  *****************************************************************************/
 void ProVideoDevice::resync()
+{
+    resyncSystem();
+}
+
+/******************************************************************************
+ * ProVideoDevice::resyncSystem()
+ *****************************************************************************/
+void ProVideoDevice::resyncSystem()
 {
     GetProVideoSystemItf()->resync();
 }
 
+/******************************************************************************
+ * ProVideoDevice::resyncSubsystem()
+ *****************************************************************************/
+void ProVideoDevice::resyncSubsystem( Subsystem s )
+{
+    (void)s;
+
+    // Nothing to be done here, has to be overwritten in device implementations
+}
+
 /******************************************************************************
  * ProVideoDevice::resyncChainSpecific()
  *****************************************************************************/
@@ -325,6 +346,27 @@ QString ProVideoDevice::getDeviceVersion()
     return d_data->m_deviceVersion;
 }
 
+/******************************************************************************
+ * ProVideoDevice::onDeviceIdChange
+ *****************************************************************************/
+void ProVideoDevice::onDeviceIdChange( uint32_t id0, uint32_t id1, uint32_t id2, uint32_t id3 )
+{
+    d_data->m_deviceId = QString( "%1%2%3%4" )
+                            .arg( id0, 8, 16, QChar('0') ).arg( id1, 8, 16, QChar('0') )
+                            .arg( id2, 8, 16, QChar('0') ).arg( id3, 8, 16, QChar('0') );
+}
+
+/******************************************************************************
+ * ProVideoDevice::getDeviceId
+ * @brief This gets the unique device identifier which is stored in the class
+ *        variable of this object. It does not invoke a com command!
+ * @returns The device identifier as hex string, empty if not read yet
+ *****************************************************************************/
+QString ProVideoDevice::getDeviceId()
+{
+    return d_data->m_deviceId;
+}
+
 /******************************************************************************
  * ProVideoDevice::onBroadcastAddressChange
  *****************************************************************************/
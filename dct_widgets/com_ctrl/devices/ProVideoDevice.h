@@ -102,6 +102,22 @@ public:
         unsigned int numTempSensors;
     };
 
+    // device settings which can be synchronized independently
+    enum Subsystem {
+        SubsystemIsp = 0,
+        SubsystemCproc,
+        SubsystemCam,
+        SubsystemAuto,
+        SubsystemMcc,
+        SubsystemLut,
+        SubsystemChain,
+        SubsystemLens,
+        SubsystemKnee,
+        SubsystemROI,
+        SubsystemDpcc,
+        SubsystemMax
+    };
+
     explicit ProVideoDevice( ComChannel *, ComProtocol * );
     ~ProVideoDevice();
 
@@ -117,6 +133,12 @@ public:
     // resync all settings
     virtual void resync();
 
+    // resync only system settings (device name, version, interfaces, ...)
+    void resyncSystem();
+
+    // resync the settings of a single subsystem
+    virtual void resyncSubsystem( Subsystem s );
+
     // resync only chain specific settings
     virtual void resyncChainSpecific();
     
@@ -127,6 +149,7 @@ public:
     QString getSystemPlatform();
     QString getDeviceName();
     QString getDeviceVersion();
+    QString getDeviceId();
     unsigned int getBroadcastAddress();
     bool getBroadcastMasterMode();
     QList<rs485Device> getDeviceList();
@@ -158,6 +181,7 @@ private slots:
     void onSystemPlatformChange( QString name );
     void onDeviceNameChange( QString name );
     void onDeviceVersionChange( QString name );
+    void onDeviceIdChange( uint32_t id0, uint32_t id1, uint32_t id2, uint32_t id3 );
     void onBroadcastAddressChange( uint32_t broadcastAddress );
     void onBroadcastMasterModeChange( uint8_t isBroadcastMaster );
     void onDeviceListChange( QList<rs485Device> deviceList );
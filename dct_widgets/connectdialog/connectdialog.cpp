@@ -52,6 +52,26 @@
 #define CON_SETTINGS_DIALOG_PARITY           ( "parity" )
 #define CON_SETTINGS_DIALOG_STOPBITS         ( "stopbits" )
 #define CON_SETTINGS_DIALOG_DEVICE_ADDRESS   ( "dev-address" )
+#define CON_SETTINGS_DIALOG_DIRECTION        ( "direction-control" )  // "auto" or "rts"
+#define CON_SETTINGS_DIALOG_MAX_SPEED        ( "max-baudrate" )       // 0 = no negotiation
+
+// number of prompt requests until a device is given up at a new baudrate
+#define NEGOTIATE_RETRIES                    ( 3 )
+
+/******************************************************************************
+ * findBaudRate - index of a baudrate in a combo box, custom rates are added
+ *****************************************************************************/
+static int findBaudRate( QComboBox * cbx, uint32_t const baudrate )
+{
+    int idx = cbx->findData( baudrate );
+    if ( (idx < 0) && CTRL_CHANNEL_BAUDRATE_VALID( baudrate ) )
+    {
+        cbx->addItem( QString::number( baudrate ), baudrate );
+        idx = cbx->count() - 1;
+    }
+
+    return ( idx );
+}
 
 /******************************************************************************
  * ConnectDialog::ConnectDialog
@@ -67,6 +87,7 @@ ConnectDialog::ConnectDialog( QWidget * parent )
     , m_detectedRS485Devices()
     , m_currentRS485DeviceIndex( -1 )
     , m_firstStart( true )
+    , m_maxBaudrate( 0u )
 {
     // initialize UI
     m_ui->setupUi( this );
@@ -81,6 +102,9 @@ ConnectDialog::ConnectDialog( QWidget * parent )
 //        m_ui->cbxBaudrateRS232->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_38400) , CTRL_CHANNEL_BAUDRATE_38400 );
     m_ui->cbxBaudrateRS232->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_57600) , CTRL_CHANNEL_BAUDRATE_57600 );
     m_ui->cbxBaudrateRS232->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_115200), CTRL_CHANNEL_BAUDRATE_115200 );
+    m_ui->cbxBaudrateRS232->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_230400), CTRL_CHANNEL_BAUDRATE_230400 );
+    m_ui->cbxBaudrateRS232->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_460800), CTRL_CHANNEL_BAUDRATE_460800 );
+    m_ui->cbxBaudrateRS232->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_921600), CTRL_CHANNEL_BAUDRATE_921600 );
     m_ui->cbxBaudrateRS232->setCurrentIndex( m_ui->cbxBaudrateRS232->findData( CTRL_CHANNEL_BAUDRATE_DEFAULT ) );
 
     // RS485
@@ -91,6 +115,9 @@ ConnectDialog::ConnectDialog( QWidget * parent )
 //        m_ui->cbxBaudrateRS485->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_38400) , CTRL_CHANNEL_BAUDRATE_38400 );
     m_ui->cbxBaudrateRS485->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_57600) , CTRL_CHANNEL_BAUDRATE_57600 );
     m_ui->cbxBaudrateRS485->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_115200), CTRL_CHANNEL_BAUDRATE_115200 );
+    m_ui->cbxBaudrateRS485->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_230400), CTRL_CHANNEL_BAUDRATE_230400 );
+    m_ui->cbxBaudrateRS485->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_460800), CTRL_CHANNEL_BAUDRATE_460800 );
+    m_ui->cbxBaudrateRS485->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_921600), CTRL_CHANNEL_BAUDRATE_921600 );
     m_ui->cbxBaudrateRS485->setCurrentIndex( m_ui->cbxBaudrateRS485->findData( CTRL_CHANNEL_BAUDRATE_DEFAULT ) );
 
     // Add data-bit selection to comboboxes
@@ -278,7 +305,7 @@ ctrl_channel_rs4xx_open_config_t ConnectDialog::getRs485Config()
 void ConnectDialog::setRs485Config( ctrl_channel_rs4xx_open_config_t const config )
 {
     m_ui->cbxPortRS485->setCurrentIndex( m_ui->cbxPortRS485->findData(config.idx) );
-    m_ui->cbxBaudrateRS485->setCurrentIndex( m_ui->cbxBaudrateRS485->findData(config.baudrate) );
+    m_ui->cbxBaudrateRS485->setCurrentIndex( findBaudRate( m_ui->cbxBaudrateRS485, config.baudrate ) );
     m_ui->cbxDatabitsRS485->setCurrentIndex( m_ui->cbxDatabitsRS485->findData(config.data) );
     m_ui->cbxParityRS485->setCurrentIndex( m_ui->cbxParityRS485->findData(config.parity) );
     m_ui->cbxStopbitsRS485->itemData( m_ui->cbxStopbitsRS485->findData(config.stop) );
@@ -308,7 +335,7 @@ ctrl_channel_rs232_open_config_t ConnectDialog::getRs232Config()
 void ConnectDialog::setRs232Config( ctrl_channel_rs232_open_config_t const config )
 {
     m_ui->cbxPortRS232->setCurrentIndex( m_ui->cbxPortRS232->findData(config.idx) );
-    m_ui->cbxBaudrateRS232->setCurrentIndex( m_ui->cbxBaudrateRS232->findData(config.baudrate) );
+    m_ui->cbxBaudrateRS232->setCurrentIndex( findBaudRate( m_ui->cbxBaudrateRS232, config.baudrate ) );
     m_ui->cbxDatabitsRS232->setCurrentIndex( m_ui->cbxDatabitsRS232->findData(config.data) );
     m_ui->cbxParityRS232->setCurrentIndex( m_ui->cbxParityRS232->findData(config.parity) );
     m_ui->cbxStopbitsRS232->itemData( m_ui->cbxStopbitsRS232->findData(config.stop) );
@@ -374,6 +401,17 @@ bool ConnectDialog::connectWithDevice()
             bConnected = genericDevice.isConnected();
             retryCount++;
         }
+
+        // a negotiated baudrate is lost when the device falls back to its default
+        if ( !bConnected && m_maxBaudrate && (getActiveInterface() == Rs232)
+                && (pActiveChannel->getBaudRate() != CTRL_CHANNEL_BAUDRATE_DEFAULT) )
+        {
+            bConnected = isReachableAt( genericDevice, CTRL_CHANNEL_BAUDRATE_DEFAULT );
+            if ( bConnected )
+            {
+                setActiveBaudRate( Rs232, static_cast<int>(CTRL_CHANNEL_BAUDRATE_DEFAULT) );
+            }
+        }
     }
 
     // III. Check for known device
@@ -381,6 +419,12 @@ bool ConnectDialog::connectWithDevice()
     {
         genericDevice.GetProVideoSystemItf()->GetSystemPlatform();
         bIsKnown = DeviceIsKnown(genericDevice.getSystemPlatform());
+
+        // switch to a faster baudrate before the device is set up
+        if ( bIsKnown && m_maxBaudrate && (getActiveInterface() == Rs232) )
+        {
+            setActiveBaudRate( Rs232, static_cast<int>(negotiateBaudRate( genericDevice )) );
+        }
     }
 
     // if not connected, close the active channel
@@ -621,7 +665,15 @@ bool ConnectDialog::loadConSettings( QSettings &s )
         {
             value = s.value(CON_SETTINGS_DIALOG_DEVICE_ADDRESS, "").toInt();
             result += setActiveDeviceAddress( iface, value );
+
+            // only needed for adapters which do not switch the bus direction on their own
+            string = s.value(CON_SETTINGS_DIALOG_DIRECTION, "auto").toString();
+            m_rs485->setDirectionControl( (string == "rts") ? ComChannelRS4xx::DirectionRts
+                                                            : ComChannelRS4xx::DirectionAuto );
         }
+
+        // negotiate a faster RS232 baudrate after connect, off by default
+        m_maxBaudrate = s.value(CON_SETTINGS_DIALOG_MAX_SPEED, 0).toUInt();
     }
 
     s.endGroup();
@@ -650,7 +702,11 @@ void ConnectDialog::saveConSettings( QSettings &s )
         if ( Rs485 == iface )
         {
             s.setValue( CON_SETTINGS_DIALOG_DEVICE_ADDRESS   , getActiveDeviceAddress() );
+            s.setValue( CON_SETTINGS_DIALOG_DIRECTION        ,
+                        (m_rs485->getDirectionControl() == ComChannelRS4xx::DirectionRts) ? "rts" : "auto" );
         }
+
+        s.setValue( CON_SETTINGS_DIALOG_MAX_SPEED        , m_maxBaudrate );
     }
 
     s.endGroup();
@@ -810,7 +866,7 @@ int ConnectDialog::setActiveBaudRate( Interface iface, int baudrate )
     switch ( iface )
     {
         case Rs232:
-            idx = m_ui->cbxBaudrateRS232->findData( baudrate );
+            idx = findBaudRate( m_ui->cbxBaudrateRS232, static_cast<uint32_t>(baudrate) );
             if ( idx != -1 )
             {
                 m_ui->cbxBaudrateRS232->setCurrentIndex( idx );
@@ -818,7 +874,7 @@ int ConnectDialog::setActiveBaudRate( Interface iface, int baudrate )
             break;
 
         case Rs485:
-            idx = m_ui->cbxBaudrateRS485->findData( baudrate );
+            idx = findBaudRate( m_ui->cbxBaudrateRS485, static_cast<uint32_t>(baudrate) );
             if ( idx != -1 )
             {
                 m_ui->cbxBaudrateRS485->setCurrentIndex( idx );
@@ -1210,7 +1266,10 @@ bool ConnectDialog::detectAndConnect()
     // Get the device list for this baudrate
     // The timeout depends on the baudrate
     uint32_t timeout = 1000;                                        // Default timeout for 115200 baud is 1000ms
-    timeout *= CTRL_CHANNEL_BAUDRATE_115200 / openCfg.baudrate;     // Increase timeout for slower baudrates
+    if ( openCfg.baudrate < CTRL_CHANNEL_BAUDRATE_115200 )
+    {
+        timeout = (timeout * CTRL_CHANNEL_BAUDRATE_115200) / openCfg.baudrate;  // Increase timeout for slower baudrates
+    }
     timeout += 200;                                                 // Add safety margin
 
     genericDevice.GetProVideoSystemItf()->GetDeviceList( timeout );
@@ -1308,7 +1367,7 @@ bool ConnectDialog::scanAndConnect()
 
     // Constants
     const int numAddresses = MAX_DEVICE_ID + 1; // 0 is a valid address to, thus: +1
-    const int numBaudrates = 2;
+    const int numBaudrates = 5;
 
     // Array that holds all baudrates that will be scanned
     /* Note: Slow baudrates below 57600 baud are not supported by the GUI because
@@ -1317,7 +1376,10 @@ bool ConnectDialog::scanAndConnect()
                                            CTRL_CHANNEL_BAUDRATE_19200,
                                            CTRL_CHANNEL_BAUDRATE_38400, */
                                            CTRL_CHANNEL_BAUDRATE_57600,
-                                           CTRL_CHANNEL_BAUDRATE_115200 };
+                                           CTRL_CHANNEL_BAUDRATE_115200,
+                                           CTRL_CHANNEL_BAUDRATE_230400,
+                                           CTRL_CHANNEL_BAUDRATE_460800,
+                                           CTRL_CHANNEL_BAUDRATE_921600 };
 
     // clear list of found devices (needed if we try to reconnect, otherwise old items stay in list)
     m_detectedRS485Devices.clear();
@@ -1499,6 +1561,93 @@ bool ConnectDialog::scanAndConnect()
     return false;
 }
 
+/******************************************************************************
+ * ConnectDialog::isReachableAt
+ *****************************************************************************/
+bool ConnectDialog::isReachableAt( ProVideoDevice & device, uint32_t baudrate )
+{
+    ctrl_channel_rs232_open_config_t cfg = getRs232Config();
+    cfg.baudrate = baudrate;
+
+    // fails if the adapter can not generate the baudrate
+    if ( m_rs232->Open( static_cast<void *>(&cfg), sizeof(cfg) ) )
+    {
+        return ( false );
+    }
+
+    // the first request may hit garbage from the switch
+    for ( int i = 0; i < NEGOTIATE_RETRIES; i++ )
+    {
+        if ( device.isConnected() )
+        {
+            return ( true );
+        }
+    }
+
+    return ( false );
+}
+
+/******************************************************************************
+ * ConnectDialog::negotiateBaudRate
+ *****************************************************************************/
+uint32_t ConnectDialog::negotiateBaudRate( ProVideoDevice & device )
+{
+    // candidates, fastest first
+    static const uint32_t baudrates[] = { CTRL_CHANNEL_BAUDRATE_921600,
+                                          CTRL_CHANNEL_BAUDRATE_460800,
+                                          CTRL_CHANNEL_BAUDRATE_230400 };
+
+    uint32_t const current = m_rs232->getBaudRate();
+
+    for ( uint32_t baudrate : baudrates )
+    {
+        if ( (baudrate > m_maxBaudrate) || (baudrate <= current) )
+        {
+            continue;
+        }
+
+        // I. check the adapter first, the device must not be switched to a
+        //    baudrate the host can not follow
+        ctrl_channel_rs232_open_config_t cfg = getRs232Config();
+        cfg.baudrate = baudrate;
+        int res = m_rs232->Open( static_cast<void *>(&cfg), sizeof(cfg) );
+
+        cfg.baudrate = current;
+        if ( m_rs232->Open( static_cast<void *>(&cfg), sizeof(cfg) ) )
+        {
+            qCritical() << "Can not reopen RS232 channel with baudrate" << current;
+            return ( current );
+        }
+
+        if ( res )
+        {
+            qDebug() << "RS232 adapter does not support baudrate" << baudrate;
+            continue;
+        }
+
+        // II. switch the device, it may answer before or after switching
+        (void)device.GetProVideoSystemItf()->SetRS232BaudRate( baudrate );
+
+        // III. follow and check that the link works at the new baudrate
+        if ( isReachableAt( device, baudrate ) )
+        {
+            qDebug() << "Negotiated RS232 baudrate" << baudrate;
+            return ( baudrate );
+        }
+
+        // IV. device rejected the baudrate or the line is too bad for it
+        if ( !isReachableAt( device, current ) )
+        {
+            // try to get the device back, the request might get through
+            isReachableAt( device, baudrate );
+            (void)device.GetProVideoSystemItf()->SetRS232BaudRate( current );
+            isReachableAt( device, current );
+        }
+    }
+
+    return ( current );
+}
+
 /******************************************************************************
  * ConnectDialog::changeComportSettings
  *****************************************************************************/
@@ -168,6 +168,7 @@ private:
     int                          m_currentRS485DeviceIndex; // Index of the connected device from the m_detectedRS485Devices list that is currently connected
     QPushButton *                m_rescan;                  // rescan button
     bool                         m_firstStart;              // connect dialog was opend for the first time
+    uint32_t                     m_maxBaudrate;             // upper limit of the RS232 baudrate negotiation, 0 = off
 
     ctrl_channel_rs4xx_open_config_t m_lastRs485Config;     // Last used RS485 connection settings
     ctrl_channel_rs232_open_config_t m_lastRs232Config;     // Last used RS232 connection settings
@@ -186,6 +187,11 @@ private:
     bool fileExists( QString & path );
     void setIsConnected( bool value );
     bool connectWithDevice();
+
+    // open the RS232 channel with another baudrate and check if the device answers
+    bool isReachableAt( ProVideoDevice & device, uint32_t baudrate );
+    // switch device and RS232 channel to the fastest baudrate both can do
+    uint32_t negotiateBaudRate( ProVideoDevice & device );
 };
 
 #endif // __CONNECT_DIALOG_H__
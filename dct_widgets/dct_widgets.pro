@@ -38,6 +38,7 @@ INCLUDEPATH += ../libraries/include     \
                ../libraries/qcustomplot \
                com_ctrl                 \
                csvwrapper               \
+               profilewrapper           \
                textviewer               \
                infodialog               \
                aecweightsdialog         \
@@ -79,6 +80,8 @@ HEADERS      = fmtspinbox/fmtspinbox.h                              \
                huesegmentselect/huesegmentselect.h                  \
                mccslider/mccslider.h                                \
                wbbox/wbbox.h                                        \
+               wbbox/wb_calibration.h                               \
+               wbbox/wb_calibration_dialog.h                        \
                mccbox/mccbox.h                                      \
                mcceqbox/mcceqbox.h                                  \
                infobox/infobox.h                                    \
@@ -86,6 +89,9 @@ HEADERS      = fmtspinbox/fmtspinbox.h                              \
                gammabox/gammabox.h                                  \
                lutbox/lutbox.h                                      \
                lutbox/cubic_interpolation.h                         \
+               lutbox/cube_export.h                                 \
+               lutbox/pipeline_preview.h                            \
+               lutbox/curve_graph.h                                 \
                inoutbox/inoutbox.h                                  \
                outbox/outbox.h                                      \
                fltbox/fltbox.h                                      \
@@ -97,17 +103,23 @@ HEADERS      = fmtspinbox/fmtspinbox.h                              \
                kneebox/knee_interpolation.h                         \
                dpccbox/dpccbox.h                                    \
                lensdriverbox/lensdriverbox.h                        \
+               lensdriverbox/lensprofilestore.h                    \
                ../libraries/include/csv/csvparser.h                 \
                ../libraries/include/csv/csvwriter.h                 \
+               ../libraries/include/profile/profile.h               \
                ../libraries/include/simple_math/cubic.h             \
                ../libraries/include/simple_math/knee.h              \
                ../libraries/include/simple_math/rgb2ycbcr.h         \
                ../libraries/include/simple_math/xyz2ct.h            \
+               ../libraries/include/simple_math/ct_table.h          \
                ../libraries/include/simple_math/gamma.h             \
+               ../libraries/include/simple_math/gamma_table.h       \
+               ../libraries/include/simple_math/isp_pipeline.h      \
                ../libraries/include/simple_math/float.h             \
                ../libraries/qcustomplot/qcustomplot.h               \
                com_ctrl/FpncData.h                                  \
                csvwrapper/csvwrapper.h                              \
+               profilewrapper/profilewrapper.h                      \
                textviewer/textviewer.h                              \
                infodialog/infodialog.h                              \
                aecweightsdialog/aecweightsdialog.h                  \
@@ -125,6 +137,8 @@ SOURCES      = fmtspinbox/fmtspinbox.cpp                            \
                huesegmentselect/huesegmentselect.cpp                \
                mccslider/mccslider.cpp                              \
                wbbox/wbbox.cpp                                      \
+               wbbox/wb_calibration.cpp                             \
+               wbbox/wb_calibration_dialog.cpp                      \
                mccbox/mccbox.cpp                                    \
                mcceqbox/mcceqbox.cpp                                \
                infobox/infobox.cpp                                  \
@@ -132,6 +146,9 @@ SOURCES      = fmtspinbox/fmtspinbox.cpp                            \
                gammabox/gammabox.cpp                                \
                lutbox/lutbox.cpp                                    \
                lutbox/cubic_interpolation.cpp                       \
+               lutbox/cube_export.cpp                               \
+               lutbox/pipeline_preview.cpp                          \
+               lutbox/curve_graph.cpp                               \
                inoutbox/inoutbox.cpp                                \
                outbox/outbox.cpp                                    \
                fltbox/fltbox.cpp                                    \
@@ -143,19 +160,25 @@ SOURCES      = fmtspinbox/fmtspinbox.cpp                            \
                kneebox/knee_interpolation.cpp                       \
                dpccbox/dpccbox.cpp                                  \
                lensdriverbox/lensdriverbox.cpp                      \
+               lensdriverbox/lensprofilestore.cpp                  \
                ../libraries/csv/csvparser.c                         \
                ../libraries/csv/csvwriter.c                         \
+               ../libraries/profile/profile.c                       \
                ../libraries/simple_math/rgb2ycbcr.c                 \
                ../libraries/simple_math/xyz2ct.c                    \
+               ../libraries/simple_math/ct_table.c                  \
                ../libraries/simple_math/cubic.c                     \
                ../libraries/simple_math/knee.c                      \
                ../libraries/simple_math/gamma.c                     \
+               ../libraries/simple_math/gamma_table.c               \
+               ../libraries/simple_math/isp_pipeline.c              \
                ../libraries/simple_math/float.c                     \
                ../libraries/qcustomplot/qcustomplot.cpp             \
                com_ctrl/FpncData.cpp                                \
                com_ctrl/common.cpp                                  \
                com_ctrl/defines.cpp                                 \
                csvwrapper/csvwrapper.cpp                            \
+               profilewrapper/profilewrapper.cpp                    \
                textviewer/textviewer.cpp                            \
                infodialog/infodialog.cpp                            \
                aecweightsdialog/aecweightsdialog.cpp                \
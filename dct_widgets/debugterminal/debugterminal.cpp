@@ -28,25 +28,34 @@
 #include <QMessageBox>
 #include <QKeyEvent>
 #include <QFileDialog>
-#include <QTextStream>
+#include <QFile>
 
 #include "debugterminal.h"
 #include "ui_debugterminal.h"
 #include <provideo_protocol/provideo_protocol_common.h>
 
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define TERMINAL_MAX_LINES          ( 10000 )       /**< line cap of the text browser */
+#define TERMINAL_RENDER_INTERVAL    ( 33 )          /**< render at most 30 times per second */
+#define TERMINAL_RENDER_MAX_BYTES   ( 256 * 1024 )  /**< max. log data rendered per frame */
+#define TERMINAL_SAVE_CHUNK_SIZE    ( 64 * 1024 )   /**< chunk size to stream the log into a file */
+
 /******************************************************************************
  * DebugTerminal::DebugTerminal
  *****************************************************************************/
 DebugTerminal::DebugTerminal( QWidget *parent ) :
     QWidget( parent ),
     ui( new Ui::DebugTerminal ),
-    currentHistoryIndex( -1 )
+    currentHistoryIndex( -1 ),
+    m_logPos( 0u )
 {
     // Setup UI
     ui->setupUi(this);
 
     // Limit number of lines in the text browser to 10000
-    ui->tbTerminal->document()->setMaximumBlockCount( 10000 );
+    ui->tbTerminal->document()->setMaximumBlockCount( TERMINAL_MAX_LINES );
     ui->sbxWaitTime->setValue(DEFAULT_CMD_TIMEOUT);
 
     // Install event filter on line edit to catch arrow up, down events
@@ -59,6 +68,12 @@ DebugTerminal::DebugTerminal( QWidget *parent ) :
     connect( ui->btnSaveLog, SIGNAL(clicked()), this, SLOT(onSaveLogClicked()) );
     connect( ui->btnClearTerminal, SIGNAL(clicked()), this, SLOT(onClearTerminalClicked()) );
     connect( ui->btnShowCommands, SIGNAL(clicked()), this, SLOT(onShowCommandsClicked()) );
+
+    // Render the traffic log in batched frames instead of per received chunk
+    m_renderTimer = new QTimer( this );
+    m_renderTimer->setInterval( TERMINAL_RENDER_INTERVAL );
+    connect( m_renderTimer, SIGNAL(timeout()), this, SLOT(onRenderTimeout()) );
+    m_renderTimer->start();
 }
 
 /******************************************************************************
@@ -167,13 +182,31 @@ bool DebugTerminal::eventFilter(QObject* obj, QEvent *event)
 }
 
 /******************************************************************************
- * DebugTerminal::onDataReceived
+ * DebugTerminal::onRenderTimeout
  *****************************************************************************/
-void DebugTerminal::onDataReceived( QString data )
+void DebugTerminal::onRenderTimeout()
 {
-    // Insert string witout a leading or trailing new line
+    quint64 last = m_log.last();
+
+    // Nothing new or nobody looking, the data stays in the log
+    if ( (m_logPos == last) || !isVisible() )
+    {
+        return;
+    }
+
+    // Skip a backlog which would be cut by the line cap anyway
+    if ( (last - m_logPos) > TERMINAL_RENDER_MAX_BYTES )
+    {
+        m_logPos = last - TERMINAL_RENDER_MAX_BYTES;
+    }
+
+    QByteArray chunk;
+    m_logPos = m_log.read( m_logPos, chunk, TERMINAL_RENDER_MAX_BYTES );
+    chunk.replace( "\r", "" );
+
+    // Insert all new data at once
     ui->tbTerminal->moveCursor( QTextCursor::End );
-    ui->tbTerminal->insertPlainText( data.remove(QRegExp("[\\r]")) );
+    ui->tbTerminal->insertPlainText( QString::fromLocal8Bit( chunk ) );
     ui->tbTerminal->moveCursor( QTextCursor::End );
 }
 
@@ -302,8 +335,14 @@ void DebugTerminal::onSaveLogClicked()
         }
         else
         {
-            QTextStream out(&file);
-            out << ui->tbTerminal->document()->toPlainText();
+            // Stream the complete log, not only the rendered lines
+            QByteArray chunk;
+            quint64 pos = m_log.first();
+            while ( pos < m_log.last() )
+            {
+                pos = m_log.read( pos, chunk, TERMINAL_SAVE_CHUNK_SIZE );
+                file.write( chunk.replace( "\r", "" ) );
+            }
             file.close();
         }
     }
@@ -314,7 +353,9 @@ void DebugTerminal::onSaveLogClicked()
  *****************************************************************************/
 void DebugTerminal::onClearTerminalClicked()
 {
-    // Clear content of terminal
+    // Clear content of terminal and log
+    m_log.clear();
+    m_logPos = m_log.last();
     ui->tbTerminal->clear();
 }
 
@@ -31,6 +31,9 @@
 #include <QEvent>
 #include <QList>
 #include <QString>
+#include <QTimer>
+
+#include "ComLog.h"
 
 namespace Ui {
 class DebugTerminal;
@@ -44,12 +47,15 @@ public:
     explicit DebugTerminal(QWidget *parent = nullptr);
     ~DebugTerminal() override;
 
+    // traffic log which is rendered by the terminal
+    ComLog * getLog()
+    {
+        return ( &m_log );
+    }
+
 signals:
     void sendData( QString data, int );
 
-public slots:
-    void onDataReceived( QString data );
-
 protected:
     void showEvent( QShowEvent* event ) override;
     void resizeEvent( QResizeEvent *event ) override;
@@ -59,6 +65,9 @@ private:
     Ui::DebugTerminal *ui;
     QList<QString> commandHistory;
     int currentHistoryIndex;
+    ComLog m_log;
+    quint64 m_logPos;
+    QTimer * m_renderTimer;
 
     void setWaitCursor()
     {
@@ -71,6 +80,7 @@ private:
     }
 
 private slots:
+    void onRenderTimeout();
     void onSendCommand();
     void onTextEdited( QString text );
     void onShowHelpClicked();
@@ -32,8 +32,11 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QMessageBox>
+#include <QTimer>
+#include <QElapsedTimer>
 
 #include "lensdriverbox.h"
+#include "lensprofilestore.h"
 #include "ui_lensdriverbox.h"
 #include "defines.h"
 
@@ -45,8 +48,14 @@ namespace Ui {
 }
 
 #define AUTO_REPEAT_THRESHOLD    ( 5000 )
-#define IRIS_APT_TABLE_MAX_NO_ROWS              ( 2 )
-#define IRIS_APT_TABLE_MAX_NO_COLUMNS           ( 9 )
+
+/******************************************************************************
+ * Motor positions are polled while a motor moves, until they did not change
+ * for a few polls or the longest possible move is over
+ *****************************************************************************/
+#define LENS_FOLLOW_DEFAULT_INTERVAL            ( 100 )
+#define LENS_FOLLOW_STABLE_POLLS                ( 4 )
+#define LENS_FOLLOW_MAX_TIME                    ( 30000 )
 
 /******************************************************************************
  * Overrule unconfigureable timer implementation in qt, there's  no property
@@ -101,14 +110,9 @@ public:
 #define LENSDRIVER_SETTINGS_IRIS_TABLE              ( "iris_table" )
 #define LENSDRIVER_SETTINGS_FILTER_SETTINGS         ( "filter_settings" )
 
-// Defines for the Lens Drive Iris Table Templates
-#define LENSDRIVER_LENS_TEMPLATES_SECTION_NAME      ( "LENS_DRIVER_IRIS_TEMPLATES")
-#define LENSDRIVER_LENS_TEMPLATES_NR_OF_TEMPLATES   ( "number_of_templates")
-#define LENSDRIVER_LENS_TEMPLATE                    ( "lens_template_")
-#define LENSDRIVER_LENS_FSTOP                       ( "fStops")
-#define LENSDRIVER_LENS_FSTOP_POS                   ( "fStop_pos")
-#define LENSDRIVER_LENS_COMPATIBLE                  ( "compatible_drive_device")
-#define LENSDRIVER_LENS_NAME                        ( "lens_name")
+// Lens driver iris table templates, next to the application
+#define LENSDRIVER_LENS_TEMPLATES_FILE              ( "SupportedLenses.txt" )
+#define LENSDRIVER_LENS_TEMPLATES_DIR               ( "tools_and_configs" )
 
 const lens_settings_t settingsUnkown {
     /* .address =             */ 0,
@@ -234,70 +238,6 @@ const lens_settings_t lensSettingProfiles[LensProfileMax] =
     settingsICS
 };
 
-/******************************************************************************
- * pairSort
- * @brief Sorts a List of pairs given by a and b components first by a and then
- *        by b value. Duplicates are removed and the sorted / cleaned vectors
- *        are returned. Both vectors must have the same lenght!
- * @param a Vector of the first component of the pairs
- * @param b Vector of the second component of the paris
- * @returns False if an error occured (e.g. length missmatch), true otherwise
- *****************************************************************************/
-static bool pairSort( QVector<int> &a, QVector<int> &b)
-{
-    if ( a.length() != b.length())
-    {
-        return false;
-    }
-
-    int size  = IRIS_APT_TABLE_MAX_NO_COLUMNS;
-
-    QList<QPair<int,int>> pointList;
-    for ( int  i= 0; i < a.length(); i++ )
-    {
-        // Do not add duplicates to the List
-        QPair<int,int> newPair(a.at(i), b.at(i));
-        if (!pointList.contains(newPair))
-        {
-            pointList.append(newPair);
-        }
-    }
-
-    // Sort it (will sort first for x, than for y, see QPair
-    std::sort(pointList.begin(), pointList.end());
-
-    // Write the results back into the table
-    a.clear();
-    b.clear();
-    for ( int i = ( pointList.length() -1 ); i >= 0; i--)
-    {
-        a.append(pointList.at(i).first);
-        b.append(pointList.at(i).second);
-    }
-
-    if(pointList.length() < size )
-    {
-        for(int i = (size - pointList.length() ); i > 0; i--)
-        {
-            a.append(0);
-            b.append(0);
-        }
-    }
-    else
-    {
-        if( pointList.length() > size )
-        {
-            for(int i = ( pointList.length() - size  ); i > 0; i--)
-            {
-                a.removeLast();
-                b.removeLast();
-            }
-        }
-    }
-
-    return true;
-}
-
 /******************************************************************************
  * Delegate
  *****************************************************************************/
@@ -437,6 +377,11 @@ public:
         , m_delegate( new LensDriverIrisTabStyledDelegat() )
         , m_LensSettings{}
         , m_LensIrisTable{}
+        , m_profiles( new LensProfileStore( parent ) )
+        , m_followTimer( new QTimer( parent ) )
+        , m_followTime()
+        , m_followStable( 0 )
+        , m_followMoved( false )
     {
         // initialize UI
         m_ui->setupUi( parent );
@@ -448,6 +393,12 @@ public:
         setDataModel();
 
         m_delegate->setBounds( 500, 500 );
+
+        // index the built-in profiles once, lookups are hashed
+        for ( int i = LensProfileFirst; i < LensProfileMax; i++ )
+        {
+            m_profiles->addProfile( i, GetLensProfileName( static_cast<enum LensProfile>(i) ), lensSettingProfiles[i] );
+        }
     }
 
     ~PrivateData()
@@ -572,152 +523,18 @@ public:
      *****************************************************************************/
     enum LensProfile GetLensProfileByName( QString profile )
     {
-        if( profile.compare(QString(LENS_PROFILE_NAME_UNKOWN)) == 0  )
-        {
-            return LensProfileUnknown;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_DCT_KIT_IRIS_1)) == 0 )
-        {
-            return LensProfileDctKit_iris_1;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_DCT_KIT_IRIS_2)) == 0  )
-        {
-            return LensProfileDctKit_iris_2;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_DCT_KIT_FOCUS_1)) == 0 )
-        {
-            return LensProfileDctKit_focus_1;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_DCT_KIT_FOCUS_2)) == 0 )
-        {
-            return LensProfileDctKit_focus_2;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_DCT_KIT_FOCUS_IRIS)) == 0 )
-        {
-            return LensProfileDctKit_focus_iris;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_DCT_KIT_IRIS_FOCUS)) == 0 )
-        {
-            return LensProfileDctKit_iris_focus;
-        }
-        if( profile.compare(QString(LENS_PROFILE_NAME_I_CS)) == 0 )
-        {
-            return LensProfileICS;
-        }
-
-        return LensProfileUnknown;
+        int id = m_profiles->profileByName( profile );
+        return ( (id < 0) ? LensProfileUnknown : static_cast<enum LensProfile>(id) );
     }
 
     /******************************************************************************
-     * getLensesFromFile( lens_iris_position_template_t )
+     * templateFileName()
      *****************************************************************************/
-    static bool getLensesFromFile( QVector<lens_iris_position_template_t>* table )
+    static QString templateFileName()
     {
-        QString m_filename = QDir::fromNativeSeparators(  QDir::currentPath() +
-                                                          QDir::separator() + "tools_and_configs" +
-                                                          QDir::separator() + "SupportedLenses.txt");
-
-        QFileInfo check_file( m_filename );
-
-        lens_iris_position_template_t temp_template;
-        QString temp_fstops;
-        QString temp_fstop_pos;
-
-        if ( check_file.exists() && check_file.isFile() )
-        {
-
-            // Open settings
-            QSettings settings( m_filename, QSettings::IniFormat );
-
-            // Load the device name and platform from the settings file
-            settings.beginGroup( LENSDRIVER_LENS_TEMPLATES_SECTION_NAME );
-            QString templates_nr = settings.value( LENSDRIVER_LENS_TEMPLATES_NR_OF_TEMPLATES ).toString();
-            settings.endGroup();
-
-            for(int i = 0; i < templates_nr.toInt(); i++)
-            {
-                settings.beginGroup( QString("%1%2").arg(LENSDRIVER_LENS_TEMPLATE).arg(i+1) );
-
-                temp_template.lensName = settings.value( LENSDRIVER_LENS_NAME ).toString();
-                temp_template.compatibleID.append( settings.value( LENSDRIVER_LENS_COMPATIBLE ).toInt() );
-
-                temp_fstops = settings.value( LENSDRIVER_LENS_FSTOP ).toString();
-                temp_fstop_pos = settings.value( LENSDRIVER_LENS_FSTOP_POS ).toString();
-
-
-               QStringList temp_fstop_list = temp_fstops.split(QRegularExpression("\\s+"));
-               QStringList temp_fstop_pos_list = temp_fstop_pos.split(QRegularExpression("\\s+"));
-
-               for( int a = 0; a < temp_fstop_list.length(); a++ )
-               {
-                   temp_template.fStops.append(temp_fstop_list.value(a).toInt());
-                   temp_template.fStopPos.append(temp_fstop_pos_list.value(a).toInt());
-               }
-
-               pairSort(temp_template.fStops,temp_template.fStopPos);
-
-               settings.endGroup();
-               table->append(temp_template);
-
-               temp_template.fStops.clear();
-               temp_template.fStopPos.clear();
-               temp_template.compatibleID.clear();
-               temp_template.lensName.clear();
-            }
-
-            return true;
-        }
-        else
-        {
-            return false;
-        }
-
-    }
-
-    /******************************************************************************
-     * setLensesToFile( lens_iris_position_template_t )
-     *****************************************************************************/
-    static bool setLensesToFile( QVector<lens_iris_position_template_t> table )
-    {
-         QString m_filename = "SupportedLenses.txt";
-
-         QString temp_fstops;
-         QString temp_fstopPos;
-
-         // Open settings file and make sure it is clean
-         QSettings settings( m_filename, QSettings::IniFormat );
-         settings.clear();
-
-         // Write the device name and platform into the settings file
-         settings.beginGroup( LENSDRIVER_LENS_TEMPLATES_SECTION_NAME );
-         settings.setValue( LENSDRIVER_LENS_TEMPLATES_NR_OF_TEMPLATES, table.length() );
-         settings.endGroup();
-
-         for(int i = 0; i < table.length(); i++)
-         {
-             settings.beginGroup( QString("%1%2").arg(LENSDRIVER_LENS_TEMPLATE).arg(i+1) );
-
-             settings.setValue( LENSDRIVER_LENS_NAME, table.value(i).lensName );
-             settings.setValue( LENSDRIVER_LENS_COMPATIBLE, table.value(i).compatibleID.first() );
-
-             for( int a = 0; a < table.value(i).fStops.length(); a++ )
-             {
-                 temp_fstops.append(QString("%1 ").arg(table.value(i).fStops.value(a)) );
-                 temp_fstopPos.append(QString("%1 ").arg(table.value(i).fStopPos.value(a)) );
-             }
-
-            settings.setValue( LENSDRIVER_LENS_FSTOP, temp_fstops );
-            settings.setValue( LENSDRIVER_LENS_FSTOP_POS, temp_fstopPos );
-
-            temp_fstops.clear();
-            temp_fstopPos.clear();
-
-            settings.endGroup();
-
-         }
-
-         return true;
-
+        return ( QDir::fromNativeSeparators( QDir::currentPath() +
+                                             QDir::separator() + LENSDRIVER_LENS_TEMPLATES_DIR +
+                                             QDir::separator() + LENSDRIVER_LENS_TEMPLATES_FILE ) );
     }
 
     Ui::UI_LensDriverBox *  m_ui;           /**< ui handle */
@@ -729,7 +546,12 @@ public:
     QStandardItemModel *    m_model;                        /**< data model */
     lens_settings_t         m_LensSettings;
     lens_iris_position_t    m_LensIrisTable;
-    QVector<lens_iris_position_template_t> m_LensIrisTemplates;
+    LensProfileStore *      m_profiles;     /**< lens profiles and iris templates */
+
+    QTimer *                m_followTimer;  /**< motor position poll timer */
+    QElapsedTimer           m_followTime;   /**< time since last motor start */
+    int                     m_followStable; /**< polls without motor movement */
+    bool                    m_followMoved;  /**< a motor position changed */
 };
 
 /******************************************************************************
@@ -836,9 +658,11 @@ LensDriverBox::LensDriverBox( QWidget * parent ) : DctWidgetBox( parent )
     d_data->m_ui->btnIrisTransmitTable->setVisible(false);
     d_data->m_ui->btnDeleteColumn->setVisible(false);
 
-    // Lens control is not supported for IronSDI, no need to check this file
+    // Lens control is not supported for IronSDI, a missing file is not reported
+    d_data->m_profiles->load( d_data->templateFileName() );
+    connect( d_data->m_profiles, SIGNAL(templatesChanged()), this, SLOT(onLensIrisTemplatesChange()) );
     /*
-    if( ! d_data->getLensesFromFile(&d_data->m_LensIrisTemplates) )
+    if( ! d_data->m_profiles->templateCount() )
     {
         QMessageBox::warning( this,
                               "Lens driver template file not found",
@@ -846,8 +670,7 @@ LensDriverBox::LensDriverBox( QWidget * parent ) : DctWidgetBox( parent )
                               "Please make sure that the file 'SupportedLenses.txt' is "
                               "placed in a folder named 'tools_and_configs' which is placed "
                               "in the same folder that 'SDIControlPoint.exe' is placed.\n\n"
-                              "Please restart the GUI after the file was restored to use"
-                              "the available templates." );
+                              "The templates are loaded as soon as the file is restored." );
     }
     */
 
@@ -866,6 +689,10 @@ LensDriverBox::LensDriverBox( QWidget * parent ) : DctWidgetBox( parent )
 
     connect( this , SIGNAL(LensSettingsChanged(bool)), this, SLOT(onLensActiveChange(bool)) );
 
+    // motor position follow
+    d_data->m_followTimer->setInterval( LENS_FOLLOW_DEFAULT_INTERVAL );
+    connect( d_data->m_followTimer, SIGNAL(timeout()), this, SLOT(onLensPositionFollowTimeout()) );
+
     // Focus Elements
     connect( d_data->m_ui->sbxFocusPosition, SIGNAL(valueChanged(int)), this, SLOT(onSbxLensFocusPositionChanged(int)));
     connect( d_data->m_ui->sldFocusPosition,SIGNAL(valueChanged(int)), d_data->m_ui->sbxFocusPosition, SLOT(setValue(int)));
@@ -1000,25 +827,8 @@ lens_settings_t LensDriverBox::profileToSettings( enum LensProfile profile )
  *****************************************************************************/
 enum LensProfile LensDriverBox::settingsToProfile( lens_settings_t settings )
 {
-    for ( int i = 0; i < LensProfileMax; i++ )
-    {
-        if ( settings.address == lensSettingProfiles[i].address &&
-             settings.chipID == lensSettingProfiles[i].chipID &&
-             settings.controllerFeatures == lensSettingProfiles[i].controllerFeatures &&
-             settings.focusMotorNr == lensSettingProfiles[i].focusMotorNr &&
-             settings.zoomMotorNr == lensSettingProfiles[i].zoomMotorNr &&
-             settings.irisMotorNr == lensSettingProfiles[i].irisMotorNr &&
-             settings.filterMotorNr == lensSettingProfiles[i].filterMotorNr &&
-             settings.focusMotorFeatures == lensSettingProfiles[i].focusMotorFeatures &&
-             settings.zoomMotorFeatures == lensSettingProfiles[i].zoomMotorFeatures &&
-             settings.irisMotorFeatures == lensSettingProfiles[i].irisMotorFeatures &&
-             settings.filterMotorFeatures == lensSettingProfiles[i].filterMotorFeatures )
-        {
-            return static_cast<enum LensProfile>(i);
-        }
-    }
-
-    return LensProfileUnknown;
+    int id = d_data->m_profiles->profileBySettings( settings );
+    return ( (id < 0) ? LensProfileUnknown : static_cast<enum LensProfile>(id) );
 }
 
 /******************************************************************************
@@ -1050,6 +860,24 @@ void LensDriverBox::addLensIrisTemplate( QString name, int id )
     d_data->m_ui->cbxIrisTableTemplate->addItem( name, id );
     d_data->m_ui->cbxIrisTableTemplate->blockSignals( false );
 }
+
+/******************************************************************************
+ * LensDriverBox::fillLensIrisTemplates
+ *****************************************************************************/
+void LensDriverBox::fillLensIrisTemplates()
+{
+    QVector<int> templates = d_data->m_profiles->templatesForChipID( d_data->m_LensSettings.chipID );
+
+    d_data->m_ui->cbxIrisTableTemplate->blockSignals(true);
+    d_data->m_ui->cbxIrisTableTemplate->clear();
+    d_data->m_ui->cbxIrisTableTemplate->blockSignals(false);
+
+    addLensIrisTemplate("Choose a Template",1);
+    for( int i = 0; i < templates.size(); i++)
+    {
+        addLensIrisTemplate(d_data->m_profiles->templateAt(templates.at(i)).lensName,templates.at(i));
+    }
+}
 /******************************************************************************
  * LensDriverBox::LensProfile
  *****************************************************************************/
@@ -1608,6 +1436,21 @@ int LensDriverBox::enableLensMotorSettings(enum LensFeatues features,int motorSe
     return res;
 }
 
+/******************************************************************************
+ * LensDriverBox::startLensPositionFollow
+ *****************************************************************************/
+void LensDriverBox::startLensPositionFollow()
+{
+    // a new target restarts the move, the timer keeps running
+    d_data->m_followStable = 0;
+    d_data->m_followTime.start();
+
+    if ( !d_data->m_followTimer->isActive() )
+    {
+        d_data->m_followTimer->start();
+    }
+}
+
 /******************************************************************************
  * LensDriverBox::onLensSettingsChange
  *****************************************************************************/
@@ -1699,18 +1542,15 @@ void LensDriverBox::onLensActiveChange( bool active )
     d_data->m_ui->cbxLensProfile->blockSignals( false );
 
 
-    d_data->m_ui->cbxIrisTableTemplate->blockSignals(true);
-    d_data->m_ui->cbxIrisTableTemplate->clear();
-    d_data->m_ui->cbxIrisTableTemplate->blockSignals(true);
+    fillLensIrisTemplates();
+}
 
-    addLensIrisTemplate("Choose a Template",1);
-    for( int i = 0; i < d_data->m_LensIrisTemplates.length(); i++)
-    {
-        if( d_data->m_LensIrisTemplates.value(i).compatibleID.contains( d_data->m_LensSettings.chipID))
-        {
-            addLensIrisTemplate(d_data->m_LensIrisTemplates.value(i).lensName,i);
-        }
-    }
+/******************************************************************************
+ * LensDriverBox::onLensIrisTemplatesChange
+ *****************************************************************************/
+void LensDriverBox::onLensIrisTemplatesChange()
+{
+    fillLensIrisTemplates();
 }
 
 /******************************************************************************
@@ -1740,6 +1580,8 @@ void LensDriverBox::onLensInvertChange( QVector<int> values )
  *****************************************************************************/
 void LensDriverBox::onLensFocusPositionChange( int pos )
 {
+    d_data->m_followMoved = true;
+
     d_data->m_ui->sbxFocusPosition->blockSignals( true );
     d_data->m_ui->sbxFocusPosition->setValue(pos);
     d_data->m_ui->sbxFocusPosition->blockSignals( false );
@@ -1765,6 +1607,8 @@ void LensDriverBox::onLensFocusFineChange( bool en )
  *****************************************************************************/
 void LensDriverBox::onLensZoomPositionChange( int pos )
 {
+    d_data->m_followMoved = true;
+
     d_data->m_ui->sbxZoomPosition->blockSignals( true );
     d_data->m_ui->sbxZoomPosition->setValue(pos);
     d_data->m_ui->sbxZoomPosition->blockSignals( false );
@@ -1789,6 +1633,8 @@ void LensDriverBox::onLensZoomInvertChange( bool en )
  *****************************************************************************/
 void LensDriverBox::onLensIrisPositionChange( int pos )
 {
+    d_data->m_followMoved = true;
+
     d_data->m_ui->sbxIrisPosition->blockSignals( true );
     d_data->m_ui->sbxIrisPosition->setValue(pos);
     d_data->m_ui->sbxIrisPosition->blockSignals( false );
@@ -1982,6 +1828,14 @@ void LensDriverBox::onLensFilterSettingsChange(  QVector<int> values  )
 
 
 
+/******************************************************************************
+ * LensDriverBox::onLensPositionFollowIntervalChange
+ *****************************************************************************/
+void LensDriverBox::onLensPositionFollowIntervalChange( int ms )
+{
+    d_data->m_followTimer->setInterval( ms );
+}
+
 /******************************************************************************
  * LensDriverBox::onCbxLensSettingsChange
  *****************************************************************************/
@@ -2066,6 +1920,7 @@ void LensDriverBox::onSbxLensFocusPositionChanged( int pos )
 
         setWaitCursor();
         emit LensFocusPositionChanged( pos );
+        startLensPositionFollow();
         setNormalCursor();
 }
 
@@ -2169,6 +2024,7 @@ void LensDriverBox::onSbxLensZoomPositionChanged( int pos )
 {
         setWaitCursor();
         emit LensZoomPositionChanged( pos );
+        startLensPositionFollow();
         setNormalCursor();
 }
 
@@ -2245,6 +2101,7 @@ void LensDriverBox::onSbxLensIrisPositionChanged( int pos )
 {
         setWaitCursor();
         emit LensIrisPositionChanged( pos );
+        startLensPositionFollow();
         emit LensIrisAperturePosChanged( pos );
         setNormalCursor();
 }
@@ -2325,6 +2182,7 @@ void LensDriverBox::onCbxLensIrisApertureChanged( int index)
         setWaitCursor();
         emit LensIrisApertureChanged( d_data->m_LensIrisTable.fStops.value( ( index - 1 ) ) );
         emit LensIrisAperturePosChanged( d_data->m_LensIrisTable.fStopsPos.value( ( index - 1 ) ) );
+        startLensPositionFollow();
         setNormalCursor();
     }
 }
@@ -2351,6 +2209,7 @@ void LensDriverBox::onBtnLensIrisAperturePlusChanged( void )
         setWaitCursor();
         emit LensIrisApertureChanged( d_data->m_LensIrisTable.fStops.value( ( index  ) ) );
         emit LensIrisAperturePosChanged( d_data->m_LensIrisTable.fStopsPos.value( ( index  ) ) );
+        startLensPositionFollow();
         setNormalCursor();
     }
 }
@@ -2376,6 +2235,7 @@ void LensDriverBox::onBtnLensIrisApertureMinusChanged( void )
         setWaitCursor();
         emit LensIrisApertureChanged( d_data->m_LensIrisTable.fStops.value( ( index + 1 ) ) );
         emit LensIrisAperturePosChanged( d_data->m_LensIrisTable.fStopsPos.value( ( index + 1 ) ) );
+        startLensPositionFollow();
         setNormalCursor();
     }
 }
@@ -2460,22 +2320,18 @@ void LensDriverBox::onBtnLensIrisTableRemoveColumnChanged( void )
  *****************************************************************************/
 void LensDriverBox::onCbxLensIrisTemplateChanged( int index )
 {
-    int i = 0;
     QVector<double> tempFStops;
     QVector<int> tempFStopPos;
 
-    while( d_data->m_LensIrisTemplates.value(i).lensName.compare( d_data->m_ui->cbxIrisTableTemplate->itemText(index)) != 0 && i < d_data->m_LensIrisTemplates.length() )
-    {
-        i++;
-    }
+    const lens_iris_position_template_t * t =
+        d_data->m_profiles->templateByName( d_data->m_ui->cbxIrisTableTemplate->itemText(index) );
 
-    if( i < d_data->m_LensIrisTemplates.length() )
+    if( t )
     {
-
-        for( int a = 0; a < d_data->m_LensIrisTemplates.value(i).fStops.length(); a++ )
+        for( int a = 0; a < t->fStops.length(); a++ )
         {
-            tempFStops.append( double( d_data->m_LensIrisTemplates.value(i).fStops.value(a) ) / 10);
-            tempFStopPos.append( d_data->m_LensIrisTemplates.value(i).fStopPos.value(a) );
+            tempFStops.append( double( t->fStops.value(a) ) / 10);
+            tempFStopPos.append( t->fStopPos.value(a) );
         }
 
         d_data->fillTable(tempFStops,tempFStopPos);
@@ -2561,3 +2417,29 @@ void LensDriverBox::onCbxLensFilterInvertChanged( int enable)
     setNormalCursor();
 }
 
+/******************************************************************************
+ * LensDriverBox::onLensPositionFollowTimeout
+ *****************************************************************************/
+void LensDriverBox::onLensPositionFollowTimeout( void )
+{
+    // do not move a slider under the mouse
+    if ( d_data->m_ui->sldFocusPosition->isSliderDown() ||
+         d_data->m_ui->sldZoomPosition->isSliderDown() ||
+         d_data->m_ui->sldIrisPosition->isSliderDown() )
+    {
+        d_data->m_followStable = 0;
+        return;
+    }
+
+    // moved motors are reported through the position slots
+    d_data->m_followMoved = false;
+    emit LensPositionFollowRequest();
+
+    d_data->m_followStable = d_data->m_followMoved ? 0 : (d_data->m_followStable + 1);
+
+    if ( (d_data->m_followStable >= LENS_FOLLOW_STABLE_POLLS) ||
+         d_data->m_followTime.hasExpired( LENS_FOLLOW_MAX_TIME ) )
+    {
+        d_data->m_followTimer->stop();
+    }
+}
@@ -27,6 +27,9 @@
 #include <QItemSelection>
 #include "defines.h"
 
+#define IRIS_APT_TABLE_MAX_NO_ROWS              ( 2 )
+#define IRIS_APT_TABLE_MAX_NO_COLUMNS           ( 9 )
+
 typedef struct lens_settings_s {
     int address;
     int chipID;
@@ -98,12 +101,14 @@ protected:
     void addLensProfile( QString name, int id );
     void addLensIrisAperture( QString name, int id );
     void addLensIrisTemplate( QString name, int id );
+    void fillLensIrisTemplates();
 
 private:
     lens_settings_t profileToSettings( enum LensProfile profile );
     enum LensProfile settingsToProfile( lens_settings_t settings );
     int showLensProfilBoxes(enum LensProfile);
     int enableLensMotorSettings(enum LensFeatues features,int motorSettings);
+    void startLensPositionFollow();
 
 
 signals:
@@ -113,6 +118,7 @@ signals:
     void LensInvertChanged( QVector<int> values );
 
     void SmallResyncRequest(void);
+    void LensPositionFollowRequest(void);
 
     void LensFocusPositionChanged( int pos );
     void LensFocusFineChanged( bool en );
@@ -131,6 +137,7 @@ public slots:
     void onLensSettingsChange( QVector<int> values );
     void onLensActiveChange( bool active );
     void onLensInvertChange( QVector<int> );
+    void onLensIrisTemplatesChange();
     void onLensFocusPositionChange( int pos);
     void onLensFocusFineChange( bool en );
     void onLensZoomPositionChange( int pos);
@@ -145,8 +152,11 @@ public slots:
     void onLensIrisSetupChange( QVector<int> values );
     void onLensIrisAperturePosChange( int pos );
     void onLensFilterSettingsChange( QVector<int>  );
+    void onLensPositionFollowIntervalChange( int ms );
 
 private slots:
+    void onLensPositionFollowTimeout( void );
+
     void onCbxLensProfileChange( int index );
     void onBtnLensActiveChange( void );
     void onCbxLensEnableAdvancedSettings(int check);
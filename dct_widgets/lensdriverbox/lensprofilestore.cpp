@@ -0,0 +1,389 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    lensprofilestore.cpp
+ *
+ * @brief   Implementation of the lens profile and iris template store
+ *
+ *****************************************************************************/
+#include <cstring>
+#include <algorithm>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QList>
+#include <QPair>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QTimer>
+
+#include "lensprofilestore.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// Defines for the Lens Drive Iris Table Templates
+#define LENSDRIVER_LENS_TEMPLATES_SECTION_NAME      ( "LENS_DRIVER_IRIS_TEMPLATES")
+#define LENSDRIVER_LENS_TEMPLATES_NR_OF_TEMPLATES   ( "number_of_templates")
+#define LENSDRIVER_LENS_TEMPLATE                    ( "lens_template_")
+#define LENSDRIVER_LENS_FSTOP                       ( "fStops")
+#define LENSDRIVER_LENS_FSTOP_POS                   ( "fStop_pos")
+#define LENSDRIVER_LENS_COMPATIBLE                  ( "compatible_drive_device")
+#define LENSDRIVER_LENS_NAME                        ( "lens_name")
+
+// editors write a file in several steps, reload once it settled
+#define LENS_TEMPLATES_RELOAD_DELAY                 ( 200 )
+
+/******************************************************************************
+ * operator==
+ *****************************************************************************/
+bool operator==( const lens_settings_t & a, const lens_settings_t & b )
+{
+    return ( !memcmp( &a, &b, sizeof(lens_settings_t) ) );
+}
+
+/******************************************************************************
+ * qHash
+ *****************************************************************************/
+uint qHash( const lens_settings_t & key, uint seed )
+{
+    // lens_settings_t consists of ints only, there is no padding to hash
+    return ( qHashBits( &key, sizeof(lens_settings_t), seed ) );
+}
+
+/******************************************************************************
+ * pairSort
+ * @brief Sorts a List of pairs given by a and b components first by a and then
+ *        by b value. Duplicates are removed and the sorted / cleaned vectors
+ *        are returned. Both vectors must have the same lenght!
+ * @param a Vector of the first component of the pairs
+ * @param b Vector of the second component of the paris
+ * @returns False if an error occured (e.g. length missmatch), true otherwise
+ *****************************************************************************/
+bool pairSort( QVector<int> &a, QVector<int> &b)
+{
+    if ( a.length() != b.length())
+    {
+        return false;
+    }
+
+    int size  = IRIS_APT_TABLE_MAX_NO_COLUMNS;
+
+    QList<QPair<int,int>> pointList;
+    for ( int  i= 0; i < a.length(); i++ )
+    {
+        // Do not add duplicates to the List
+        QPair<int,int> newPair(a.at(i), b.at(i));
+        if (!pointList.contains(newPair))
+        {
+            pointList.append(newPair);
+        }
+    }
+
+    // Sort it (will sort first for x, than for y, see QPair
+    std::sort(pointList.begin(), pointList.end());
+
+    // Write the results back into the table
+    a.clear();
+    b.clear();
+    for ( int i = ( pointList.length() -1 ); i >= 0; i--)
+    {
+        a.append(pointList.at(i).first);
+        b.append(pointList.at(i).second);
+    }
+
+    if(pointList.length() < size )
+    {
+        for(int i = (size - pointList.length() ); i > 0; i--)
+        {
+            a.append(0);
+            b.append(0);
+        }
+    }
+    else
+    {
+        if( pointList.length() > size )
+        {
+            for(int i = ( pointList.length() - size  ); i > 0; i--)
+            {
+                a.removeLast();
+                b.removeLast();
+            }
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * LensProfileStore::LensProfileStore
+ *****************************************************************************/
+LensProfileStore::LensProfileStore( QObject * parent )
+    : QObject( parent )
+    , m_watcher( new QFileSystemWatcher( this ) )
+    , m_reloadTimer( new QTimer( this ) )
+{
+    m_reloadTimer->setSingleShot( true );
+    m_reloadTimer->setInterval( LENS_TEMPLATES_RELOAD_DELAY );
+
+    connect( m_watcher, SIGNAL(fileChanged(const QString &)), this, SLOT(onFileChanged()) );
+    connect( m_watcher, SIGNAL(directoryChanged(const QString &)), this, SLOT(onFileChanged()) );
+    connect( m_reloadTimer, SIGNAL(timeout()), this, SLOT(onReloadTimeout()) );
+}
+
+/******************************************************************************
+ * LensProfileStore::addProfile
+ *****************************************************************************/
+void LensProfileStore::addProfile( int id, const QString & name, const lens_settings_t & settings )
+{
+    if ( !m_profileBySettings.contains( settings ) )
+    {
+        m_profileBySettings.insert( settings, id );
+    }
+
+    if ( !m_profileByName.contains( name ) )
+    {
+        m_profileByName.insert( name, id );
+    }
+}
+
+/******************************************************************************
+ * LensProfileStore::profileBySettings
+ *****************************************************************************/
+int LensProfileStore::profileBySettings( const lens_settings_t & settings ) const
+{
+    return ( m_profileBySettings.value( settings, -1 ) );
+}
+
+/******************************************************************************
+ * LensProfileStore::profileByName
+ *****************************************************************************/
+int LensProfileStore::profileByName( const QString & name ) const
+{
+    return ( m_profileByName.value( name, -1 ) );
+}
+
+/******************************************************************************
+ * LensProfileStore::load
+ *****************************************************************************/
+bool LensProfileStore::load( const QString & fileName )
+{
+    m_fileName = fileName;
+    watch();
+
+    return ( parse( fileName ) );
+}
+
+/******************************************************************************
+ * LensProfileStore::save
+ *****************************************************************************/
+bool LensProfileStore::save( const QString & fileName ) const
+{
+    // Open settings file and make sure it is clean
+    QSettings settings( fileName, QSettings::IniFormat );
+    settings.clear();
+
+    // Write the number of templates into the settings file
+    settings.beginGroup( LENSDRIVER_LENS_TEMPLATES_SECTION_NAME );
+    settings.setValue( LENSDRIVER_LENS_TEMPLATES_NR_OF_TEMPLATES, m_templates.size() );
+    settings.endGroup();
+
+    for ( int i = 0; i < m_templates.size(); i++ )
+    {
+        const lens_iris_position_template_t & t = m_templates.at( i );
+        QString fstops;
+        QString fstopPos;
+
+        settings.beginGroup( QString("%1%2").arg(LENSDRIVER_LENS_TEMPLATE).arg(i+1) );
+
+        settings.setValue( LENSDRIVER_LENS_NAME, t.lensName );
+        settings.setValue( LENSDRIVER_LENS_COMPATIBLE, t.compatibleID.value( 0 ) );
+
+        for ( int a = 0; a < t.fStops.size(); a++ )
+        {
+            fstops.append( QString("%1 ").arg(t.fStops.at(a)) );
+            fstopPos.append( QString("%1 ").arg(t.fStopPos.value(a)) );
+        }
+
+        settings.setValue( LENSDRIVER_LENS_FSTOP, fstops );
+        settings.setValue( LENSDRIVER_LENS_FSTOP_POS, fstopPos );
+
+        settings.endGroup();
+    }
+
+    settings.sync();
+
+    return ( settings.status() == QSettings::NoError );
+}
+
+/******************************************************************************
+ * LensProfileStore::templateByName
+ *****************************************************************************/
+const lens_iris_position_template_t * LensProfileStore::templateByName( const QString & name ) const
+{
+    QHash<QString, int>::const_iterator it = m_templateByName.constFind( name );
+
+    return ( (it != m_templateByName.constEnd()) ? &m_templates.at( it.value() ) : nullptr );
+}
+
+/******************************************************************************
+ * LensProfileStore::templatesForChipID
+ *****************************************************************************/
+QVector<int> LensProfileStore::templatesForChipID( int chipID ) const
+{
+    QVector<int> indices;
+
+    for ( QMultiHash<int, int>::const_iterator it = m_templatesByChipID.constFind( chipID );
+          (it != m_templatesByChipID.constEnd()) && (it.key() == chipID); ++it )
+    {
+        indices.append( it.value() );
+    }
+
+    // a multi-hash returns the values of a key in reverse insertion order
+    std::sort( indices.begin(), indices.end() );
+
+    return ( indices );
+}
+
+/******************************************************************************
+ * LensProfileStore::parse
+ *****************************************************************************/
+bool LensProfileStore::parse( const QString & fileName )
+{
+    QFileInfo check_file( fileName );
+
+    m_modified = check_file.exists() ? check_file.lastModified() : QDateTime();
+
+    m_templates.clear();
+    m_templateByName.clear();
+    m_templatesByChipID.clear();
+
+    if ( !check_file.exists() || !check_file.isFile() )
+    {
+        return ( false );
+    }
+
+    // Open settings
+    QSettings settings( fileName, QSettings::IniFormat );
+
+    settings.beginGroup( LENSDRIVER_LENS_TEMPLATES_SECTION_NAME );
+    int count = settings.value( LENSDRIVER_LENS_TEMPLATES_NR_OF_TEMPLATES ).toInt();
+    settings.endGroup();
+
+    m_templates.reserve( count );
+
+    QRegularExpression separator( "\\s+" );
+
+    for ( int i = 0; i < count; i++ )
+    {
+        lens_iris_position_template_t t;
+
+        settings.beginGroup( QString("%1%2").arg(LENSDRIVER_LENS_TEMPLATE).arg(i+1) );
+
+        t.lensName = settings.value( LENSDRIVER_LENS_NAME ).toString();
+        t.compatibleID.append( settings.value( LENSDRIVER_LENS_COMPATIBLE ).toInt() );
+
+        QStringList fstops   = settings.value( LENSDRIVER_LENS_FSTOP ).toString().split( separator );
+        QStringList fstopPos = settings.value( LENSDRIVER_LENS_FSTOP_POS ).toString().split( separator );
+
+        for ( int a = 0; a < fstops.size(); a++ )
+        {
+            t.fStops.append( fstops.value(a).toInt() );
+            t.fStopPos.append( fstopPos.value(a).toInt() );
+        }
+
+        pairSort( t.fStops, t.fStopPos );
+
+        settings.endGroup();
+
+        int index = m_templates.size();
+        m_templates.append( t );
+
+        // the first template of a name is the one selected by name
+        if ( !m_templateByName.contains( t.lensName ) )
+        {
+            m_templateByName.insert( t.lensName, index );
+        }
+
+        for ( int a = 0; a < t.compatibleID.size(); a++ )
+        {
+            m_templatesByChipID.insert( t.compatibleID.at(a), index );
+        }
+    }
+
+    return ( settings.status() == QSettings::NoError );
+}
+
+/******************************************************************************
+ * LensProfileStore::watch
+ *****************************************************************************/
+void LensProfileStore::watch()
+{
+    QFileInfo info( m_fileName );
+
+    if ( !m_watcher->files().isEmpty() )
+    {
+        m_watcher->removePaths( m_watcher->files() );
+    }
+
+    if ( !m_watcher->directories().isEmpty() )
+    {
+        m_watcher->removePaths( m_watcher->directories() );
+    }
+
+    // the directory is watched as well, to notice a file that is created,
+    // or replaced by an editor which writes a new file and renames it
+    if ( info.absoluteDir().exists() )
+    {
+        m_watcher->addPath( info.absolutePath() );
+    }
+
+    if ( info.exists() )
+    {
+        m_watcher->addPath( info.absoluteFilePath() );
+    }
+}
+
+/******************************************************************************
+ * LensProfileStore::onFileChanged
+ *****************************************************************************/
+void LensProfileStore::onFileChanged()
+{
+    m_reloadTimer->start();
+}
+
+/******************************************************************************
+ * LensProfileStore::onReloadTimeout
+ *****************************************************************************/
+void LensProfileStore::onReloadTimeout()
+{
+    QFileInfo info( m_fileName );
+
+    // a replaced file is a new file for the watcher
+    watch();
+
+    // other files in the directory changed
+    if ( (info.exists() ? info.lastModified() : QDateTime()) == m_modified )
+    {
+        return;
+    }
+
+    parse( m_fileName );
+
+    emit templatesChanged();
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    lensprofilestore.h
+ *
+ * @brief   Indexed store of lens controller profiles and iris templates
+ *
+ * @note    Controller profiles are looked up by name and by their complete
+ *          settings tuple, iris templates by lens name and by the chip-ID
+ *          of the lens controller they are compatible with. All lookups are
+ *          hashed, the template file is parsed once when it is loaded and
+ *          again only when it changes on disk.
+ *
+ *****************************************************************************/
+#ifndef _LENS_PROFILE_STORE_H_
+#define _LENS_PROFILE_STORE_H_
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QMultiHash>
+#include <QString>
+#include <QVector>
+
+#include "lensdriverbox.h"
+
+class QFileSystemWatcher;
+class QTimer;
+
+// lens settings are equal if all fields are equal
+bool operator==( const lens_settings_t & a, const lens_settings_t & b );
+uint qHash( const lens_settings_t & key, uint seed = 0 );
+
+// sort f-stop / position pairs descending, drop duplicates and pad to table width
+bool pairSort( QVector<int> &a, QVector<int> &b );
+
+class LensProfileStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LensProfileStore( QObject * parent = nullptr );
+
+    // register a controller profile, the first profile of a settings tuple wins
+    void addProfile( int id, const QString & name, const lens_settings_t & settings );
+
+    // id of a controller profile, -1 if unknown
+    int profileBySettings( const lens_settings_t & settings ) const;
+    int profileByName( const QString & name ) const;
+
+    // load iris templates from a template file and follow its changes, false on error
+    bool load( const QString & fileName );
+    bool save( const QString & fileName ) const;
+
+    int templateCount() const
+    {
+        return ( m_templates.size() );
+    }
+
+    const lens_iris_position_template_t & templateAt( int i ) const
+    {
+        return ( m_templates.at( i ) );
+    }
+
+    // template of a lens, nullptr if unknown
+    const lens_iris_position_template_t * templateByName( const QString & name ) const;
+
+    // indices of the templates compatible to a chip-ID, in file order
+    QVector<int> templatesForChipID( int chipID ) const;
+
+signals:
+    // template file was reloaded after a change on disk
+    void templatesChanged();
+
+private slots:
+    void onFileChanged();
+    void onReloadTimeout();
+
+private:
+    bool parse( const QString & fileName );
+    void watch();
+
+    QHash<lens_settings_t, int>             m_profileBySettings;    /**< settings -> profile id */
+    QHash<QString, int>                     m_profileByName;        /**< name -> profile id */
+
+    QVector<lens_iris_position_template_t>  m_templates;            /**< templates in file order */
+    QHash<QString, int>                     m_templateByName;       /**< lens name -> template index */
+    QMultiHash<int, int>                    m_templatesByChipID;    /**< chip-ID -> template indices */
+
+    QString                                 m_fileName;             /**< loaded template file */
+    QDateTime                               m_modified;             /**< modification time of parsed file */
+    QFileSystemWatcher *                    m_watcher;              /**< template file watcher */
+    QTimer *                                m_reloadTimer;          /**< coalesces change notifications */
+};
+
+#endif // _LENS_PROFILE_STORE_H_
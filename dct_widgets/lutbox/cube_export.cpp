@@ -0,0 +1,469 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    cube_export.cpp
+ *
+ * @brief   Implementation of a baked 3D LUT (.cube) export
+ *
+ *****************************************************************************/
+#include <cstring>
+
+#include <QtDebug>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QFile>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include "cube_export.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// fixed point formats of the device interfaces
+#define GAIN_ONE                        ( 256.0f )      // white balance gains, Q8
+#define CROSS_ONE                       ( 4096.0f )     // colour correction matrix, S0.12
+#define CROSS_OFFSET_ONE                ( 4096.0f )     // colour correction offsets, 12 bit
+#define CONV_ONE                        ( 4096.0f )     // colour conversion matrix, S0.12
+#define MCC_SATURATION_ONE              ( 16384.0f )    // multi colour control saturation, Q2.14
+#define MCC_HUE_90                      ( 16384.0f )    // multi colour control hue of 90 degree
+#define CPROC_BRIGHTNESS_ONE            ( 256.0f )      // colour processing brightness, 8 bit
+#define CPROC_ONE                       ( 128.0f )      // colour processing contrast/saturation, Q1.7
+#define CPROC_HUE_90                    ( 128.0f )      // colour processing hue of 90 degree
+
+// longest line of a lattice point, "1.000000 1.000000 1.000000\n"
+#define CUBE_LINE_LENGTH                ( 27 )
+
+/******************************************************************************
+ * formatValue - print v in [0, 1] with six decimals, like "%.6f" but
+ *               without the locale and format parsing of the printf family
+ *****************************************************************************/
+static char * formatValue( char * p, float v )
+{
+    int n = (int)(v * 1e6f + 0.5f);
+    int d;
+
+    if ( n >= 1000000 )
+    {
+        memcpy( p, "1.000000", 8 );
+        return ( p + 8 );
+    }
+
+    n = ( n < 0 ) ? 0 : n;
+
+    *p++ = '0';
+    *p++ = '.';
+    for ( d = 100000; d > 0; d /= 10 )
+    {
+        *p++ = (char)('0' + (n / d) % 10);
+    }
+
+    return ( p );
+}
+
+/******************************************************************************
+ * CubeBake - bakes and formats blue slices until all slices are taken
+ *****************************************************************************/
+class CubeBake
+{
+public:
+    CubeBake( const isp_pipeline_t * pipe, int size )
+        : m_pipe( pipe )
+        , m_size( size )
+        , m_slices( size )
+        , m_next( 0 )
+        , m_failed( 0 )
+    {
+    }
+
+    void run()
+    {
+        const int points = m_size * m_size;
+        QVector<float> rgb( 3 * points );
+        int b;
+
+        while ( (b = m_next.fetchAndAddRelaxed( 1 )) < m_size )
+        {
+            int res = sm_isp_pipeline_bake_cube( m_pipe, (uint32_t)m_size, (uint32_t)b, 1u, rgb.data() );
+            if ( res )
+            {
+                m_failed.storeRelease( 1 );
+                return;
+            }
+
+            QByteArray & text = m_slices[b];
+            text.resize( points * CUBE_LINE_LENGTH );
+
+            char * p = text.data();
+            for ( int i = 0; i < points; i++ )
+            {
+                p = formatValue( p, rgb[3*i + 0] );
+                *p++ = ' ';
+                p = formatValue( p, rgb[3*i + 1] );
+                *p++ = ' ';
+                p = formatValue( p, rgb[3*i + 2] );
+                *p++ = '\n';
+            }
+            text.resize( (int)(p - text.data()) );
+        }
+    }
+
+    const isp_pipeline_t *  m_pipe;     /**< computed pipeline, only read */
+    int                     m_size;     /**< lattice points per axis */
+    QVector<QByteArray>     m_slices;   /**< formatted blue slices */
+    QAtomicInt              m_next;     /**< next slice to bake */
+    QAtomicInt              m_failed;   /**< a slice could not be baked */
+};
+
+/******************************************************************************
+ * CubeBakeJob - runs a CubeBake on a pool thread
+ *****************************************************************************/
+class CubeBakeJob : public QRunnable
+{
+public:
+    CubeBakeJob( CubeBake * bake, QSemaphore * done )
+        : m_bake( bake )
+        , m_done( done )
+    {
+        setAutoDelete( true );
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_bake->run();
+        m_done->release();
+    }
+
+private:
+    CubeBake *      m_bake;
+    QSemaphore *    m_done;
+};
+
+/******************************************************************************
+ * CubeExport::PrivateData
+ *****************************************************************************/
+class CubeExport::PrivateData
+{
+public:
+    PrivateData()
+        : m_pipe( new isp_pipeline_t )
+    {
+        sm_isp_pipeline_reset( m_pipe );
+        sm_isp_pipeline_params_init( &m_params );
+
+        for ( int ch = 0; ch < 3; ch++ )
+        {
+            m_has_lut[ch] = false;
+        }
+    }
+
+    ~PrivateData()
+    {
+        delete m_pipe;
+    }
+
+    isp_pipeline_t *        m_pipe;                                 /**< pipeline model */
+    isp_pipeline_params_t   m_params;                               /**< settings reported by the device */
+    uint16_t                m_lut[3][ISP_PIPELINE_LUT_SIZE];        /**< transfer tables */
+    bool                    m_has_lut[3];                           /**< transfer table was set */
+};
+
+/******************************************************************************
+ * CubeExport::CubeExport
+ *****************************************************************************/
+CubeExport::CubeExport( QObject * parent )
+    : QObject( parent )
+{
+    d_data = new PrivateData;
+}
+
+/******************************************************************************
+ * CubeExport::~CubeExport
+ *****************************************************************************/
+CubeExport::~CubeExport()
+{
+    delete d_data;
+}
+
+/******************************************************************************
+ * CubeExport::setLut
+ *****************************************************************************/
+void CubeExport::setLut( int ch, const QVector<int> & table, unsigned int bit_width )
+{
+    if ( (ch < 0) || (ch > 2) )
+    {
+        return;
+    }
+
+    const int size = ( (bit_width >= 1u) && (bit_width <= 16u) ) ? (1 << bit_width) : 0;
+    if ( !size || (table.count() != size) )
+    {
+        d_data->m_has_lut[ch] = false;
+        emit SettingsChanged();
+        return;
+    }
+
+    // resample to the table size and bit-width of the model
+    const int max = size - 1;
+    for ( int i = 0; i < (int)ISP_PIPELINE_LUT_SIZE; i++ )
+    {
+        int v = table[(int)(((qint64)i * size) / ISP_PIPELINE_LUT_SIZE)];
+        v = qBound( 0, v, max );
+        d_data->m_lut[ch][i] = (uint16_t)(((qint64)v * (ISP_PIPELINE_LUT_SIZE - 1) + max / 2) / max);
+    }
+
+    d_data->m_has_lut[ch] = true;
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::pipelineParams
+ *****************************************************************************/
+void CubeExport::pipelineParams( isp_pipeline_params_t & params ) const
+{
+    params = d_data->m_params;
+    for ( int ch = 0; ch < 3; ch++ )
+    {
+        params.lut[ch] = d_data->m_has_lut[ch] ? d_data->m_lut[ch] : nullptr;
+    }
+}
+
+/******************************************************************************
+ * CubeExport::save
+ *****************************************************************************/
+bool CubeExport::save( const QString & fileName, int size, const QString & title )
+{
+    if ( (size < (int)ISP_PIPELINE_CUBE_MIN_SIZE) || (size > (int)ISP_PIPELINE_CUBE_MAX_SIZE) )
+    {
+        return ( false );
+    }
+
+    isp_pipeline_params_t params;
+    pipelineParams( params );
+
+    int res = sm_isp_pipeline_update( d_data->m_pipe, &params );
+    if ( res )
+    {
+        qDebug() << "cube export: invalid pipeline settings" << res;
+        return ( false );
+    }
+
+    // bake on the pool threads and on this one
+    CubeBake bake( d_data->m_pipe, size );
+    QSemaphore done;
+
+    QThreadPool * pool = QThreadPool::globalInstance();
+    const int jobs = qMin( pool->maxThreadCount(), size ) - 1;
+    for ( int i = 0; i < jobs; i++ )
+    {
+        pool->start( new CubeBakeJob( &bake, &done ) );
+    }
+    bake.run();
+    done.acquire( jobs );
+
+    if ( bake.m_failed.loadAcquire() )
+    {
+        return ( false );
+    }
+
+    QFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+    {
+        return ( false );
+    }
+
+    QByteArray header;
+    header += "TITLE \"" + QString( title ).remove( '"' ).toUtf8() + "\"\n";
+    header += "LUT_3D_SIZE " + QByteArray::number( size ) + "\n";
+    header += "DOMAIN_MIN 0.0 0.0 0.0\n";
+    header += "DOMAIN_MAX 1.0 1.0 1.0\n";
+
+    bool ok = ( file.write( header ) == header.size() );
+    for ( int b = 0; ok && (b < size); b++ )
+    {
+        ok = ( file.write( bake.m_slices[b] ) == bake.m_slices[b].size() );
+    }
+
+    file.close();
+
+    return ( ok );
+}
+
+/******************************************************************************
+ * CubeExport::onRedGainChange
+ *****************************************************************************/
+void CubeExport::onRedGainChange( int value )
+{
+    d_data->m_params.wb_gain[0] = (float)value / GAIN_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onGreenGainChange
+ *****************************************************************************/
+void CubeExport::onGreenGainChange( int value )
+{
+    d_data->m_params.wb_gain[1] = (float)value / GAIN_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onBlueGainChange
+ *****************************************************************************/
+void CubeExport::onBlueGainChange( int value )
+{
+    d_data->m_params.wb_gain[2] = (float)value / GAIN_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onColorCorrectionChange
+ *****************************************************************************/
+void CubeExport::onColorCorrectionChange
+(
+    int c0, int c1, int c2,
+    int c3, int c4, int c5,
+    int c6, int c7, int c8,
+    int red, int green, int blue
+)
+{
+    const int c[9] = { c0, c1, c2, c3, c4, c5, c6, c7, c8 };
+
+    for ( int i = 0; i < 9; i++ )
+    {
+        d_data->m_params.cross[i] = (float)c[i] / CROSS_ONE;
+    }
+
+    d_data->m_params.cross_offset[0] = (float)red   / CROSS_OFFSET_ONE;
+    d_data->m_params.cross_offset[1] = (float)green / CROSS_OFFSET_ONE;
+    d_data->m_params.cross_offset[2] = (float)blue  / CROSS_OFFSET_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onColorConversionMatrixChange
+ *****************************************************************************/
+void CubeExport::onColorConversionMatrixChange
+(
+    int c0, int c1, int c2,
+    int c3, int c4, int c5,
+    int c6, int c7, int c8
+)
+{
+    const int c[9] = { c0, c1, c2, c3, c4, c5, c6, c7, c8 };
+
+    for ( int i = 0; i < 9; i++ )
+    {
+        d_data->m_params.conv[i] = (float)c[i] / CONV_ONE;
+    }
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onKneeConfigChange
+ *****************************************************************************/
+void CubeExport::onKneeConfigChange( int enable, int point, int slope, int clip )
+{
+    d_data->m_params.knee_enable = enable ? 1u : 0u;
+    d_data->m_params.knee_point  = (uint8_t)point;
+    d_data->m_params.knee_slope  = (uint16_t)slope;
+    d_data->m_params.white_clip  = (uint8_t)clip;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onMccEnableChange
+ *****************************************************************************/
+void CubeExport::onMccEnableChange( int value )
+{
+    d_data->m_params.mcc_enable = value ? 1u : 0u;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onMccOperationModeChange
+ *****************************************************************************/
+void CubeExport::onMccOperationModeChange( int mode, int no_phases )
+{
+    Q_UNUSED( mode );
+
+    d_data->m_params.mcc_phases = (uint8_t)qBound( 0, no_phases, (int)ISP_PIPELINE_MAX_PHASES );
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onMccPhaseChange
+ *****************************************************************************/
+void CubeExport::onMccPhaseChange( int id, int saturation, int hue )
+{
+    if ( (id >= 0) && (id < (int)ISP_PIPELINE_MAX_PHASES) )
+    {
+        d_data->m_params.mcc_saturation[id] = (float)saturation / MCC_SATURATION_ONE;
+        d_data->m_params.mcc_hue[id]        = (float)hue * 90.0f / MCC_HUE_90;
+    }
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onBrightnessChange
+ *****************************************************************************/
+void CubeExport::onBrightnessChange( int value )
+{
+    d_data->m_params.brightness = (float)value / CPROC_BRIGHTNESS_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onContrastChange
+ *****************************************************************************/
+void CubeExport::onContrastChange( int value )
+{
+    d_data->m_params.contrast = (float)value / CPROC_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onSaturationChange
+ *****************************************************************************/
+void CubeExport::onSaturationChange( int value )
+{
+    d_data->m_params.saturation = (float)value / CPROC_ONE;
+
+    emit SettingsChanged();
+}
+
+/******************************************************************************
+ * CubeExport::onHueChange
+ *****************************************************************************/
+void CubeExport::onHueChange( int value )
+{
+    d_data->m_params.hue = (float)value * 90.0f / CPROC_HUE_90;
+
+    emit SettingsChanged();
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    cube_export.h
+ *
+ * @brief   Class definition of a baked 3D LUT (.cube) export
+ *
+ * @note    A CubeExport follows the colour settings reported by the device
+ *          interfaces (white balance, colour correction, knee, multi colour
+ *          control, colour conversion and colour processing); the transfer
+ *          tables are handed over by the LUT box. On export the settings
+ *          are folded into the software pipeline model and baked into a
+ *          lattice, the blue slices are baked and formatted on all cores.
+ *          The same settings drive the pipeline preview, SettingsChanged
+ *          is emitted on every change.
+ *
+ *****************************************************************************/
+#ifndef __CUBE_EXPORT_H__
+#define __CUBE_EXPORT_H__
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <simple_math/isp_pipeline.h>
+
+class CubeExport : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CubeExport( QObject * parent = nullptr );
+    ~CubeExport();
+
+    // transfer table of red (0), green (1) or blue (2) with 1 << bit_width
+    // entries of bit_width bit, an empty table is linear
+    void setLut( int ch, const QVector<int> & table, unsigned int bit_width );
+
+    // current pipeline settings, the transfer tables point into this object
+    void pipelineParams( isp_pipeline_params_t & params ) const;
+
+    // bake the pipeline into a size^3 lattice and write it as .cube file,
+    // false on error
+    bool save( const QString & fileName, int size, const QString & title );
+
+signals:
+    void SettingsChanged();
+
+public slots:
+    // white balance
+    void onRedGainChange( int value );
+    void onGreenGainChange( int value );
+    void onBlueGainChange( int value );
+
+    // colour correction
+    void onColorCorrectionChange( int c0, int c1, int c2,
+                                  int c3, int c4, int c5,
+                                  int c6, int c7, int c8,
+                                  int red, int green, int blue );
+
+    // colour conversion
+    void onColorConversionMatrixChange( int c0, int c1, int c2,
+                                        int c3, int c4, int c5,
+                                        int c6, int c7, int c8 );
+
+    // knee
+    void onKneeConfigChange( int enable, int point, int slope, int clip );
+
+    // multi colour control
+    void onMccEnableChange( int value );
+    void onMccOperationModeChange( int mode, int no_phases );
+    void onMccPhaseChange( int id, int saturation, int hue );
+
+    // colour processing
+    void onBrightnessChange( int value );
+    void onContrastChange( int value );
+    void onSaturationChange( int value );
+    void onHueChange( int value );
+
+private:
+    class PrivateData;
+    PrivateData * d_data;
+};
+
+#endif // __CUBE_EXPORT_H__
@@ -82,9 +82,25 @@ public:
         return ( (int)y );
     }
 
+    void interpolate( int x0, int step, QVector<int> &y )
+    {
+        int res;
+
+        m_range.resize( y.count() );
+        res = sm_cubic_spline_interpolation_calc_range( &m_ctx, CSIP_SAMPLE_TYPE(x0), CSIP_SAMPLE_TYPE(step),
+                                                        m_range.data(), (unsigned)m_range.count() );
+        Q_ASSERT( res == 0 );
+
+        for ( int i = 0; i<y.count(); i++ )
+        {
+            y[i] = (int)m_range[i];
+        }
+    }
+
     spline_interpolation_ctx_t              m_ctx;
     spline_interpolation_sample_type_t      m_x[CSIP_MAX_SAMPLES];
     spline_interpolation_sample_type_t      m_y[CSIP_MAX_SAMPLES];
+    QVector<spline_interpolation_sample_type_t> m_range;    /**< reused output buffer of range interpolation */
 };
 
 /******************************************************************************
@@ -128,3 +144,11 @@ int CubicInterpolation::interpolate( int x )
     return ( d_data->interpolate( x ) );
 }
 
+
+/******************************************************************************
+ * CubicInterpolation::interpolate
+ *****************************************************************************/
+void CubicInterpolation::interpolate( int x0, int step, QVector<int> &y )
+{
+    d_data->interpolate( x0, step, y );
+}
@@ -33,6 +33,9 @@ public:
     void setSamples( QVector<int> &x, QVector<int> &y );
     int interpolate( int x );
 
+    // interpolates y.count() equidistant points starting at x0
+    void interpolate( int x0, int step, QVector<int> &y );
+
 private:
     class PrivateData;
     PrivateData * d_data;
@@ -0,0 +1,303 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    curve_graph.cpp
+ *
+ * @brief   Implementation of an incrementally updated curve graph
+ *
+ *****************************************************************************/
+#include <QtDebug>
+
+#include <qcustomplot.h>
+
+#include "curve_graph.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// lower bound of decimation buckets, used as long as the plot has no geometry
+#define CURVE_GRAPH_MIN_BUCKETS         ( 512 )
+
+/******************************************************************************
+ * CurveGraph::PrivateData
+ *****************************************************************************/
+class CurveGraph::PrivateData
+{
+public:
+    PrivateData( QCPGraph * graph )
+        : m_graph( graph )
+        , m_layer( nullptr )
+        , m_scale( 1.0 )
+        , m_is_curve( false )
+        , m_x0( 0 )
+        , m_step( 1 )
+        , m_buckets( 0 )
+        , m_replot_pending( false )
+        , m_full_replot( true )
+    {
+        QCustomPlot * plot = graph->parentPlot();
+
+        // own buffered layer right below the axes, so this graph can be
+        // repainted without the rest of the plot
+        QString name = QString( "curve%1" ).arg( plot->layerCount() );
+        plot->addLayer( name, plot->layer( "axes" ), QCustomPlot::limBelow );
+        m_layer = plot->layer( name );
+        m_layer->setMode( QCPLayer::lmBuffered );
+        graph->setLayer( m_layer );
+    }
+
+    int buckets() const
+    {
+        if ( m_y.count() < 2 )
+        {
+            return ( CURVE_GRAPH_MIN_BUCKETS );
+        }
+
+        // pixels covered by the whole curve at the current zoom level
+        QCPAxis * axis = m_graph->keyAxis();
+        double first = m_scale * m_x0;
+        double last  = m_scale * (m_x0 + (m_y.count() - 1) * m_step);
+        double px    = qAbs( axis->coordToPixel( last ) - axis->coordToPixel( first ) );
+
+        return ( qMax( (int)qMin( px, (double)m_y.count() ), CURVE_GRAPH_MIN_BUCKETS ) );
+    }
+
+    QCPGraphData point( int i ) const
+    {
+        double x = m_is_curve ? (double)(m_x0 + i * m_step) : (double)m_x[i];
+        return ( QCPGraphData( m_scale * x, m_scale * (double)m_y[i] ) );
+    }
+
+    void decimate()
+    {
+        int n = m_y.count();
+
+        m_buckets = m_is_curve ? buckets() : 0;
+        m_points.resize( 0 );
+
+        if ( !m_is_curve || (n <= (2 * m_buckets)) )
+        {
+            m_points.reserve( n );
+            for ( int i = 0; i < n; i++ )
+            {
+                m_points.append( point( i ) );
+            }
+            return;
+        }
+
+        // min/max per bucket in order of occurrence, always two points per
+        // bucket so the container size only changes with the bucket count
+        m_points.reserve( 2 * m_buckets );
+        for ( int b = 0; b < m_buckets; b++ )
+        {
+            int start = (int)(((qint64)b * n) / m_buckets);
+            int end   = (int)(((qint64)(b + 1) * n) / m_buckets);
+            int lo    = start;
+            int hi    = start;
+
+            for ( int i = start + 1; i < end; i++ )
+            {
+                lo = (m_y[i] < m_y[lo]) ? i : lo;
+                hi = (m_y[i] > m_y[hi]) ? i : hi;
+            }
+
+            m_points.append( point( qMin( lo, hi ) ) );
+            m_points.append( point( qMax( lo, hi ) ) );
+        }
+    }
+
+    // write the decimated points to the graph, returns true if anything changed
+    bool apply()
+    {
+        QSharedPointer<QCPGraphDataContainer> data = m_graph->data();
+
+        if ( data->size() != m_points.count() )
+        {
+            data->set( m_points, true );
+            return ( true );
+        }
+
+        // same size: both are sorted, so overwriting the differing points
+        // keeps the container sorted
+        bool changed = false;
+        QCPGraphDataContainer::iterator it = data->begin();
+        for ( int i = 0; i < m_points.count(); i++, it++ )
+        {
+            if ( (it->key != m_points[i].key) || (it->value != m_points[i].value) )
+            {
+                *it = m_points[i];
+                changed = true;
+            }
+        }
+
+        return ( changed );
+    }
+
+    QCPGraph *              m_graph;            /**< plotted graph */
+    QCPLayer *              m_layer;            /**< own buffered layer of graph */
+    double                  m_scale;            /**< sample value to plot coordinate */
+
+    bool                    m_is_curve;         /**< equidistant curve or individual points */
+    int                     m_x0;               /**< first x of curve */
+    int                     m_step;             /**< x distance of curve samples */
+    QVector<int>            m_x;                /**< x of individual points */
+    QVector<int>            m_y;                /**< full resolution y values */
+
+    int                     m_buckets;          /**< buckets of current decimation */
+    QVector<QCPGraphData>   m_points;           /**< decimated points */
+
+    bool                    m_replot_pending;   /**< queued replot not yet executed */
+    bool                    m_full_replot;      /**< layer buffer not yet painted */
+};
+
+/******************************************************************************
+ * CurveGraph::CurveGraph
+ *****************************************************************************/
+CurveGraph::CurveGraph( QCPGraph * graph )
+    : QObject( graph->parentPlot() )
+{
+    // create private data container
+    d_data = new PrivateData( graph );
+
+    // decimation depends on the zoom level
+    connect( graph->keyAxis(), SIGNAL(rangeChanged(const QCPRange &)),
+             this, SLOT(onRangeChanged(const QCPRange &)) );
+}
+
+/******************************************************************************
+ * CurveGraph::~CurveGraph
+ *****************************************************************************/
+CurveGraph::~CurveGraph()
+{
+    delete d_data;
+}
+
+/******************************************************************************
+ * CurveGraph::graph
+ *****************************************************************************/
+QCPGraph * CurveGraph::graph() const
+{
+    return ( d_data->m_graph );
+}
+
+/******************************************************************************
+ * CurveGraph::setScale
+ *****************************************************************************/
+void CurveGraph::setScale( double scale )
+{
+    if ( d_data->m_scale != scale )
+    {
+        d_data->m_scale = scale;
+        d_data->decimate();
+        if ( d_data->apply() )
+        {
+            replot();
+        }
+    }
+}
+
+/******************************************************************************
+ * CurveGraph::setCurve
+ *****************************************************************************/
+void CurveGraph::setCurve( int x0, int step, const QVector<int> &y )
+{
+    d_data->m_is_curve = true;
+    d_data->m_x0       = x0;
+    d_data->m_step     = step;
+    d_data->m_x.clear();
+    d_data->m_y        = y;
+
+    d_data->decimate();
+    if ( d_data->apply() )
+    {
+        replot();
+    }
+}
+
+/******************************************************************************
+ * CurveGraph::setPoints
+ *****************************************************************************/
+void CurveGraph::setPoints( const QVector<int> &x, const QVector<int> &y )
+{
+    Q_ASSERT( x.count() == y.count() );
+
+    d_data->m_is_curve = false;
+    d_data->m_x        = x;
+    d_data->m_y        = y;
+
+    d_data->decimate();
+    if ( d_data->apply() )
+    {
+        replot();
+    }
+}
+
+/******************************************************************************
+ * CurveGraph::clear
+ *****************************************************************************/
+void CurveGraph::clear()
+{
+    setPoints( QVector<int>(), QVector<int>() );
+}
+
+/******************************************************************************
+ * CurveGraph::replot
+ *****************************************************************************/
+void CurveGraph::replot()
+{
+    // hidden graphs only keep their data up to date
+    if ( d_data->m_graph->visible() && !d_data->m_replot_pending )
+    {
+        d_data->m_replot_pending = true;
+        QMetaObject::invokeMethod( this, "onReplot", Qt::QueuedConnection );
+    }
+}
+
+/******************************************************************************
+ * CurveGraph::onRangeChanged
+ *****************************************************************************/
+void CurveGraph::onRangeChanged( const QCPRange & )
+{
+    if ( d_data->m_is_curve && (d_data->buckets() != d_data->m_buckets) )
+    {
+        d_data->decimate();
+        if ( d_data->apply() )
+        {
+            replot();
+        }
+    }
+}
+
+/******************************************************************************
+ * CurveGraph::onReplot
+ *****************************************************************************/
+void CurveGraph::onReplot()
+{
+    d_data->m_replot_pending = false;
+
+    if ( d_data->m_full_replot )
+    {
+        // the layer buffer needs one complete replot before it can be
+        // repainted on its own
+        d_data->m_full_replot = false;
+        d_data->m_graph->parentPlot()->replot();
+    }
+    else
+    {
+        d_data->m_layer->replot();
+    }
+}
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    curve_graph.h
+ *
+ * @brief   Class definition of an incrementally updated curve graph
+ *
+ * @note    A CurveGraph owns a buffered layer of the plot for its QCPGraph.
+ *          New data is min/max decimated to the pixel width of the axis,
+ *          only the changed range of the persistent data container is
+ *          written and only this layer is replotted (queued, so several
+ *          updates within one event loop iteration cost one repaint).
+ *
+ *****************************************************************************/
+#ifndef __CURVE_GRAPH_H__
+#define __CURVE_GRAPH_H__
+
+#include <QObject>
+#include <QVector>
+
+class QCPGraph;
+class QCPRange;
+
+class CurveGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CurveGraph( QCPGraph * graph );
+    ~CurveGraph();
+
+    QCPGraph * graph() const;
+
+    // scale from integer sample values to plot coordinates
+    void setScale( double scale );
+
+    // equidistant curve y[i] at x0 + i * step, decimated for display
+    void setCurve( int x0, int step, const QVector<int> &y );
+
+    // individual points, never decimated
+    void setPoints( const QVector<int> &x, const QVector<int> &y );
+
+    void clear();
+
+    // request a repaint after changing the graph style
+    void replot();
+
+private slots:
+    void onRangeChanged( const QCPRange &range );
+    void onReplot();
+
+private:
+    class PrivateData;
+    PrivateData * d_data;
+};
+
+#endif // __CURVE_GRAPH_H__
@@ -27,14 +27,20 @@
 #include <QItemDelegate>
 #include <QLineEdit>
 #include <QDir>
+#include <QApplication>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QTimer>
 
 #include <csvwrapper.h>
-#include <simple_math/gamma.h>
+#include <simple_math/gamma_table.h>
 
 #include <defines.h>
 
 #include "cubic_interpolation.h"
+#include "cube_export.h"
+#include "curve_graph.h"
 #include "lutbox.h"
 #include "ui_lutbox.h"
 
@@ -85,6 +91,7 @@ enum LutFixedMode
 #define FINAL_CURVE_ID                      ( 2 )
 #define SAMPLE_CURVE_ID                     ( 3 )
 #define HIGHLIGHT_CURVE_ID                  ( 4 )
+#define NUM_CURVES                          ( 5 )
 
 /******************************************************************************
  * STRAIGHT
@@ -224,6 +231,53 @@ public:
     }
 };
 
+/******************************************************************************
+ * LutPresetSamples - sample tables of all presets as read from the device
+ *****************************************************************************/
+struct LutPresetSamples
+{
+    LutPresetSamples()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for ( int preset = 0; preset < LUT_NO_PRESETS; preset++ )
+        {
+            for ( int ch = LutBox::Master; ch < LutBox::LutChannelMax; ch++ )
+            {
+                valid[preset][ch] = false;
+            }
+        }
+    }
+
+    QList<int>  x[LUT_NO_PRESETS][LutBox::LutChannelMax];
+    QList<int>  y[LUT_NO_PRESETS][LutBox::LutChannelMax];
+    bool        valid[LUT_NO_PRESETS][LutBox::LutChannelMax];
+};
+
+/******************************************************************************
+ * LutSnapshot - settings of a chain which is not the active one
+ *****************************************************************************/
+struct LutSnapshot
+{
+    LutSnapshot()
+        : valid( false )
+        , mode( 0 )
+        , fixed_mode( 0 )
+        , preset( 0 )
+        , fast_gamma( 0 )
+    { }
+
+    bool                valid;
+    int                 mode;
+    int                 fixed_mode;
+    int                 preset;
+    int                 fast_gamma;
+    LutPresetSamples    samples;
+};
+
 /******************************************************************************
  * LutBox::PrivateData
  *****************************************************************************/
@@ -239,10 +293,19 @@ public:
         , m_preset( 0 )
         , m_ch( Master )
         , m_bit_width( DEFAULT_BIT_WIDTH )
+        , m_gamma_tables( new gamma_table_cache_t )
+        , m_cube_export( new CubeExport( parent ) )
     {
         // initialize UI
         m_ui->setupUi( parent );
 
+        sm_gamma_table_cache_reset( m_gamma_tables );
+
+        // transfer tables of the pipeline preview follow the curves, a
+        // change that redraws several curves updates them once
+        m_cube_luts.setSingleShot( true );
+        m_cube_luts.setInterval( 0 );
+
         // Initialize enable to false for all chains, will be updated when syncronizing with the device
         for ( int i = 0; i < MAX_NUM_CHAINS; i++ )
         {
@@ -340,6 +403,7 @@ public:
     {
         delete m_ui;
         delete m_delegate;
+        delete m_gamma_tables;
         
         delete m_final_interpolate[Blue];
         delete m_final_interpolate[Green];
@@ -426,6 +490,13 @@ public:
         plot->graph( HIGHLIGHT_CURVE_ID )->setLineStyle(QCPGraph::lsNone);
         plot->graph( HIGHLIGHT_CURVE_ID )->setScatterStyle( QCPScatterStyle(QCPScatterStyle::ssCircle, 4) );
 
+        // incremental update adapters, owned by the plot
+        for ( int i = 0; i < NUM_CURVES; i++ )
+        {
+            m_curve[ch][i] = new CurveGraph( plot->graph( i ) );
+            m_curve[ch][i]->setScale( 1.0 / (double)(1 << m_bit_width) );
+        }
+
         plot->setBackground( QBrush(QColor(48,47,47)) );
         plot->setInteractions( QCP::iRangeDrag | QCP::iRangeZoom );
         
@@ -605,45 +676,36 @@ public:
 
     void drawHelperLine( LutChannel ch )
     {
-        QVector<double> x(2);
-        QVector<double> y(2);
+        QVector<int> x(2);
+        QVector<int> y(2);
 
-        QCustomPlot * plot = getLutPlot( ch );
+        x[0] = y[0] = 0;
+        x[1] = y[1] = (1 << m_bit_width);
 
-        plot->graph( LINEAR_CURVE_ID )->data()->clear();
-
-        x[0] = y[0] = 0.0f;
-        x[1] = y[1] = 1.0f;
+        m_curve[ch][LINEAR_CURVE_ID]->setPoints( x, y );
+    }
 
-        plot->graph( LINEAR_CURVE_ID )->setData( x, y );
-        
-        plot->replot();
+    void setCurveScale()
+    {
+        for ( int ch = 0; ch < LutChannelMax; ch++ )
+        {
+            for ( int i = 0; i < NUM_CURVES; i++ )
+            {
+                m_curve[ch][i]->setScale( 1.0 / (double)(1 << m_bit_width) );
+            }
+        }
     }
 
     void computeLutLine( LutChannel ch, QVector<int> &x, QVector<int> &y )
     {
-        QCustomPlot * plot = getLutPlot( ch );
-
-        // plot 1024 values
-        const int num_samples = 1024;
-        const int scale_factor = (1 << m_bit_width) / num_samples;
-
-        // clear all graphs 
-        plot->graph( INTERPOLATION_CURVE_ID )->data()->clear();
-        plot->graph( FINAL_CURVE_ID )->data()->clear();
-        plot->graph( SAMPLE_CURVE_ID )->data()->clear();
-        plot->graph( HIGHLIGHT_CURVE_ID )->data()->clear();
+        // compute every lut entry, the curve graphs decimate to the plot width
+        const int num_samples = (1 << m_bit_width);
 
         // interpolated curve
-        QVector<double> x1( num_samples );
-        QVector<double> y1( num_samples );
+        QVector<int> yi( num_samples );
         m_interpolate[ch]->setSamples( x, y );
-        for ( int i=0; i<num_samples; i+=1 )
-        {
-            x1[i] = ((double)(i*scale_factor)) / (double)(1 << m_bit_width);
-            y1[i] = ((double)m_interpolate[ch]->interpolate( (i*scale_factor) )) / (double)(1 << m_bit_width);
-        }
-        plot->graph( INTERPOLATION_CURVE_ID )->setData( x1, y1 );
+        m_interpolate[ch]->interpolate( 0, 1, yi );
+        m_curve[ch][INTERPOLATION_CURVE_ID]->setCurve( 0, 1, yi );
 
         // final curve
         if ( ch != Master )
@@ -658,16 +720,8 @@ public:
                 y3[i] = m_interpolate[ch]->interpolate( y2[i] );
             }
             m_final_interpolate[ch]->setSamples( x2, y3 );
-            
-            QVector<double> x4( num_samples );
-            QVector<double> y4( num_samples );
-            for ( int i=0; i<num_samples; i+=1 )
-            {
-                x4[i] = ((double)(i*scale_factor)) / (double)(1 << m_bit_width);
-                y4[i] = ((double)m_final_interpolate[ch]->interpolate( (i*scale_factor) )) / (double)(1 << m_bit_width);
-            }
-            
-            plot->graph( FINAL_CURVE_ID )->setData( x4, y4 );
+            m_final_interpolate[ch]->interpolate( 0, 1, yi );
+            m_curve[ch][FINAL_CURVE_ID]->setCurve( 0, 1, yi );
         }
         // master curve and interpolation mode
         else if ( m_mode == LUT_MODE_INTERPOLATE )
@@ -691,37 +745,57 @@ public:
             y2.clear();
         }
 
-        // sample points 
-        QVector<double> x5( x.count() );
-        QVector<double> y5( y.count() );
-        for ( int i=0; i<x.count(); i ++ )
+        // master has no final curve
+        if ( ch == Master )
         {
-            x5[i] = ((double)x[i]) / (double)(1 << m_bit_width);
-            y5[i] = ((double)y[i]) / (double)(1 << m_bit_width);
+            m_curve[ch][FINAL_CURVE_ID]->clear();
         }
-        plot->graph( SAMPLE_CURVE_ID )->setData( x5, y5 );
 
-        plot->replot();
+        // sample points 
+        m_curve[ch][SAMPLE_CURVE_ID]->setPoints( x, y );
+        m_curve[ch][HIGHLIGHT_CURVE_ID]->clear();
+
+        m_cube_luts.start();
     }
 
-    void highlightSamples( LutChannel ch, QVector<int> &x, QVector<int> &y )
+    void updateCubeLuts()
     {
-        QCustomPlot * plot = getLutPlot( ch );
+        QVector<int> table;
+        for ( int ch = Red; ch <= Blue; ch++ )
+        {
+            getLutTable( (LutChannel)ch, table );
+            m_cube_export->setLut( ch - Red, table, m_bit_width );
+        }
+    }
 
-        plot->graph( HIGHLIGHT_CURVE_ID )->data()->clear();
+    void getLutTable( LutChannel ch, QVector<int> &table )
+    {
+        // every mode draws its curve into the master interpolation
+        table.resize( 1 << m_bit_width );
+        m_interpolate[Master]->interpolate( 0, 1, table );
 
-        // sample points 
-        QVector<double> x2( x.count() );
-        QVector<double> y2( y.count() );
-        for ( int i=0; i<x.count(); i ++ )
+        // colour channels are applied on top of the master curve, same as
+        // the final curve of computeLutLine
+        if ( (ch != Master) && (m_mode == LUT_MODE_INTERPOLATE) )
         {
-            x2[i] = ((double)x[i]) / (double)(1 << m_bit_width);
-            y2[i] = ((double)y[i]) / (double)(1 << m_bit_width);
-        }
+            QVector<int> x;
+            QVector<int> y;
+            getDataFromModel( Master, x, y );
 
-        plot->graph( HIGHLIGHT_CURVE_ID )->setData( x2, y2 );
+            for ( int i = 0; i < y.count(); i++ )
+            {
+                y[i] = m_interpolate[ch]->interpolate( y[i] );
+            }
 
-        plot->replot();
+            CubicInterpolation final_interpolate;
+            final_interpolate.setSamples( x, y );
+            final_interpolate.interpolate( 0, 1, table );
+        }
+    }
+
+    void highlightSamples( LutChannel ch, QVector<int> &x, QVector<int> &y )
+    {
+        m_curve[ch][HIGHLIGHT_CURVE_ID]->setPoints( x, y );
     }
 
     void drawFastGammaPlot( LutChannel ch, int gamma_int, bool apply_rec709 )
@@ -832,20 +906,46 @@ public:
         unsigned int const bit_width = m_bit_width;
         int const num_samples = 128;
         int i;
-        for ( i = 0; i < (1 << bit_width); i += (1 << bit_width) / num_samples )
+
+        gamma_table_params_t params;
+        params.kink              = threshold;
+        params.linear_contrast   = lcontrast;
+        params.linear_brightness = lbrightness;
+        params.contrast          = contrast;
+        params.gamma             = inverse_gamma;
+        params.brightness        = brightness;
+
+        // every knob step is a new curve, so only the plotted samples are
+        // evaluated instead of a full table that would push the fixed
+        // curves out of the table cache
+        QVector<uint32_t> x_s;
+        int const step = (1 << bit_width) / num_samples;
+        int const x_i_int = (int)(x_i * (1 << bit_width));
+
+        for ( i = 0; i < (1 << bit_width); i += step )
         {
-            x.append( i );
-            y.append( sm_gamma_float((uint32_t)i, threshold, lcontrast, lbrightness, contrast, inverse_gamma, brightness, (uint8_t)bit_width, (uint8_t)bit_width) );
+            x_s.append( i );
 
             // Add a sample at the intersection of linear part and gamma curve
-            int x_i_int = (int)(x_i * (1 << bit_width));
-            if ( x_i_int > i && x_i_int < (i + (1 << bit_width) / num_samples ) )
+            if ( x_i_int > i && x_i_int < (i + step) )
             {
-                x.append( x_i_int );
-                y.append( sm_gamma_float((uint32_t)x_i_int, threshold, lcontrast, lbrightness, contrast, inverse_gamma, brightness, (uint8_t)bit_width, (uint8_t)bit_width) );
+                x_s.append( x_i_int );
             }
         }
 
+        QVector<uint16_t> y_s( x_s.size() );
+        if ( sm_gamma_table_sample( GAMMA_TABLE_CURVE_GAMMA, &params, (uint8_t)bit_width,
+                                    x_s.constData(), y_s.data(), (uint32_t)x_s.size() ) )
+        {
+            return;
+        }
+
+        for ( i = 0; i < x_s.size(); i++ )
+        {
+            x.append( (int)x_s[i] );
+            y.append( y_s[i] );
+        }
+
         // III. Draw the lut line
         computeLutLine( ch, x, y );
     }
@@ -856,40 +956,114 @@ public:
         QVector<int> y;
 
         // Set constants for Rec. 709 curve calculation
-        float const kink = TO_FLOAT( REC709_THRESHOLD );
-        float const lcontrast = TO_FLOAT( REC709_LINEAR_CONTRAST );
-        float const lbrightness = TO_FLOAT( REC709_LINEAR_BRIGHTNESS );
-        float const contrast = TO_FLOAT( REC709_CONTRAST );
-        float const inverse_gamma = 1.0f / TO_FLOAT( REC709_GAMMA );
-        float const brightness = TO_FLOAT( REC709_BRIGHTNESS );
+        gamma_table_params_t params;
+        params.kink              = TO_FLOAT( REC709_THRESHOLD );
+        params.linear_contrast   = TO_FLOAT( REC709_LINEAR_CONTRAST );
+        params.linear_brightness = TO_FLOAT( REC709_LINEAR_BRIGHTNESS );
+        params.contrast          = TO_FLOAT( REC709_CONTRAST );
+        params.gamma             = 1.0f / TO_FLOAT( REC709_GAMMA );
+        params.brightness        = TO_FLOAT( REC709_BRIGHTNESS );
+
+        gamma_table_curve_t curve;
+        switch ( mode )
+        {
+        case LUT_FIXED_REC709: // Rec. 709
+            curve = GAMMA_TABLE_CURVE_GAMMA;
+            break;
+        case LUT_FIXED_PQ: // Rec. 2100 - PQ
+            curve = GAMMA_TABLE_CURVE_PQ;
+            break;
+        case LUT_FIXED_HLG: // Rec. 2100 - HLG
+            curve = GAMMA_TABLE_CURVE_HLG;
+            break;
+        default:
+            return;
+        }
 
         // I. Calculate samples
         unsigned int const bit_width = m_bit_width;
         int const num_samples = 512;
         int i;
+
+        // fixed curves are computed once per bit-width and then served from the cache
+        uint16_t const * table = sm_gamma_table_get( m_gamma_tables, curve, &params, (uint8_t)bit_width );
+        if ( !table )
+        {
+            return;
+        }
+
         for ( i = 0; i < (1 << bit_width); i += (1 << bit_width) / num_samples )
         {
             x.append( i );
-            switch ( mode )
-            {
-            case LUT_FIXED_REC709: // Rec. 709
-                y.append( sm_gamma_float((uint32_t)i, kink, lcontrast, lbrightness, contrast, inverse_gamma, brightness, (uint8_t)bit_width, (uint8_t)bit_width) );
-                break;
-            case LUT_FIXED_PQ: // Rec. 2100 - PQ
-                y.append( sm_pq((uint32_t)i, (uint8_t)bit_width, (uint8_t)bit_width) );
-                break;
-            case LUT_FIXED_HLG: // Rec. 2100 - HLG
-                y.append( sm_hlg((uint32_t)i, (uint8_t)bit_width, (uint8_t)bit_width) );
-                break;
-            default:
-                return;
-            }
+            y.append( table[i] );
         }
 
         // II. Draw the lut line
         computeLutLine( ch, x, y );
     }
 
+    bool saveSamples( QSettings & s, const LutPresetSamples & samples )
+    {
+        bool complete = true;
+
+        for ( int preset = 0; preset < LUT_NO_PRESETS; preset++ )
+        {
+            for ( int ch = Master; ch < LutChannelMax; ch++ )
+            {
+                QString name_x;
+                QString name_y;
+
+                switch ( ch )
+                {
+                    case Red:
+                        name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_RED_X).arg( preset );
+                        name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_RED_Y).arg( preset );
+                        break;
+
+                    case Green:
+                        name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_GREEN_X).arg( preset );
+                        name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_GREEN_Y).arg( preset );
+                        break;
+
+                    case Blue:
+                        name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_BLUE_X).arg( preset );
+                        name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_BLUE_Y).arg( preset );
+                        break;
+
+                    default:
+                        name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_X).arg( preset );
+                        name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_Y).arg( preset );
+                        break;
+                }
+
+                // no device answer, leave the table out of the file, so
+                // loading the file keeps the table of the device
+                if ( !samples.valid[preset][ch] )
+                {
+                    complete = false;
+                    continue;
+                }
+
+                // @TODO: save list as readable text
+                // NOTE: call qRegisterMetaTypeStreamOperators<QList<int> >("QList<int>");
+                s.setValue( name_x, QVariant::fromValue<QList<int>>(samples.x[preset][ch]) );
+                s.setValue( name_y, QVariant::fromValue<QList<int>>(samples.y[preset][ch]) );
+            }
+        }
+
+        return ( complete );
+    }
+
+    void saveRec709( QSettings & s )
+    {
+        s.setValue( LUT_SETTINGS_REC709_LCONTRAST  , m_ui->sbxRec709LinContrast->value() );
+        s.setValue( LUT_SETTINGS_REC709_LBRIGHTNESS, m_ui->sbxRec709LinOffset  ->value() );
+        s.setValue( LUT_SETTINGS_REC709_THRESHOLD  , m_ui->sbxRec709Threshold  ->value() );
+        s.setValue( LUT_SETTINGS_REC709_CONTRAST   , m_ui->sbxRec709Contrast   ->value() );
+        s.setValue( LUT_SETTINGS_REC709_GAMMA      , m_ui->sbxRec709Gamma      ->value() );
+        s.setValue( LUT_SETTINGS_REC709_BRIGHTNESS , m_ui->sbxRec709Offset     ->value() );
+    }
+
     Ui::UI_LutBox *         m_ui;                           /**< ui handle */
     LutDelegate *           m_delegate;                     /**< delegation class */
     int                     m_active_chain_idx;             /**< index of the currently active chain */
@@ -899,11 +1073,18 @@ public:
     int                     m_preset;                       /**< current preset */
     LutChannel              m_ch;                           /**< currently selected channel */
     unsigned int            m_bit_width;                    /**< width of the lut module (depends on device) */
+    gamma_table_cache_t *   m_gamma_tables;                 /**< cache of transfer-function tables */
+    CubeExport *            m_cube_export;                  /**< 3D LUT export and preview settings */
+    QTimer                  m_cube_luts;                    /**< pending transfer table update */
     
     CubicInterpolation *    m_interpolate[LutChannelMax];       /**< interpolation class */
     CubicInterpolation *    m_final_interpolate[LutChannelMax]; /**< final interpolation class */
+    CurveGraph *            m_curve[LutChannelMax][NUM_CURVES]; /**< plotted curves */
     QStandardItemModel *    m_model[LutChannelMax];             /**< data model */
 
+    LutPresetSamples        m_preset_samples;                   /**< received samples of all presets */
+    LutSnapshot             m_snapshot[MAX_NUM_CHAINS];         /**< received settings of inactive chains */
+
     QString                 m_filename;
 };
 
@@ -988,6 +1169,8 @@ LutBox::LutBox( QWidget * parent ) : DctWidgetBox( parent )
     connect( d_data->m_ui->btnInterpolate, SIGNAL(clicked()), this, SLOT(onInterpolateClicked()) );
     connect( d_data->m_ui->btnImport, SIGNAL(clicked()), this, SLOT(onImportClicked()) );
     connect( d_data->m_ui->btnExport, SIGNAL(clicked()), this, SLOT(onExportClicked()) );
+    connect( d_data->m_ui->btnExportCube, SIGNAL(clicked()), this, SLOT(onExportCubeClicked()) );
+    connect( &d_data->m_cube_luts, SIGNAL(timeout()), this, SLOT(onCubeLutsTimeout()) );
 
     connect( d_data->m_model[Master], SIGNAL(dataChanged(const QModelIndex&,const QModelIndex&)), this, SLOT(onMasterSampleChanged(const QModelIndex&,const QModelIndex&)) );
     connect( d_data->m_model[Red]   , SIGNAL(dataChanged(const QModelIndex&,const QModelIndex&)), this, SLOT(onRedSampleChanged(const QModelIndex&,const QModelIndex&)) );
@@ -1038,6 +1221,14 @@ LutBox::~LutBox()
     delete d_data;
 }
 
+/******************************************************************************
+ * LutBox::cubeExport
+ *****************************************************************************/
+CubeExport * LutBox::cubeExport() const
+{
+    return ( d_data->m_cube_export );
+}
+
 /******************************************************************************
  * LutBox::LutEnable
  *****************************************************************************/
@@ -1148,6 +1339,11 @@ unsigned int LutBox::LutBitWidth() const
 void LutBox::setLutBitWidth( const unsigned int width )
 {
     d_data->m_bit_width = width;
+    d_data->setCurveScale();
+    d_data->drawHelperLine( Master );
+    d_data->drawHelperLine( Red );
+    d_data->drawHelperLine( Green );
+    d_data->drawHelperLine( Blue );
 
     // Reinitialize data model with new bit width
     d_data->initDataModel( Master );
@@ -1180,6 +1376,13 @@ void LutBox::loadSettings( QSettings & s )
     
     s.beginGroup( QString(LUT_SETTINGS_SECTION_NAME) + QString::number(d_data->m_active_chain_idx) );
 
+    // chain not saved (not selected or not read from the device), keep the device settings
+    if ( !s.contains(LUT_SETTINGS_STORAGE) )
+    {
+        s.endGroup();
+        return;
+    }
+
     // set lut enable
     setLutEnable( s.value(LUT_SETTINGS_ENABLE).toBool() );
 
@@ -1238,6 +1441,12 @@ void LutBox::loadSettings( QSettings & s )
                     break;
             }
 
+            // table left out on save (no device answer), keep the device table
+            if ( !s.contains(name_x) || !s.contains(name_y) )
+            {
+                continue;
+            }
+
             // @TODO: load list from readable text
             // NOTE: call qRegisterMetaTypeStreamOperators<QList<int> >("QList<int>");
             x = QVector<int>::fromList( s.value(name_x).value<QList<int> >() );
@@ -1295,12 +1504,6 @@ void LutBox::loadSettings( QSettings & s )
  *****************************************************************************/
 void LutBox::saveSettings( QSettings & s )
 {
-    QList<int> x;
-    QList<int> y;
-
-    // before storing, get current preset storage number, because it will be iterated in the save loop
-    int currentPreset = LutPresetStorage();
-
     s.beginGroup( QString(LUT_SETTINGS_SECTION_NAME) + QString::number(d_data->m_active_chain_idx) );
 
     // Store general lut settings
@@ -1310,75 +1513,63 @@ void LutBox::saveSettings( QSettings & s )
     s.setValue( LUT_SETTINGS_STORAGE   , LutPresetStorage() );
     s.setValue( LUT_SETTINGS_FAST_GAMMA, LutFastGamma() );
 
-    // disable updates to the view, otherwise the user can see the iterations
-    d_data->m_ui->LutPlot->setUpdatesEnabled( false );
-    d_data->m_ui->LutPlotRed->setUpdatesEnabled( false );
-    d_data->m_ui->LutPlotGreen->setUpdatesEnabled( false );
-    d_data->m_ui->LutPlotBlue->setUpdatesEnabled( false );
-    d_data->m_ui->tblSamples->setUpdatesEnabled( false );
-
-    // Store all lut tables
+    // request sample tables of all presets, answered from the interface cache;
+    // an uncached preset is briefly activated on the device to read it
+    d_data->m_preset_samples.clear();
     for ( int preset = 0; preset < LUT_NO_PRESETS; preset++ )
     {
-        // trigger event that loads the table from the device
-        emit LutPresetChanged( preset );
-
-        // store preset in file
-        for ( int ch = Master; ch < LutChannelMax; ch++ )
-        {
-            QString name_x;
-            QString name_y;
+        emit LutPresetSampleValuesRequested( preset );
+    }
 
-            switch ( ch )
-            {
-                case Red:
-                    name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_RED_X).arg( preset );
-                    name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_RED_Y).arg( preset );
-                    break;
+    // Store all lut tables, presets without device answer are left out
+    if ( !d_data->saveSamples( s, d_data->m_preset_samples ) )
+    {
+        QMessageBox::warning( this, tr("Save LUT Settings"),
+            tr("Not all LUT presets could be read from the device. The missing "
+               "presets are not saved and keep their device tables on load.") );
+    }
 
-                case Green:
-                    name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_GREEN_X).arg( preset );;
-                    name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_GREEN_Y).arg( preset );;
-                    break;
+    // REC.709 settings
+    d_data->saveRec709( s );
 
-                case Blue:
-                    name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_BLUE_X).arg( preset );;
-                    name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_BLUE_Y).arg( preset );;
-                    break;
+    s.endGroup();
+}
 
-                default:
-                    name_x = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_X).arg( preset );;
-                    name_y = QString( "%1_%2" ).arg( LUT_SETTINGS_SAMPLE_Y).arg( preset );;
-                    break;
-            }
+/******************************************************************************
+ * LutBox::saveSnapshot
+ *****************************************************************************/
+bool LutBox::saveSnapshot( QSettings & s, const int chain )
+{
+    int idx = chain - 1;
 
-            d_data->getDataFromModel( (LutChannel)ch, x, y );
-            // @TODO: save list as readable text
-            // NOTE: call qRegisterMetaTypeStreamOperators<QList<int> >("QList<int>");
-            s.setValue( name_x, QVariant::fromValue<QList<int>>(x) );
-            s.setValue( name_y, QVariant::fromValue<QList<int>>(y) );
-        }
+    // the snapshot is consumed, a failed read must not store stale data
+    if ( (idx < 0) || (idx >= MAX_NUM_CHAINS) || !d_data->m_snapshot[idx].valid )
+    {
+        return ( false );
     }
 
-    // REC.709 settings
-    s.setValue( LUT_SETTINGS_REC709_LCONTRAST  , d_data->m_ui->sbxRec709LinContrast->value() );
-    s.setValue( LUT_SETTINGS_REC709_LBRIGHTNESS, d_data->m_ui->sbxRec709LinOffset  ->value() );
-    s.setValue( LUT_SETTINGS_REC709_THRESHOLD  , d_data->m_ui->sbxRec709Threshold  ->value() );
-    s.setValue( LUT_SETTINGS_REC709_CONTRAST   , d_data->m_ui->sbxRec709Contrast   ->value() );
-    s.setValue( LUT_SETTINGS_REC709_GAMMA      , d_data->m_ui->sbxRec709Gamma      ->value() );
-    s.setValue( LUT_SETTINGS_REC709_BRIGHTNESS , d_data->m_ui->sbxRec709Offset     ->value() );
+    LutSnapshot & snapshot = d_data->m_snapshot[idx];
+
+    s.beginGroup( QString(LUT_SETTINGS_SECTION_NAME) + QString::number(idx) );
+
+    // Store general lut settings
+    s.setValue( LUT_SETTINGS_ENABLE    , d_data->m_enable[idx] );
+    s.setValue( LUT_SETTINGS_MODE      , snapshot.mode );
+    s.setValue( LUT_SETTINGS_FIXED_MODE, snapshot.fixed_mode );
+    s.setValue( LUT_SETTINGS_STORAGE   , snapshot.preset );
+    s.setValue( LUT_SETTINGS_FAST_GAMMA, snapshot.fast_gamma );
+
+    // Store all lut tables, tables without device answer are left out
+    bool complete = d_data->saveSamples( s, snapshot.samples );
+
+    // REC.709 settings (only exist in the user interface)
+    d_data->saveRec709( s );
 
     s.endGroup();
 
-    // Switch back to original preset
-    emit LutPresetChanged( currentPreset );
+    snapshot.valid = false;
 
-    // Renable updates
-    d_data->m_ui->LutPlot->setUpdatesEnabled( true );
-    d_data->m_ui->LutPlotRed->setUpdatesEnabled( true );
-    d_data->m_ui->LutPlotGreen->setUpdatesEnabled( true );
-    d_data->m_ui->LutPlotBlue->setUpdatesEnabled( true );
-    d_data->m_ui->tblSamples->setUpdatesEnabled( true );
+    return ( complete );
 }
 
 /******************************************************************************
@@ -1542,6 +1733,7 @@ void LutBox::onLutModeChange( int mode )
 
         // Use scatter symbols in interpolation mode
         masterPlot->graph( SAMPLE_CURVE_ID )->setScatterStyle( QCPScatterStyle(QCPScatterStyle::ssCircle, 4 ) );
+        d_data->m_curve[Master][SAMPLE_CURVE_ID]->replot();
 
         // Disable fast gamma ui elements
         d_data->m_ui->rbFastGamma->setChecked( false );
@@ -1571,6 +1763,7 @@ void LutBox::onLutModeChange( int mode )
 
         // Do not use scatter symbols in fat gamma or fixed mode
         masterPlot->graph( SAMPLE_CURVE_ID )->setScatterStyle( QCPScatterStyle(QCPScatterStyle::ssNone ) );
+        d_data->m_curve[Master][SAMPLE_CURVE_ID]->replot();
 
         // If mode = fast gamma, enable fast gamma UI elements
         if ( mode == LUT_MODE_FAST_GAMMA )
@@ -1863,6 +2056,64 @@ void LutBox::onExportClicked()
     }
 }
 
+/******************************************************************************
+ * LutBox::onExportCubeClicked
+ *****************************************************************************/
+void LutBox::onExportCubeClicked()
+{
+    QStringList sizes;
+    sizes << "33" << "65";
+
+    bool ok = false;
+    QString size = QInputDialog::getItem( this, tr("Export 3D LUT"),
+        tr("Lattice size:"), sizes, 0, false, &ok );
+    if ( !ok )
+    {
+        return;
+    }
+
+    QString directory = QDir::currentPath();
+
+    // NOTE: see onExportClicked
+    QFileDialog dialog( this );
+    dialog.setDefaultSuffix( "cube" );
+    QString fileName = dialog.getSaveFileName(
+        this, tr("Save 3D LUT"),
+        directory,
+        "Cube LUT (*.cube);;All files (*.*)"
+    );
+
+    if ( nullptr != fileName )
+    {
+        QFileInfo file( fileName );
+        if ( file.suffix().isEmpty() )
+        {
+            fileName += ".cube";
+        }
+
+        d_data->m_cube_luts.stop();
+        d_data->updateCubeLuts();
+
+        QApplication::setOverrideCursor( Qt::WaitCursor );
+        ok = d_data->m_cube_export->save( fileName, size.toInt(), file.completeBaseName() );
+        QApplication::restoreOverrideCursor();
+
+        if ( !ok )
+        {
+            QMessageBox::warning( this, tr("Export 3D LUT"),
+                tr("The 3D LUT could not be written to %1.").arg( fileName ) );
+        }
+    }
+}
+
+/******************************************************************************
+ * LutBox::onCubeLutsTimeout
+ *****************************************************************************/
+void LutBox::onCubeLutsTimeout()
+{
+    d_data->updateCubeLuts();
+}
+
 /******************************************************************************
  * LutBox::SampleChanged
  *****************************************************************************/
@@ -1999,6 +2250,58 @@ void LutBox::onLutSampleValuesBlueChange( QVector<int> x, QVector<int> y )
     d_data->setSamples( Blue, x, y );
 }
 
+/******************************************************************************
+ * LutBox::onLutPresetSampleValuesChange
+ *****************************************************************************/
+void LutBox::onLutPresetSampleValuesChange( int preset, int ch, QVector<int> x, QVector<int> y )
+{
+    if ( (preset >= 0) && (preset < LUT_NO_PRESETS) && (ch >= Master) && (ch < LutChannelMax) )
+    {
+        d_data->m_preset_samples.x[preset][ch]     = x.toList();
+        d_data->m_preset_samples.y[preset][ch]     = y.toList();
+        d_data->m_preset_samples.valid[preset][ch] = true;
+    }
+}
+
+/******************************************************************************
+ * LutBox::onLutSnapshotChange
+ *****************************************************************************/
+void LutBox::onLutSnapshotChange( int chain, int mode, int fixed_mode, int preset, int fast_gamma )
+{
+    int idx = chain - 1;
+
+    if ( (idx >= 0) && (idx < MAX_NUM_CHAINS) )
+    {
+        LutSnapshot & snapshot = d_data->m_snapshot[idx];
+
+        // a new snapshot starts, sample tables follow
+        snapshot.valid      = true;
+        snapshot.mode       = mode;
+        snapshot.fixed_mode = fixed_mode;
+        snapshot.preset     = preset;
+        snapshot.fast_gamma = fast_gamma;
+        snapshot.samples.clear();
+    }
+}
+
+/******************************************************************************
+ * LutBox::onLutSnapshotSampleValuesChange
+ *****************************************************************************/
+void LutBox::onLutSnapshotSampleValuesChange( int chain, int preset, int ch, QVector<int> x, QVector<int> y )
+{
+    int idx = chain - 1;
+
+    if ( (idx >= 0) && (idx < MAX_NUM_CHAINS) &&
+         (preset >= 0) && (preset < LUT_NO_PRESETS) && (ch >= Master) && (ch < LutChannelMax) )
+    {
+        LutPresetSamples & samples = d_data->m_snapshot[idx].samples;
+
+        samples.x[preset][ch]     = x.toList();
+        samples.y[preset][ch]     = y.toList();
+        samples.valid[preset][ch] = true;
+    }
+}
+
 /******************************************************************************
  * LutBox::onLutFastGammaChange
  *****************************************************************************/
@@ -29,6 +29,8 @@
 #include <QAbstractButton>
 #include <QItemSelection>
 
+class CubeExport;
+
 /******************************************************************************
  * Linear Contrast Definitions
  *****************************************************************************/
@@ -125,6 +127,13 @@ public:
     unsigned int LutBitWidth() const;
     void setLutBitWidth( const unsigned int );
 
+    // save the settings snapshot of a chain which is not the active one,
+    // false if the device did not answer for all settings
+    bool saveSnapshot( QSettings & s, const int chain );
+
+    // 3D LUT export, follows the colour settings of the device interfaces
+    CubeExport * cubeExport() const;
+
 protected:
     void prepareMode( const Mode mode ) Q_DECL_OVERRIDE;
 
@@ -155,6 +164,7 @@ signals:
     void LutSampleValuesGreenRequested();
     void LutSampleValuesBlueRequested();
     void LutSampleValuesMasterRequested();
+    void LutPresetSampleValuesRequested( int );
 
     void LutInterpolateChanged();
     void LutInterpolateRedChanged();
@@ -180,6 +190,10 @@ public slots:
     void onLutSampleValuesRedChange( QVector<int> x, QVector<int> y );
     void onLutSampleValuesGreenChange( QVector<int> x, QVector<int> y );
     void onLutSampleValuesBlueChange( QVector<int> x, QVector<int> y );
+    void onLutPresetSampleValuesChange( int preset, int ch, QVector<int> x, QVector<int> y );
+
+    void onLutSnapshotChange( int chain, int mode, int fixed_mode, int preset, int fast_gamma );
+    void onLutSnapshotSampleValuesChange( int chain, int preset, int ch, QVector<int> x, QVector<int> y );
 
     void onLutFastGammaChange( int );
 
@@ -223,6 +237,8 @@ private slots:
     void onInterpolateClicked();
     void onImportClicked();
     void onExportClicked();
+    void onExportCubeClicked();
+    void onCubeLutsTimeout();
 
     void onMasterSampleChanged( const QModelIndex &, const QModelIndex & );
     void onRedSampleChanged( const QModelIndex &, const QModelIndex & );
@@ -0,0 +1,490 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    pipeline_preview.cpp
+ *
+ * @brief   Implementation of a preview of the ISP colour pipeline
+ *
+ *****************************************************************************/
+#include <cmath>
+
+#include <QtDebug>
+#include <QAtomicInt>
+#include <QColor>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QImage>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPainter>
+#include <QPushButton>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QVector>
+
+#include <simple_math/isp_pipeline.h>
+
+#include "cube_export.h"
+#include "pipeline_preview.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define PREVIEW_CHART_WIDTH             ( 1280 )        // size of the test chart
+#define PREVIEW_CHART_HEIGHT            ( 720 )
+#define PREVIEW_MAX_WIDTH               ( 1920 )        // loaded pictures are scaled down to 1080p
+#define PREVIEW_MAX_HEIGHT              ( 1080 )
+#define PREVIEW_STRIP_LINES             ( 16 )          // lines processed at once by a thread
+#define PREVIEW_BIT_WIDTH               ( 16u )         // bit-width of the linear input
+#define PREVIEW_ONE                     ( 65535.0f )
+
+/******************************************************************************
+ * toSample - linear value in [0, 1] as input sample
+ *****************************************************************************/
+static inline uint16_t toSample( float v )
+{
+    v = ( v < 0.0f ) ? 0.0f : ( (v > 1.0f) ? 1.0f : v );
+    return ( (uint16_t)(v * PREVIEW_ONE + 0.5f) );
+}
+
+/******************************************************************************
+ * PreviewStrips - processes strips of a frame until all strips are taken
+ *****************************************************************************/
+class PreviewStrips
+{
+public:
+    PreviewStrips( const isp_pipeline_t * pipe, const uint16_t * in, uint32_t * out,
+                   int out_stride, int width, int height )
+        : m_pipe( pipe )
+        , m_in( in )
+        , m_out( out )
+        , m_out_stride( out_stride )
+        , m_width( width )
+        , m_height( height )
+        , m_strips( (height + PREVIEW_STRIP_LINES - 1) / PREVIEW_STRIP_LINES )
+        , m_next( 0 )
+        , m_failed( 0 )
+    {
+    }
+
+    void run()
+    {
+        int s;
+
+        while ( (s = m_next.fetchAndAddRelaxed( 1 )) < m_strips )
+        {
+            const int y = s * PREVIEW_STRIP_LINES;
+            const int h = qMin( PREVIEW_STRIP_LINES, m_height - y );
+
+            int res = sm_isp_pipeline_process( m_pipe,
+                          &m_in[(size_t)y * 3u * (size_t)m_width], 3u * (uint32_t)m_width, PREVIEW_BIT_WIDTH,
+                          &m_out[(size_t)y * (size_t)m_out_stride], (uint32_t)m_out_stride,
+                          (uint32_t)m_width, (uint32_t)h );
+            if ( res )
+            {
+                m_failed.storeRelease( 1 );
+                return;
+            }
+        }
+    }
+
+    const isp_pipeline_t *  m_pipe;         /**< computed pipeline, only read */
+    const uint16_t *        m_in;           /**< linear RGB input */
+    uint32_t *              m_out;          /**< 0xffRRGGBB output */
+    int                     m_out_stride;   /**< distance of output lines in pixels */
+    int                     m_width;        /**< pixels per line */
+    int                     m_height;       /**< lines of the frame */
+    int                     m_strips;       /**< number of strips */
+    QAtomicInt              m_next;         /**< next strip to process */
+    QAtomicInt              m_failed;       /**< a strip could not be processed */
+};
+
+/******************************************************************************
+ * PreviewStripsJob - runs a PreviewStrips on a pool thread
+ *****************************************************************************/
+class PreviewStripsJob : public QRunnable
+{
+public:
+    PreviewStripsJob( PreviewStrips * strips, QSemaphore * done )
+        : m_strips( strips )
+        , m_done( done )
+    {
+        setAutoDelete( true );
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_strips->run();
+        m_done->release();
+    }
+
+private:
+    PreviewStrips * m_strips;
+    QSemaphore *    m_done;
+};
+
+/******************************************************************************
+ * PipelinePreview::PrivateData
+ *****************************************************************************/
+class PipelinePreview::PrivateData
+{
+public:
+    PrivateData()
+        : m_pipe( new isp_pipeline_t )
+        , m_source( nullptr )
+        , m_width( 0 )
+        , m_height( 0 )
+        , m_dirty( true )
+        , m_area( nullptr )
+        , m_status( nullptr )
+    {
+        sm_isp_pipeline_reset( m_pipe );
+
+        // changes in a row are rendered once
+        m_timer.setSingleShot( true );
+        m_timer.setInterval( 0 );
+    }
+
+    ~PrivateData()
+    {
+        delete m_pipe;
+    }
+
+    // test chart: colour bars, hue and saturation sweep and a grey ramp
+    void makeChart()
+    {
+        const int w = PREVIEW_CHART_WIDTH;
+        const int h = PREVIEW_CHART_HEIGHT;
+        const int bars = h / 3;
+        const int sweep = h / 3;
+
+        static const float bar[8][3] =
+        {
+            { 0.75f, 0.75f, 0.75f }, { 0.75f, 0.75f, 0.0f  }, { 0.0f , 0.75f, 0.75f }, { 0.0f , 0.75f, 0.0f },
+            { 0.75f, 0.0f , 0.75f }, { 0.75f, 0.0f , 0.0f  }, { 0.0f , 0.0f , 0.75f }, { 0.0f , 0.0f , 0.0f },
+        };
+
+        m_width  = w;
+        m_height = h;
+        m_in.resize( 3 * w * h );
+
+        uint16_t * p = m_in.data();
+        for ( int y = 0; y < h; y++ )
+        {
+            for ( int x = 0; x < w; x++ )
+            {
+                float rgb[3];
+
+                if ( y < bars )
+                {
+                    const int b = (x * 8) / w;
+                    rgb[0] = bar[b][0];
+                    rgb[1] = bar[b][1];
+                    rgb[2] = bar[b][2];
+                }
+                else if ( y < (bars + sweep) )
+                {
+                    const QColor c = QColor::fromHsvF( (qreal)x / (qreal)w,
+                                                       1.0 - (qreal)(y - bars) / (qreal)sweep, 0.8 );
+                    rgb[0] = (float)c.redF();
+                    rgb[1] = (float)c.greenF();
+                    rgb[2] = (float)c.blueF();
+                }
+                else
+                {
+                    rgb[0] = rgb[1] = rgb[2] = (float)x / (float)(w - 1);
+                }
+
+                *p++ = toSample( rgb[0] );
+                *p++ = toSample( rgb[1] );
+                *p++ = toSample( rgb[2] );
+            }
+        }
+    }
+
+    // picture as linear input, sRGB transfer function removed
+    bool makeImage( QImage image )
+    {
+        if ( image.isNull() )
+        {
+            return ( false );
+        }
+
+        if ( (image.width() > PREVIEW_MAX_WIDTH) || (image.height() > PREVIEW_MAX_HEIGHT) )
+        {
+            image = image.scaled( PREVIEW_MAX_WIDTH, PREVIEW_MAX_HEIGHT, Qt::KeepAspectRatio, Qt::SmoothTransformation );
+        }
+        image = image.convertToFormat( QImage::Format_RGB32 );
+
+        uint16_t linear[256];
+        for ( int i = 0; i < 256; i++ )
+        {
+            const float v = (float)i / 255.0f;
+            linear[i] = toSample( (v <= 0.04045f) ? (v / 12.92f) : powf( (v + 0.055f) / 1.055f, 2.4f ) );
+        }
+
+        m_width  = image.width();
+        m_height = image.height();
+        m_in.resize( 3 * m_width * m_height );
+
+        uint16_t * p = m_in.data();
+        for ( int y = 0; y < m_height; y++ )
+        {
+            const QRgb * line = (const QRgb *)image.constScanLine( y );
+            for ( int x = 0; x < m_width; x++ )
+            {
+                *p++ = linear[qRed( line[x] )];
+                *p++ = linear[qGreen( line[x] )];
+                *p++ = linear[qBlue( line[x] )];
+            }
+        }
+
+        return ( true );
+    }
+
+    isp_pipeline_t *    m_pipe;         /**< pipeline model */
+    CubeExport *        m_source;       /**< pipeline settings */
+    QVector<uint16_t>   m_in;           /**< still image, interleaved linear RGB */
+    int                 m_width;        /**< width of still image */
+    int                 m_height;       /**< height of still image */
+    QImage              m_frame;        /**< rendered frame */
+    bool                m_dirty;        /**< settings changed while hidden */
+    QTimer              m_timer;        /**< coalesces settings changes */
+    QWidget *           m_area;         /**< area of the frame */
+    QLabel *            m_status;       /**< size and render time */
+};
+
+/******************************************************************************
+ * PipelinePreview::PipelinePreview
+ *****************************************************************************/
+PipelinePreview::PipelinePreview( QWidget * parent )
+    : QWidget( parent )
+{
+    d_data = new PrivateData;
+
+    QPushButton * load  = new QPushButton( tr("Load Image"), this );
+    QPushButton * chart = new QPushButton( tr("Test Chart"), this );
+    d_data->m_status = new QLabel( this );
+
+    QHBoxLayout * bar = new QHBoxLayout;
+    bar->addWidget( load );
+    bar->addWidget( chart );
+    bar->addStretch();
+    bar->addWidget( d_data->m_status );
+
+    // the frame is painted by this widget into the area
+    d_data->m_area = new QWidget( this );
+    d_data->m_area->setMinimumSize( 160, 90 );
+
+    QVBoxLayout * layout = new QVBoxLayout( this );
+    layout->addLayout( bar );
+    layout->addWidget( d_data->m_area, 1 );
+
+    connect( load, SIGNAL(clicked()), this, SLOT(onLoadClicked()) );
+    connect( chart, SIGNAL(clicked()), this, SLOT(onChartClicked()) );
+    connect( &d_data->m_timer, SIGNAL(timeout()), this, SLOT(onRender()) );
+
+    d_data->makeChart();
+}
+
+/******************************************************************************
+ * PipelinePreview::~PipelinePreview
+ *****************************************************************************/
+PipelinePreview::~PipelinePreview()
+{
+    delete d_data;
+}
+
+/******************************************************************************
+ * PipelinePreview::setSource
+ *****************************************************************************/
+void PipelinePreview::setSource( CubeExport * source )
+{
+    if ( d_data->m_source )
+    {
+        disconnect( d_data->m_source, SIGNAL(SettingsChanged()), this, SLOT(onSettingsChange()) );
+    }
+
+    d_data->m_source = source;
+
+    if ( source )
+    {
+        connect( source, SIGNAL(SettingsChanged()), this, SLOT(onSettingsChange()) );
+    }
+
+    onSettingsChange();
+}
+
+/******************************************************************************
+ * PipelinePreview::loadImage
+ *****************************************************************************/
+bool PipelinePreview::loadImage( const QString & fileName )
+{
+    if ( !d_data->makeImage( QImage( fileName ) ) )
+    {
+        return ( false );
+    }
+
+    onSettingsChange();
+
+    return ( true );
+}
+
+/******************************************************************************
+ * PipelinePreview::sizeHint
+ *****************************************************************************/
+QSize PipelinePreview::sizeHint() const
+{
+    return ( QSize( 480, 300 ) );
+}
+
+/******************************************************************************
+ * PipelinePreview::onSettingsChange
+ *****************************************************************************/
+void PipelinePreview::onSettingsChange()
+{
+    d_data->m_dirty = true;
+
+    if ( isVisible() && !d_data->m_timer.isActive() )
+    {
+        d_data->m_timer.start();
+    }
+}
+
+/******************************************************************************
+ * PipelinePreview::onRender
+ *****************************************************************************/
+void PipelinePreview::onRender()
+{
+    // a hidden preview is rendered when it is shown
+    if ( !d_data->m_source || !isVisible() )
+    {
+        return;
+    }
+
+    d_data->m_dirty = false;
+
+    QElapsedTimer t;
+    t.start();
+
+    isp_pipeline_params_t params;
+    d_data->m_source->pipelineParams( params );
+
+    int res = sm_isp_pipeline_update( d_data->m_pipe, &params );
+    if ( res )
+    {
+        qDebug() << "pipeline preview: invalid pipeline settings" << res;
+        return;
+    }
+
+    if ( d_data->m_frame.size() != QSize( d_data->m_width, d_data->m_height ) )
+    {
+        d_data->m_frame = QImage( d_data->m_width, d_data->m_height, QImage::Format_RGB32 );
+    }
+
+    // process on the pool threads and on this one
+    PreviewStrips strips( d_data->m_pipe, d_data->m_in.constData(), (uint32_t *)d_data->m_frame.bits(),
+                          d_data->m_frame.bytesPerLine() / 4, d_data->m_width, d_data->m_height );
+    QSemaphore done;
+
+    QThreadPool * pool = QThreadPool::globalInstance();
+    const int jobs = qMin( pool->maxThreadCount(), strips.m_strips ) - 1;
+    for ( int i = 0; i < jobs; i++ )
+    {
+        pool->start( new PreviewStripsJob( &strips, &done ) );
+    }
+    strips.run();
+    done.acquire( jobs );
+
+    if ( strips.m_failed.loadAcquire() )
+    {
+        qDebug() << "pipeline preview: frame could not be processed";
+        return;
+    }
+
+    d_data->m_status->setText( tr("%1x%2, %3 ms").arg( d_data->m_width ).arg( d_data->m_height ).arg( t.elapsed() ) );
+
+    update();
+}
+
+/******************************************************************************
+ * PipelinePreview::paintEvent
+ *****************************************************************************/
+void PipelinePreview::paintEvent( QPaintEvent * )
+{
+    if ( d_data->m_frame.isNull() )
+    {
+        return;
+    }
+
+    const QRect area = d_data->m_area->geometry();
+
+    QSize size = d_data->m_frame.size();
+    size.scale( area.size(), Qt::KeepAspectRatio );
+
+    QRect target( QPoint( 0, 0 ), size );
+    target.moveCenter( area.center() );
+
+    QPainter painter( this );
+    painter.setRenderHint( QPainter::SmoothPixmapTransform );
+    painter.drawImage( target, d_data->m_frame );
+}
+
+/******************************************************************************
+ * PipelinePreview::showEvent
+ *****************************************************************************/
+void PipelinePreview::showEvent( QShowEvent * event )
+{
+    QWidget::showEvent( event );
+
+    if ( d_data->m_dirty )
+    {
+        onSettingsChange();
+    }
+}
+
+/******************************************************************************
+ * PipelinePreview::onLoadClicked
+ *****************************************************************************/
+void PipelinePreview::onLoadClicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+        this, tr("Load Preview Image"),
+        QDir::currentPath(),
+        "Images (*.png *.jpg *.jpeg *.bmp *.tif *.tiff);;All files (*.*)"
+    );
+
+    if ( !fileName.isEmpty() && !loadImage( fileName ) )
+    {
+        QMessageBox::warning( this, tr("Load Preview Image"),
+            tr("The image %1 could not be read.").arg( fileName ) );
+    }
+}
+
+/******************************************************************************
+ * PipelinePreview::onChartClicked
+ *****************************************************************************/
+void PipelinePreview::onChartClicked()
+{
+    d_data->makeChart();
+    onSettingsChange();
+}
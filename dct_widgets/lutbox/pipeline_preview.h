@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    pipeline_preview.h
+ *
+ * @brief   Class definition of a preview of the ISP colour pipeline
+ *
+ * @note    The preview shows a still image (a test chart or a loaded
+ *          picture) through the software pipeline model with the settings
+ *          of a CubeExport, which follows the white balance, colour
+ *          processing, multi colour control, knee and LUT widgets. Every
+ *          change is rendered again, changes in a row are coalesced into
+ *          one frame. The frame is processed in strips of lines on the
+ *          global thread pool and on the GUI thread.
+ *
+ *****************************************************************************/
+#ifndef __PIPELINE_PREVIEW_H__
+#define __PIPELINE_PREVIEW_H__
+
+#include <QWidget>
+
+class CubeExport;
+
+class PipelinePreview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PipelinePreview( QWidget * parent = nullptr );
+    ~PipelinePreview();
+
+    // pipeline settings to follow
+    void setSource( CubeExport * source );
+
+    // show a picture instead of the test chart, false if it can not be read
+    bool loadImage( const QString & fileName );
+
+    QSize sizeHint() const Q_DECL_OVERRIDE;
+
+public slots:
+    // render again with the current settings
+    void onSettingsChange();
+
+protected:
+    void paintEvent( QPaintEvent * event ) Q_DECL_OVERRIDE;
+    void showEvent( QShowEvent * event ) Q_DECL_OVERRIDE;
+
+private slots:
+    void onRender();
+    void onLoadClicked();
+    void onChartClicked();
+
+private:
+    class PrivateData;
+    PrivateData * d_data;
+};
+
+#endif // __PIPELINE_PREVIEW_H__
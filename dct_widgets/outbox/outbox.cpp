@@ -63,6 +63,34 @@ static bool fileExists( QString & path )
     return ( check_file.exists() && check_file.isFile() );
 }
 
+/******************************************************************************
+ * OutSnapshot - settings of a chain which is not the active one
+ *****************************************************************************/
+struct OutSnapshot
+{
+    OutSnapshot()
+        : matrix_valid( false )
+        , sdi_valid( false )
+        , raw_valid( false )
+        , kred( 0 )
+        , kblue( 0 )
+        , sdi_mode( 0 )
+        , sdi_black( 0 )
+        , sdi_white( 0 )
+        , raw_mode( 0 )
+    { }
+
+    bool    matrix_valid;
+    bool    sdi_valid;
+    bool    raw_valid;
+    int     kred;
+    int     kblue;
+    int     sdi_mode;       /**< combo box index, same as saved by saveSettings */
+    int     sdi_black;
+    int     sdi_white;
+    int     raw_mode;       /**< combo box index, same as saved by saveSettings */
+};
+
 /******************************************************************************
  * OutBox::PrivateData
  *****************************************************************************/
@@ -159,6 +187,7 @@ public:
     int               m_active_chain_idx;   /**< index of the currently active chain */
     SdiMode           m_sdiMode;            /**< current sdi mode */
     OutputMode    m_csMode;             /**< current color space mode */
+    OutSnapshot       m_snapshot[MAX_NUM_CHAINS]; /**< received settings of inactive chains */
     
     QString           m_filename;           /**< Matrix profile name */
 };
@@ -424,12 +453,29 @@ void OutBox::loadSettings( QSettings & s )
 {
     s.beginGroup( QString(OUT_SETTINGS_SECTION_NAME) + QString::number(d_data->m_active_chain_idx) );
 
-    setRedCoefficient( s.value( OUT_SETTINGS_RED_COEFFICIENT).toInt() );
-    setBlueCoefficient( s.value( OUT_SETTINGS_BLUE_COEFFICIENT).toInt() );
-    setSdiBlack(s.value( OUT_SETTINGS_SDI_BLACK ).toInt() );
-    setSdiWhite(s.value( OUT_SETTINGS_SDI_WHITE ).toInt() );
-    setSdiMode(s.value( OUT_SETTINGS_SDI_MODE ).toInt() );
-    setRawMode(s.value( OUT_SETTINGS_RAW_MODE ).toInt() );
+    // settings which are missing in the file (not read from the device on
+    // save) are skipped, the device keeps its values
+    if ( s.contains(OUT_SETTINGS_RED_COEFFICIENT) && s.contains(OUT_SETTINGS_BLUE_COEFFICIENT) )
+    {
+        setRedCoefficient( s.value( OUT_SETTINGS_RED_COEFFICIENT).toInt() );
+        setBlueCoefficient( s.value( OUT_SETTINGS_BLUE_COEFFICIENT).toInt() );
+    }
+    if ( s.contains(OUT_SETTINGS_SDI_BLACK) )
+    {
+        setSdiBlack(s.value( OUT_SETTINGS_SDI_BLACK ).toInt() );
+    }
+    if ( s.contains(OUT_SETTINGS_SDI_WHITE) )
+    {
+        setSdiWhite(s.value( OUT_SETTINGS_SDI_WHITE ).toInt() );
+    }
+    if ( s.contains(OUT_SETTINGS_SDI_MODE) )
+    {
+        setSdiMode(s.value( OUT_SETTINGS_SDI_MODE ).toInt() );
+    }
+    if ( s.contains(OUT_SETTINGS_RAW_MODE) )
+    {
+        setRawMode(s.value( OUT_SETTINGS_RAW_MODE ).toInt() );
+    }
 
     s.endGroup();
 }
@@ -451,6 +497,49 @@ void OutBox::saveSettings( QSettings & s )
     s.endGroup();
 }
 
+/******************************************************************************
+ * OutBox::saveSnapshot
+ *****************************************************************************/
+bool OutBox::saveSnapshot( QSettings & s, const int chain )
+{
+    int idx = chain - 1;
+
+    if ( (idx < 0) || (idx >= MAX_NUM_CHAINS) )
+    {
+        return ( false );
+    }
+
+    OutSnapshot & snapshot = d_data->m_snapshot[idx];
+    bool complete = snapshot.matrix_valid && snapshot.sdi_valid && snapshot.raw_valid;
+
+    s.beginGroup( QString(OUT_SETTINGS_SECTION_NAME) + QString::number(idx) );
+
+    // settings the device did not answer for are left out, loading the
+    // file keeps the device values for them
+    if ( snapshot.matrix_valid )
+    {
+        s.setValue( OUT_SETTINGS_RED_COEFFICIENT , snapshot.kred );
+        s.setValue( OUT_SETTINGS_BLUE_COEFFICIENT, snapshot.kblue );
+    }
+    if ( snapshot.sdi_valid )
+    {
+        s.setValue( OUT_SETTINGS_SDI_BLACK       , snapshot.sdi_black );
+        s.setValue( OUT_SETTINGS_SDI_WHITE       , snapshot.sdi_white );
+        s.setValue( OUT_SETTINGS_SDI_MODE        , snapshot.sdi_mode );
+    }
+    if ( snapshot.raw_valid )
+    {
+        s.setValue( OUT_SETTINGS_RAW_MODE        , snapshot.raw_mode );
+    }
+
+    s.endGroup();
+
+    // the snapshot is consumed
+    snapshot = OutSnapshot();
+
+    return ( complete );
+}
+
 /******************************************************************************
  * OutBox::applySettings
  *****************************************************************************/
@@ -600,6 +689,64 @@ void OutBox::onRawModeChange( int value )
     }    
 }
 
+/******************************************************************************
+ * OutBox::onColorConversionMatrixSnapshotChange
+ *****************************************************************************/
+void OutBox::onColorConversionMatrixSnapshotChange
+(
+    int chain,
+    int c0, int c1, int c2,
+    int c3, int c4, int c5,
+    int c6, int c7, int c8
+)
+{
+    (void)c1;
+    (void)c3; (void)c4; (void)c5;
+    (void)c6; (void)c7; (void)c8;
+
+    int idx = chain - 1;
+
+    if ( (idx >= 0) && (idx < MAX_NUM_CHAINS) )
+    {
+        // same conversion as onColorConversionMatrixChange
+        d_data->m_snapshot[idx].kred         = (int)((((float)c0) / FIX_PRECISION_S0212) * FIX_PRECISION_KRED);
+        d_data->m_snapshot[idx].kblue        = (int)((((float)c2) / FIX_PRECISION_S0212) * FIX_PRECISION_KBLUE);
+        d_data->m_snapshot[idx].matrix_valid = true;
+    }
+}
+
+/******************************************************************************
+ * OutBox::onSdiSnapshotChange
+ *****************************************************************************/
+void OutBox::onSdiSnapshotChange( int chain, int mode, int black, int white )
+{
+    int idx   = chain - 1;
+    int index = d_data->m_ui->cbxSdiMode->findData( mode );
+
+    if ( (idx >= 0) && (idx < MAX_NUM_CHAINS) && (index != -1) )
+    {
+        d_data->m_snapshot[idx].sdi_mode  = index;
+        d_data->m_snapshot[idx].sdi_black = black;
+        d_data->m_snapshot[idx].sdi_white = white;
+        d_data->m_snapshot[idx].sdi_valid = true;
+    }
+}
+
+/******************************************************************************
+ * OutBox::onRawModeSnapshotChange
+ *****************************************************************************/
+void OutBox::onRawModeSnapshotChange( int chain, int value )
+{
+    int idx   = chain - 1;
+    int index = d_data->m_ui->cbxCsMode->findData( value );
+
+    if ( (idx >= 0) && (idx < MAX_NUM_CHAINS) && (index != -1) )
+    {
+        d_data->m_snapshot[idx].raw_mode  = index;
+        d_data->m_snapshot[idx].raw_valid = true;
+    }
+}
+
 /******************************************************************************
  * OutBox::onKredChange
  *****************************************************************************/
@@ -97,6 +97,10 @@ public:
     void changeSdiStringToHdmi(const bool value);
     void setRawModeVisible(const bool value);
 
+    // save the settings snapshot of a chain which is not the active one,
+    // false if the device did not answer for all settings
+    bool saveSnapshot( QSettings & s, const int chain );
+
 protected:
     void prepareMode( const Mode mode ) Q_DECL_OVERRIDE;
 
@@ -125,6 +129,13 @@ public slots:
     
     void onRawModeChange( int mode );
 
+    void onColorConversionMatrixSnapshotChange( int chain,
+                                                int c0, int c1, int c2,
+                                                int c3, int c4, int c5,
+                                                int c6, int c7, int c8 );
+    void onSdiSnapshotChange( int chain, int mode, int black, int white );
+    void onRawModeSnapshotChange( int chain, int value );
+
 private slots:
     void onKredChange( int value );
     void onKblueChange( int value );
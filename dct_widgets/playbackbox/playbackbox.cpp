@@ -27,6 +27,7 @@
 #include <QtDebug>
 #include <QSignalMapper>
 #include <QTimer>
+#include <QElapsedTimer>
 
 /******************************************************************************
  * namespaces 
@@ -46,6 +47,10 @@ namespace Ui {
 #define BANK_CONFIGURATION_DEFAULT_4    ( 4 )
 #define BANK_CONFIGURATION_USER         ( 5 )
 
+#define POS_DISPLAY_MIN_INTERVAL        ( 33 )      // max. 30 display updates per second
+#define POS_SYNC_DEFAULT_INTERVAL       ( 250 )     // device position poll interval (in ms)
+#define POS_DRIFT_TOLERANCE             ( 2 )       // tolerated extrapolation error (in frames)
+
 /******************************************************************************
  * class Bank
  *****************************************************************************/
@@ -423,6 +428,9 @@ private:
         , m_init_sync( true )
         , m_dial_value( 25 )
         , m_dial_delta( 0 )
+        , m_out_fps( 50000 )
+        , m_pos_anchor( 0 )
+        , m_sync_interval( POS_SYNC_DEFAULT_INTERVAL )
     {
         // initialize UI
         m_ui->setupUi( parent );
@@ -481,6 +489,7 @@ private:
         m_ui->Position->blockSignals( false );
 
         m_pos_timer = new QTimer();
+        m_pos_timer->setInterval( 1000000 / m_out_fps );
     };
 
     ~PrivateData()
@@ -511,13 +520,53 @@ private:
             b->setVideoModeSpeed( value );
         }
 
-        // wind up position timer to once per playout second
-        if ( value > 0 )
+        // wind up display timer to once per playout frame, the position
+        // is extrapolated locally so no device access happens on this tick
+        if ( (value > 0) && (GetVideoModeSpeed( (VideoMode)value ) > 0) )
         {
-            m_pos_timer->setInterval( GetVideoModeSpeed( (VideoMode)value ) / 1000 );
+            m_out_fps = GetVideoModeSpeed( (VideoMode)value );
+            m_pos_timer->setInterval( qMax( 1000000 / m_out_fps, POS_DISPLAY_MIN_INTERVAL ) );
         }
     }
 
+    bool isPlaying() const
+    {
+        return ( (m_play_bank >= 0) && (m_play_bank < MAX_BANKS) &&
+                 (m_banks[m_play_bank]->getState() == Bank::Playing) );
+    }
+
+    // restart position tracking from the next device sample
+    void resetPosition()
+    {
+        m_pos_clock.invalidate();
+        m_sync_clock.invalidate();
+    }
+
+    // a device sample is due if none was taken within the sync interval
+    bool isPositionSyncDue() const
+    {
+        return ( !m_sync_clock.isValid() || (m_sync_clock.elapsed() >= m_sync_interval) );
+    }
+
+    // playhead position extrapolated from the last device sample
+    int extrapolatePosition() const
+    {
+        if ( !m_pos_clock.isValid() || !isPlaying() )
+        {
+            return ( m_pos_anchor );
+        }
+
+        qint64 pos = m_pos_anchor + (m_pos_clock.elapsed() * m_out_fps) / 1000000;
+        return ( static_cast<int>(qMin( pos, static_cast<qint64>(m_banks[m_play_bank]->endFrame()) )) );
+    }
+
+    void showPosition( int pos )
+    {
+        QString s;
+        s.sprintf("%4d", pos );
+        m_ui->letPosition->setText( s );
+    }
+
     void setMaxFrames( int value )
     {
         foreach( Bank * b, m_banks )
@@ -569,9 +618,16 @@ private:
     // combobox bank configuration mode
     int                   m_mode;               /**< current bank configuration mode */
 
+    // play-back position tracking
+    int                   m_out_fps;            /**< playout speed (in fps * 1000) */
+    int                   m_pos_anchor;         /**< last device position used for extrapolation */
+    int                   m_sync_interval;      /**< device position poll interval (in ms) */
+    QElapsedTimer         m_pos_clock;          /**< time since m_pos_anchor was taken */
+    QElapsedTimer         m_sync_clock;         /**< time since last device position poll */
+
     QVector<Bank *>       m_banks;              /**< bank array */
     QSignalMapper *       m_mapper;             /**< signal mapper for bank-buttons */
-    QTimer *              m_pos_timer;          /**< get-position timer */
+    QTimer *              m_pos_timer;          /**< position display timer */
 };
 
 /******************************************************************************
@@ -705,6 +761,7 @@ void PlayBackBox::onPlayChange( int id )
 
     // stop position timer
     d_data->m_pos_timer->stop();
+    d_data->resetPosition();
 
     // handle old playback bank
     if ( (d_data->m_play_bank >= 0) && (d_data->m_play_bank < MAX_BANKS) && // range
@@ -770,6 +827,8 @@ void PlayBackBox::onPausedChange( bool flag )
     {
         if ( d_data->m_banks[d_data->m_play_bank]->getState() != Bank::Live )
         {
+            d_data->resetPosition();
+
             if ( flag )
             {
                 d_data->m_pos_timer->stop();
@@ -818,9 +877,27 @@ void PlayBackBox::onBankDefaultChange( int index )
  *****************************************************************************/
 void PlayBackBox::onPositionChange( int pos )
 {
-    QString s;
-    s.sprintf("%4d", pos );
-    d_data->m_ui->letPosition->setText( s );
+    // while playing keep the extrapolated playhead unless it drifted away
+    if ( d_data->isPlaying() && d_data->m_pos_clock.isValid() &&
+         (qAbs( pos - d_data->extrapolatePosition() ) <= POS_DRIFT_TOLERANCE) )
+    {
+        return;
+    }
+
+    d_data->m_pos_anchor = pos;
+    d_data->m_pos_clock.start();
+    d_data->showPosition( pos );
+}
+
+/******************************************************************************
+ * PlayBackBox::onPositionSyncIntervalChange
+ *****************************************************************************/
+void PlayBackBox::onPositionSyncIntervalChange( int ms )
+{
+    if ( ms > 0 )
+    {
+        d_data->m_sync_interval = ms;
+    }
 }
 
 /******************************************************************************
@@ -1092,10 +1169,16 @@ void PlayBackBox::calcRotationDirection( int value )
  *****************************************************************************/
 void PlayBackBox::onPosTimeOut()
 {
-    if ( (d_data->m_play_bank >= 0) && (d_data->m_play_bank<MAX_BANKS)       &&
-         (d_data->m_banks[d_data->m_play_bank]->getState() == Bank::Playing) )
+    if ( d_data->isPlaying() )
     {
-        emit PositionUpdate();
+        // poll the device only once per sync interval
+        if ( d_data->isPositionSyncDue() )
+        {
+            d_data->m_sync_clock.start();
+            emit PositionUpdate();
+        }
+
+        d_data->showPosition( d_data->extrapolatePosition() );
     }
 }
 
@@ -74,6 +74,7 @@ public slots:
     void onRecordChange( int id );
     void onPausedChange( bool flag );
     void onPositionChange( int pos );
+    void onPositionSyncIntervalChange( int ms );
 
 protected:
     void enterEvent(QEvent * ) Q_DECL_OVERRIDE;
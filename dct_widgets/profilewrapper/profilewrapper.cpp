@@ -0,0 +1,717 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    profilewrapper.cpp
+ *
+ * @brief   Binary device profiles as QSettings format
+ *
+ * @note    The payload of a section is a sequence of typed entries, each
+ *          4-byte aligned:
+ *
+ *              uint16  key_len     length of the key (relative to the group)
+ *              uint8   type        entry_type_t
+ *              uint8   reserved    0
+ *              uint32  count       number of elements (bytes for strings)
+ *              key, data
+ *
+ *****************************************************************************/
+#include "profilewrapper.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QStringList>
+#include <QVector>
+#include <QtEndian>
+#include <QtDebug>
+
+#include <profile/profile.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define ENTRY_HEADER_SIZE       ( 8 )
+#define ALIGN4( x )             ( ((x) + 3) & ~3 )
+
+enum entry_type_t
+{
+    ENTRY_TYPE_INT          = 0,    // int32
+    ENTRY_TYPE_INT_LIST     = 1,    // int32 array restored as QList<int>
+    ENTRY_TYPE_INT_VECTOR   = 2,    // int32 array restored as QVector<int>
+    ENTRY_TYPE_BOOL         = 3,    // int32, 0 or 1
+    ENTRY_TYPE_DOUBLE       = 4,    // IEEE 754 double
+    ENTRY_TYPE_STRING       = 5,    // utf8
+    ENTRY_TYPE_STRING_LIST  = 6,    // count strings, each uint32 length and utf8
+    ENTRY_TYPE_BYTES        = 7,    // raw bytes
+    ENTRY_TYPE_VARIANT      = 8,    // anything else, QDataStream of the QVariant
+};
+
+/******************************************************************************
+ * subsystem of a settings group
+ *****************************************************************************/
+static uint16_t subsystemOf( const QString & group )
+{
+    static const struct
+    {
+        const char *    prefix;
+        uint16_t        subsystem;
+    } map[] =
+    {
+        { "MAIN"                       , PROFILE_SUBSYSTEM_DEVICE   },
+        { "WB"                         , PROFILE_SUBSYSTEM_ISP      },
+        { "BL"                         , PROFILE_SUBSYSTEM_ISP      },
+        { "FLT"                        , PROFILE_SUBSYSTEM_ISP      },
+        { "FPNC"                       , PROFILE_SUBSYSTEM_ISP      },
+        { "INOUT"                      , PROFILE_SUBSYSTEM_ISP      },
+        { "OUT"                        , PROFILE_SUBSYSTEM_ISP      },
+        { "GAMMA"                      , PROFILE_SUBSYSTEM_ISP      },
+        { "ROI"                        , PROFILE_SUBSYSTEM_ISP      },
+        { "LUT"                        , PROFILE_SUBSYSTEM_LUT      },
+        { "MCC"                        , PROFILE_SUBSYSTEM_MCC      },
+        { "KNEE"                       , PROFILE_SUBSYSTEM_KNEE     },
+        { "DPCC"                       , PROFILE_SUBSYSTEM_DPCC     },
+        { "LENSDRIVER"                 , PROFILE_SUBSYSTEM_LENS     },
+        { PROFILE_COMMANDS_SECTION_NAME, PROFILE_SUBSYSTEM_COMMANDS },
+    };
+
+    for ( unsigned i = 0u; i < sizeof(map)/sizeof(map[0]); i++ )
+    {
+        // chain specific groups carry the chain index (LUT0, OUT1, ...)
+        if ( group.startsWith( QLatin1String( map[i].prefix ) ) )
+        {
+            return ( map[i].subsystem );
+        }
+    }
+
+    return ( PROFILE_SUBSYSTEM_GENERIC );
+}
+
+/******************************************************************************
+ * little endian helpers
+ *****************************************************************************/
+static void appendU32( QByteArray & out, quint32 value )
+{
+    uchar b[4];
+    qToLittleEndian<quint32>( value, b );
+    out.append( reinterpret_cast<const char *>(b), 4 );
+}
+
+static quint32 getU32( const uchar * p )
+{
+    return ( qFromLittleEndian<quint32>( p ) );
+}
+
+/******************************************************************************
+ * appendEntry - encode one value into a section payload
+ *****************************************************************************/
+static void appendEntry( QByteArray & out, const QString & key, const QVariant & value )
+{
+    QByteArray k = key.toUtf8();
+    QByteArray data;
+    quint32 count = 1u;
+    quint8 type;
+
+    const int userType = value.userType();
+    if ( userType == qMetaTypeId<QList<int>>() || userType == qMetaTypeId<QVector<int>>() )
+    {
+        QVector<int> v = ( userType == qMetaTypeId<QList<int>>() )
+                       ? value.value<QList<int>>().toVector()
+                       : value.value<QVector<int>>();
+        type  = ( userType == qMetaTypeId<QList<int>>() ) ? ENTRY_TYPE_INT_LIST : ENTRY_TYPE_INT_VECTOR;
+        count = static_cast<quint32>(v.size());
+        data.reserve( v.size() * 4 );
+        for ( int i = 0; i < v.size(); i++ )
+        {
+            appendU32( data, static_cast<quint32>(v[i]) );
+        }
+    }
+    else if ( userType == QMetaType::Int || userType == QMetaType::UInt )
+    {
+        type = ENTRY_TYPE_INT;
+        appendU32( data, static_cast<quint32>(value.toInt()) );
+    }
+    else if ( userType == QMetaType::Bool )
+    {
+        type = ENTRY_TYPE_BOOL;
+        appendU32( data, value.toBool() ? 1u : 0u );
+    }
+    else if ( userType == QMetaType::Double )
+    {
+        type = ENTRY_TYPE_DOUBLE;
+        quint64 bits;
+        double d = value.toDouble();
+        memcpy( &bits, &d, sizeof(bits) );
+        appendU32( data, static_cast<quint32>(bits) );
+        appendU32( data, static_cast<quint32>(bits >> 32) );
+    }
+    else if ( userType == QMetaType::QString )
+    {
+        // INI files hand back every number as string, keep them numeric
+        bool ok;
+        int i = value.toString().toInt( &ok );
+        if ( ok && QString::number( i ) == value.toString() )
+        {
+            type = ENTRY_TYPE_INT;
+            appendU32( data, static_cast<quint32>(i) );
+        }
+        else
+        {
+            type  = ENTRY_TYPE_STRING;
+            data  = value.toString().toUtf8();
+            count = static_cast<quint32>(data.size());
+        }
+    }
+    else if ( userType == QMetaType::QStringList )
+    {
+        const QStringList list = value.toStringList();
+        type  = ENTRY_TYPE_STRING_LIST;
+        count = static_cast<quint32>(list.size());
+        for ( int i = 0; i < list.size(); i++ )
+        {
+            QByteArray s = list[i].toUtf8();
+            appendU32( data, static_cast<quint32>(s.size()) );
+            data.append( s );
+        }
+    }
+    else if ( userType == QMetaType::QByteArray )
+    {
+        type  = ENTRY_TYPE_BYTES;
+        data  = value.toByteArray();
+        count = static_cast<quint32>(data.size());
+    }
+    else
+    {
+        type = ENTRY_TYPE_VARIANT;
+        QDataStream stream( &data, QIODevice::WriteOnly );
+        stream << value;
+        count = static_cast<quint32>(data.size());
+    }
+
+    uchar header[ENTRY_HEADER_SIZE];
+    qToLittleEndian<quint16>( static_cast<quint16>(k.size()), header );
+    header[2] = type;
+    header[3] = 0u;
+    qToLittleEndian<quint32>( count, header + 4 );
+
+    out.append( reinterpret_cast<const char *>(header), ENTRY_HEADER_SIZE );
+    out.append( k );
+    out.append( data );
+    out.append( QByteArray( ALIGN4( out.size() ) - out.size(), '\0' ) );
+}
+
+/******************************************************************************
+ * readEntries - decode the entries of a section payload, false if truncated
+ *****************************************************************************/
+static bool readEntries( const QString & group, const uchar * p, quint32 size, QSettings::SettingsMap & map )
+{
+    const QString prefix = group.isEmpty() ? QString() : group + '/';
+    quint32 offset = 0u;
+
+    while ( offset < size )
+    {
+        if ( size - offset < ENTRY_HEADER_SIZE )
+        {
+            return ( false );
+        }
+
+        const uchar * e      = p + offset;
+        const quint32 keyLen = qFromLittleEndian<quint16>( e );
+        const quint8  type   = e[2];
+        const quint32 count  = getU32( e + 4 );
+        const quint32 avail  = size - offset - ENTRY_HEADER_SIZE;
+
+        if ( keyLen > avail )
+        {
+            return ( false );
+        }
+
+        const QString key = prefix + QString::fromUtf8( reinterpret_cast<const char *>(e + ENTRY_HEADER_SIZE),
+                                                        static_cast<int>(keyLen) );
+        const uchar * d   = e + ENTRY_HEADER_SIZE + keyLen;
+        const quint32 len = avail - keyLen;
+        quint32 used;
+        QVariant value;
+
+        switch ( type )
+        {
+            case ENTRY_TYPE_INT:
+            case ENTRY_TYPE_BOOL:
+                if ( len < 4u ) return ( false );
+                used  = 4u;
+                value = ( type == ENTRY_TYPE_INT ) ? QVariant( static_cast<int>(getU32( d )) )
+                                                   : QVariant( getU32( d ) != 0u );
+                break;
+
+            case ENTRY_TYPE_INT_LIST:
+            case ENTRY_TYPE_INT_VECTOR:
+            {
+                if ( count > len / 4u ) return ( false );
+                used = count * 4u;
+                QVector<int> v( static_cast<int>(count) );
+                for ( quint32 i = 0u; i < count; i++ )
+                {
+                    v[static_cast<int>(i)] = static_cast<int>(getU32( d + 4u * i ));
+                }
+                value = ( type == ENTRY_TYPE_INT_LIST ) ? QVariant::fromValue( v.toList() )
+                                                        : QVariant::fromValue( v );
+                break;
+            }
+
+            case ENTRY_TYPE_DOUBLE:
+            {
+                if ( len < 8u ) return ( false );
+                used = 8u;
+                quint64 bits = static_cast<quint64>(getU32( d )) | (static_cast<quint64>(getU32( d + 4 )) << 32);
+                double v;
+                memcpy( &v, &bits, sizeof(v) );
+                value = v;
+                break;
+            }
+
+            case ENTRY_TYPE_STRING:
+            case ENTRY_TYPE_BYTES:
+            case ENTRY_TYPE_VARIANT:
+            {
+                if ( count > len ) return ( false );
+                used = count;
+                // QByteArray::fromRawData does not copy out of the mapped file
+                QByteArray raw = QByteArray::fromRawData( reinterpret_cast<const char *>(d), static_cast<int>(count) );
+                if ( type == ENTRY_TYPE_STRING )
+                {
+                    value = QString::fromUtf8( raw );
+                }
+                else if ( type == ENTRY_TYPE_BYTES )
+                {
+                    value = QByteArray( raw.constData(), raw.size() );
+                }
+                else
+                {
+                    QDataStream stream( raw );
+                    stream >> value;
+                    if ( stream.status() != QDataStream::Ok ) return ( false );
+                }
+                break;
+            }
+
+            case ENTRY_TYPE_STRING_LIST:
+            {
+                QStringList list;
+                used = 0u;
+                for ( quint32 i = 0u; i < count; i++ )
+                {
+                    if ( len - used < 4u ) return ( false );
+                    quint32 n = getU32( d + used );
+                    used += 4u;
+                    if ( n > len - used ) return ( false );
+                    list.append( QString::fromUtf8( reinterpret_cast<const char *>(d + used), static_cast<int>(n) ) );
+                    used += n;
+                }
+                value = list;
+                break;
+            }
+
+            default:
+                // unknown type of a newer writer, skip the section
+                return ( false );
+        }
+
+        map.insert( key, value );
+        offset = ALIGN4( offset + ENTRY_HEADER_SIZE + keyLen + used );
+    }
+
+    return ( true );
+}
+
+/******************************************************************************
+ * readProfile - QSettings read function
+ *****************************************************************************/
+static bool readProfile( QIODevice & device, QSettings::SettingsMap & map )
+{
+    QByteArray content;
+    const uchar * buf = nullptr;
+    qint64 len = 0;
+    bool mapped = false;
+
+    // map the file instead of reading it, payloads are decoded in place
+    QFile * file = qobject_cast<QFile *>( &device );
+    if ( file && file->size() > 0 )
+    {
+        len = file->size();
+        buf = file->map( 0, len );
+        mapped = ( buf != nullptr );
+    }
+
+    if ( !buf )
+    {
+        content = device.readAll();
+        buf = reinterpret_cast<const uchar *>(content.constData());
+        len = content.size();
+    }
+
+    // an empty file is a new profile
+    if ( !len )
+    {
+        return ( true );
+    }
+
+    bool ok = true;
+    uint16_t count = 0u;
+    int res = profile_read_header( buf, static_cast<size_t>(len), &count );
+    if ( res )
+    {
+        qWarning() << "profile:" << ( file ? file->fileName() : QString() ) << "is no valid profile";
+        ok = false;
+        count = 0u;
+    }
+
+    size_t offset = PROFILE_HEADER_SIZE;
+    for ( uint16_t i = 0u; i < count; i++ )
+    {
+        profile_section_t section;
+        res = profile_read_section( buf, static_cast<size_t>(len), &offset, &section );
+        if ( res == -EINVAL )
+        {
+            ok = false;
+            break;
+        }
+
+        const QString group = QString::fromUtf8( section.name, section.name_len );
+        if ( res )
+        {
+            // keep the intact sections, report the file as damaged
+            qWarning() << "profile: checksum error in section" << group;
+            ok = false;
+            continue;
+        }
+
+        if ( !readEntries( group, section.data, section.size, map ) )
+        {
+            qWarning() << "profile: invalid entries in section" << group;
+            ok = false;
+        }
+    }
+
+    if ( mapped )
+    {
+        file->unmap( const_cast<uchar *>(buf) );
+    }
+
+    return ( ok );
+}
+
+/******************************************************************************
+ * writeProfile - QSettings write function
+ *****************************************************************************/
+static bool writeProfile( QIODevice & device, const QSettings::SettingsMap & map )
+{
+    // one section per top level group, the map is sorted so groups are contiguous
+    QMap<QString, QByteArray> payloads;
+    for ( QSettings::SettingsMap::const_iterator it = map.constBegin(); it != map.constEnd(); ++it )
+    {
+        const int sep = it.key().indexOf( '/' );
+        const QString group = ( sep < 0 ) ? QString() : it.key().left( sep );
+        appendEntry( payloads[group], it.key().mid( sep + 1 ), it.value() );
+    }
+
+    if ( payloads.size() > 0xffff )
+    {
+        return ( false );
+    }
+
+    QList<QByteArray> names;
+    size_t size = PROFILE_HEADER_SIZE;
+    for ( QMap<QString, QByteArray>::const_iterator it = payloads.constBegin(); it != payloads.constEnd(); ++it )
+    {
+        names.append( it.key().toUtf8() );
+        size += profile_section_size( static_cast<uint16_t>(names.last().size()),
+                                      static_cast<uint32_t>(it.value().size()) );
+    }
+
+    QByteArray out( static_cast<int>(size), '\0' );
+    uint8_t * buf = reinterpret_cast<uint8_t *>(out.data());
+    size_t offset = PROFILE_HEADER_SIZE;
+    int i = 0;
+
+    for ( QMap<QString, QByteArray>::const_iterator it = payloads.constBegin(); it != payloads.constEnd(); ++it, ++i )
+    {
+        profile_section_t section;
+        section.subsystem = subsystemOf( it.key() );
+        section.name_len  = static_cast<uint16_t>(names[i].size());
+        section.size      = static_cast<uint32_t>(it.value().size());
+        section.name      = names[i].constData();
+        section.data      = reinterpret_cast<const uint8_t *>(it.value().constData());
+
+        int res = profile_write_section( &buf[offset], &section );
+        if ( res < 0 )
+        {
+            return ( false );
+        }
+        offset += static_cast<size_t>(res);
+    }
+
+    if ( profile_write_header( buf, static_cast<uint16_t>(payloads.size()), static_cast<uint32_t>(size) ) )
+    {
+        return ( false );
+    }
+
+    return ( device.write( out ) == out.size() );
+}
+
+/******************************************************************************
+ * profileFormat
+ *****************************************************************************/
+QSettings::Format profileFormat()
+{
+    static const QSettings::Format format =
+        QSettings::registerFormat( PROFILE_FILE_SUFFIX, readProfile, writeProfile );
+
+    return ( format );
+}
+
+/******************************************************************************
+ * profileFormatOf
+ *****************************************************************************/
+QSettings::Format profileFormatOf( const QString & path )
+{
+    if ( QFileInfo( path ).suffix().compare( PROFILE_FILE_SUFFIX, Qt::CaseInsensitive ) == 0 )
+    {
+        return ( profileFormat() );
+    }
+
+    return ( QSettings::IniFormat );
+}
+
+/******************************************************************************
+ * isCommandDump
+ *****************************************************************************/
+static bool isCommandDump( const QString & path )
+{
+    return ( QFileInfo( path ).suffix().compare( COMMAND_DUMP_FILE_SUFFIX, Qt::CaseInsensitive ) == 0 );
+}
+
+/******************************************************************************
+ * addCommandDumpLine - sort one line of a command dump into header or commands
+ *****************************************************************************/
+static void addCommandDumpLine( const QString & line, QStringList & header, QStringList & commands )
+{
+    const QString l = line.trimmed();
+
+    if ( l.startsWith( '=' ) )
+    {
+        // same split as the command dump loader: everything up to the
+        // last separator line is header
+        header.append( commands );
+        commands.clear();
+    }
+    else if ( !l.isEmpty() )
+    {
+        commands.append( l );
+    }
+}
+
+/******************************************************************************
+ * splitCommandDump - header lines and commands of a command dump
+ *****************************************************************************/
+static void splitCommandDump( const QByteArray & text, QStringList & header, QStringList & commands )
+{
+    foreach ( const QString & line, QString::fromUtf8( text ).split( '\n' ) )
+    {
+        addCommandDumpLine( line, header, commands );
+    }
+}
+
+/******************************************************************************
+ * commandDumpToSettings
+ *****************************************************************************/
+void commandDumpToSettings( const QByteArray & text, QSettings & s )
+{
+    CommandDumpWriter dump( s );
+    dump.open( QIODevice::WriteOnly );
+    dump.write( text );
+    dump.commit();
+}
+
+/******************************************************************************
+ * CommandDumpWriter::CommandDumpWriter
+ *****************************************************************************/
+CommandDumpWriter::CommandDumpWriter( QSettings & s )
+    : QIODevice()
+    , m_settings( s )
+{
+}
+
+/******************************************************************************
+ * CommandDumpWriter::commit
+ *****************************************************************************/
+bool CommandDumpWriter::commit()
+{
+    if ( !m_line.isEmpty() )
+    {
+        addCommandDumpLine( QString::fromUtf8( m_line ), m_header, m_commands );
+        m_line.clear();
+    }
+
+    close();
+
+    m_settings.beginGroup( PROFILE_COMMANDS_SECTION_NAME );
+    m_settings.setValue( PROFILE_COMMANDS_HEADER, m_header );
+    m_settings.setValue( PROFILE_COMMANDS_COMMANDS, m_commands );
+    m_settings.endGroup();
+
+    return ( !m_commands.isEmpty() );
+}
+
+/******************************************************************************
+ * CommandDumpWriter::readData
+ *****************************************************************************/
+qint64 CommandDumpWriter::readData( char *, qint64 )
+{
+    return ( -1 );
+}
+
+/******************************************************************************
+ * CommandDumpWriter::writeData
+ *****************************************************************************/
+qint64 CommandDumpWriter::writeData( const char * data, qint64 len )
+{
+    // only the incomplete last line is buffered
+    m_line.append( data, int(len) );
+
+    int start = 0;
+    int end;
+    while ( (end = m_line.indexOf( '\n', start )) >= 0 )
+    {
+        addCommandDumpLine( QString::fromUtf8( m_line.constData() + start, end - start ),
+                            m_header, m_commands );
+        start = end + 1;
+    }
+    m_line.remove( 0, start );
+
+    return ( len );
+}
+
+/******************************************************************************
+ * settingsToCommandDump
+ *****************************************************************************/
+QByteArray settingsToCommandDump( QSettings & s )
+{
+    s.beginGroup( PROFILE_COMMANDS_SECTION_NAME );
+    const QStringList header   = s.value( PROFILE_COMMANDS_HEADER ).toStringList();
+    const QStringList commands = s.value( PROFILE_COMMANDS_COMMANDS ).toStringList();
+    s.endGroup();
+
+    if ( commands.isEmpty() )
+    {
+        return ( QByteArray() );
+    }
+
+    QByteArray text;
+    foreach ( const QString & line, header )
+    {
+        text.append( line.toUtf8() ).append( "\n\n" );
+    }
+    text.append( "===================================\n\n" );
+    foreach ( const QString & command, commands )
+    {
+        text.append( command.toUtf8() ).append( '\n' );
+    }
+
+    return ( text );
+}
+
+/******************************************************************************
+ * loadCommands
+ *****************************************************************************/
+bool loadCommands( const QString & path, QStringList & commands )
+{
+    if ( isCommandDump( path ) )
+    {
+        QFile file( path );
+        if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+        {
+            return ( false );
+        }
+
+        QStringList header;
+        splitCommandDump( file.readAll(), header, commands );
+        return ( !commands.isEmpty() );
+    }
+
+    QSettings s( path, profileFormatOf( path ) );
+    commands = s.value( QString(PROFILE_COMMANDS_SECTION_NAME) + '/' + PROFILE_COMMANDS_COMMANDS ).toStringList();
+
+    return ( (s.status() == QSettings::NoError) && !commands.isEmpty() );
+}
+
+/******************************************************************************
+ * convertProfile
+ *****************************************************************************/
+bool convertProfile( const QString & from, const QString & to )
+{
+    if ( isCommandDump( to ) )
+    {
+        QSettings src( from, profileFormatOf( from ) );
+        const QByteArray text = settingsToCommandDump( src );
+        if ( (src.status() != QSettings::NoError) || text.isEmpty() )
+        {
+            return ( false );
+        }
+
+        QFile file( to );
+        if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+        {
+            return ( false );
+        }
+
+        return ( file.write( text ) == text.size() );
+    }
+
+    QSettings dst( to, profileFormatOf( to ) );
+    dst.clear();
+
+    if ( isCommandDump( from ) )
+    {
+        QFile file( from );
+        if ( !file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+        {
+            return ( false );
+        }
+
+        commandDumpToSettings( file.readAll(), dst );
+    }
+    else
+    {
+        QSettings src( from, profileFormatOf( from ) );
+        if ( src.status() != QSettings::NoError )
+        {
+            return ( false );
+        }
+
+        foreach ( const QString & key, src.allKeys() )
+        {
+            dst.setValue( key, src.value( key ) );
+        }
+    }
+
+    dst.sync();
+
+    return ( dst.status() == QSettings::NoError );
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    profilewrapper.h
+ *
+ * @brief   Binary device profiles (*.dctp) as QSettings format and
+ *          conversion from and to INI files and command dumps (*.kyscp)
+ *
+ * @note    Every top level settings group is stored as one section of a
+ *          profile container (see profile/profile.h), values keep their
+ *          type: integer lists such as LUT samples are plain int32 arrays
+ *          instead of serialized variants. A command dump is stored in the
+ *          group PROFILE_COMMANDS_SECTION_NAME, with the dump header lines
+ *          and the device commands as string lists.
+ *
+ *****************************************************************************/
+#ifndef __PROFILE_WRAPPER_H__
+#define __PROFILE_WRAPPER_H__
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QSettings>
+#include <QString>
+#include <QStringList>
+
+#define PROFILE_FILE_SUFFIX                 ( "dctp" )
+#define COMMAND_DUMP_FILE_SUFFIX            ( "kyscp" )
+
+#define PROFILE_COMMANDS_SECTION_NAME       ( "KYSCP" )
+#define PROFILE_COMMANDS_HEADER             ( "header" )
+#define PROFILE_COMMANDS_COMMANDS           ( "commands" )
+
+// QSettings format of binary profiles, registered on first use
+QSettings::Format profileFormat();
+
+// settings format of a file by its suffix, INI unless it is a binary profile
+QSettings::Format profileFormatOf( const QString & path );
+
+// command dump <-> command group of a settings object
+void commandDumpToSettings( const QByteArray & text, QSettings & s );
+QByteArray settingsToCommandDump( QSettings & s );
+
+// write-only device that splits a streamed command dump into header and
+// commands, commit() stores them into the command group of the settings
+class CommandDumpWriter : public QIODevice
+{
+public:
+    explicit CommandDumpWriter( QSettings & s );
+
+    // store the dump into the settings, false if nothing was written
+    bool commit();
+
+protected:
+    qint64 readData( char * data, qint64 maxlen ) Q_DECL_OVERRIDE;
+    qint64 writeData( const char * data, qint64 len ) Q_DECL_OVERRIDE;
+
+private:
+    QSettings &  m_settings;
+    QByteArray   m_line;        // incomplete last line
+    QStringList  m_header;
+    QStringList  m_commands;
+};
+
+// device commands of a binary profile or command dump, false on error
+bool loadCommands( const QString & path, QStringList & commands );
+
+// convert between INI, command dump and binary profile (by suffix), false on error
+bool convertProfile( const QString & from, const QString & to );
+
+#endif // __PROFILE_WRAPPER_H__
@@ -50,6 +50,9 @@ SettingsDialog::SettingsDialog(QWidget *parent)
 //    m_ui->cbxRS232Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_38400) , CTRL_CHANNEL_BAUDRATE_38400 );
     m_ui->cbxRS232Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_57600) , CTRL_CHANNEL_BAUDRATE_57600 );
     m_ui->cbxRS232Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_115200), CTRL_CHANNEL_BAUDRATE_115200 );
+    m_ui->cbxRS232Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_230400), CTRL_CHANNEL_BAUDRATE_230400 );
+    m_ui->cbxRS232Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_460800), CTRL_CHANNEL_BAUDRATE_460800 );
+    m_ui->cbxRS232Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_921600), CTRL_CHANNEL_BAUDRATE_921600 );
     m_ui->cbxRS232Baudrate->setCurrentIndex( m_ui->cbxRS232Baudrate->findData( CTRL_CHANNEL_BAUDRATE_DEFAULT ) );
 
 //    m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_9600)  , CTRL_CHANNEL_BAUDRATE_9600 );
@@ -57,6 +60,9 @@ SettingsDialog::SettingsDialog(QWidget *parent)
 //    m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_38400) , CTRL_CHANNEL_BAUDRATE_38400 );
     m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_57600) , CTRL_CHANNEL_BAUDRATE_57600 );
     m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_115200), CTRL_CHANNEL_BAUDRATE_115200 );
+    m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_230400), CTRL_CHANNEL_BAUDRATE_230400 );
+    m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_460800), CTRL_CHANNEL_BAUDRATE_460800 );
+    m_ui->cbxRS485Baudrate->addItem( QString::number(CTRL_CHANNEL_BAUDRATE_921600), CTRL_CHANNEL_BAUDRATE_921600 );
     m_ui->cbxRS485Baudrate->setCurrentIndex( m_ui->cbxRS485Baudrate->findData( CTRL_CHANNEL_BAUDRATE_DEFAULT ) );
 
     // connect system settings
@@ -178,6 +184,11 @@ void SettingsDialog::setRS232SettingsVisible( const bool value )
  *****************************************************************************/
 void SettingsDialog::onRS232BaudrateChange( uint32_t baudrate )
 {
+    // a custom baudrate of the device is added to the list
+    if ( (m_ui->cbxRS232Baudrate->findData( baudrate ) < 0) && CTRL_CHANNEL_BAUDRATE_VALID( baudrate ) )
+    {
+        m_ui->cbxRS232Baudrate->addItem( QString::number(baudrate), baudrate );
+    }
     m_ui->cbxRS232Baudrate->setCurrentIndex( m_ui->cbxRS232Baudrate->findData( baudrate ) );
 }
 
@@ -186,6 +197,11 @@ void SettingsDialog::onRS232BaudrateChange( uint32_t baudrate )
  *****************************************************************************/
 void SettingsDialog::onRS485BaudrateChange( uint32_t baudrate )
 {
+    // a custom baudrate of the device is added to the list
+    if ( (m_ui->cbxRS485Baudrate->findData( baudrate ) < 0) && CTRL_CHANNEL_BAUDRATE_VALID( baudrate ) )
+    {
+        m_ui->cbxRS485Baudrate->addItem( QString::number(baudrate), baudrate );
+    }
     m_ui->cbxRS485Baudrate->setCurrentIndex( m_ui->cbxRS485Baudrate->findData( baudrate ) );
 }
 
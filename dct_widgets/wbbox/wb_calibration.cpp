@@ -0,0 +1,496 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    wb_calibration.cpp
+ *
+ * @brief   Implementation of the white-balance calibration
+ *
+ *****************************************************************************/
+#include <cstring>
+
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <simple_math/ct_table.h>
+
+#include "wbbox.h"
+#include "wb_calibration.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define WB_CALIBRATION_CT_MIN           ( CT_TABLE_CT_MIN )
+#define WB_CALIBRATION_CT_MAX           ( 12000.0 )
+#define WB_CALIBRATION_CT_STEP          ( 10.0 )
+
+#define WB_CALIBRATION_POLL_INTERVAL    ( 100 )     // ms between two XYZ requests
+#define WB_CALIBRATION_POLL_DUTY        ( 4 )       // idle time per request time, at least
+#define WB_CALIBRATION_MIN_SAMPLES      ( 10 )      // samples of a capture
+
+#define WB_CALIBRATION_LOCUS_STEP       ( 10 )      // table entries per plotted point
+#define WB_CALIBRATION_CAMERA_STEP      ( 100 )     // K per plotted point
+
+/******************************************************************************
+ * WbCalibration::PrivateData
+ *****************************************************************************/
+class WbCalibration::PrivateData
+{
+public:
+    PrivateData()
+        : m_table( new ct_table_t )
+        , m_has_matrix( false )
+        , m_streaming( false )
+        , m_requesting( false )
+        , m_capturing( false )
+        , m_reference( 0 )
+        , m_count( 0 )
+        , m_solved( false )
+    {
+        // the only place the locus is computed
+        sm_ct_table_calc( WB_CALIBRATION_CT_MIN, WB_CALIBRATION_CT_MAX,
+                          WB_CALIBRATION_CT_STEP, m_table );
+
+        memset( m_matrix, 0, sizeof(m_matrix) );
+        memset( m_sum, 0, sizeof(m_sum) );
+        memset( &m_fit, 0, sizeof(m_fit) );
+
+        m_poll.setInterval( WB_CALIBRATION_POLL_INTERVAL );
+        m_poll.setSingleShot( true );
+    }
+
+    ~PrivateData()
+    {
+        delete m_table;
+    }
+
+    ct_table_t *        m_table;            /**< daylight locus and camera gains */
+    double              m_matrix[9];        /**< camera RGB to XYZ */
+    bool                m_has_matrix;
+
+    QTimer              m_poll;             /**< XYZ statistic request timer */
+    bool                m_streaming;
+    bool                m_requesting;       /**< a request is outstanding */
+
+    bool                m_capturing;
+    QString             m_name;             /**< illuminant of the running capture */
+    int                 m_reference;
+    double              m_sum[3];           /**< sum of the captured XYZ samples */
+    int                 m_count;
+
+    QVector<Capture>    m_captures;
+    QVector<Preset>     m_presets;
+
+    ct_fit_t            m_fit;              /**< solved gain curves */
+    bool                m_solved;
+};
+
+/******************************************************************************
+ * WbCalibration::WbCalibration
+ *****************************************************************************/
+WbCalibration::WbCalibration( QObject * parent )
+    : QObject( parent )
+{
+    d_data = new PrivateData;
+
+    connect( &d_data->m_poll, SIGNAL(timeout()), this, SLOT(onPoll()) );
+}
+
+/******************************************************************************
+ * WbCalibration::~WbCalibration
+ *****************************************************************************/
+WbCalibration::~WbCalibration()
+{
+    delete d_data;
+}
+
+/******************************************************************************
+ * WbCalibration::locus
+ *****************************************************************************/
+QVector<QPointF> WbCalibration::locus() const
+{
+    QVector<QPointF> points;
+
+    for ( int i = 0; i < d_data->m_table->size; i += WB_CALIBRATION_LOCUS_STEP )
+    {
+        points.append( QPointF( d_data->m_table->entry[i].u, d_data->m_table->entry[i].v ) );
+    }
+
+    return ( points );
+}
+
+/******************************************************************************
+ * WbCalibration::cameraLocus
+ *****************************************************************************/
+QVector<QPointF> WbCalibration::cameraLocus() const
+{
+    QVector<QPointF> points;
+
+    if ( !d_data->m_solved || !d_data->m_has_matrix )
+    {
+        return ( points );
+    }
+
+    const double * m = d_data->m_matrix;
+
+    for ( int ct = (int)WB_CALIBRATION_CT_MIN; ct <= (int)WB_CALIBRATION_CT_MAX; ct += WB_CALIBRATION_CAMERA_STEP )
+    {
+        double red, blue;
+
+        if ( sm_ct_fit_eval( &d_data->m_fit, ct, &red, &blue ) || (red <= 0.0) || (blue <= 0.0) )
+        {
+            continue;
+        }
+
+        // camera RGB which the gains turn grey
+        double r = 1.0 / red;
+        double b = 1.0 / blue;
+
+        double X = m[0] * r + m[1] + m[2] * b;
+        double Y = m[3] * r + m[4] + m[5] * b;
+        double Z = m[6] * r + m[7] + m[8] * b;
+        double d = X + 15.0 * Y + 3.0 * Z;
+
+        if ( d > 0.0 )
+        {
+            points.append( QPointF( 4.0 * X / d, 6.0 * Y / d ) );
+        }
+    }
+
+    return ( points );
+}
+
+/******************************************************************************
+ * WbCalibration::setCameraMatrix
+ *****************************************************************************/
+void WbCalibration::setCameraMatrix( const QVector<float> & rgb2xyz )
+{
+    if ( rgb2xyz.size() != 9 )
+    {
+        return;
+    }
+
+    for ( int i = 0; i < 9; i++ )
+    {
+        d_data->m_matrix[i] = rgb2xyz[i];
+    }
+
+    d_data->m_has_matrix = !sm_ct_table_set_camera( d_data->m_table, d_data->m_matrix );
+}
+
+/******************************************************************************
+ * WbCalibration::hasCameraMatrix
+ *****************************************************************************/
+bool WbCalibration::hasCameraMatrix() const
+{
+    return ( d_data->m_has_matrix );
+}
+
+/******************************************************************************
+ * WbCalibration::setStreaming
+ *****************************************************************************/
+void WbCalibration::setStreaming( const bool enable )
+{
+    if ( enable && !d_data->m_streaming )
+    {
+        d_data->m_streaming = true;
+        emit ColorXYZRequested();
+        d_data->m_poll.start( WB_CALIBRATION_POLL_INTERVAL );
+    }
+    else if ( !enable )
+    {
+        d_data->m_streaming = false;
+        d_data->m_poll.stop();
+    }
+}
+
+/******************************************************************************
+ * WbCalibration::isStreaming
+ *****************************************************************************/
+bool WbCalibration::isStreaming() const
+{
+    return ( d_data->m_streaming );
+}
+
+/******************************************************************************
+ * WbCalibration::addSample
+ *****************************************************************************/
+void WbCalibration::addSample( const int x, const int y, const int z )
+{
+    double xyz[3] = { (double)x, (double)y, (double)z };
+    double d = xyz[0] + 15.0 * xyz[1] + 3.0 * xyz[2];
+    double ct;
+    double duv;
+
+    if ( (d <= 0.0) || sm_ct_table_find( d_data->m_table, xyz, &ct, &duv ) )
+    {
+        return;
+    }
+
+    if ( d_data->m_capturing )
+    {
+        d_data->m_sum[0] += xyz[0];
+        d_data->m_sum[1] += xyz[1];
+        d_data->m_sum[2] += xyz[2];
+        d_data->m_count++;
+
+        emit CaptureProgress( d_data->m_count );
+    }
+
+    emit SampleAdded( 4.0 * xyz[0] / d, 6.0 * xyz[1] / d, ct, duv );
+}
+
+/******************************************************************************
+ * WbCalibration::startCapture
+ *****************************************************************************/
+void WbCalibration::startCapture( const QString & name, const int reference )
+{
+    memset( d_data->m_sum, 0, sizeof(d_data->m_sum) );
+    d_data->m_count     = 0;
+    d_data->m_name      = name;
+    d_data->m_reference = reference;
+    d_data->m_capturing = true;
+
+    emit CaptureProgress( 0 );
+}
+
+/******************************************************************************
+ * WbCalibration::isCapturing
+ *****************************************************************************/
+bool WbCalibration::isCapturing() const
+{
+    return ( d_data->m_capturing );
+}
+
+/******************************************************************************
+ * WbCalibration::stopCapture
+ *****************************************************************************/
+bool WbCalibration::stopCapture()
+{
+    if ( !d_data->m_capturing )
+    {
+        return ( false );
+    }
+
+    d_data->m_capturing = false;
+
+    if ( (d_data->m_count < WB_CALIBRATION_MIN_SAMPLES) || !d_data->m_has_matrix )
+    {
+        return ( false );
+    }
+
+    double xyz[3];
+    for ( int i = 0; i < 3; i++ )
+    {
+        xyz[i] = d_data->m_sum[i] / d_data->m_count;
+    }
+
+    double d = xyz[0] + 15.0 * xyz[1] + 3.0 * xyz[2];
+
+    Capture capture;
+    capture.name      = d_data->m_name;
+    capture.reference = d_data->m_reference;
+    capture.samples   = d_data->m_count;
+    capture.u         = 4.0 * xyz[0] / d;
+    capture.v         = 6.0 * xyz[1] / d;
+
+    if ( sm_ct_table_find( d_data->m_table, xyz, &capture.ct, &capture.duv ) ||
+         sm_ct_gains( d_data->m_matrix, xyz, &capture.red, &capture.blue ) )
+    {
+        return ( false );
+    }
+
+    d_data->m_captures.append( capture );
+
+    emit CapturesChanged();
+
+    return ( true );
+}
+
+/******************************************************************************
+ * WbCalibration::captures
+ *****************************************************************************/
+const QVector<WbCalibration::Capture> & WbCalibration::captures() const
+{
+    return ( d_data->m_captures );
+}
+
+/******************************************************************************
+ * WbCalibration::removeCapture
+ *****************************************************************************/
+void WbCalibration::removeCapture( const int index )
+{
+    if ( (index >= 0) && (index < d_data->m_captures.size()) )
+    {
+        d_data->m_captures.remove( index );
+        emit CapturesChanged();
+    }
+}
+
+/******************************************************************************
+ * WbCalibration::clearCaptures
+ *****************************************************************************/
+void WbCalibration::clearCaptures()
+{
+    d_data->m_captures.clear();
+    emit CapturesChanged();
+}
+
+/******************************************************************************
+ * WbCalibration::setPreset
+ *****************************************************************************/
+void WbCalibration::setPreset( const int id, const QString & name, const int ct )
+{
+    if ( id == 0 )
+    {
+        d_data->m_presets.clear();
+    }
+
+    Preset preset;
+    preset.id   = id;
+    preset.name = name;
+    preset.ct   = ct;
+
+    if ( !gains( ct, preset.red, preset.blue ) )
+    {
+        preset.red  = -1;
+        preset.blue = -1;
+    }
+
+    d_data->m_presets.append( preset );
+
+    emit PresetsChanged();
+}
+
+/******************************************************************************
+ * WbCalibration::presets
+ *****************************************************************************/
+const QVector<WbCalibration::Preset> & WbCalibration::presets() const
+{
+    return ( d_data->m_presets );
+}
+
+/******************************************************************************
+ * WbCalibration::solve
+ *****************************************************************************/
+bool WbCalibration::solve()
+{
+    double ct[CT_FIT_MAX_POINTS];
+    double red[CT_FIT_MAX_POINTS];
+    double blue[CT_FIT_MAX_POINTS];
+    int no = 0;
+
+    if ( !d_data->m_captures.isEmpty() )
+    {
+        // all illuminants in one fit, a known nominal temperature is preferred
+        for ( int i = 0; (i < d_data->m_captures.size()) && (no < CT_FIT_MAX_POINTS); i++ )
+        {
+            const Capture & c = d_data->m_captures[i];
+
+            ct[no]   = (c.reference > 0) ? c.reference : c.ct;
+            red[no]  = c.red;
+            blue[no] = c.blue;
+            no++;
+        }
+    }
+    else if ( d_data->m_table->has_gains )
+    {
+        // camera model only
+        int step = qMax( 1, d_data->m_table->size / (CT_FIT_MAX_POINTS - 1) );
+        for ( int i = 0; (i < d_data->m_table->size) && (no < CT_FIT_MAX_POINTS); i += step )
+        {
+            const ct_table_entry_t & e = d_data->m_table->entry[i];
+
+            ct[no]   = e.ct;
+            red[no]  = e.red;
+            blue[no] = e.blue;
+            no++;
+        }
+    }
+
+    d_data->m_solved = (no > 0) && !sm_ct_fit_gains( no, ct, red, blue, &d_data->m_fit );
+    if ( !d_data->m_solved )
+    {
+        return ( false );
+    }
+
+    for ( int i = 0; i < d_data->m_presets.size(); i++ )
+    {
+        Preset & p = d_data->m_presets[i];
+        gains( p.ct, p.red, p.blue );
+    }
+
+    emit PresetsChanged();
+    emit Solved();
+
+    return ( true );
+}
+
+/******************************************************************************
+ * WbCalibration::isSolved
+ *****************************************************************************/
+bool WbCalibration::isSolved() const
+{
+    return ( d_data->m_solved );
+}
+
+/******************************************************************************
+ * WbCalibration::gains
+ *****************************************************************************/
+bool WbCalibration::gains( const int ct, int & red, int & blue ) const
+{
+    double r, b;
+
+    if ( !d_data->m_solved || sm_ct_fit_eval( &d_data->m_fit, ct, &r, &b ) )
+    {
+        return ( false );
+    }
+
+    red  = qBound( WB_RED_GAIN_MIN , qRound( r * WB_GAIN_DEFAULT ), WB_RED_GAIN_MAX );
+    blue = qBound( WB_BLUE_GAIN_MIN, qRound( b * WB_GAIN_DEFAULT ), WB_BLUE_GAIN_MAX );
+
+    return ( true );
+}
+
+/******************************************************************************
+ * WbCalibration::onPoll
+ *****************************************************************************/
+void WbCalibration::onPoll()
+{
+    /* The request blocks the GUI thread until the device answers, and an
+     * error message runs a nested event loop. Ticks during a request are
+     * skipped, the request re-arms the timer when it returns. */
+    if ( d_data->m_requesting )
+    {
+        return;
+    }
+
+    QElapsedTimer duration;
+    duration.start();
+
+    d_data->m_requesting = true;
+    emit StatXYZRequested();
+    d_data->m_requesting = false;
+
+    // the next request follows after an idle time of at least
+    // WB_CALIBRATION_POLL_DUTY times this request, so a slow link
+    // stretches the interval instead of blocking the user interface
+    if ( d_data->m_streaming )
+    {
+        int idle = static_cast<int>(duration.elapsed()) * WB_CALIBRATION_POLL_DUTY;
+        d_data->m_poll.start( qMax( idle, WB_CALIBRATION_POLL_INTERVAL ) );
+    }
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    wb_calibration.h
+ *
+ * @brief   Class definition of the white-balance calibration
+ *
+ * @note    A WbCalibration precomputes a dense color temperature table of
+ *          the daylight locus (2500 K..12000 K, 10 K steps) once. While
+ *          streaming it polls the XYZ statistic, the next request is sent
+ *          100 ms (or four request times, if longer) after the previous
+ *          one returned, so requests never queue up on the GUI thread.
+ *          Every sample is placed on the locus by a table search.
+ *
+ *          A capture averages the samples taken under one illuminant and
+ *          derives the gains which turn it grey with the camera color
+ *          matrix. solve() fits the red and blue gain curves through all
+ *          captures at once (least squares in mired, see sm_ct_fit_gains)
+ *          and evaluates them at the color temperature of every preset.
+ *          Without captures the curves are fitted to the camera model.
+ *
+ *****************************************************************************/
+#ifndef __WB_CALIBRATION_H__
+#define __WB_CALIBRATION_H__
+
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+class WbCalibration : public QObject
+{
+    Q_OBJECT
+
+public:
+    // measurement of one illuminant
+    struct Capture
+    {
+        QString     name;
+        int         reference;      // nominal color temperature, 0 if unknown
+        int         samples;        // number of averaged samples
+        double      u;              // CIE 1960 chromaticity of the mean sample
+        double      v;
+        double      ct;             // measured color temperature
+        double      duv;            // distance to the daylight locus
+        double      red;            // gains which turn the illuminant grey
+        double      blue;
+    };
+
+    // white-balance preset of the device
+    struct Preset
+    {
+        int         id;
+        QString     name;
+        int         ct;
+        int         red;            // solved gains (256 = 1.0), -1 if unsolved
+        int         blue;
+    };
+
+    explicit WbCalibration( QObject * parent = nullptr );
+    ~WbCalibration();
+
+    // daylight locus in CIE 1960 uv
+    QVector<QPointF> locus() const;
+
+    // white point of the camera along the solved gain curves in CIE 1960
+    // uv, empty if not solved
+    QVector<QPointF> cameraLocus() const;
+
+    // camera RGB to XYZ matrix (row major, 9 values)
+    void setCameraMatrix( const QVector<float> & rgb2xyz );
+    bool hasCameraMatrix() const;
+
+    // poll the XYZ statistic
+    void setStreaming( const bool enable );
+    bool isStreaming() const;
+
+    // pass a XYZ statistic sample
+    void addSample( const int x, const int y, const int z );
+
+    // average the following samples as illuminant "name"
+    void startCapture( const QString & name, const int reference );
+    bool isCapturing() const;
+
+    // finish the capture, false if there are too few samples or no camera
+    // matrix (the capture is dropped)
+    bool stopCapture();
+
+    const QVector<Capture> & captures() const;
+    void removeCapture( const int index );
+    void clearCaptures();
+
+    // presets of the device, id 0 restarts the list
+    void setPreset( const int id, const QString & name, const int ct );
+    const QVector<Preset> & presets() const;
+
+    // fit the gain curves and compute the preset gains, false on error
+    bool solve();
+    bool isSolved() const;
+
+    // solved gains at a color temperature (256 = 1.0)
+    bool gains( const int ct, int & red, int & blue ) const;
+
+signals:
+    void StatXYZRequested();
+    void ColorXYZRequested();
+
+    void SampleAdded( double u, double v, double ct, double duv );
+    void CaptureProgress( int samples );
+    void CapturesChanged();
+    void PresetsChanged();
+    void Solved();
+
+private slots:
+    void onPoll();
+
+private:
+    class PrivateData;
+    PrivateData * d_data;
+};
+
+#endif // __WB_CALIBRATION_H__
@@ -0,0 +1,457 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    wb_calibration_dialog.cpp
+ *
+ * @brief   Implementation of the white-balance calibration dialog
+ *
+ *****************************************************************************/
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <qcustomplot.h>
+
+#include "wbbox.h"
+#include "wb_calibration.h"
+#include "wb_calibration_dialog.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define WB_CALIBRATION_DIALOG_LIVE_POINTS   ( 200 )     // live samples in the plot
+#define WB_CALIBRATION_DIALOG_PLOT_MARGIN   ( 0.01 )    // uv around the locus
+
+/******************************************************************************
+ * gainText - display text of a gain (256 = 1.0)
+ *****************************************************************************/
+static QString gainText( const int gain )
+{
+    return ( (gain < 0) ? QString( "-" ) : QString::number( (double)gain / WB_GAIN_DEFAULT, 'f', 3 ) );
+}
+
+/******************************************************************************
+ * setRow - fill a table row with read-only items
+ *****************************************************************************/
+static void setRow( QTableWidget * table, const int row, const QStringList & texts )
+{
+    for ( int i = 0; i < texts.size(); i++ )
+    {
+        QTableWidgetItem * item = new QTableWidgetItem( texts[i] );
+        item->setFlags( Qt::ItemIsSelectable | Qt::ItemIsEnabled );
+        table->setItem( row, i, item );
+    }
+}
+
+/******************************************************************************
+ * newTable - read-only table with row selection
+ *****************************************************************************/
+static QTableWidget * newTable( const QStringList & header )
+{
+    QTableWidget * table = new QTableWidget( 0, header.size() );
+
+    table->setHorizontalHeaderLabels( header );
+    table->horizontalHeader()->setSectionResizeMode( QHeaderView::Stretch );
+    table->verticalHeader()->hide();
+    table->setSelectionBehavior( QAbstractItemView::SelectRows );
+    table->setSelectionMode( QAbstractItemView::SingleSelection );
+    table->setEditTriggers( QAbstractItemView::NoEditTriggers );
+
+    return ( table );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::PrivateData
+ *****************************************************************************/
+class WbCalibrationDialog::PrivateData
+{
+public:
+    PrivateData( WbCalibration * calibration )
+        : m_calibration( calibration )
+    {
+    }
+
+    WbCalibration *     m_calibration;
+
+    QCustomPlot *       m_plot;
+    QCPCurve *          m_locus;            /**< daylight locus */
+    QCPCurve *          m_camera;           /**< solved white point of the camera */
+    QCPCurve *          m_samples;          /**< live samples */
+    QCPCurve *          m_captures;         /**< captured illuminants */
+    QVector<double>     m_u;                /**< live samples in uv */
+    QVector<double>     m_v;
+
+    QLabel *            m_live;
+    QLineEdit *         m_name;
+    QSpinBox *          m_reference;
+    QPushButton *       m_capture;
+    QLabel *            m_progress;
+    QTableWidget *      m_captureTable;
+    QPushButton *       m_remove;
+    QPushButton *       m_solve;
+    QTableWidget *      m_presetTable;
+    QPushButton *       m_apply;
+};
+
+/******************************************************************************
+ * WbCalibrationDialog::WbCalibrationDialog
+ *****************************************************************************/
+WbCalibrationDialog::WbCalibrationDialog( WbCalibration * calibration, QWidget * parent )
+    : QDialog( parent )
+{
+    d_data = new PrivateData( calibration );
+
+    setWindowTitle( tr( "White Balance Calibration" ) );
+
+    ////////////////////
+    // locus plot
+    ////////////////////
+    d_data->m_plot = new QCustomPlot( this );
+    d_data->m_plot->setMinimumSize( 420, 320 );
+    d_data->m_plot->xAxis->setLabel( "u" );
+    d_data->m_plot->yAxis->setLabel( "v" );
+
+    d_data->m_locus = new QCPCurve( d_data->m_plot->xAxis, d_data->m_plot->yAxis );
+    d_data->m_locus->setName( tr( "Daylight locus" ) );
+    d_data->m_locus->setPen( QPen( Qt::gray, 2 ) );
+
+    d_data->m_camera = new QCPCurve( d_data->m_plot->xAxis, d_data->m_plot->yAxis );
+    d_data->m_camera->setName( tr( "Camera white point" ) );
+    d_data->m_camera->setPen( QPen( Qt::blue, 2 ) );
+
+    d_data->m_samples = new QCPCurve( d_data->m_plot->xAxis, d_data->m_plot->yAxis );
+    d_data->m_samples->setName( tr( "Samples" ) );
+    d_data->m_samples->setLineStyle( QCPCurve::lsNone );
+    d_data->m_samples->setScatterStyle( QCPScatterStyle( QCPScatterStyle::ssDisc, QColor( 255, 128, 0 ), 3 ) );
+
+    d_data->m_captures = new QCPCurve( d_data->m_plot->xAxis, d_data->m_plot->yAxis );
+    d_data->m_captures->setName( tr( "Illuminants" ) );
+    d_data->m_captures->setLineStyle( QCPCurve::lsNone );
+    d_data->m_captures->setScatterStyle( QCPScatterStyle( QCPScatterStyle::ssCircle, Qt::red, 9 ) );
+
+    QVector<QPointF> locus = calibration->locus();
+    QVector<double> u, v;
+    for ( int i = 0; i < locus.size(); i++ )
+    {
+        u.append( locus[i].x() );
+        v.append( locus[i].y() );
+    }
+    d_data->m_locus->setData( u, v );
+
+    bool found;
+    QCPRange ur = d_data->m_locus->getKeyRange( found );
+    QCPRange vr = d_data->m_locus->getValueRange( found );
+    d_data->m_plot->xAxis->setRange( ur.lower - WB_CALIBRATION_DIALOG_PLOT_MARGIN, ur.upper + WB_CALIBRATION_DIALOG_PLOT_MARGIN );
+    d_data->m_plot->yAxis->setRange( vr.lower - WB_CALIBRATION_DIALOG_PLOT_MARGIN, vr.upper + WB_CALIBRATION_DIALOG_PLOT_MARGIN );
+    d_data->m_plot->setInteractions( QCP::iRangeDrag | QCP::iRangeZoom );
+    d_data->m_plot->legend->setVisible( true );
+
+    d_data->m_live = new QLabel( tr( "No samples" ) );
+
+    ////////////////////
+    // capture
+    ////////////////////
+    d_data->m_name = new QLineEdit();
+    d_data->m_name->setPlaceholderText( tr( "Illuminant" ) );
+
+    d_data->m_reference = new QSpinBox();
+    d_data->m_reference->setRange( 0, WB_COLOR_TEMPERATURE_MAX );
+    d_data->m_reference->setSingleStep( 100 );
+    d_data->m_reference->setSuffix( " K" );
+    d_data->m_reference->setSpecialValueText( tr( "measured" ) );
+    d_data->m_reference->setToolTip( tr( "Nominal color temperature of the illuminant" ) );
+
+    d_data->m_capture  = new QPushButton( tr( "Start Capture" ) );
+    d_data->m_progress = new QLabel();
+
+    d_data->m_captureTable = newTable( QStringList() << tr( "Illuminant" ) << tr( "Nominal" ) << tr( "Measured" )
+                                                     << tr( "Duv" ) << tr( "Samples" ) << tr( "Red" ) << tr( "Blue" ) );
+    d_data->m_remove = new QPushButton( tr( "Remove" ) );
+    d_data->m_solve  = new QPushButton( tr( "Solve" ) );
+
+    QGridLayout * captureLayout = new QGridLayout();
+    captureLayout->addWidget( d_data->m_name, 0, 0 );
+    captureLayout->addWidget( d_data->m_reference, 0, 1 );
+    captureLayout->addWidget( d_data->m_capture, 0, 2 );
+    captureLayout->addWidget( d_data->m_progress, 0, 3 );
+    captureLayout->addWidget( d_data->m_captureTable, 1, 0, 1, 4 );
+    captureLayout->addWidget( d_data->m_remove, 2, 2 );
+    captureLayout->addWidget( d_data->m_solve, 2, 3 );
+
+    QGroupBox * captureBox = new QGroupBox( tr( "Illuminants" ) );
+    captureBox->setLayout( captureLayout );
+
+    ////////////////////
+    // presets
+    ////////////////////
+    d_data->m_presetTable = newTable( QStringList() << tr( "Preset" ) << tr( "Color Temperature" )
+                                                    << tr( "Red" ) << tr( "Blue" ) );
+    d_data->m_apply = new QPushButton( tr( "Apply Gains" ) );
+    d_data->m_apply->setToolTip( tr( "Set the red and blue gain of the selected preset" ) );
+
+    QVBoxLayout * presetLayout = new QVBoxLayout();
+    presetLayout->addWidget( d_data->m_presetTable );
+    presetLayout->addWidget( d_data->m_apply, 0, Qt::AlignRight );
+
+    QGroupBox * presetBox = new QGroupBox( tr( "Preset Gains" ) );
+    presetBox->setLayout( presetLayout );
+
+    QDialogButtonBox * buttons = new QDialogButtonBox( QDialogButtonBox::Close );
+
+    QVBoxLayout * plotLayout = new QVBoxLayout();
+    plotLayout->addWidget( d_data->m_plot, 1 );
+    plotLayout->addWidget( d_data->m_live );
+
+    QVBoxLayout * tableLayout = new QVBoxLayout();
+    tableLayout->addWidget( captureBox );
+    tableLayout->addWidget( presetBox );
+
+    QHBoxLayout * contentLayout = new QHBoxLayout();
+    contentLayout->addLayout( plotLayout, 1 );
+    contentLayout->addLayout( tableLayout, 1 );
+
+    QVBoxLayout * layout = new QVBoxLayout( this );
+    layout->addLayout( contentLayout );
+    layout->addWidget( buttons );
+
+    ////////////////////
+    // connections
+    ////////////////////
+    connect( calibration, SIGNAL(SampleAdded(double,double,double,double)), this, SLOT(onSampleAdded(double,double,double,double)) );
+    connect( calibration, SIGNAL(CaptureProgress(int)), this, SLOT(onCaptureProgress(int)) );
+    connect( calibration, SIGNAL(CapturesChanged()), this, SLOT(onCapturesChanged()) );
+    connect( calibration, SIGNAL(PresetsChanged()), this, SLOT(onPresetsChanged()) );
+    connect( calibration, SIGNAL(Solved()), this, SLOT(onSolved()) );
+
+    connect( d_data->m_capture, SIGNAL(clicked()), this, SLOT(onCaptureClicked()) );
+    connect( d_data->m_remove, SIGNAL(clicked()), this, SLOT(onRemoveClicked()) );
+    connect( d_data->m_solve, SIGNAL(clicked()), this, SLOT(onSolveClicked()) );
+    connect( d_data->m_apply, SIGNAL(clicked()), this, SLOT(onApplyClicked()) );
+    connect( buttons, SIGNAL(rejected()), this, SLOT(close()) );
+
+    onCapturesChanged();
+    onPresetsChanged();
+    onSolved();
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::~WbCalibrationDialog
+ *****************************************************************************/
+WbCalibrationDialog::~WbCalibrationDialog()
+{
+    delete d_data;
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::showEvent
+ *****************************************************************************/
+void WbCalibrationDialog::showEvent( QShowEvent * event )
+{
+    d_data->m_calibration->setStreaming( true );
+    QDialog::showEvent( event );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::hideEvent
+ *****************************************************************************/
+void WbCalibrationDialog::hideEvent( QHideEvent * event )
+{
+    d_data->m_calibration->setStreaming( false );
+    QDialog::hideEvent( event );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onSampleAdded
+ *****************************************************************************/
+void WbCalibrationDialog::onSampleAdded( double u, double v, double ct, double duv )
+{
+    d_data->m_u.append( u );
+    d_data->m_v.append( v );
+    if ( d_data->m_u.size() > WB_CALIBRATION_DIALOG_LIVE_POINTS )
+    {
+        d_data->m_u.remove( 0 );
+        d_data->m_v.remove( 0 );
+    }
+
+    d_data->m_samples->setData( d_data->m_u, d_data->m_v );
+    d_data->m_live->setText( QString( "%1 K, Duv %2" ).arg( qRound( ct ) ).arg( duv, 0, 'f', 4 ) );
+
+    // several samples within one event loop iteration cost one repaint
+    d_data->m_plot->replot( QCustomPlot::rpQueuedReplot );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onCaptureProgress
+ *****************************************************************************/
+void WbCalibrationDialog::onCaptureProgress( int samples )
+{
+    d_data->m_progress->setText( tr( "%1 samples" ).arg( samples ) );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onCapturesChanged
+ *****************************************************************************/
+void WbCalibrationDialog::onCapturesChanged()
+{
+    const QVector<WbCalibration::Capture> & captures = d_data->m_calibration->captures();
+
+    QVector<double> u, v;
+
+    d_data->m_captureTable->setRowCount( captures.size() );
+    for ( int i = 0; i < captures.size(); i++ )
+    {
+        const WbCalibration::Capture & c = captures[i];
+
+        setRow( d_data->m_captureTable, i, QStringList()
+                << c.name
+                << ((c.reference > 0) ? QString( "%1 K" ).arg( c.reference ) : QString( "-" ))
+                << QString( "%1 K" ).arg( qRound( c.ct ) )
+                << QString::number( c.duv, 'f', 4 )
+                << QString::number( c.samples )
+                << QString::number( c.red, 'f', 3 )
+                << QString::number( c.blue, 'f', 3 ) );
+        u.append( c.u );
+        v.append( c.v );
+    }
+
+    d_data->m_captures->setData( u, v );
+    d_data->m_remove->setEnabled( !captures.isEmpty() );
+
+    onSolved();
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onPresetsChanged
+ *****************************************************************************/
+void WbCalibrationDialog::onPresetsChanged()
+{
+    const QVector<WbCalibration::Preset> & presets = d_data->m_calibration->presets();
+
+    d_data->m_presetTable->setRowCount( presets.size() );
+    for ( int i = 0; i < presets.size(); i++ )
+    {
+        const WbCalibration::Preset & p = presets[i];
+
+        setRow( d_data->m_presetTable, i, QStringList()
+                << p.name
+                << QString( "%1 K" ).arg( p.ct )
+                << gainText( p.red )
+                << gainText( p.blue ) );
+    }
+
+    d_data->m_apply->setEnabled( d_data->m_calibration->isSolved() && !presets.isEmpty() );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onSolved
+ *****************************************************************************/
+void WbCalibrationDialog::onSolved()
+{
+    QVector<QPointF> points = d_data->m_calibration->cameraLocus();
+    QVector<double> u, v;
+
+    for ( int i = 0; i < points.size(); i++ )
+    {
+        u.append( points[i].x() );
+        v.append( points[i].y() );
+    }
+
+    d_data->m_camera->setData( u, v );
+    d_data->m_plot->replot( QCustomPlot::rpQueuedReplot );
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onCaptureClicked
+ *****************************************************************************/
+void WbCalibrationDialog::onCaptureClicked()
+{
+    WbCalibration * calibration = d_data->m_calibration;
+
+    if ( !calibration->isCapturing() )
+    {
+        QString name = d_data->m_name->text().trimmed();
+        if ( name.isEmpty() )
+        {
+            name = tr( "Illuminant %1" ).arg( calibration->captures().size() + 1 );
+        }
+
+        calibration->startCapture( name, d_data->m_reference->value() );
+        d_data->m_capture->setText( tr( "Stop Capture" ) );
+        return;
+    }
+
+    d_data->m_capture->setText( tr( "Start Capture" ) );
+    d_data->m_progress->clear();
+
+    if ( !calibration->stopCapture() )
+    {
+        QMessageBox::warning( this, windowTitle(),
+                              calibration->hasCameraMatrix()
+                              ? tr( "Too few samples, capture the illuminant for at least a few seconds." )
+                              : tr( "The camera did not report its color matrix." ) );
+        return;
+    }
+
+    d_data->m_name->clear();
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onRemoveClicked
+ *****************************************************************************/
+void WbCalibrationDialog::onRemoveClicked()
+{
+    int row = d_data->m_captureTable->currentRow();
+    if ( row >= 0 )
+    {
+        d_data->m_calibration->removeCapture( row );
+    }
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onSolveClicked
+ *****************************************************************************/
+void WbCalibrationDialog::onSolveClicked()
+{
+    if ( !d_data->m_calibration->solve() )
+    {
+        QMessageBox::warning( this, windowTitle(),
+                              tr( "The gain curves can not be solved, capture illuminants of different color temperatures." ) );
+    }
+}
+
+/******************************************************************************
+ * WbCalibrationDialog::onApplyClicked
+ *****************************************************************************/
+void WbCalibrationDialog::onApplyClicked()
+{
+    const QVector<WbCalibration::Preset> & presets = d_data->m_calibration->presets();
+
+    int row = d_data->m_presetTable->currentRow();
+    if ( (row >= 0) && (row < presets.size()) && (presets[row].red >= 0) )
+    {
+        emit GainsApplied( presets[row].red, presets[row].blue );
+    }
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    wb_calibration_dialog.h
+ *
+ * @brief   Declaration of the white-balance calibration dialog
+ *
+ * @note    The dialog plots the daylight locus, the live XYZ samples, the
+ *          captured illuminants and the solved white point of the camera in
+ *          the CIE 1960 uv plane. The calibration streams while the dialog
+ *          is visible.
+ *
+ *****************************************************************************/
+#ifndef __WB_CALIBRATION_DIALOG_H__
+#define __WB_CALIBRATION_DIALOG_H__
+
+#include <QDialog>
+
+class WbCalibration;
+
+class WbCalibrationDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit WbCalibrationDialog( WbCalibration * calibration, QWidget * parent = nullptr );
+    ~WbCalibrationDialog();
+
+signals:
+    // apply solved gains (256 = 1.0)
+    void GainsApplied( int red, int blue );
+
+protected:
+    void showEvent( QShowEvent * ) Q_DECL_OVERRIDE;
+    void hideEvent( QHideEvent * ) Q_DECL_OVERRIDE;
+
+private slots:
+    void onSampleAdded( double u, double v, double ct, double duv );
+    void onCaptureProgress( int samples );
+    void onCapturesChanged();
+    void onPresetsChanged();
+    void onSolved();
+
+    void onCaptureClicked();
+    void onRemoveClicked();
+    void onSolveClicked();
+    void onApplyClicked();
+
+private:
+    class PrivateData;
+    PrivateData * d_data;
+};
+
+#endif // __WB_CALIBRATION_DIALOG_H__
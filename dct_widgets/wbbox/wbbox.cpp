@@ -23,10 +23,11 @@
 #include <QtDebug>
 #include <QTimer>
 
-#include <simple_math/xyz2ct.h>
 #include <common.h>
 
 #include "wbbox.h"
+#include "wb_calibration.h"
+#include "wb_calibration_dialog.h"
 #include "ui_wbbox.h"
 
 /******************************************************************************
@@ -68,6 +69,8 @@ public:
         , m_awb_enable( false )
         , m_awb_speed( 0 )
         , m_green_gain( 0 )
+        , m_calibration( new WbCalibration() )
+        , m_calibration_dialog( nullptr )
     {
         m_XYZ.resize( 9 );
 
@@ -78,6 +81,8 @@ public:
 
     ~PrivateData()
     {
+        delete m_calibration_dialog;
+        delete m_calibration;
         delete m_wb_timer;
         delete m_ui;
     };
@@ -91,6 +96,9 @@ public:
                                              because of normalization to '1' by awb */
     QVector<float>  m_XYZ;
     QTimer *        m_wb_timer;         /**< white-balance timer to update gains*/
+
+    WbCalibration *         m_calibration;          /**< gain calibration, owns the color temperature table */
+    WbCalibrationDialog *   m_calibration_dialog;   /**< created on first use */
 };
 
 /******************************************************************************
@@ -251,6 +259,12 @@ WbBox::WbBox( QWidget * parent ) : DctWidgetBox( parent )
     ////////////////////
     connect( d_data->m_wb_timer, SIGNAL(timeout()), this, SLOT(onWbUpdate()) );
 
+    ////////////////////
+    // calibration
+    ////////////////////
+    connect( d_data->m_calibration, SIGNAL(StatXYZRequested()), this, SIGNAL(StatXYZRequested()) );
+    connect( d_data->m_calibration, SIGNAL(ColorXYZRequested()), this, SIGNAL(ColorXYZRequested()) );
+
     /*
      * Manulal hiding the following features.
      * This features are currently not available the IronSDI
@@ -604,6 +618,9 @@ void WbBox::setWhiteBalanceSettingsVisible(const bool awbVisible, const bool gai
     d_data->m_ui->RedGain->setVisible(gainVisible);
     d_data->m_ui->GreenGain->setVisible(greenGainVisible);
     d_data->m_ui->BlueGain->setVisible(gainVisible);
+
+    // Calibration sets the red and blue gain
+    d_data->m_ui->btnWbCalibration->setVisible(gainVisible);
 }
 
 /******************************************************************************
@@ -637,6 +654,8 @@ void WbBox::onWbPresetsChange( int id, QString name, int ct )
         d_data->m_ui->WbButtonBox->addButton( "Oneshot", QPixmap(":/images/wb/wb.png") );
     }
 
+    d_data->m_calibration->setPreset( id, name, ct );
+
     QString s;
     s.sprintf( "%s(%dK)", name.toStdString().c_str(), ct );
 
@@ -827,20 +846,7 @@ void WbBox::onStatRGBChange( int red, int green, int blue )
  *****************************************************************************/
 void WbBox::onStatXYZChange( int x, int y, int z )
 {
-    double XYZ[3];
-    double ct;
-    int res;
-
-    XYZ[0] = (double)x;
-    XYZ[1] = (double)y;
-    XYZ[2] = (double)z;
-    ct = 0.0f;
-    res = XYZtoCorColorTemp_Robertson( XYZ, &ct );
-    if ( ! res )
-    {
-//        d_data->m_ui->ColorTemperature->onValueChange( (int)ct );
-    }
-    // qDebug( "ct=%d, X=%d, Y=%d, Z=%d", (int)ct, x, y, z );
+    d_data->m_calibration->addSample( x, y, z );
 }
 
 /******************************************************************************
@@ -860,6 +866,8 @@ void WbBox::onColorXYZChange( int c0, int c1, int c2,
     d_data->m_XYZ[7] = ((float)c7) / FIX_PRECISION_S0216;
     d_data->m_XYZ[8] = ((float)c8) / FIX_PRECISION_S0216;
 
+    d_data->m_calibration->setCameraMatrix( d_data->m_XYZ );
+
     // qDebug( "c0=%6.2f, c1=%6.2f, c2=%6.2f", d_data->m_XYZ[0], d_data->m_XYZ[1], d_data->m_XYZ[2] );
 }
 
@@ -1019,3 +1027,34 @@ void WbBox::on_whiteBalanceBlueResetButton_clicked()
 {
     setBlueGain(WB_GAIN_DEFAULT);
 }
+
+/******************************************************************************
+ * WbBox::on_btnWbCalibration_clicked
+ *****************************************************************************/
+void WbBox::on_btnWbCalibration_clicked()
+{
+    if ( !d_data->m_calibration_dialog )
+    {
+        d_data->m_calibration_dialog = new WbCalibrationDialog( d_data->m_calibration, this );
+        connect( d_data->m_calibration_dialog, SIGNAL(GainsApplied(int,int)), this, SLOT(onCalibrationGainsApplied(int,int)) );
+    }
+
+    d_data->m_calibration_dialog->show();
+    d_data->m_calibration_dialog->raise();
+    d_data->m_calibration_dialog->activateWindow();
+}
+
+/******************************************************************************
+ * WbBox::onCalibrationGainsApplied
+ *****************************************************************************/
+void WbBox::onCalibrationGainsApplied( int red, int blue )
+{
+    // continuous auto white balance would overwrite the gains
+    if ( AwbEnable() )
+    {
+        setAwbEnable( false );
+    }
+
+    setRedGain( red );
+    setBlueGain( blue );
+}
@@ -169,6 +169,10 @@ signals:
 
     void StatisticChanged();
 
+    // statistics requested by the white-balance calibration
+    void StatXYZRequested();
+    void ColorXYZRequested();
+
     void RedGainChanged( int value );
     void GreenGainChanged( int value );
     void BlueGainChanged( int value );
@@ -222,6 +226,8 @@ private slots:
     void on_whiteBalanceRedResetButton_clicked();
     void on_whiteBalanceGreenResetButton_clicked();
     void on_whiteBalanceBlueResetButton_clicked();
+    void on_btnWbCalibration_clicked();
+    void onCalibrationGainsApplied( int red, int blue );
 
 private:
     class PrivateData;
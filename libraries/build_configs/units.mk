@@ -6,5 +6,6 @@ LIBS_DIR = csv \
            provideo_protocol \
            embUnit \
            rs232 \
-           simple_math
+           simple_math \
+           profile
 
@@ -96,6 +96,21 @@ typedef struct ctrl_channel_s
 
     ctrl_channel_state_t            state;              /**< control channel state */
     void *                          priv;               /**< pointer to internal context */
+
+    uint32_t                        no_responses;       /**< number of complete responses since open */
+    uint32_t                        line_rate;          /**< line rate in bits/s, 0 if unknown */
+
+    uint8_t                         request[CTRL_CHANNEL_REQUEST_SIZE]; /**< beginning of last request */
+    int                             request_len;        /**< length of last request */
+
+    int                             no_late;            /**< responses given up before their timeout */
+    int64_t                         late_expiry_ms;     /**< end of the timeout of the last one */
+
+    uint8_t                         scratch[CTRL_CHANNEL_SCRATCH_SIZE]; /**< reusable response buffer */
+
+    ctrl_channel_defer_request_t    defer;              /**< receiver of deferred set-commands */
+    ctrl_channel_flush_requests_t   flush;              /**< sends the deferred set-commands */
+    void *                          defer_priv;         /**< context of defer and flush */
 } ctrl_channel_t;
 
 /******************************************************************************
@@ -106,6 +121,24 @@ int ctrl_channel_get_instance_size( void )
     return ( sizeof( ctrl_channel_t ) );
 }
 
+/******************************************************************************
+ * ctrl_channel_get_scratch_buffer - returns the reusable buffer of a control
+ * channel instance
+ *****************************************************************************/
+uint8_t * ctrl_channel_get_scratch_buffer
+(
+    ctrl_channel_handle_t const ch,
+    int const                   len
+)
+{
+    if ( ch && (len > 0) && (len <= CTRL_CHANNEL_SCRATCH_SIZE) )
+    {
+        return ( ch->scratch );
+    }
+
+    return ( NULL );
+}
+
 /******************************************************************************
  * ctrl_channel_get_state - returns state of control channel instance
  *****************************************************************************/
@@ -167,7 +200,10 @@ int ctrl_channel_open
     res = ch->open( ch->priv, param, size );
     if ( !res )
     {
-        ch->state = CTRL_CHANNEL_STATE_CONNECTED;
+        ch->state        = CTRL_CHANNEL_STATE_CONNECTED;
+        ch->no_responses = 0u;
+        ch->request_len  = 0;
+        ch->no_late      = 0;
     }
 
     return ( res );
@@ -210,6 +246,20 @@ int ctrl_channel_send_request
     
     CHECK_API_FUNC( ch->send_request );
 
+    /* Deferred set-commands go first, the receiver is detached meanwhile so
+     * its own requests are sent directly. */
+    if ( ch->defer )
+    {
+        ctrl_channel_defer_request_t defer = ch->defer;
+
+        ch->defer = NULL;
+        if ( ch->flush )
+        {
+            ch->flush( ch->defer_priv );
+        }
+        ch->defer = defer;
+    }
+
     /* Send data over channel. Lock and release channel if those functions are
      * available, otherwise send without locking. */
 
@@ -225,9 +275,61 @@ int ctrl_channel_send_request
         ch->release( ch->priv );
     }
 
+    // keep the beginning of the request, e.g. to tell the command of a response
+    if ( data && (len > 0) )
+    {
+        memcpy( ch->request, data, (size_t)((len < CTRL_CHANNEL_REQUEST_SIZE) ? len : CTRL_CHANNEL_REQUEST_SIZE) );
+        ch->request_len = len;
+    }
+
     return res;
 }
 
+/******************************************************************************
+ * ctrl_channel_set_defer - install a receiver for deferred set-commands
+ *****************************************************************************/
+int ctrl_channel_set_defer
+(
+    ctrl_channel_handle_t const         ch,
+    ctrl_channel_defer_request_t const  defer,
+    ctrl_channel_flush_requests_t const flush,
+    void * const                        priv
+)
+{
+    CHECK_HANDLE( ch );
+
+    ch->defer      = defer;
+    ch->flush      = defer ? flush : NULL;
+    ch->defer_priv = defer ? priv  : NULL;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * ctrl_channel_defer_request - hand a set-command to the installed receiver
+ *****************************************************************************/
+int ctrl_channel_defer_request
+(
+    ctrl_channel_handle_t const ch,
+    uint8_t const * const       data,
+    int const                   len,
+    int const                   tmo_ms
+)
+{
+    int res;
+
+    CHECK_HANDLE_AND_STATE( ch, CTRL_CHANNEL_STATE_CONNECTED );
+
+    if ( !ch->defer )
+    {
+        return ( 0 );
+    }
+
+    res = ch->defer( ch->defer_priv, data, len, tmo_ms );
+
+    return ( res ? res : 1 );
+}
+
 /******************************************************************************
  * ctrl_channel_receive_response - receive response data from a connected device
  *****************************************************************************/
@@ -262,6 +364,115 @@ int ctrl_channel_receive_response
     return res;
 }
 
+/******************************************************************************
+ * ctrl_channel_count_response - count a complete response of the device
+ *****************************************************************************/
+void ctrl_channel_count_response( ctrl_channel_handle_t const ch )
+{
+    if ( ch )
+    {
+        ch->no_responses++;
+    }
+}
+
+/******************************************************************************
+ * ctrl_channel_get_response_count - returns number of complete responses
+ *****************************************************************************/
+uint32_t ctrl_channel_get_response_count( ctrl_channel_handle_t const ch )
+{
+    return ( ch ? ch->no_responses : 0u );
+}
+
+/******************************************************************************
+ * ctrl_channel_get_last_request - returns the beginning of the last request
+ *****************************************************************************/
+uint8_t const * ctrl_channel_get_last_request
+(
+    ctrl_channel_handle_t const ch,
+    int * const                 len
+)
+{
+    if ( len )
+    {
+        *len = ch ? ch->request_len : 0;
+    }
+
+    return ( ch ? ch->request : NULL );
+}
+
+/******************************************************************************
+ * ctrl_channel_add_late_response - note a response given up before its timeout
+ *****************************************************************************/
+void ctrl_channel_add_late_response
+(
+    ctrl_channel_handle_t const ch,
+    int64_t const               expiry_ms
+)
+{
+    if ( ch )
+    {
+        ch->no_late++;
+        ch->late_expiry_ms = expiry_ms;
+    }
+}
+
+/******************************************************************************
+ * ctrl_channel_get_late_responses - returns the number of late responses
+ *****************************************************************************/
+int ctrl_channel_get_late_responses
+(
+    ctrl_channel_handle_t const ch,
+    int64_t const               now_ms
+)
+{
+    if ( !ch )
+    {
+        return ( 0 );
+    }
+
+    // the device does not answer after the timeout
+    if ( now_ms > ch->late_expiry_ms )
+    {
+        ch->no_late = 0;
+    }
+
+    return ( ch->no_late );
+}
+
+/******************************************************************************
+ * ctrl_channel_skip_late_response - a late response was received
+ *****************************************************************************/
+void ctrl_channel_skip_late_response( ctrl_channel_handle_t const ch )
+{
+    if ( ch && (ch->no_late > 0) )
+    {
+        ch->no_late--;
+    }
+}
+
+/******************************************************************************
+ * ctrl_channel_set_line_rate - sets the line rate of a channel
+ *****************************************************************************/
+void ctrl_channel_set_line_rate
+(
+    ctrl_channel_handle_t const ch,
+    uint32_t const              rate
+)
+{
+    if ( ch )
+    {
+        ch->line_rate = rate;
+    }
+}
+
+/******************************************************************************
+ * ctrl_channel_get_line_rate - returns the line rate of a channel
+ *****************************************************************************/
+uint32_t ctrl_channel_get_line_rate( ctrl_channel_handle_t const ch )
+{
+    return ( ch ? ch->line_rate : 0u );
+}
+
 /******************************************************************************
  * ctrl_channel_register - register a control channel driver functions
  *****************************************************************************/
@@ -304,6 +515,11 @@ int ctrl_channel_register
     ch->send_request     = send_request;
     ch->receive_response = receive_response;
 
+    // set-commands are sent directly
+    ch->defer            = NULL;
+    ch->flush            = NULL;
+    ch->defer_priv       = NULL;
+
     ch->state = CTRL_CHANNEL_STATE_INIT;
 
     return ( 0 );
@@ -487,6 +487,23 @@ int ctrl_protocol_set_lens_filter_settings
     return ( LENS_DRV(protocol->drv)->set_lens_filter_settings( protocol->ctx, channel, no, values ) );
 }
 
+/******************************************************************************
+ * ctrl_protocol_get_lens_state
+ *****************************************************************************/
+int ctrl_protocol_get_lens_state
+(
+    ctrl_protocol_handle_t const protocol,
+    ctrl_channel_handle_t const  channel,
+    int const                    no,
+    uint8_t * const              values
+)
+{
+    CHECK_HANDLE( protocol );
+    CHECK_DRV_FUNC( LENS_DRV(protocol->drv), get_lens_state );
+    CHECK_NOT_NULL( values );
+    return ( LENS_DRV(protocol->drv)->get_lens_state( protocol->ctx, channel, no, values ) );
+}
+
 
 
 
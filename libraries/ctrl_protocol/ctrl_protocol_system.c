@@ -840,6 +840,40 @@ int ctrl_protocol_set_settings_from_file
     return ( SYS_DRV(protocol->drv)->set_device_settings( protocol->ctx, channel, no, settings ) );
 }
 
+/******************************************************************************
+ * ctrl_protocol_send_commands
+ *****************************************************************************/
+int ctrl_protocol_send_commands
+(
+    ctrl_protocol_handle_t const protocol,
+    ctrl_channel_handle_t const  channel,
+    int const                    no,
+    uint8_t * const              values
+)
+{
+    CHECK_HANDLE( protocol );
+    CHECK_DRV_FUNC( SYS_DRV(protocol->drv), send_commands );
+    CHECK_NOT_NULL( values );
+    return ( SYS_DRV(protocol->drv)->send_commands( protocol->ctx, channel, no, values ) );
+}
+
+/******************************************************************************
+ * ctrl_protocol_read_settings
+ *****************************************************************************/
+int ctrl_protocol_read_settings
+(
+    ctrl_protocol_handle_t const protocol,
+    ctrl_channel_handle_t const  channel,
+    int const                    no,
+    uint8_t * const              values
+)
+{
+    CHECK_HANDLE( protocol );
+    CHECK_DRV_FUNC( SYS_DRV(protocol->drv), read_device_settings );
+    CHECK_NOT_NULL( values );
+    return ( SYS_DRV(protocol->drv)->read_device_settings( protocol->ctx, channel, no, values ) );
+}
+
 /******************************************************************************
  * ctrl_protocol_sys_register
  *****************************************************************************/
@@ -34,6 +34,16 @@ extern "C" {
  * @{
  *****************************************************************************/
 
+/**************************************************************************//**
+ * @brief      Size of the reusable response buffer of a control channel
+ *****************************************************************************/
+#define CTRL_CHANNEL_SCRATCH_SIZE   ( 4096 )
+
+/**************************************************************************//**
+ * @brief      Number of bytes kept of the last request of a control channel
+ *****************************************************************************/
+#define CTRL_CHANNEL_REQUEST_SIZE   ( 32 )
+
 /**************************************************************************//**
  * @brief      Control channel instance handle
  *****************************************************************************/
@@ -167,6 +177,35 @@ typedef int (* ctrl_channel_receive_response_t)
     int const       len
 );
 
+/**************************************************************************//**
+ * @brief function pointer type to take over a set-command instead of sending
+ *        it (see ctrl_channel_set_defer)
+ *
+ * @param[in]  priv     context of the receiver
+ * @param[in]  data     complete command line
+ * @param[in]  len      length of the command line
+ * @param[in]  tmo_ms   response timeout of the command
+ *
+ * @return      0 on sucess, error-code otherwise
+ *****************************************************************************/
+typedef int (* ctrl_channel_defer_request_t)
+(
+    void * const            priv,
+    uint8_t const * const   data,
+    int const               len,
+    int const               tmo_ms
+);
+
+/**************************************************************************//**
+ * @brief function pointer type to send the deferred set-commands
+ *
+ * @param[in]  priv     context of the receiver
+ *****************************************************************************/
+typedef void (* ctrl_channel_flush_requests_t)
+(
+    void * const            priv
+);
+
 /**************************************************************************//**
  * @brief      Returns the size of a control channel instance
  *
@@ -176,6 +215,25 @@ typedef int (* ctrl_channel_receive_response_t)
  *****************************************************************************/
 int ctrl_channel_get_instance_size( void );
 
+/**************************************************************************//**
+ * @brief      Get the reusable buffer of a control channel instance
+ *
+ * @note       The buffer is part of the instance memory, so commands can
+ *             receive their response without allocating memory. It is owned
+ *             by the caller until the next call on the same channel.
+ *
+ * @param[in]  ch   control channel handle
+ * @param[in]  len  required buffer size in bytes
+ *
+ * @return     buffer of at least len bytes, NULL if len is larger than
+ *             CTRL_CHANNEL_SCRATCH_SIZE
+ *****************************************************************************/
+uint8_t * ctrl_channel_get_scratch_buffer
+(
+    ctrl_channel_handle_t const ch,
+    int const                   len
+);
+
 /**************************************************************************//**
  * @brief      Get state of control channel instance
  *
@@ -275,6 +333,144 @@ int ctrl_channel_receive_response
     int const                   len
 );
 
+/**************************************************************************//**
+ * @brief      Count a complete response (OK or FAIL) received from the device
+ *
+ * @note       Called by the protocol layer for every terminated response, so
+ *             the link state can be observed without sending extra commands.
+ *
+ * @param[in]  ch       control channel handle
+ *****************************************************************************/
+void ctrl_channel_count_response( ctrl_channel_handle_t const ch );
+
+/**************************************************************************//**
+ * @brief      Get the number of complete responses since the channel was opened
+ *
+ * @param[in]  ch       control channel handle
+ *
+ * @return     response counter, wraps around at 2^32
+ *****************************************************************************/
+uint32_t ctrl_channel_get_response_count( ctrl_channel_handle_t const ch );
+
+/**************************************************************************//**
+ * @brief      Get the last request sent over the channel
+ *
+ * @param[in]  ch       control channel handle
+ * @param[out] len      length of the whole request, 0 if nothing was sent
+ *
+ * @return     the first CTRL_CHANNEL_REQUEST_SIZE bytes of the request
+ *****************************************************************************/
+uint8_t const * ctrl_channel_get_last_request
+(
+    ctrl_channel_handle_t const ch,
+    int * const                 len
+);
+
+/**************************************************************************//**
+ * @brief      Note a response which was given up before its timeout
+ *
+ * @note       A device which was only slow still sends the response, in front
+ *             of the response to the next request. The protocol layer skips
+ *             the noted responses until they arrived or expired.
+ *
+ * @param[in]  ch           control channel handle
+ * @param[in]  expiry_ms    monotonic time in ms when the timeout of the request
+ *                          is over
+ *****************************************************************************/
+void ctrl_channel_add_late_response
+(
+    ctrl_channel_handle_t const ch,
+    int64_t const               expiry_ms
+);
+
+/**************************************************************************//**
+ * @brief      Get the number of late responses still expected
+ *
+ * @param[in]  ch       control channel handle
+ * @param[in]  now_ms   monotonic time in ms, expired late responses are dropped
+ *
+ * @return     number of late responses
+ *****************************************************************************/
+int ctrl_channel_get_late_responses
+(
+    ctrl_channel_handle_t const ch,
+    int64_t const               now_ms
+);
+
+/**************************************************************************//**
+ * @brief      A late response was received and skipped
+ *
+ * @param[in]  ch       control channel handle
+ *****************************************************************************/
+void ctrl_channel_skip_late_response( ctrl_channel_handle_t const ch );
+
+/**************************************************************************//**
+ * @brief      Set the line rate of the channel
+ *
+ * @note       Called by channel implementations with a fixed line rate (e.g.
+ *             serial ports) when they are opened.
+ *
+ * @param[in]  ch       control channel handle
+ * @param[in]  rate     line rate in bits/s, 0 if unknown
+ *****************************************************************************/
+void ctrl_channel_set_line_rate
+(
+    ctrl_channel_handle_t const ch,
+    uint32_t const              rate
+);
+
+/**************************************************************************//**
+ * @brief      Get the line rate of the channel
+ *
+ * @param[in]  ch       control channel handle
+ *
+ * @return     line rate in bits/s, 0 if unknown
+ *****************************************************************************/
+uint32_t ctrl_channel_get_line_rate( ctrl_channel_handle_t const ch );
+
+/**************************************************************************//**
+ * @brief      Install a receiver for deferred set-commands
+ *
+ * @note       While a receiver is installed, set-commands are handed to defer
+ *             instead of being sent, so the receiver can merge and pipeline
+ *             them. Before any other request is sent, flush is called, so a
+ *             get-command always sees the deferred settings on the device.
+ *             The receiver is not called recursively while it flushes.
+ *
+ * @param[in]  ch       control channel handle
+ * @param[in]  defer    receiver of set-commands, NULL to remove the receiver
+ * @param[in]  flush    sends the deferred set-commands
+ * @param[in]  priv     context passed to defer and flush
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int ctrl_channel_set_defer
+(
+    ctrl_channel_handle_t const         ch,
+    ctrl_channel_defer_request_t const  defer,
+    ctrl_channel_flush_requests_t const flush,
+    void * const                        priv
+);
+
+/**************************************************************************//**
+ * @brief      Hand a set-command to the installed receiver
+ *
+ * @param[in]  ch       control channel handle
+ * @param[in]  data     complete command line
+ * @param[in]  len      length of the command line
+ * @param[in]  tmo_ms   response timeout of the command
+ *
+ * @return     1 if the command was deferred, 0 if it has to be sent,
+ *             error-code otherwise
+ *****************************************************************************/
+int ctrl_channel_defer_request
+(
+    ctrl_channel_handle_t const ch,
+    uint8_t const * const       data,
+    int const                   len,
+    int const                   tmo_ms
+);
+
 /**************************************************************************//**
  * @brief      Register function handlers at control channel instance
  *
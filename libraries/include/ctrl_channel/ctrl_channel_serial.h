@@ -30,18 +30,30 @@ extern "C" {
 #endif
 
 /**************************************************************************//**
- * @brief number of data bits to use
+ * @brief baudrate to use
  * @note  slow baudrates below 57600 baud are not supported by the GUI because
  *        the delays / wait times get to long for a fluid user experience
+ * @note  any other baudrate between CTRL_CHANNEL_BAUDRATE_MIN and
+ *        CTRL_CHANNEL_BAUDRATE_MAX is passed to the serial driver as custom
+ *        baudrate, it depends on the adapter if it can be generated
  *****************************************************************************/
 #define CTRL_CHANNEL_BAUDRATE_9600    (   9600u ) /**<   9600 bits/s */
 #define CTRL_CHANNEL_BAUDRATE_19200   (  19200u ) /**<  19200 bits/s */
 #define CTRL_CHANNEL_BAUDRATE_38400   (  38400u ) /**<  38400 bits/s */
 #define CTRL_CHANNEL_BAUDRATE_57600   (  57600u ) /**<  57600 bits/s */
 #define CTRL_CHANNEL_BAUDRATE_115200  ( 115200u ) /**< 115200 bits/s */
+#define CTRL_CHANNEL_BAUDRATE_230400  ( 230400u ) /**< 230400 bits/s */
+#define CTRL_CHANNEL_BAUDRATE_460800  ( 460800u ) /**< 460800 bits/s */
+#define CTRL_CHANNEL_BAUDRATE_921600  ( 921600u ) /**< 921600 bits/s */
 
 #define CTRL_CHANNEL_BAUDRATE_DEFAULT ( CTRL_CHANNEL_BAUDRATE_115200 )  /**< default configuration if 0 */
 
+#define CTRL_CHANNEL_BAUDRATE_MIN     (    1200u )  /**< lowest accepted baudrate */
+#define CTRL_CHANNEL_BAUDRATE_MAX     ( 4000000u )  /**< highest accepted baudrate */
+
+#define CTRL_CHANNEL_BAUDRATE_VALID( b ) \
+    ( ((b) >= CTRL_CHANNEL_BAUDRATE_MIN) && ((b) <= CTRL_CHANNEL_BAUDRATE_MAX) )
+
 /**************************************************************************//**
  * @brief number of data bits to use 
  *****************************************************************************/
@@ -48,6 +48,55 @@ extern "C" {
 #define NO_VALUES_LENS_IRIS_SETUP           ( 18 )
 #define NO_VALUES_LENS_FILTER_SETTINGS      ( 3 )
 
+/**************************************************************************//**
+ * @brief Values of a lens driver state readout (see ctrl_protocol_lens_state_t)
+ *****************************************************************************/
+#define CTRL_PROTOCOL_LENS_STATE_SETTINGS           ( 1u <<  0 )
+#define CTRL_PROTOCOL_LENS_STATE_ACTIVE             ( 1u <<  1 )
+#define CTRL_PROTOCOL_LENS_STATE_INVERT             ( 1u <<  2 )
+#define CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION     ( 1u <<  3 )
+#define CTRL_PROTOCOL_LENS_STATE_FINE_FOCUS         ( 1u <<  4 )
+#define CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION      ( 1u <<  5 )
+#define CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION      ( 1u <<  6 )
+#define CTRL_PROTOCOL_LENS_STATE_FILTER_POSITION    ( 1u <<  7 )
+#define CTRL_PROTOCOL_LENS_STATE_IRIS_APERTURE      ( 1u <<  8 )
+#define CTRL_PROTOCOL_LENS_STATE_IRIS_SETUP         ( 1u <<  9 )
+#define CTRL_PROTOCOL_LENS_STATE_FOCUS_SETTINGS     ( 1u << 10 )
+#define CTRL_PROTOCOL_LENS_STATE_ZOOM_SETTINGS      ( 1u << 11 )
+#define CTRL_PROTOCOL_LENS_STATE_IRIS_SETTINGS      ( 1u << 12 )
+#define CTRL_PROTOCOL_LENS_STATE_FILTER_SETTINGS    ( 1u << 13 )
+
+/**************************************************************************//**
+ * @brief Motor positions followed while a lens motor moves
+ *****************************************************************************/
+#define CTRL_PROTOCOL_LENS_STATE_POSITIONS                  \
+    ( CTRL_PROTOCOL_LENS_STATE_FOCUS_POSITION               \
+    | CTRL_PROTOCOL_LENS_STATE_ZOOM_POSITION                \
+    | CTRL_PROTOCOL_LENS_STATE_IRIS_POSITION )
+
+/**************************************************************************//**
+ * @brief lens driver state, read with one pipelined readout
+ *****************************************************************************/
+typedef struct ctrl_protocol_lens_state_s
+{
+    uint32_t    request;                                    /**< values to read (CTRL_PROTOCOL_LENS_STATE_*) */
+    uint32_t    valid;                                      /**< values read from device */
+    int32_t     settings[NO_VALUES_LENS_SETTINGS];          /**< lens settings */
+    int32_t     active;                                     /**< lens driver active */
+    int32_t     invert[NO_VALUES_LENS_INVERT];              /**< motor direction inversion */
+    int32_t     focus_position;                             /**< focus position */
+    int32_t     fine_focus;                                 /**< fine focus enable */
+    int32_t     zoom_position;                              /**< zoom position */
+    int32_t     iris_position;                              /**< iris position */
+    int32_t     filter_position;                            /**< filter position */
+    int32_t     iris_aperture;                              /**< iris aperture */
+    int32_t     iris_setup[NO_VALUES_LENS_IRIS_SETUP];      /**< iris setup table */
+    int32_t     focus_settings[NO_VALUES_LENS_FOCUS_SETTINGS];  /**< focus motor settings */
+    int32_t     zoom_settings[NO_VALUES_LENS_ZOOM_SETTINGS];    /**< zoom motor settings */
+    int32_t     iris_settings[NO_VALUES_LENS_IRIS_SETTINGS];    /**< iris motor settings */
+    int32_t     filter_settings[NO_VALUES_LENS_FILTER_SETTINGS];/**< filter motor settings */
+} ctrl_protocol_lens_state_t;
+
 /**************************************************************************//**
  * @brief Gets the current lens settings
  *
@@ -535,6 +584,27 @@ int ctrl_protocol_set_lens_filter_settings
 
 
 
+/**************************************************************************//**
+ * @brief Reads several lens driver values at once, the get-commands of all
+ *        values selected in ctrl_protocol_lens_state_t::request are
+ *        pipelined
+ *
+ * @param[in]     channel  control channel instance
+ * @param[in]     protocol control protocol instance
+ * @param[in]     no       size of lens state structure
+ * @param[in,out] values   lens state (ctrl_protocol_lens_state_t), valid
+ *                         flags the values which were read
+ *
+ * @return      0 on success, error-code otherwise
+ *****************************************************************************/
+int ctrl_protocol_get_lens_state
+(
+    ctrl_protocol_handle_t const protocol,
+    ctrl_channel_handle_t const  channel,
+    int const                    no,
+    uint8_t * const              values
+);
+
 ///**************************************************************************//**
 // * @brief Gets the current iris aperture
 // *
@@ -604,6 +674,7 @@ typedef struct ctrl_protocol_lens_drv_s
     ctrl_protocol_int32_array_t     get_lens_filter_settings;
     ctrl_protocol_int32_array_t     set_lens_filter_settings;
 
+    ctrl_protocol_uint8_array_t     get_lens_state;
 
 //    ctrl_protocol_get_int32_t       get_iris_apt;
 //    ctrl_protocol_set_int32_t       set_iris_apt;
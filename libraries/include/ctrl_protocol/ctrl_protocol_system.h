@@ -979,6 +979,80 @@ int ctrl_protocol_set_settings_from_file
     uint8_t * const              settings
 );
 
+/**************************************************************************//**
+ * @brief device command of a pipelined transfer
+ *****************************************************************************/
+typedef struct ctrl_protocol_cmd_s
+{
+    char const *    cmd;        /**< command line including the line feed */
+    int             len;        /**< length of the command line */
+    int             tmo_ms;     /**< response timeout of the command */
+    int             res;        /**< 0 if acknowledged, error-code otherwise */
+} ctrl_protocol_cmd_t;
+
+/**************************************************************************//**
+ * @brief Send several set-commands, pipelined so the device works on the
+ *        next command while the response of the previous one is on the way.
+ *
+ * @param[in]     channel  control channel instance
+ * @param[in]     protocol control protocol instance
+ * @param[in]     no       number of commands
+ * @param[in,out] values   commands (ctrl_protocol_cmd_t), res is set for
+ *                         every command
+ *
+ * @return     number of acknowledged commands, error-code if the link failed
+ *****************************************************************************/
+int ctrl_protocol_send_commands
+(
+    ctrl_protocol_handle_t const handle,
+    ctrl_channel_handle_t const  channel,
+    int const                    no,
+    uint8_t * const              values
+);
+
+/**************************************************************************//**
+ * @brief Line handler of a streamed settings dump, a negative return value
+ *        aborts the dump with this error-code
+ *****************************************************************************/
+typedef int (* ctrl_protocol_line_handler_t)
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+);
+
+/**************************************************************************//**
+ * @brief receiver of a streamed settings dump
+ *****************************************************************************/
+typedef struct ctrl_protocol_line_reader_s
+{
+    ctrl_protocol_line_handler_t    handler;    /**< called for every line */
+    void *                          priv;       /**< context of handler */
+} ctrl_protocol_line_reader_t;
+
+/**************************************************************************//**
+ * @brief Read the device settings line by line, without a size limit.
+ *
+ * @note       Every line of the dump is passed to the handler when it is
+ *             received (including its line feed, without the "OK"
+ *             terminator), the dump is done as soon as the terminator
+ *             arrives.
+ *
+ * @param[in]  channel  control channel instance
+ * @param[in]  protocol control protocol instance
+ * @param[in]  no       number of values (sizeof(ctrl_protocol_line_reader_t))
+ * @param[in]  values   receiver (ctrl_protocol_line_reader_t)
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int ctrl_protocol_read_settings
+(
+    ctrl_protocol_handle_t const handle,
+    ctrl_channel_handle_t const  channel,
+    int const                    no,
+    uint8_t * const              values
+);
+
 /**************************************************************************//**
  * @brief System protocol driver implementation
  *****************************************************************************/
@@ -1034,6 +1108,8 @@ typedef struct ctrl_protocol_sys_drv_s
     ctrl_protocol_uint8_array_t     copy_settings;
     ctrl_protocol_uint8_array_t     get_device_settings;
     ctrl_protocol_uint8_array_t     set_device_settings;
+    ctrl_protocol_uint8_array_t     send_commands;
+    ctrl_protocol_uint8_array_t     read_device_settings;
 } ctrl_protocol_sys_drv_t;
 
 /******************************************************************************
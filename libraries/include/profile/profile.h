@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    profile.h
+ *
+ * @brief   Binary device profile container
+ *
+ * @note    A profile file is a header followed by sections. Every section
+ *          belongs to a subsystem, carries a name (the settings group it
+ *          was written from) and an opaque payload, and is protected by its
+ *          own CRC-32, so a damaged section is detected without rejecting
+ *          the rest of the file. All numbers are little endian, sections
+ *          start 4-byte aligned.
+ *
+ *          file header (16 bytes)
+ *              uint32  magic       PROFILE_MAGIC
+ *              uint16  version     PROFILE_VERSION
+ *              uint16  count       number of sections
+ *              uint32  size        file size in bytes
+ *              uint32  crc         CRC-32 of the first 12 bytes
+ *
+ *          section header (16 bytes), then name, payload and padding
+ *              uint16  subsystem   profile_subsystem_t
+ *              uint16  name_len    length of the name in bytes
+ *              uint32  size        length of the payload in bytes
+ *              uint32  crc         CRC-32 of name and payload
+ *              uint32  reserved    0
+ *
+ *          The reader works on a buffer holding the complete file, e.g. a
+ *          memory mapped file, and never copies payloads.
+ *
+ *****************************************************************************/
+#ifndef __PROFILE_H__
+#define __PROFILE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @brief file identification
+ *****************************************************************************/
+#define PROFILE_MAGIC               ( 0x50544344u )     /**< "DCTP" */
+#define PROFILE_VERSION             ( 1u )
+
+#define PROFILE_HEADER_SIZE         ( 16u )
+#define PROFILE_SECTION_HEADER_SIZE ( 16u )
+
+/******************************************************************************
+ * @brief subsystem of a section
+ *****************************************************************************/
+typedef enum profile_subsystem_e
+{
+    PROFILE_SUBSYSTEM_GENERIC   = 0,    /**< anything else */
+    PROFILE_SUBSYSTEM_DEVICE    = 1,    /**< device identification */
+    PROFILE_SUBSYSTEM_ISP       = 2,    /**< white balance, black level, filter, in/out */
+    PROFILE_SUBSYSTEM_LUT       = 3,    /**< LUT and LUT presets */
+    PROFILE_SUBSYSTEM_MCC       = 4,    /**< multi colour control */
+    PROFILE_SUBSYSTEM_KNEE      = 5,    /**< knee function */
+    PROFILE_SUBSYSTEM_DPCC      = 6,    /**< defect pixel correction */
+    PROFILE_SUBSYSTEM_LENS      = 7,    /**< lens driver */
+    PROFILE_SUBSYSTEM_COMMANDS  = 8,    /**< device command dump */
+    PROFILE_SUBSYSTEM_MAX
+} profile_subsystem_t;
+
+/******************************************************************************
+ * @brief section of a profile, name and data point into the file buffer
+ *****************************************************************************/
+typedef struct profile_section_s
+{
+    uint16_t            subsystem;      /**< profile_subsystem_t */
+    uint16_t            name_len;       /**< length of name */
+    uint32_t            size;           /**< length of data */
+    char const *        name;           /**< section name, not zero terminated */
+    uint8_t const *     data;           /**< payload */
+} profile_section_t;
+
+/**************************************************************************//**
+ * @brief      Update a CRC-32 (IEEE 802.3, as used by zip and png)
+ *
+ * @param[in]  crc      CRC of the preceding data, 0 to start
+ * @param[in]  data     data to add
+ * @param[in]  len      length of data in bytes
+ *
+ * @return     updated CRC
+ *****************************************************************************/
+uint32_t profile_crc32
+(
+    uint32_t            crc,
+    void const * const  data,
+    size_t const        len
+);
+
+/**************************************************************************//**
+ * @brief      Space a section takes in a file
+ *
+ * @param[in]  name_len length of the section name
+ * @param[in]  size     length of the payload
+ *
+ * @return     bytes including header and padding
+ *****************************************************************************/
+size_t profile_section_size
+(
+    uint16_t const      name_len,
+    uint32_t const      size
+);
+
+/**************************************************************************//**
+ * @brief      Write the file header
+ *
+ * @param[out] buf      buffer of at least PROFILE_HEADER_SIZE bytes
+ * @param[in]  count    number of sections
+ * @param[in]  size     file size in bytes
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int profile_write_header
+(
+    uint8_t * const     buf,
+    uint16_t const      count,
+    uint32_t const      size
+);
+
+/**************************************************************************//**
+ * @brief      Write a section
+ *
+ * @param[out] buf      buffer of at least profile_section_size bytes
+ * @param[in]  section  section to write
+ *
+ * @return     number of bytes written, error-code (< 0) otherwise
+ *****************************************************************************/
+int profile_write_section
+(
+    uint8_t * const                 buf,
+    profile_section_t const * const section
+);
+
+/**************************************************************************//**
+ * @brief      Check the file header
+ *
+ * @param[in]  buf      file contents
+ * @param[in]  len      length of buf in bytes
+ * @param[out] count    number of sections
+ *
+ * @return     0 on success, -EINVAL if buf is no profile or truncated,
+ *             -EILSEQ on a header checksum error
+ *****************************************************************************/
+int profile_read_header
+(
+    uint8_t const * const   buf,
+    size_t const            len,
+    uint16_t * const        count
+);
+
+/**************************************************************************//**
+ * @brief      Read the section at an offset and advance the offset
+ *
+ * @note       Start with offset PROFILE_HEADER_SIZE. The offset is advanced
+ *             past a section with a checksum error as well, so the remaining
+ *             sections can still be read.
+ *
+ * @param[in]  buf      file contents
+ * @param[in]  len      length of buf in bytes
+ * @param[in]  offset   offset of the section, offset of the next on return
+ * @param[out] section  section found
+ *
+ * @return     0 on success, -EINVAL if the section exceeds the file,
+ *             -EILSEQ on a section checksum error
+ *****************************************************************************/
+int profile_read_section
+(
+    uint8_t const * const       buf,
+    size_t const                len,
+    size_t * const              offset,
+    profile_section_t * const   section
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROFILE_H__ */
@@ -0,0 +1,160 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_codec.h
+ *
+ * @brief   Allocation-free encoder and decoder of integer commands
+ *
+ * @note    The CMD_SET_* format strings of the provideo protocol are compiled
+ *          once into command descriptors (literal text plus a list of integer
+ *          conversions). Encoding and decoding then only walks the descriptor,
+ *          without the format parsing, locale handling and va_list overhead
+ *          of vsnprintf and vsscanf.
+ *
+ *          Supported are the conversions %i, %d, %u and %x without flags,
+ *          width or length modifier. Other format strings (%s, %[, %n, %f,
+ *          widths, ...) are reported as unsupported and have to be handled
+ *          by the standard library.
+ *
+ *****************************************************************************/
+#ifndef __PROVIDEO_PROTOCOL_CODEC_H__
+#define __PROVIDEO_PROTOCOL_CODEC_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @defgroup provideo_protocol_codec Provideo protocol command codec
+ * @{
+ *****************************************************************************/
+
+/**************************************************************************//**
+ * @brief maximal number of integer conversions in a command descriptor
+ *****************************************************************************/
+#define CMD_DESC_MAX_PARAMS         ( 32u )
+
+/**************************************************************************//**
+ * @brief maximal length of a format string compiled into a descriptor
+ *****************************************************************************/
+#define CMD_DESC_MAX_FORMAT_LENGTH  ( 255u )
+
+/**************************************************************************//**
+ * @brief number of command descriptors kept in the descriptor cache
+ *****************************************************************************/
+#define CMD_DESC_CACHE_SIZE         ( 512u )
+
+/**************************************************************************//**
+ * @brief command descriptor
+ *
+ * @note  The descriptor consists of no + 1 literals, literal k is followed by
+ *        conversion k. Literals are referenced by offset into the format.
+ *****************************************************************************/
+typedef struct cmd_desc_s
+{
+    char const *    fmt;                                /**< compiled format string */
+    uint8_t         supported;                          /**< format can be handled by the codec */
+    uint8_t         no;                                 /**< number of conversions */
+    uint8_t         lit_offset[CMD_DESC_MAX_PARAMS + 1];/**< offset of literal in format */
+    uint8_t         lit_length[CMD_DESC_MAX_PARAMS + 1];/**< length of literal */
+    char            conv[CMD_DESC_MAX_PARAMS];          /**< conversion character (i, d, u or x) */
+} cmd_desc_t;
+
+/**************************************************************************//**
+ * @brief      Compile a format string into a command descriptor
+ *
+ * @param[in]  fmt      format string (e.g. CMD_SET_LSC)
+ * @param[out] desc     resulting descriptor
+ *
+ * @return     0 on success, -ENOSYS if the format is not supported by the
+ *             codec, error-code otherwise
+ *****************************************************************************/
+int cmd_desc_compile
+(
+    char const * const  fmt,
+    cmd_desc_t * const  desc
+);
+
+/**************************************************************************//**
+ * @brief      Get the command descriptor of a format string
+ *
+ * @note       Descriptors are cached by the address of the format string,
+ *             which is a CMD_* string literal in all protocol modules. If the
+ *             cache is full the descriptor is compiled into tmp. The cache is
+ *             not thread-safe, like the rest of the protocol layer it is only
+ *             used from one thread.
+ *
+ * @param[in]  fmt      format string
+ * @param[in]  tmp      descriptor memory used if the cache is full
+ *
+ * @return     descriptor, NULL if the format is not supported
+ *****************************************************************************/
+cmd_desc_t const * cmd_desc_get
+(
+    char const * const  fmt,
+    cmd_desc_t * const  tmp
+);
+
+/**************************************************************************//**
+ * @brief      Encode a command with integer parameters (like snprintf)
+ *
+ * @param[in]  desc     command descriptor
+ * @param[out] buf      command buffer, always '\0' terminated on success
+ * @param[in]  size     size of command buffer
+ * @param[in]  values   array of desc->no parameter values
+ *
+ * @return     length of command without '\0', error-code otherwise
+ *             (-EFAULT if the command does not fit into the buffer)
+ *****************************************************************************/
+int cmd_encode_int
+(
+    cmd_desc_t const * const    desc,
+    char * const                buf,
+    int const                   size,
+    int32_t const * const       values
+);
+
+/**************************************************************************//**
+ * @brief      Decode integer parameters from a response line (like sscanf)
+ *
+ * @note       Same matching rules as sscanf: whitespace in the format
+ *             matches any amount of whitespace, %i accepts decimal, octal
+ *             and 0x-prefixed hex numbers, %x accepts an optional 0x prefix.
+ *
+ * @param[in]  desc     command descriptor
+ * @param[in]  s        '\0' terminated string to parse
+ * @param[out] values   array of at least desc->no values
+ *
+ * @return     number of decoded values, -1 (EOF) if the string ended before
+ *             the first conversion
+ *****************************************************************************/
+int cmd_decode_int
+(
+    cmd_desc_t const * const    desc,
+    char const *                s,
+    int32_t * const             values
+);
+
+/* @} provideo_protocol_codec */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROVIDEO_PROTOCOL_CODEC_H__ */
@@ -28,6 +28,7 @@ extern "C" {
 #endif
 
 #include <ctrl_protocol/ctrl_protocol.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
 
 #include <time.h>
 
@@ -327,6 +328,29 @@ int get_param_settings_string
     char *                       param
 );
 
+/******************************************************************************
+ * @brief Sends a given get-command to provideo device and passes the lines of
+ *        its (arbitrarily long) response to a line handler as they arrive
+ *
+ * @param[in]   channel         control channel to use
+ * @param[in]   cmd_get         command string to readout parameter fron device
+ * @param[in]   handler         line handler, called for every line except
+ *                              the "OK" terminator
+ * @param[in]   priv            private context of the line handler
+ * @param[in]   tmo_ms          timeout in ms, counts from the last data
+ *
+ * @return     0 on success, -ENOMEM if a line was too long for the reader,
+ *             error-code otherwise
+ *****************************************************************************/
+int get_param_lines
+(
+    ctrl_channel_handle_t const  channel,
+    char * const                 cmd_get,
+    cmd_reader_line_t const      handler,
+    void * const                 priv,
+    int const                    tmo_ms
+);
+
 /******************************************************************************
  * @brief Sends a given set-command to provideo device and transmitts a string
  *
@@ -407,6 +431,49 @@ int get_param_int_X_with_tmo
     ...
 );
 
+/******************************************************************************
+ * @brief maximal number of get-commands sent in one pipelined request, keeps
+ *        the queued commands well inside the receive buffer of the device
+ *****************************************************************************/
+#define CMD_BATCH_DEPTH                     ( 4 )
+
+/******************************************************************************
+ * @brief set-commands with a longer timeout are not pipelined, they change
+ *        the device mode and may discard queued input meanwhile
+ *****************************************************************************/
+#define CMD_BATCH_MAX_TMO                   ( 3000 )
+
+/******************************************************************************
+ * @brief get-command of a pipelined readout, see get_param_int_batch
+ *****************************************************************************/
+typedef struct cmd_batch_item_s
+{
+    char const *    cmd_get;    /**< command string to readout parameter from device */
+    char const *    cmd_sync;   /**< command string to find the response line */
+    char const *    cmd_set;    /**< formatted command string to parse the response line */
+    int             no;         /**< number of integer parameters */
+    int32_t *       values;     /**< parsed parameters */
+    int             res;        /**< number of parsed parameters or error-code */
+} cmd_batch_item_t;
+
+/******************************************************************************
+ * @brief Sends several get-commands with integer parameters and parses the
+ *        responses, up to CMD_BATCH_DEPTH commands share one request so the
+ *        link turns around once per batch instead of once per command
+ *
+ * @param[in]      channel  control channel to use
+ * @param[in,out]  items    get-commands, res is set for every command
+ * @param[in]      no       number of get-commands
+ *
+ * @return     0 if all commands were answered, error-code otherwise
+ *****************************************************************************/
+int get_param_int_batch
+(
+    ctrl_channel_handle_t const     channel,
+    cmd_batch_item_t * const        items,
+    int const                       no
+);
+
 /******************************************************************************
  * @brief Send a set command with a variable bumber of interger parameters
  *
@@ -442,6 +509,56 @@ int set_param_int_X_with_tmo
     ...
 );
 
+/******************************************************************************
+ * @brief Sends a complete set-command line and evaluates the response, or
+ *        hands it to the deferred command receiver of the channel
+ *        (see ctrl_channel_set_defer)
+ *
+ * @param[in]   channel control channel to use
+ * @param[in]   cmd     command line including the line feed
+ * @param[in]   len     length of the command line
+ * @param[in]   tmo_ms  time in ms that is waited until timeout (command failed)
+ *
+ * @return     0 on success or if deferred, error-code otherwise
+ *****************************************************************************/
+int send_set_request
+(
+    ctrl_channel_handle_t const channel,
+    char * const                cmd,
+    int const                   len,
+    int const                   tmo_ms
+);
+
+/******************************************************************************
+ * @brief set-command of a pipelined transfer, see set_param_batch
+ *****************************************************************************/
+typedef struct cmd_set_item_s
+{
+    char const *    cmd;        /**< command line including the line feed */
+    int             len;        /**< length of the command line */
+    int             tmo_ms;     /**< response timeout of the command */
+    int             res;        /**< 0 if acknowledged, error-code otherwise */
+} cmd_set_item_t;
+
+/******************************************************************************
+ * @brief Sends several set-commands in pipelined requests, up to
+ *        CMD_BATCH_DEPTH commands share one request; a command with a
+ *        timeout above CMD_BATCH_MAX_TMO (e.g. a video mode change) is
+ *        sent on its own
+ *
+ * @param[in]      channel  control channel to use
+ * @param[in,out]  items    set-commands, res is set for every command
+ * @param[in]      no       number of set-commands
+ *
+ * @return     number of acknowledged commands, error-code if the link failed
+ *****************************************************************************/
+int set_param_batch
+(
+    ctrl_channel_handle_t const     channel,
+    cmd_set_item_t * const          items,
+    int const                       no
+);
+
 /* @} command_common */
 
 #ifdef __cplusplus
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_reader.h
+ *
+ * @brief   Streaming line reader for provideo device responses
+ *
+ * @note    The reader consumes every received byte exactly once. Complete
+ *          lines are passed to a per-command line handler, "OK" and "FAIL"
+ *          terminators and "ERROR: ..." messages are recognized once per
+ *          line, so multi-line responses are parsed in linear time without
+ *          rescanning a growing receive buffer.
+ *
+ *****************************************************************************/
+#ifndef __PROVIDEO_PROTOCOL_READER_H__
+#define __PROVIDEO_PROTOCOL_READER_H__
+
+#include <stdint.h>
+
+#include <ctrl_channel/ctrl_channel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @defgroup provideo_protocol_reader Provideo protocol response reader
+ * @{
+ *****************************************************************************/
+
+/**************************************************************************//**
+ * @brief maximal length of a response line (including line end)
+ *****************************************************************************/
+#define CMD_READER_LINE_SIZE        ( 256 )
+
+/**************************************************************************//**
+ * @brief line handler, called for every complete response line which is
+ *        not empty, including terminators and error messages
+ *
+ * @param[in]  priv     private context of the handler
+ * @param[in]  line     '\0' terminated line including its line end
+ * @param[in]  len      length of line
+ *
+ * @return     0 to continue, error-code to abort reading
+ *****************************************************************************/
+typedef int (* cmd_reader_line_t)
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+);
+
+/**************************************************************************//**
+ * @brief reader states
+ *****************************************************************************/
+typedef enum cmd_reader_state_e
+{
+    CMD_READER_STATE_BUSY   = 0,    /**< no terminator received yet */
+    CMD_READER_STATE_OK     = 1,    /**< "OK" received */
+    CMD_READER_STATE_FAIL   = 2,    /**< "FAIL" received */
+    CMD_READER_STATE_ABORT  = 3,    /**< line handler aborted reading */
+} cmd_reader_state_t;
+
+/**************************************************************************//**
+ * @brief how long cmd_reader_receive waits for data
+ *****************************************************************************/
+typedef enum cmd_reader_wait_e
+{
+    CMD_READER_WAIT_TERMINATOR = 0, /**< until terminator, timeout counts from start */
+    CMD_READER_WAIT_IDLE       = 1, /**< until terminator, timeout counts from last data */
+    CMD_READER_WAIT_TIMEOUT    = 2, /**< until timeout (replies of several devices) */
+} cmd_reader_wait_t;
+
+/**************************************************************************//**
+ * @brief response reader context
+ *****************************************************************************/
+typedef struct cmd_reader_s
+{
+    cmd_reader_line_t   handler;                    /**< line handler (may be NULL) */
+    void *              priv;                       /**< private context of line handler */
+    char                line[CMD_READER_LINE_SIZE]; /**< line under construction */
+    int                 len;                        /**< length of line under construction */
+    int                 discard;                    /**< line too long, skip until line end */
+    int                 discarded;                  /**< number of lines skipped as too long */
+    cmd_reader_state_t  state;                      /**< reader state */
+    int                 error;                      /**< error-code of ERROR message or handler */
+    int                 terminators;                /**< number of "OK" and "FAIL" lines */
+} cmd_reader_t;
+
+/**************************************************************************//**
+ * @brief      Initialize a response reader
+ *
+ * @param[out] reader   reader context
+ * @param[in]  handler  line handler (may be NULL)
+ * @param[in]  priv     private context of line handler
+ *****************************************************************************/
+void cmd_reader_init
+(
+    cmd_reader_t * const    reader,
+    cmd_reader_line_t const handler,
+    void * const            priv
+);
+
+/**************************************************************************//**
+ * @brief      Feed received bytes into a response reader
+ *
+ * @note       Lines received after a terminator are still passed to the
+ *             line handler, an "OK" overrides an earlier "FAIL".
+ *
+ * @param[in]  reader   reader context
+ * @param[in]  data     received bytes
+ * @param[in]  len      number of received bytes
+ *
+ * @return     reader state after consuming the data
+ *****************************************************************************/
+cmd_reader_state_t cmd_reader_feed
+(
+    cmd_reader_t * const    reader,
+    char const * const      data,
+    int const               len
+);
+
+/**************************************************************************//**
+ * @brief      Result of a response reader
+ *
+ * @param[in]  reader   reader context
+ *
+ * @return     0 after "OK", error-code after "FAIL" or abort, -EILSEQ if no
+ *             terminator was received
+ *****************************************************************************/
+int cmd_reader_result
+(
+    cmd_reader_t const * const reader
+);
+
+/**************************************************************************//**
+ * @brief      Receive a response from a control channel
+ *
+ * @note       Every terminated response is counted at the channel, see
+ *             ctrl_channel_count_response. With CMD_READER_WAIT_TERMINATOR
+ *             the wait for the first byte adapts to the observed response
+ *             times of the command, see provideo_protocol_timing.h.
+ *
+ * @param[in]  reader   initialized reader context
+ * @param[in]  channel  control channel to receive from
+ * @param[in]  wait     wait mode
+ * @param[in]  tmo_ms   timeout in ms
+ *
+ * @return     see cmd_reader_result
+ *****************************************************************************/
+int cmd_reader_receive
+(
+    cmd_reader_t * const        reader,
+    ctrl_channel_handle_t const channel,
+    cmd_reader_wait_t const     wait,
+    int const                   tmo_ms
+);
+
+/**************************************************************************//**
+ * @brief      Receive the responses of several pipelined commands
+ *
+ * @note       The commands have to be sent in one request, every "OK" or
+ *             "FAIL" terminates the response of one command. Reading stops
+ *             after count terminators, or when the line is idle for tmo_ms.
+ *             Pipelined responses are counted at the channel but not timed.
+ *
+ * @param[in]  reader   initialized reader context
+ * @param[in]  channel  control channel to receive from
+ * @param[in]  count    number of expected responses
+ * @param[in]  tmo_ms   idle timeout in ms
+ *
+ * @return     number of terminated responses, error-code if the line handler
+ *             aborted reading
+ *****************************************************************************/
+int cmd_reader_receive_count
+(
+    cmd_reader_t * const        reader,
+    ctrl_channel_handle_t const channel,
+    int const                   count,
+    int const                   tmo_ms
+);
+
+/* @} provideo_protocol_reader */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROVIDEO_PROTOCOL_READER_H__ */
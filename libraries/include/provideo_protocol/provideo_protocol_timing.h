@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_timing.h
+ *
+ * @brief   Adaptive response deadlines of provideo commands
+ *
+ * @note    The response times of every command are recorded per line rate.
+ *          Once a command has been answered often enough, the reader waits
+ *          for its first response byte only a multiple of the slowest
+ *          recently observed response plus the time the line needs to carry
+ *          request and response. A dead bus is detected after tens of
+ *          milliseconds instead of the full timeout.
+ *
+ *          A device which only paused (flash write, mode change) still sends
+ *          the response given up at the deadline. The reader notes it at the
+ *          channel and skips it in front of the next response, and the next
+ *          request waits the full timeout, so responses never shift by one
+ *          command.
+ *
+ *          The timeout given by the caller stays the upper bound, extended by
+ *          the serialization time at slow line rates. Commands with a
+ *          timeout above CMD_TIMING_MAX_ADAPTIVE_TMO do real work on the
+ *          device (video mode switch, flash access) and keep their fixed
+ *          timeout.
+ *
+ *****************************************************************************/
+#ifndef __PROVIDEO_PROTOCOL_TIMING_H__
+#define __PROVIDEO_PROTOCOL_TIMING_H__
+
+#include <stdint.h>
+
+#include <ctrl_channel/ctrl_channel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @defgroup provideo_protocol_timing Provideo protocol response deadlines
+ * @{
+ *****************************************************************************/
+
+/**************************************************************************//**
+ * @brief number of commands with response statistics (direct mapped)
+ *****************************************************************************/
+#define CMD_TIMING_TABLE_SIZE           ( 256u )
+
+/**************************************************************************//**
+ * @brief number of response times kept per command
+ *****************************************************************************/
+#define CMD_TIMING_NO_SAMPLES           ( 32 )
+
+/**************************************************************************//**
+ * @brief number of responses needed before the deadline adapts
+ *****************************************************************************/
+#define CMD_TIMING_MIN_SAMPLES          ( 8 )
+
+/**************************************************************************//**
+ * @brief deadline as multiple of the slowest recent response
+ *****************************************************************************/
+#define CMD_TIMING_FACTOR               ( 3 )
+
+/**************************************************************************//**
+ * @brief scheduling jitter of the host in ms (timer resolution, task switch)
+ *****************************************************************************/
+#define CMD_TIMING_SLACK_MS             ( 20 )
+
+/**************************************************************************//**
+ * @brief shortest adaptive deadline in ms
+ *****************************************************************************/
+#define CMD_TIMING_MIN_TMO_MS           ( 30 )
+
+/**************************************************************************//**
+ * @brief commands with a longer timeout are not adapted
+ *****************************************************************************/
+#define CMD_TIMING_MAX_ADAPTIVE_TMO     ( 1000 )
+
+/**************************************************************************//**
+ * @brief bits on the line per byte (8N1)
+ *****************************************************************************/
+#define CMD_TIMING_BITS_PER_BYTE        ( 10u )
+
+/**************************************************************************//**
+ * @brief deadlines of the command in flight
+ *****************************************************************************/
+typedef struct cmd_timing_s
+{
+    uint32_t    key;            /**< command and line rate, 0 if not tracked */
+    uint32_t    line_rate;      /**< line rate in bits/s, 0 if unknown */
+    int         request_len;    /**< length of the request */
+    int         deadline;       /**< ms to wait for the first response byte */
+    int         timeout;        /**< ms to wait for the complete response */
+} cmd_timing_t;
+
+/**************************************************************************//**
+ * @brief      Serialization time of data on a line
+ *
+ * @param[in]  line_rate    line rate in bits/s, 0 if unknown
+ * @param[in]  len          number of bytes
+ *
+ * @return     time in ms (rounded up), 0 if the line rate is unknown
+ *****************************************************************************/
+int cmd_timing_line_time
+(
+    uint32_t const  line_rate,
+    int const       len
+);
+
+/**************************************************************************//**
+ * @brief      Get the deadlines for the response of the last request
+ *
+ * @param[out] timing   deadlines of the command
+ * @param[in]  channel  control channel the request was sent over
+ * @param[in]  tmo_ms   timeout given by the caller
+ *****************************************************************************/
+void cmd_timing_start
+(
+    cmd_timing_t * const        timing,
+    ctrl_channel_handle_t const channel,
+    int const                   tmo_ms
+);
+
+/**************************************************************************//**
+ * @brief      Record the response time of a command
+ *
+ * @param[in]  timing       deadlines returned by cmd_timing_start
+ * @param[in]  elapsed_ms   time from request to terminator or timeout
+ * @param[in]  received     number of received response bytes
+ * @param[in]  terminated   response was terminated by OK or FAIL
+ *****************************************************************************/
+void cmd_timing_finish
+(
+    cmd_timing_t const * const  timing,
+    int const                   elapsed_ms,
+    int const                   received,
+    int const                   terminated
+);
+
+/**************************************************************************//**
+ * @brief      Drop all recorded response times
+ *****************************************************************************/
+void cmd_timing_reset( void );
+
+/* @} provideo_protocol_timing */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROVIDEO_PROTOCOL_TIMING_H__ */
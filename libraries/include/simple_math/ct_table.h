@@ -0,0 +1,231 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#ifndef __CT_TABLE_H__
+#define __CT_TABLE_H__
+
+#include <stdint.h>
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @brief maximal number of entries of a color temperature table
+ *****************************************************************************/
+#define CT_TABLE_MAX_SIZE           ( 2048 )
+
+/******************************************************************************
+ * @brief lowest color temperature of a table, the daylight locus of
+ *        CorColorTemptoXYZ turns back below about 2250 K
+ *****************************************************************************/
+#define CT_TABLE_CT_MIN             ( 2500.0 )
+
+/******************************************************************************
+ * @brief maximal order of a fitted gain curve
+ *****************************************************************************/
+#define CT_FIT_MAX_ORDER            ( 2 )
+
+/******************************************************************************
+ * @brief maximal number of calibration points of a gain curve fit
+ *****************************************************************************/
+#define CT_FIT_MAX_POINTS           ( 64 )
+
+/******************************************************************************
+ * @brief entry of a color temperature table
+ *****************************************************************************/
+typedef struct ct_table_entry_s
+{
+    double  ct;                     /**< correlated color temperature (K) */
+    double  xyz[3];                 /**< XYZ of the illuminant, see CorColorTemptoXYZ */
+    double  u;                      /**< CIE 1960 chromaticity u */
+    double  v;                      /**< CIE 1960 chromaticity v */
+    double  red;                    /**< red white-balance gain (green = 1.0) */
+    double  blue;                   /**< blue white-balance gain (green = 1.0) */
+} ct_table_entry_t;
+
+/******************************************************************************
+ * @brief color temperature table, equidistant in color temperature
+ *
+ * @note  The table is large (about 128 KiB), allocate it on the heap.
+ *****************************************************************************/
+typedef struct ct_table_s
+{
+    double              ct_min;                     /**< color temperature of entry 0 */
+    double              ct_step;                    /**< distance of two entries */
+    int                 size;                       /**< number of entries */
+    int                 has_gains;                  /**< gains are valid */
+    ct_table_entry_t    entry[CT_TABLE_MAX_SIZE];   /**< table entries */
+} ct_table_t;
+
+/******************************************************************************
+ * @brief white-balance gain curves over the reciprocal color temperature
+ *        (mired), gain = c[0] + c[1] * mired + c[2] * mired^2
+ *****************************************************************************/
+typedef struct ct_fit_s
+{
+    int     order;                          /**< order of both polynomials */
+    double  red[CT_FIT_MAX_ORDER + 1];      /**< coefficients of the red gain */
+    double  blue[CT_FIT_MAX_ORDER + 1];     /**< coefficients of the blue gain */
+} ct_fit_t;
+
+/**************************************************************************//**
+ * @brief      Compute a color temperature table
+ *
+ * @note       Every entry is computed once with CorColorTemptoXYZ, the gains
+ *             are set to 1.0 until a camera matrix is given.
+ *
+ * @param[in]  ct_min   color temperature of the first entry (K, at least
+ *                      CT_TABLE_CT_MIN)
+ * @param[in]  ct_max   color temperature of the last entry (K)
+ * @param[in]  ct_step  distance of two entries (K)
+ * @param[out] table    resulting table
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_ct_table_calc
+(
+    double const        ct_min,
+    double const        ct_max,
+    double const        ct_step,
+    ct_table_t * const  table
+);
+
+/**************************************************************************//**
+ * @brief      Compute the white-balance gains of all entries
+ *
+ * @note       The gains map the camera RGB of every illuminant to grey,
+ *             camera RGB = rgb2xyz^-1 * XYZ.
+ *
+ * @param[in]  table    table to update
+ * @param[in]  rgb2xyz  camera RGB to XYZ matrix (row major, 9 values)
+ *
+ * @return     0 on success, -EINVAL if the matrix is singular, -ERANGE if an
+ *             illuminant has no positive camera RGB
+ *****************************************************************************/
+int sm_ct_table_set_camera
+(
+    ct_table_t * const      table,
+    double const * const    rgb2xyz
+);
+
+/**************************************************************************//**
+ * @brief      Compute the white-balance gains of a single color
+ *
+ * @param[in]  rgb2xyz  camera RGB to XYZ matrix (row major, 9 values)
+ * @param[in]  xyz      XYZ of the color (3 values)
+ * @param[out] red      red gain (green = 1.0)
+ * @param[out] blue     blue gain (green = 1.0)
+ *
+ * @return     0 on success, -EINVAL if the matrix is singular, -ERANGE if
+ *             the color has no positive camera RGB
+ *****************************************************************************/
+int sm_ct_gains
+(
+    double const * const    rgb2xyz,
+    double const * const    xyz,
+    double * const          red,
+    double * const          blue
+);
+
+/**************************************************************************//**
+ * @brief      Interpolate the table at a color temperature
+ *
+ * @param[in]  table    table to use
+ * @param[in]  ct       color temperature (K)
+ * @param[out] entry    interpolated entry
+ *
+ * @return     0 on success, -ERANGE if ct is outside of the table
+ *****************************************************************************/
+int sm_ct_table_lookup
+(
+    ct_table_t const * const    table,
+    double const                ct,
+    ct_table_entry_t * const    entry
+);
+
+/**************************************************************************//**
+ * @brief      Find the color temperature of a XYZ sample
+ *
+ * @note       The sample is projected on the nearest segment of the locus in
+ *             the CIE 1960 uv plane. The segment is found by a binary search
+ *             on the direction of the locus, which holds for samples closer
+ *             to the locus than its radius of curvature (all practical
+ *             illuminants), a lookup costs log2(size) steps.
+ *
+ * @param[in]  table    table to use
+ * @param[in]  xyz      XYZ of the sample (3 values)
+ * @param[out] ct       color temperature (K)
+ * @param[out] duv      signed distance to the locus, positive above (may
+ *                      be NULL)
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_ct_table_find
+(
+    ct_table_t const * const    table,
+    double const * const        xyz,
+    double * const              ct,
+    double * const              duv
+);
+
+/**************************************************************************//**
+ * @brief      Fit the red and blue gain curves through calibration points
+ *
+ * @note       Least squares in mired, the order is the number of points
+ *             minus one, at most CT_FIT_MAX_ORDER.
+ *
+ * @param[in]  no       number of points (1..CT_FIT_MAX_POINTS)
+ * @param[in]  ct       color temperatures of the points (K)
+ * @param[in]  red      red gains of the points
+ * @param[in]  blue     blue gains of the points
+ * @param[out] fit      fitted curves
+ *
+ * @return     0 on success, -EINVAL if the points do not define the curves
+ *****************************************************************************/
+int sm_ct_fit_gains
+(
+    int const               no,
+    double const * const    ct,
+    double const * const    red,
+    double const * const    blue,
+    ct_fit_t * const        fit
+);
+
+/**************************************************************************//**
+ * @brief      Evaluate fitted gain curves
+ *
+ * @param[in]  fit      fitted curves
+ * @param[in]  ct       color temperature (K)
+ * @param[out] red      red gain
+ * @param[out] blue     blue gain
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_ct_fit_eval
+(
+    ct_fit_t const * const  fit,
+    double const            ct,
+    double * const          red,
+    double * const          blue
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CT_TABLE_H__ */
@@ -184,6 +184,32 @@ int sm_cubic_spline_interpolation_calc
     spline_interpolation_sample_type_t * const  y
 );
 
+/**************************************************************************//**
+ * @brief      Run cubic spline interpolation for an equidistant range of x
+ *
+ * @note       Computes y[k] = S(x0 + k * step) for k = 0..no-1 with the same
+ *             rounding and clipping as sm_cubic_spline_interpolation_calc.
+ *             The segments are walked once in ascending order and the
+ *             polynomial coefficients are set up once per segment, so a
+ *             complete 4096 or 65536 entry table is computed in one pass.
+ *
+ * @param[in]  ctx  pointer to interpolation context
+ * @param[in]  x0   x coordinate of first sample point to interpolate
+ * @param[in]  step distance between two sample points (> 0)
+ * @param[out] y    resulting y coordinates (array of no elements)
+ * @param[in]  no   number of sample points to interpolate
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_cubic_spline_interpolation_calc_range
+(
+    spline_interpolation_ctx_t * const          ctx,
+    spline_interpolation_sample_type_t const    x0,
+    spline_interpolation_sample_type_t const    step,
+    spline_interpolation_sample_type_t * const  y,
+    unsigned const                              no
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,178 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#ifndef __GAMMA_TABLE_H__
+#define __GAMMA_TABLE_H__
+
+#include <stdint.h>
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @brief maximal bit-width of a transfer-function table
+ *****************************************************************************/
+#define GAMMA_TABLE_MAX_BIT_WIDTH   ( 16u )
+#define GAMMA_TABLE_MAX_SIZE        ( 1u << GAMMA_TABLE_MAX_BIT_WIDTH )
+
+/******************************************************************************
+ * @brief number of tables held in a gamma table cache
+ *****************************************************************************/
+#define GAMMA_TABLE_CACHE_SIZE      ( 4u )
+
+/******************************************************************************
+ * @brief transfer-function curves
+ *****************************************************************************/
+typedef enum gamma_table_curve_e
+{
+    GAMMA_TABLE_CURVE_GAMMA = 0,    /**< gamma curve with linear part, see sm_gamma_float */
+    GAMMA_TABLE_CURVE_PQ    = 1,    /**< Rec. 2100 PQ, see sm_pq */
+    GAMMA_TABLE_CURVE_HLG   = 2,    /**< Rec. 2100 HLG, see sm_hlg */
+    GAMMA_TABLE_CURVE_MAX
+} gamma_table_curve_t;
+
+/******************************************************************************
+ * @brief parameters of GAMMA_TABLE_CURVE_GAMMA (ignored for PQ and HLG),
+ *        same meaning as the parameters of sm_gamma_float
+ *****************************************************************************/
+typedef struct gamma_table_params_s
+{
+    float   kink;                   /**< end of linear part */
+    float   linear_contrast;        /**< slope in linear part */
+    float   linear_brightness;      /**< offset in linear part */
+    float   contrast;               /**< slope */
+    float   gamma;                  /**< exponent */
+    float   brightness;             /**< offset */
+} gamma_table_params_t;
+
+/******************************************************************************
+ * @brief transfer-function table
+ *****************************************************************************/
+typedef struct gamma_table_s
+{
+    gamma_table_curve_t     curve;                      /**< curve of table */
+    gamma_table_params_t    params;                     /**< curve parameters */
+    uint8_t                 bit_width;                  /**< bit-width of input and output */
+    uint32_t                age;                        /**< last use, 0 if unused */
+    uint16_t                data[GAMMA_TABLE_MAX_SIZE]; /**< table values */
+} gamma_table_t;
+
+/******************************************************************************
+ * @brief cache of recently used transfer-function tables
+ *
+ * @note  The cache is large (about 512 KiB), allocate it on the heap.
+ *****************************************************************************/
+typedef struct gamma_table_cache_s
+{
+    gamma_table_t   table[GAMMA_TABLE_CACHE_SIZE];      /**< cached tables */
+    uint32_t        clock;                              /**< use counter */
+} gamma_table_cache_t;
+
+/**************************************************************************//**
+ * @brief      Compute a complete transfer-function table
+ *
+ * @note       All 2^bit_width entries are computed in one pass. powf, logf
+ *             and sqrtf are replaced by branch-free polynomial approximations
+ *             of log2 and exp2 (relative error < 2e-7), so the loops can be
+ *             vectorized by the compiler. The maximal deviation from a double
+ *             precision reference is 1 LSB at 16 bit and less than 1 LSB at
+ *             10 and 12 bit, which is more precise than the fastpow based
+ *             sm_gamma_float and sm_pq.
+ *
+ * @param[in]  curve        transfer-function curve
+ * @param[in]  params       curve parameters (may be NULL for PQ and HLG)
+ * @param[in]  bit_width    bit-width of input and output (1..16)
+ * @param[out] table        resulting table (array of 2^bit_width elements)
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_gamma_table_calc
+(
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    uint8_t const                       bit_width,
+    uint16_t * const                    table
+);
+
+/**************************************************************************//**
+ * @brief      Evaluate a transfer-function at single input code values
+ *
+ * @note       Gives the same values as the table entries of
+ *             sm_gamma_table_calc, but only computes the requested samples.
+ *             Use it for curves that are plotted at a few points and change
+ *             with every parameter step; a table and its cache slot are only
+ *             worth it for curves that are reused.
+ *
+ * @param[in]  curve        transfer-function curve
+ * @param[in]  params       curve parameters (may be NULL for PQ and HLG)
+ * @param[in]  bit_width    bit-width of input and output (1..16)
+ * @param[in]  x            input code values (clipped to 2^bit_width - 1)
+ * @param[out] y            resulting output code values
+ * @param[in]  n            number of samples
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_gamma_table_sample
+(
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    uint8_t const                       bit_width,
+    uint32_t const * const              x,
+    uint16_t * const                    y,
+    uint32_t const                      n
+);
+
+/**************************************************************************//**
+ * @brief      Invalidate all tables of a cache
+ *
+ * @param[in]  cache    cache to reset
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_gamma_table_cache_reset
+(
+    gamma_table_cache_t * const cache
+);
+
+/**************************************************************************//**
+ * @brief      Get a transfer-function table from the cache
+ *
+ * @note       The table is keyed by (curve, params, bit_width). On a miss the
+ *             least recently used table is recomputed. The returned table is
+ *             valid until GAMMA_TABLE_CACHE_SIZE other tables are requested.
+ *
+ * @param[in]  cache        cache to use
+ * @param[in]  curve        transfer-function curve
+ * @param[in]  params       curve parameters (may be NULL for PQ and HLG)
+ * @param[in]  bit_width    bit-width of input and output (1..16)
+ *
+ * @return     table with 2^bit_width elements, NULL on error
+ *****************************************************************************/
+uint16_t const * sm_gamma_table_get
+(
+    gamma_table_cache_t * const         cache,
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    uint8_t const                       bit_width
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GAMMA_TABLE_H__ */
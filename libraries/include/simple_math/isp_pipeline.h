@@ -0,0 +1,228 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    isp_pipeline.h
+ *
+ * @brief   Software model of the colour pipeline of the camera ISP
+ *
+ * @note    The model applies white balance, colour correction, knee,
+ *          transfer tables, multi colour control, RGB to YCbCr conversion
+ *          and colour processing to a linear RGB still image and converts
+ *          the result back to RGB for display, so settings can be previewed
+ *          without a camera round trip.
+ *
+ *          Everything that depends on the settings is folded into matrices
+ *          and tables by sm_isp_pipeline_update, processing a pixel is then
+ *          a few multiply-adds and table lookups. Pixels are processed in
+ *          short runs with one loop per stage, the arithmetic loops are
+ *          vectorized by the compiler.
+ *
+ *          sm_isp_pipeline_process only reads the pipeline, it can be run
+ *          for different strips of an image on several threads at once.
+ *          The same holds for sm_isp_pipeline_bake_cube, which evaluates
+ *          the pipeline on a 3D lattice for a baked 3D LUT.
+ *
+ *****************************************************************************/
+#ifndef __ISP_PIPELINE_H__
+#define __ISP_PIPELINE_H__
+
+#include <stdint.h>
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ * @brief bit-width and size of the transfer tables (same as MAX_VALUES_LUT)
+ *****************************************************************************/
+#define ISP_PIPELINE_LUT_BIT_WIDTH  ( 12u )
+#define ISP_PIPELINE_LUT_SIZE       ( 1u << ISP_PIPELINE_LUT_BIT_WIDTH )
+
+/******************************************************************************
+ * @brief maximal number of multi colour control phases
+ *****************************************************************************/
+#define ISP_PIPELINE_MAX_PHASES     ( 32u )
+
+/******************************************************************************
+ * @brief resolution of the chroma table (per axis), odd so that neutral
+ *        grey hits an entry exactly
+ *****************************************************************************/
+#define ISP_PIPELINE_CHROMA_SIZE    ( 257u )
+
+/******************************************************************************
+ * @brief lattice size (per axis) of a baked 3D LUT, the limits of the
+ *        .cube format
+ *****************************************************************************/
+#define ISP_PIPELINE_CUBE_MIN_SIZE  ( 2u )
+#define ISP_PIPELINE_CUBE_MAX_SIZE  ( 256u )
+
+/******************************************************************************
+ * @brief settings of the modelled pipeline in physical units, the widgets
+ *        convert their fixed point values with their COMMA_POSITION defines
+ *****************************************************************************/
+typedef struct isp_pipeline_params_s
+{
+    float               wb_gain[3];         /**< white balance gains red, green, blue (1.0 = unity) */
+
+    float               cross[9];           /**< colour correction matrix RGB->RGB, row major */
+    float               cross_offset[3];    /**< offsets after colour correction (1.0 = full scale) */
+
+    uint8_t             knee_enable;        /**< apply knee function */
+    uint8_t             knee_point;         /**< knee point, see sm_knee_interpolation_calc_init */
+    uint16_t            knee_slope;         /**< knee slope */
+    uint8_t             white_clip;         /**< white clip */
+
+    uint16_t const *    lut[3];             /**< transfer tables red, green, blue with ISP_PIPELINE_LUT_SIZE
+                                                 samples of ISP_PIPELINE_LUT_BIT_WIDTH bit, NULL = linear */
+
+    uint8_t             mcc_enable;         /**< apply multi colour control */
+    uint8_t             mcc_phases;         /**< number of colour phases */
+    float               mcc_saturation[ISP_PIPELINE_MAX_PHASES];  /**< saturation of phase (1.0 = unity) */
+    float               mcc_hue[ISP_PIPELINE_MAX_PHASES];         /**< hue shift of phase in degree */
+
+    float               conv[9];            /**< colour conversion RGB->YCbCr, see cal_YCbCr_coefficients */
+
+    float               brightness;         /**< luma offset (1.0 = full scale) */
+    float               contrast;           /**< luma gain (1.0 = unity) */
+    float               saturation;         /**< chroma gain (1.0 = unity) */
+    float               hue;                /**< chroma rotation in degree */
+} isp_pipeline_params_t;
+
+/******************************************************************************
+ * @brief precomputed pipeline
+ *
+ * @note  The pipeline is large (about 600 KiB), allocate it on the heap.
+ *****************************************************************************/
+typedef struct isp_pipeline_s
+{
+    isp_pipeline_params_t   params;                                     /**< settings of the tables */
+    int                     valid;                                      /**< tables are computed */
+
+    float                   rgb[9];                                     /**< white balance and colour correction */
+    float                   rgb_offset[3];                              /**< colour correction offsets */
+    float                   knee[ISP_PIPELINE_LUT_SIZE];                /**< knee gain by maximal component */
+    float                   lut[3][ISP_PIPELINE_LUT_SIZE];              /**< normalized transfer tables */
+    float                   ycbcr[9];                                   /**< conversion with contrast */
+    float                   y_offset;                                   /**< brightness */
+    float                   display[9];                                 /**< YCbCr->RGB for display */
+    float                   chroma[ISP_PIPELINE_CHROMA_SIZE * ISP_PIPELINE_CHROMA_SIZE][2]; /**< Cb, Cr after MCC and CPROC */
+} isp_pipeline_t;
+
+/**************************************************************************//**
+ * @brief      Fill pipeline settings with a neutral pipeline (unity gains,
+ *             identity matrices, linear tables, BT.709 conversion)
+ *
+ * @param[out] params   settings to initialize
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_isp_pipeline_params_init
+(
+    isp_pipeline_params_t * const params
+);
+
+/**************************************************************************//**
+ * @brief      Invalidate a pipeline, the next update computes all tables
+ *
+ * @param[in]  pipe     pipeline to reset
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_isp_pipeline_reset
+(
+    isp_pipeline_t * const pipe
+);
+
+/**************************************************************************//**
+ * @brief      Compute a pipeline from its settings
+ *
+ * @note       Only tables whose settings changed since the last update are
+ *             recomputed; the chroma table, which is by far the largest,
+ *             is left alone while white balance, knee or the transfer
+ *             tables are tweaked. Transfer tables are copied, they need not
+ *             stay valid after the update.
+ *
+ * @param[in]  pipe     pipeline to compute
+ * @param[in]  params   pipeline settings
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_isp_pipeline_update
+(
+    isp_pipeline_t * const                  pipe,
+    isp_pipeline_params_t const * const     params
+);
+
+/**************************************************************************//**
+ * @brief      Process a strip of an image
+ *
+ * @param[in]  pipe         computed pipeline
+ * @param[in]  in           first input pixel, interleaved linear RGB
+ * @param[in]  in_stride    distance of input lines in samples
+ * @param[in]  bit_width    bit-width of input samples (8..16)
+ * @param[out] out          first output pixel, 0xffRRGGBB
+ * @param[in]  out_stride   distance of output lines in pixels
+ * @param[in]  width        number of pixels per line
+ * @param[in]  height       number of lines
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_isp_pipeline_process
+(
+    isp_pipeline_t const * const    pipe,
+    uint16_t const * const          in,
+    uint32_t const                  in_stride,
+    uint8_t const                   bit_width,
+    uint32_t * const                out,
+    uint32_t const                  out_stride,
+    uint32_t const                  width,
+    uint32_t const                  height
+);
+
+/**************************************************************************//**
+ * @brief      Evaluate the pipeline on blue slices of a 3D lattice
+ *
+ * @note       Lattice points are spaced evenly over [0, 1] per component
+ *             of the linear input. The output is display RGB in [0, 1],
+ *             red changes fastest, then green, then blue, which is the
+ *             order of the .cube format. Slices are independent, several
+ *             threads can bake different slices at once.
+ *
+ * @param[in]  pipe     computed pipeline
+ * @param[in]  size     lattice points per axis
+ *                      (ISP_PIPELINE_CUBE_MIN_SIZE..ISP_PIPELINE_CUBE_MAX_SIZE)
+ * @param[in]  first    first blue slice
+ * @param[in]  count    number of blue slices
+ * @param[out] out      count * size * size interleaved RGB triples
+ *
+ * @return     0 on success, error-code otherwise
+ *****************************************************************************/
+int sm_isp_pipeline_bake_cube
+(
+    isp_pipeline_t const * const    pipe,
+    uint32_t const                  size,
+    uint32_t const                  first,
+    uint32_t const                  count,
+    float * const                   out
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ISP_PIPELINE_H__ */
@@ -30,6 +30,7 @@
 #include <ctrl_protocol/ctrl_protocol_auto.h>
 
 #include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
 
 /******************************************************************************
  * @brief command "aec" 
@@ -289,6 +290,59 @@ static int set_aec_weight
                               INT( values[0] ), INT( values[1] ) ) );
 }
 
+/******************************************************************************
+ * aec_weights_read_t - context of aec weights readout
+ *****************************************************************************/
+typedef struct aec_weights_read_s
+{
+    uint8_t *   values;     /**< weights to fill */
+    int         cnt;        /**< number of received weights */
+} aec_weights_read_t;
+
+/******************************************************************************
+ * aec_weight_line - line handler of aec weights readout
+ *****************************************************************************/
+static int aec_weight_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    aec_weights_read_t * r = (aec_weights_read_t *)priv;
+
+    (void) len;
+
+    // get start position of command
+    char const * s = strstr( line, CMD_SYNC_AEC_WEIGHT );
+    if ( s )
+    {
+        int index = 0, weight = 0;
+        int offset = 0;
+
+        // parse command
+        int res = sscanf( s, CMD_SET_AEC_WEIGHTn, &index, &weight, &offset );
+        if ( (res == CMD_SET_AEC_WEIGHT_NO_PARAMS) && (offset != 0) && (s[offset-1] == '\n') )
+        {
+            if ( r->cnt >= CMD_GET_AEC_WEIGHT_NUM_ITEMS )
+            {
+                return ( -ENOMEM );
+            }
+
+            // check if indices are in order and none are missing
+            if ( index != r->cnt + 1 )
+            {
+                return ( -EFAULT );
+            }
+
+            r->values[r->cnt] = UINT8( weight );
+            r->cnt++;
+        }
+    }
+
+    return ( 0 );
+}
+
 /******************************************************************************
  * get_aec_weights - read all aec weights
  *****************************************************************************/
@@ -302,135 +356,25 @@ static int get_aec_weights
 {
     (void) ctx;
 
-    char command[CMD_SINGLE_LINE_COMMAND_SIZE];
-    char buf[CMD_SINGLE_LINE_RESPONSE_SIZE];
-    char data[CMD_SINGLE_LINE_RESPONSE_SIZE*2];
-
-    struct timespec start, now;
-    int loop = 1;
-    int cnt = 0;
+    aec_weights_read_t r;
+    cmd_reader_t reader;
 
     if ( !no || !values || (no != CMD_GET_AEC_WEIGHT_NUM_ITEMS) )
     {
         return ( -EINVAL );
     }
 
-    // clear command buffer
-    memset( command, 0, sizeof(command) );
-
-    // create command to send
-    sprintf( command, CMD_GET_AEC_WEIGHT );
+    r.values = values;
+    r.cnt    = 0;
 
     // send get-command to control channel
-    ctrl_channel_send_request( channel, (uint8_t *)command, (int)strlen(command) );
-
-    // clear data buffer
-    memset( data, 0, sizeof(data) );
-    data[0] = '\0';
-
-    // counter to check for buffer overflow
-    unsigned int data_count = 0;
-
-    // start timer
-    get_time_monotonic( &start );
-
-    // wait for answer from COM-Port
-    while ( loop )
-    {
-        int n;
-
-        // poll for data (NOTE: reserve last byte for '\0')
-        memset( buf, 0, sizeof(buf) );
-        n = ctrl_channel_receive_response( channel, (uint8_t *)buf, (sizeof(buf) - 1u) );
-
-        // evaluate number of received data
-        if ( n > 0 )
-        {
-            // always put a "null" at the end of a string
-            buf[n] = '\0';
-
-            // increment data counter and check for overflow
-            data_count += (unsigned int)n;
-            if ( data_count >= sizeof(data) )
-            {
-                return ( -ENOMEM );
-            }
-
-            // append poll buffer to receive buffer
-            strcat( data, buf );
+    ctrl_channel_send_request( channel, (uint8_t *)CMD_GET_AEC_WEIGHT, (int)strlen(CMD_GET_AEC_WEIGHT) );
 
-            // consume all commands from buffer
-            // (get start position of first command therefoe)
-            char * s = strstr( data, CMD_SYNC_AEC_WEIGHT );
-            while ( s )
-            {
-                int index = 0, weight = 0;
-                int offset = 0;
-
-                // parse command
-                int res = sscanf( s, CMD_SET_AEC_WEIGHTn, &index, &weight, &offset );
-                if ( (res == CMD_SET_AEC_WEIGHT_NO_PARAMS) && (offset != 0) && (s[offset-1] == '\n') )
-                {
-                    if ( cnt >= CMD_GET_AEC_WEIGHT_NUM_ITEMS )
-                    {
-                        return ( -ENOMEM );
-                    }
-
-                    // check if indices are in order and none are missing
-                    if ( index != cnt + 1 )
-                    {
-                        return ( -EFAULT );
-                    }
-
-                    values[cnt] = UINT8( weight );
-                    cnt++;
-
-                    // decrement data counter by bytes taken out
-                    unsigned int num_bytes_processed = (unsigned int)(s + offset - data);
-                    data_count -= num_bytes_processed;
-
-                    // move out the processed command
-                    // Note: Use memmove instead of strncpy, because dst and src overlap!
-                    memmove( data, (s+offset), data_count );
-
-                    // clear moved out data to make sure buffer is free of garbage
-                    memset((data + data_count), 0, num_bytes_processed );
-
-                    // search next command in buffer
-                    s = strstr( data, CMD_SYNC_AEC_WEIGHT);
-                }
-                else
-                {
-                    s = NULL;
-                }
-            }
-
-            // check if string is complete and valid
-            if ( strstr( data, CMD_OK ) )
-            {
-                return ( 0 );
-            }
-
-            // check if string is complete and error-message
-            else if ( strstr( data, CMD_FAIL ) )
-            {
-                return ( evaluate_error_response( data, -EINVAL ) );
-            }
-
-            // reset timer
-            get_time_monotonic( &start );
-        }
-        else
-        {
-            // timeout handling, if device does not send new pixel positions after
-            // 1 second, assume table has been transmitted completely
-            get_time_monotonic( &now );
-            int diff_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
-            loop = (diff_ms > 1000) ? 0 : 1;
-        }
-    }
+    // consume weights line by line, if device does not send new weights
+    // after 1 second, assume all weights have been transmitted
+    cmd_reader_init( &reader, aec_weight_line, &r );
 
-    return ( -EILSEQ );
+    return ( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_IDLE, 1000 ) );
 }
 
 /******************************************************************************
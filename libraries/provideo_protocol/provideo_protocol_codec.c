@@ -0,0 +1,423 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_codec.c
+ *
+ * @brief   Implementation of the allocation-free command encoder and decoder
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <provideo_protocol/provideo_protocol_codec.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// number of cache slots searched for a format string
+#define CMD_DESC_CACHE_PROBES       ( 16u )
+
+// enough digits for a 32 bit value in octal
+#define MAX_DIGITS                  ( 12 )
+
+/******************************************************************************
+ * local variables
+ *****************************************************************************/
+static cmd_desc_t desc_cache[CMD_DESC_CACHE_SIZE];
+
+/******************************************************************************
+ * is_space - same characters as isspace() in the "C" locale
+ *****************************************************************************/
+static inline int is_space( char const c )
+{
+    return ( (c == ' ') || ((c >= '\t') && (c <= '\r')) );
+}
+
+/******************************************************************************
+ * digit_value - value of a digit in base 16, -1 if not a digit
+ *****************************************************************************/
+static inline int digit_value( char const c )
+{
+    if ( (c >= '0') && (c <= '9') )
+    {
+        return ( c - '0' );
+    }
+
+    if ( (c >= 'a') && (c <= 'f') )
+    {
+        return ( c - 'a' + 10 );
+    }
+
+    if ( (c >= 'A') && (c <= 'F') )
+    {
+        return ( c - 'A' + 10 );
+    }
+
+    return ( -1 );
+}
+
+/******************************************************************************
+ * cache_slot - first cache slot of a format string
+ *****************************************************************************/
+static inline uint32_t cache_slot( char const * const fmt )
+{
+    // fibonacci hashing of the string address
+    uint32_t h = (uint32_t)((uintptr_t)fmt >> 3) * 2654435761u;
+    return ( h % CMD_DESC_CACHE_SIZE );
+}
+
+/******************************************************************************
+ * encode_number - write a number in base 10 or 16, returns number of chars
+ *****************************************************************************/
+static int encode_number
+(
+    char * const    buf,
+    int const       size,
+    int32_t const   value,
+    char const      conv
+)
+{
+    static char const hex[] = "0123456789abcdef";
+
+    char        digits[MAX_DIGITS];
+    uint32_t    v = (uint32_t)value;
+    int         neg = 0;
+    int         n = 0;
+    int         len;
+    int         i;
+
+    if ( ((conv == 'i') || (conv == 'd')) && (value < 0) )
+    {
+        neg = 1;
+        v   = 0u - v;
+    }
+
+    if ( conv == 'x' )
+    {
+        do
+        {
+            digits[n++] = hex[v & 0xfu];
+            v >>= 4;
+        } while ( v );
+    }
+    else
+    {
+        do
+        {
+            digits[n++] = (char)('0' + (v % 10u));
+            v /= 10u;
+        } while ( v );
+    }
+
+    len = neg + n;
+    if ( len > size )
+    {
+        return ( -EFAULT );
+    }
+
+    if ( neg )
+    {
+        buf[0] = '-';
+    }
+
+    for ( i = 0; i < n; i++ )
+    {
+        buf[neg + i] = digits[n - 1 - i];
+    }
+
+    return ( len );
+}
+
+/******************************************************************************
+ * decode_number - parse a number like sscanf, returns the end of the number
+ *                 or NULL if there is no number
+ *****************************************************************************/
+static char const * decode_number
+(
+    char const *    s,
+    char const      conv,
+    int32_t * const value
+)
+{
+    uint32_t    v    = 0u;
+    uint32_t    base = (conv == 'x') ? 16u : 10u;
+    int         neg  = 0;
+    int         d;
+    char const * start;
+
+    if ( (*s == '+') || (*s == '-') )
+    {
+        neg = (*s == '-');
+        s++;
+    }
+
+    // hex prefix, only taken if a hex digit follows
+    if ( ((conv == 'x') || (conv == 'i')) && (s[0] == '0')
+            && ((s[1] == 'x') || (s[1] == 'X')) && (digit_value( s[2] ) >= 0) )
+    {
+        base = 16u;
+        s += 2;
+    }
+    else if ( (conv == 'i') && (s[0] == '0') )
+    {
+        base = 8u;
+    }
+
+    start = s;
+    while ( ((d = digit_value( *s )) >= 0) && ((uint32_t)d < base) )
+    {
+        v = v * base + (uint32_t)d;
+        s++;
+    }
+
+    if ( s == start )
+    {
+        return ( NULL );
+    }
+
+    *value = (int32_t)(neg ? (0u - v) : v);
+
+    return ( s );
+}
+
+/******************************************************************************
+ * cmd_desc_compile
+ *****************************************************************************/
+int cmd_desc_compile
+(
+    char const * const  fmt,
+    cmd_desc_t * const  desc
+)
+{
+    char const * p;
+    uint32_t start = 0u;
+    uint32_t no = 0u;
+
+    if ( !fmt || !desc )
+    {
+        return ( -EINVAL );
+    }
+
+    memset( desc, 0, sizeof(*desc) );
+    desc->fmt = fmt;
+
+    if ( strlen( fmt ) > CMD_DESC_MAX_FORMAT_LENGTH )
+    {
+        return ( -ENOSYS );
+    }
+
+    for ( p = fmt; *p; p++ )
+    {
+        if ( *p != '%' )
+        {
+            continue;
+        }
+
+        // only plain integer conversions
+        if ( (p[1] != 'i') && (p[1] != 'd') && (p[1] != 'u') && (p[1] != 'x') )
+        {
+            return ( -ENOSYS );
+        }
+
+        if ( no >= CMD_DESC_MAX_PARAMS )
+        {
+            return ( -ENOSYS );
+        }
+
+        desc->lit_offset[no] = (uint8_t)start;
+        desc->lit_length[no] = (uint8_t)((uint32_t)(p - fmt) - start);
+        desc->conv[no]       = p[1];
+        no++;
+
+        p++;
+        start = (uint32_t)(p - fmt) + 1u;
+    }
+
+    desc->lit_offset[no] = (uint8_t)start;
+    desc->lit_length[no] = (uint8_t)((uint32_t)(p - fmt) - start);
+    desc->no             = (uint8_t)no;
+    desc->supported      = 1u;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * cmd_desc_get
+ *****************************************************************************/
+cmd_desc_t const * cmd_desc_get
+(
+    char const * const  fmt,
+    cmd_desc_t * const  tmp
+)
+{
+    uint32_t slot;
+    uint32_t i;
+
+    if ( !fmt )
+    {
+        return ( NULL );
+    }
+
+    slot = cache_slot( fmt );
+    for ( i = 0u; i < CMD_DESC_CACHE_PROBES; i++ )
+    {
+        cmd_desc_t * desc = &desc_cache[(slot + i) % CMD_DESC_CACHE_SIZE];
+
+        if ( desc->fmt == fmt )
+        {
+            return ( desc->supported ? desc : NULL );
+        }
+
+        if ( !desc->fmt )
+        {
+            // unsupported formats are cached as well, so they are parsed once
+            return ( cmd_desc_compile( fmt, desc ) ? NULL : desc );
+        }
+    }
+
+    // cache is full around this slot
+    if ( !tmp || cmd_desc_compile( fmt, tmp ) )
+    {
+        return ( NULL );
+    }
+
+    return ( tmp );
+}
+
+/******************************************************************************
+ * cmd_encode_int
+ *****************************************************************************/
+int cmd_encode_int
+(
+    cmd_desc_t const * const    desc,
+    char * const                buf,
+    int const                   size,
+    int32_t const * const       values
+)
+{
+    int n = 0;
+    int k;
+
+    if ( !desc || !desc->supported || !buf || (size <= 0) || (!values && desc->no) )
+    {
+        return ( -EINVAL );
+    }
+
+    for ( k = 0; k <= desc->no; k++ )
+    {
+        int len = desc->lit_length[k];
+
+        // always keep one byte for '\0'
+        if ( len > (size - 1 - n) )
+        {
+            return ( -EFAULT );
+        }
+
+        memcpy( &buf[n], &desc->fmt[desc->lit_offset[k]], (size_t)len );
+        n += len;
+
+        if ( k < desc->no )
+        {
+            len = encode_number( &buf[n], size - 1 - n, values[k], desc->conv[k] );
+            if ( len < 0 )
+            {
+                return ( len );
+            }
+            n += len;
+        }
+    }
+
+    buf[n] = '\0';
+
+    return ( n );
+}
+
+/******************************************************************************
+ * cmd_decode_int
+ *****************************************************************************/
+int cmd_decode_int
+(
+    cmd_desc_t const * const    desc,
+    char const *                s,
+    int32_t * const             values
+)
+{
+    int count = 0;
+    int k;
+
+    if ( !desc || !desc->supported || !s || (!values && desc->no) )
+    {
+        return ( -EINVAL );
+    }
+
+    for ( k = 0; k <= desc->no; k++ )
+    {
+        char const * lit = &desc->fmt[desc->lit_offset[k]];
+        int i;
+
+        // literal text, whitespace matches any amount of whitespace
+        for ( i = 0; i < desc->lit_length[k]; i++ )
+        {
+            if ( is_space( lit[i] ) )
+            {
+                while ( is_space( *s ) )
+                {
+                    s++;
+                }
+            }
+            else if ( *s == '\0' )
+            {
+                // input failure
+                return ( count ? count : -1 );
+            }
+            else if ( *s != lit[i] )
+            {
+                // matching failure
+                return ( count );
+            }
+            else
+            {
+                s++;
+            }
+        }
+
+        if ( k < desc->no )
+        {
+            // numeric conversions skip leading whitespace
+            while ( is_space( *s ) )
+            {
+                s++;
+            }
+
+            if ( *s == '\0' )
+            {
+                return ( count ? count : -1 );
+            }
+
+            s = decode_number( s, desc->conv[k], &values[k] );
+            if ( !s )
+            {
+                return ( count );
+            }
+            count++;
+        }
+    }
+
+    return ( count );
+}
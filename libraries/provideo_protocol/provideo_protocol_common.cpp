@@ -30,6 +30,10 @@
 #include <ctrl_channel/ctrl_channel.h>
 
 #include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_codec.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
+
+#define CMD_GET_DUMP_SETTINGS_TMO 2000
 
 #define USE_CUSTOM_GET_TIME
 #ifdef USE_CUSTOM_GET_TIME
@@ -41,8 +45,6 @@
 #ifdef _WIN32
 #include <windows.h>
 
-#define CMD_GET_DUMP_SETTINGS_TMO 2000
-
 static LARGE_INTEGER getFILETIMEoffset()
 {
     SYSTEMTIME s;
@@ -122,6 +124,154 @@ int get_time_monotonic(struct timespec * time)
     return ret;
 }
 
+/******************************************************************************
+ * get_response_buffer - response buffer for a get command, uses the scratch
+ *                       buffer of the channel and only allocates for large
+ *                       responses
+ *****************************************************************************/
+static char * get_response_buffer
+(
+    ctrl_channel_handle_t const channel,
+    int const                   len,
+    std::vector<char> &         heap
+)
+{
+    char * data = (char *)ctrl_channel_get_scratch_buffer( channel, len );
+    if ( !data )
+    {
+        heap.resize( len );
+        data = heap.data();
+    }
+
+    return ( data );
+}
+
+/******************************************************************************
+ * parse_params - parse integer parameters of a response line, uses the
+ *                command codec and vsscanf for unsupported formats
+ *****************************************************************************/
+static int parse_params
+(
+    char const * const  s,
+    char const * const  fmt,
+    va_list             args
+)
+{
+    cmd_desc_t tmp;
+    cmd_desc_t const * desc = cmd_desc_get( fmt, &tmp );
+    if ( !desc )
+    {
+        return ( vsscanf( s, fmt, args ) );
+    }
+
+    int32_t values[CMD_DESC_MAX_PARAMS];
+    int res = cmd_decode_int( desc, s, values );
+    for ( int i = 0; i < res; i++ )
+    {
+        *va_arg( args, int32_t * ) = values[i];
+    }
+
+    return ( res );
+}
+
+/******************************************************************************
+ * format_params - create a command with integer parameters, uses the command
+ *                 codec and vsnprintf for unsupported formats
+ *****************************************************************************/
+static int format_params
+(
+    char * const        buf,
+    int const           size,
+    char const * const  fmt,
+    va_list             args
+)
+{
+    cmd_desc_t tmp;
+    cmd_desc_t const * desc = cmd_desc_get( fmt, &tmp );
+    if ( !desc )
+    {
+        int res = vsnprintf( buf, size, fmt, args );
+        return ( (res >= size) ? -EFAULT : res );
+    }
+
+    int32_t values[CMD_DESC_MAX_PARAMS];
+    for ( int i = 0; i < desc->no; i++ )
+    {
+        values[i] = va_arg( args, int32_t );
+    }
+
+    return ( cmd_encode_int( desc, buf, size, values ) );
+}
+
+/******************************************************************************
+ * response_buffer_t - response lines collected by append_line
+ *****************************************************************************/
+typedef struct response_buffer_s
+{
+    char *  data;       /**< response buffer */
+    int     size;       /**< size of response buffer */
+    int     len;        /**< used length without '\0' */
+} response_buffer_t;
+
+/******************************************************************************
+ * is_ok_line - check if a response line is the "OK" terminator
+ *****************************************************************************/
+static bool is_ok_line( char const * const line )
+{
+    size_t n = strlen( CMD_OK );
+    return ( !strncmp( line, CMD_OK, n ) && ((line[n] == '\r') || (line[n] == '\n') || (line[n] == '\0')) );
+}
+
+/******************************************************************************
+ * append_line - line handler, appends a response line to a response buffer
+ *****************************************************************************/
+static int append_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    response_buffer_t * r = (response_buffer_t *)priv;
+
+    // check data buffer size (NOTE: reserve last byte for '\0')
+    if ( (r->len + len) >= r->size )
+    {
+        return ( -EINVAL );
+    }
+
+    memcpy( &r->data[r->len], line, len );
+    r->len += len;
+    r->data[r->len] = '\0';
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * line_forward_t - line handler and context of get_param_lines
+ *****************************************************************************/
+typedef struct line_forward_s
+{
+    cmd_reader_line_t   handler;
+    void *              priv;
+} line_forward_t;
+
+/******************************************************************************
+ * forward_line - line handler, passes a line of a long response on without
+ *                the "OK" terminator
+ *****************************************************************************/
+static int forward_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    line_forward_t * f = (line_forward_t *)priv;
+
+    return ( is_ok_line( line ) ? 0 : f->handler( f->priv, line, len ) );
+}
+
 /******************************************************************************
  * evaluate_error_response - evaluate error message from provideo device
  *****************************************************************************/
@@ -191,73 +341,12 @@ int evaluate_set_response_with_tmo
     int const                   tmo_ms
 )
 {
-    char buf[CMD_SINGLE_LINE_RESPONSE_SIZE];
-    char data[CMD_SINGLE_LINE_RESPONSE_SIZE*2];
-
-    struct timespec start, now;
-    int loop = 1;
+    cmd_reader_t reader;
 
-    // start timer
-    get_time_monotonic( &start );
+    // only terminator and error message are of interest
+    cmd_reader_init( &reader, NULL, NULL );
 
-    // set received_string to zero
-    memset( data, 0u, sizeof(data) );
-
-    // wait for answer from COM-Port
-    while ( loop )
-    {
-        int n;
-        
-        // clear poll buffer
-        memset( buf, 0u, sizeof(buf) );
-
-        // poll for data data (NOTE: reserve last byte for '\0')
-        n = ctrl_channel_receive_response( channel, (uint8_t *)buf, (sizeof(buf) - 1u) );
-
-        // evaluate number of received data
-        if ( n > 0 )
-        {
-            // always put a "null" at the end of a string
-            buf[n] = '\0';
-
-            // check for buffer overflow
-            if ( strlen(data) + strlen(buf) >= sizeof(data) )
-            {
-                // device is sending more data than expected -> throw away old data
-                memset( data, 0u, sizeof(data) );
-            }
-
-            // append poll buffer to receive buffer
-            strcat( data, buf );
-
-            // check if string is complete and valid
-            if ( strstr( data, CMD_OK ) )
-            {
-                return ( 0 );
-            }
-
-            // check if string is complete and error-message
-            else if ( strstr( data, CMD_FAIL ) )
-            {
-                return ( evaluate_error_response( data, -EINVAL ) );
-            }
-
-            // else stay in loop
-            else
-            {
-                // do nothing
-            }
-        }
-        else
-        {
-            // timeout handling
-            get_time_monotonic( &now );
-            int diff_ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
-            loop = (diff_ms > tmo_ms) ? 0 : 1;
-        }
-    }
-
-    return ( -EILSEQ );
+    return ( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, tmo_ms ) );
 }
 
 /******************************************************************************
@@ -285,63 +374,45 @@ int evaluate_get_response_with_tmo
     int const                   tmo_ms
 )
 {
-    struct timespec start, now;
-    int loop = 1;
-    int i = 0;
-
-    // start timer
-    get_time_monotonic( &start );
+    response_buffer_t response;
+    cmd_reader_t reader;
 
-    // set received_string and buffer to zero
-    memset( data, 0u, len );
+    response.data = data;
+    response.size = len;
+    response.len  = 0;
 
-    // wait for answer from COM-Port
-    while ( loop )
-    {
-        int n;
-
-        // poll for data data (NOTE: reserve last byte for '\0')
-        n = ctrl_channel_receive_response( channel, (uint8_t *)&data[i], (len - i - 1)  );
+    // start with empty string
+    data[0] = '\0';
 
-        // evaluate number of received data
-        if ( n > 0 )
-        {
-            i += n;
+    cmd_reader_init( &reader, append_line, &response );
 
-            // check data buffer size
-            if ( i >= len )
-            {
-                return ( -EINVAL );
-            }
-
-            // check if string is complete and valid
-            if ( strstr( data, CMD_OK ) )
-            {
-                return ( 0 );
-            }
-
-            // check if string is complete and error-message
-            else if ( strstr( data, CMD_FAIL ) )
-            {
-                return ( -EINVAL );
-            }
+    return ( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, tmo_ms ) );
+}
 
-            // else stay in loop
-            else
-            {
-                // do nothing
-            }
-        }
-        else
-        {
-            // timeout handling
-            get_time_monotonic( &now );
-            int diff_ms = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000;
-            loop = (diff_ms > tmo_ms) ? 0 : 1;
-        }
+/******************************************************************************
+ * send_set_request - Send a set command and evaluate the response, or hand
+ *                    it to the deferred command receiver
+ *****************************************************************************/
+int send_set_request
+(
+    ctrl_channel_handle_t const channel,
+    char * const                cmd,
+    int const                   len,
+    int const                   tmo_ms
+)
+{
+    int res = ctrl_channel_defer_request( channel, (uint8_t *)cmd, len, tmo_ms );
+    if ( res )
+    {
+        // deferred, the receiver reports the response
+        return ( (res < 0) ? res : 0 );
     }
 
-    return ( -EILSEQ );
+    // send command to COM port
+    ctrl_channel_send_request( channel, (uint8_t *)cmd, len );
+
+    // wait for response and evaluate
+    return ( evaluate_set_response_with_tmo( channel, tmo_ms ) );
 }
 
 /******************************************************************************
@@ -353,11 +424,8 @@ int set_param_0
     char * const                 data
 )
 {
-    // send data buffer to control channel
-    ctrl_channel_send_request( channel, (uint8_t *)data, strlen( data ) );
-
-    // wait for response and evaluate it
-    return ( evaluate_set_response( channel ) );
+    // send data buffer to control channel, wait for response and evaluate it
+    return ( send_set_request( channel, data, INT(strlen( data )), DEFAULT_CMD_TIMEOUT ) );
 }
 
 /******************************************************************************
@@ -370,11 +438,8 @@ int set_param_0_with_tmo
     int const                    tmo_ms
 )
 {
-    // send data buffer to control channel
-    ctrl_channel_send_request( channel, (uint8_t *)data, strlen( data ) );
-
-    // wait for response and evaluate it
-    return ( evaluate_set_response_with_tmo( channel, tmo_ms ) );
+    // send data buffer to control channel, wait for response and evaluate it
+    return ( send_set_request( channel, data, INT(strlen( data )), tmo_ms ) );
 }
 
 /******************************************************************************
@@ -391,8 +456,9 @@ int get_param_string
     char *                       param
 )
 {
-    //char data[(lines*CMD_SINGLE_LINE_RESPONSE_SIZE)]; VLA Fix:
-    std::vector<char> data(lines*CMD_SINGLE_LINE_RESPONSE_SIZE);
+    int len = lines * CMD_SINGLE_LINE_RESPONSE_SIZE;
+    std::vector<char> heap;
+    char * data = get_response_buffer( channel, len, heap );
 
     int res;
 
@@ -400,13 +466,11 @@ int get_param_string
     ctrl_channel_send_request( channel, (uint8_t *)cmd_get, strlen(cmd_get) );
 
     // read response from provideo device
-    //res = evaluate_get_response( channel, data, sizeof(data) ); VLA Fix:
-    res = evaluate_get_response( channel, data.data(), data.size() );
+    res = evaluate_get_response( channel, data, len );
     if ( !res )
     {
         // get start position of command
-        //char * s = strstr( data, cmd_sync ); VLA Fix:
-        char * s = strstr( data.data(), cmd_sync );
+        char * s = strstr( data, cmd_sync );
         if ( s )
         {
             // parse command
@@ -421,8 +485,7 @@ int get_param_string
     }
     else
     {
-        //res = evaluate_error_response( data, res ); VLA Fix:
-        res = evaluate_error_response( data.data(), res );
+        res = evaluate_error_response( data, res );
     }
 
     return ( res );
@@ -442,43 +505,52 @@ int get_param_settings_string
     char *                       param
 )
 {
-    std::vector<char> data(lines);
+    response_buffer_t response;
 
-    int res;
+    (void) cmd_sync;
+    (void) cmd_set;
+
+    // settings are streamed line by line into the result
+    response.data = param;
+    response.size = lines;
+    response.len  = 0;
+
+    param[0] = '\0';
+
+    return ( get_param_lines( channel, cmd_get, append_line, &response, CMD_GET_DUMP_SETTINGS_TMO ) );
+}
+
+/******************************************************************************
+ * get_param_lines - Sends a given get-command to provideo device and passes
+ *                   the response lines to a handler as they arrive
+ *****************************************************************************/
+int get_param_lines
+(
+    ctrl_channel_handle_t const  channel,
+    char * const                 cmd_get,
+    cmd_reader_line_t const      handler,
+    void * const                 priv,
+    int const                    tmo_ms
+)
+{
+    line_forward_t forward;
+    cmd_reader_t reader;
+
+    forward.handler = handler;
+    forward.priv    = priv;
 
     // send get-command to control channel
     ctrl_channel_send_request( channel, (uint8_t *)cmd_get, strlen(cmd_get) );
 
-    // read response from provideo device
-    res = evaluate_get_response_with_tmo( channel, data.data(), data.size(),
-                                          CMD_GET_DUMP_SETTINGS_TMO*CMD_SINGLE_LINE_RESPONSE_SIZE);
+    // the response is done with its terminator, only a silent line times out
+    cmd_reader_init( &reader, forward_line, &forward );
 
-    if ( !res )
-    {
-        bool res2 = strstr( data.data(), CMD_OK );
-        if(res2)
-        {
-            for (auto iter = data.begin(); iter != data.end(); ++iter)
-            {
-                auto jter = std::next(iter);
-
-                if(jter != data.end())
-                {
-                    if (*iter == 'O' && *jter == 'K')
-                    {
-                        jter = std::prev(data.erase(jter));
-                        data.erase(iter);
-                        break;
-                    }
-                }
-            }
+    int res = cmd_reader_receive( &reader, channel, CMD_READER_WAIT_IDLE, tmo_ms );
 
-            memcpy ( param, data.data() , data.size() );
-        }
-    }
-    else
+    // a line longer than CMD_READER_LINE_SIZE is missing in the output
+    if ( !res && reader.discarded )
     {
-        res = evaluate_error_response( data.data(), res );
+        return ( -ENOMEM );
     }
 
     return ( res );
@@ -509,11 +581,8 @@ int set_param_string
         return ( -EFAULT );
     }
 
-    // send command to COM port
-    ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-    // wait for response and evaluate
-    return ( evaluate_set_response( channel ) );
+    // send command to COM port, wait for response and evaluate
+    return ( send_set_request( channel, command, INT(strlen(command)), DEFAULT_CMD_TIMEOUT ) );
 }
 
 /******************************************************************************
@@ -542,11 +611,8 @@ int set_param_string_with_tmo
         return ( -EFAULT );
     }
 
-    // send command to COM port
-    ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-    // wait for response and evaluate
-    return ( evaluate_set_response_with_tmo( channel,  cmd_timeout_ms) );
+    // send command to COM port, wait for response and evaluate
+    return ( send_set_request( channel, command, INT(strlen(command)), cmd_timeout_ms ) );
 }
 
 /******************************************************************************
@@ -563,8 +629,9 @@ int get_param_int_X
     ...
 )
 {
-    //char data[(lines*CMD_SINGLE_LINE_RESPONSE_SIZE)]; VLA Fix:
-    std::vector<char> data(lines*CMD_SINGLE_LINE_RESPONSE_SIZE);
+    int len = lines * CMD_SINGLE_LINE_RESPONSE_SIZE;
+    std::vector<char> heap;
+    char * data = get_response_buffer( channel, len, heap );
 
     va_list args;
 
@@ -574,18 +641,16 @@ int get_param_int_X
     ctrl_channel_send_request( channel, (uint8_t *)cmd_get, strlen(cmd_get) );
 
     // read response from provideo device
-    //res = evaluate_get_response( channel, data, sizeof(data) ); VLA Fix:
-    res = evaluate_get_response( channel, data.data(), data.size() );
+    res = evaluate_get_response( channel, data, len );
     if ( !res )
     {
         // get start position of command
-        //char * s = strstr( data, cmd_sync ); VLA Fix:
-        char * s = strstr( data.data(), cmd_sync );
+        char * s = strstr( data, cmd_sync );
         if ( s )
         {
             // parse command
             va_start( args, cmd_set );
-            res = vsscanf( s, cmd_set, args );
+            res = parse_params( s, cmd_set, args );
             va_end( args );
            
             return ( res );
@@ -598,8 +663,7 @@ int get_param_int_X
     }
     else
     {
-        //res = evaluate_error_response( data, res ); VLA Fix:
-        res = evaluate_error_response( data.data(), res );
+        res = evaluate_error_response( data, res );
     }
 
     return ( res );
@@ -621,8 +685,9 @@ int get_param_int_X_with_tmo
     ...
 )
 {
-    //char data[(lines*CMD_SINGLE_LINE_RESPONSE_SIZE)]; VLA Fix:
-    std::vector<char> data(lines*CMD_SINGLE_LINE_RESPONSE_SIZE);
+    int len = lines * CMD_SINGLE_LINE_RESPONSE_SIZE;
+    std::vector<char> heap;
+    char * data = get_response_buffer( channel, len, heap );
 
     va_list args;
 
@@ -632,18 +697,16 @@ int get_param_int_X_with_tmo
     ctrl_channel_send_request( channel, (uint8_t *)cmd_get, strlen(cmd_get) );
 
     // read response from provideo device
-    //res = evaluate_get_response_with_tmo( channel, data, sizeof(data), cmd_timeout_ms ); VLA Fix:
-    res = evaluate_get_response_with_tmo( channel, data.data(), data.size(), cmd_timeout_ms );
+    res = evaluate_get_response_with_tmo( channel, data, len, cmd_timeout_ms );
     if ( !res )
     {
         // get start position of command
-        //char * s = strstr( data, cmd_sync ); VLA Fix:
-        char * s = strstr( data.data(), cmd_sync );
+        char * s = strstr( data, cmd_sync );
         if ( s )
         {
             // parse command
             va_start( args, cmd_timeout_ms );
-            res = vsscanf( s, cmd_set, args );
+            res = parse_params( s, cmd_set, args );
             va_end( args );
 
             return ( res );
@@ -656,13 +719,293 @@ int get_param_int_X_with_tmo
     }
     else
     {
-        //res = evaluate_error_response( data, res ); VLA Fix:
-        res = evaluate_error_response( data.data(), res );
+        res = evaluate_error_response( data, res );
     }
 
     return ( res );
 }
 
+/******************************************************************************
+ * batch_response_t - state of a pipelined readout, see batch_line
+ *****************************************************************************/
+typedef struct batch_response_s
+{
+    cmd_batch_item_t *  items;      /**< get-commands of the batch */
+    int                 no;         /**< number of get-commands */
+    int                 current;    /**< command of the next terminator */
+    int                 error;      /**< error-code of the last ERROR message */
+} batch_response_t;
+
+/******************************************************************************
+ * batch_line - line handler, parses the response lines of a pipelined
+ *              readout, the n-th terminator belongs to the n-th command
+ *****************************************************************************/
+static int batch_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    batch_response_t * b = (batch_response_t *)priv;
+
+    (void) len;
+
+    if ( is_ok_line( line ) || !strncmp( line, CMD_FAIL, strlen( CMD_FAIL ) ) )
+    {
+        if ( (b->current < b->no) && !is_ok_line( line ) )
+        {
+            b->items[b->current].res = b->error ? b->error : -EINVAL;
+        }
+        b->current++;
+        b->error = 0;
+
+        return ( 0 );
+    }
+
+    if ( !strncmp( line, "ERROR", 5 ) )
+    {
+        b->error = evaluate_error_response( (char *)line, -EINVAL );
+        return ( 0 );
+    }
+
+    for ( int i = 0; i < b->no; i++ )
+    {
+        cmd_batch_item_t * item = &b->items[i];
+        char const * s = strstr( line, item->cmd_sync );
+        if ( s )
+        {
+            cmd_desc_t tmp;
+            cmd_desc_t const * desc = cmd_desc_get( item->cmd_set, &tmp );
+            if ( !desc )
+            {
+                // no vsscanf fallback for a parameter array
+                item->res = -ENOSYS;
+                break;
+            }
+
+            int32_t values[CMD_DESC_MAX_PARAMS];
+            int res = cmd_decode_int( desc, s, values );
+            if ( res > 0 )
+            {
+                memcpy( item->values, values, (size_t)((res < item->no) ? res : item->no) * sizeof(int32_t) );
+            }
+            item->res = res;
+            break;
+        }
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * get_param_int_batch - Sends several get-commands in pipelined requests and
+ *                       parses the responses for integer values
+ *****************************************************************************/
+int get_param_int_batch
+(
+    ctrl_channel_handle_t const  channel,
+    cmd_batch_item_t * const     items,
+    int const                    no
+)
+{
+    char cmd[CMD_BATCH_DEPTH * CMD_SINGLE_LINE_COMMAND_SIZE];
+
+    for ( int i = 0; i < no; i++ )
+    {
+        // a command without response line is not found
+        items[i].res = -EFAULT;
+    }
+
+    for ( int first = 0; first < no; )
+    {
+        batch_response_t response;
+        cmd_reader_t reader;
+        int len = 0;
+        int n = 0;
+
+        // one request, one cache entry and one bus turnaround per batch
+        while ( ((first + n) < no) && (n < CMD_BATCH_DEPTH) )
+        {
+            int l = (int)strlen( items[first + n].cmd_get );
+            if ( (len + l) >= (int)sizeof(cmd) )
+            {
+                break;
+            }
+
+            memcpy( &cmd[len], items[first + n].cmd_get, (size_t)l );
+            len += l;
+            n++;
+        }
+        cmd[len] = '\0';
+
+        if ( !n )
+        {
+            return ( -EFAULT );
+        }
+
+        response.items   = &items[first];
+        response.no      = n;
+        response.current = 0;
+        response.error   = 0;
+
+        ctrl_channel_send_request( channel, (uint8_t *)cmd, len );
+
+        cmd_reader_init( &reader, batch_line, &response );
+        int res = cmd_reader_receive_count( &reader, channel, n, DEFAULT_CMD_TIMEOUT );
+        if ( res < 0 )
+        {
+            return ( res );
+        }
+
+        if ( res < n )
+        {
+            // the link went silent, do not queue more commands
+            for ( int i = first + res; i < no; i++ )
+            {
+                items[i].res = -EILSEQ;
+            }
+            return ( -EILSEQ );
+        }
+
+        first += n;
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * set_response_t - state of a pipelined transfer, see set_batch_line
+ *****************************************************************************/
+typedef struct set_response_s
+{
+    cmd_set_item_t *    items;      /**< set-commands of the batch */
+    int                 no;         /**< number of set-commands */
+    int                 current;    /**< command of the next terminator */
+    int                 error;      /**< error-code of the last ERROR message */
+} set_response_t;
+
+/******************************************************************************
+ * set_batch_line - line handler, the n-th terminator acknowledges the n-th
+ *                  command of a pipelined transfer
+ *****************************************************************************/
+static int set_batch_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    set_response_t * b = (set_response_t *)priv;
+
+    (void) len;
+
+    if ( is_ok_line( line ) || !strncmp( line, CMD_FAIL, strlen( CMD_FAIL ) ) )
+    {
+        if ( b->current < b->no )
+        {
+            b->items[b->current].res = is_ok_line( line ) ? 0 : (b->error ? b->error : -EINVAL);
+        }
+        b->current++;
+        b->error = 0;
+    }
+    else if ( !strncmp( line, "ERROR", 5 ) )
+    {
+        b->error = evaluate_error_response( (char *)line, -EINVAL );
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * set_param_batch - Sends several set-commands in pipelined requests
+ *****************************************************************************/
+int set_param_batch
+(
+    ctrl_channel_handle_t const  channel,
+    cmd_set_item_t * const       items,
+    int const                    no
+)
+{
+    char cmd[CMD_BATCH_DEPTH * CMD_SINGLE_LINE_COMMAND_SIZE];
+    int acked = 0;
+
+    for ( int i = 0; i < no; i++ )
+    {
+        // a command without terminator is not acknowledged
+        items[i].res = -EILSEQ;
+    }
+
+    for ( int first = 0; first < no; )
+    {
+        set_response_t response;
+        cmd_reader_t reader;
+        int tmo = DEFAULT_CMD_TIMEOUT;
+        int len = 0;
+        int n = 0;
+
+        // a slow command (mode change, flash access) gets a request of its own
+        while ( ((first + n) < no) && (n < CMD_BATCH_DEPTH) )
+        {
+            cmd_set_item_t const * item = &items[first + n];
+            bool slow = ( item->tmo_ms > CMD_BATCH_MAX_TMO );
+
+            if ( (n && slow) || ((len + item->len) >= (int)sizeof(cmd)) )
+            {
+                break;
+            }
+
+            memcpy( &cmd[len], item->cmd, (size_t)item->len );
+            len += item->len;
+            n++;
+
+            tmo = ( item->tmo_ms > tmo ) ? item->tmo_ms : tmo;
+            if ( slow )
+            {
+                break;
+            }
+        }
+        cmd[len] = '\0';
+
+        if ( !n )
+        {
+            // a single command exceeds the request buffer
+            items[first].res = -EFAULT;
+            first++;
+            continue;
+        }
+
+        response.items   = &items[first];
+        response.no      = n;
+        response.current = 0;
+        response.error   = 0;
+
+        ctrl_channel_send_request( channel, (uint8_t *)cmd, len );
+
+        cmd_reader_init( &reader, set_batch_line, &response );
+        int res = cmd_reader_receive_count( &reader, channel, n, tmo );
+        if ( res < 0 )
+        {
+            return ( res );
+        }
+
+        for ( int i = 0; i < response.current && i < n; i++ )
+        {
+            acked += !items[first + i].res;
+        }
+
+        if ( res < n )
+        {
+            // the link went silent, do not queue more commands
+            return ( -EILSEQ );
+        }
+
+        first += n;
+    }
+
+    return ( acked );
+}
+
 /******************************************************************************
  * set_param_int_X - Send a set command with X interger parameters
  *****************************************************************************/
@@ -679,25 +1022,19 @@ int set_param_int_X
 
     int res;
     
-    // clear command buffer
-    memset( command, 0, sizeof(command) );
-
     // create command to send
     va_start( args, cmd_set );
-    res = vsnprintf( command, sizeof(command), cmd_set, args );
+    res = format_params( command, INT(sizeof(command)), cmd_set, args );
     va_end( args );
 
     // prevent buffer overrun
-    if ( res >= INT(sizeof(command)) )
+    if ( res < 0 )
     {
         return ( -EFAULT );
     }
-    
-    // send command to COM port
-    ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
 
-    // wait for response and evaluate
-    return ( evaluate_set_response( channel ) );
+    // send command to COM port, wait for response and evaluate
+    return ( send_set_request( channel, command, res, DEFAULT_CMD_TIMEOUT ) );
 }
 
 /******************************************************************************
@@ -718,24 +1055,18 @@ int set_param_int_X_with_tmo
 
     int res;
 
-    // clear command buffer
-    memset( command, 0, sizeof(command) );
-
     // create command to send
     va_start( args, cmd_timeout_ms );
-    res = vsnprintf( command, sizeof(command), cmd_set, args );
+    res = format_params( command, INT(sizeof(command)), cmd_set, args );
     va_end( args );
 
     // prevent buffer overrun
-    if ( res >= INT(sizeof(command)) )
+    if ( res < 0 )
     {
         return ( -EFAULT );
     }
 
-    // send command to COM port
-    ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-    // wait for response and evaluate
-    return ( evaluate_set_response_with_tmo( channel, cmd_timeout_ms ) );
+    // send command to COM port, wait for response and evaluate
+    return ( send_set_request( channel, command, res, cmd_timeout_ms ) );
 }
 
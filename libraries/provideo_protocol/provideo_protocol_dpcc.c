@@ -31,6 +31,7 @@
 
 #include <provideo_protocol/provideo_protocol.h>
 #include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
 
 /******************************************************************************
  * @brief command "dpc" 
@@ -336,6 +337,54 @@ static int add_dpcc_pixel
                                        INT( values[0] ), INT( values[1] ) ) );
 }
 
+/******************************************************************************
+ * dpcc_table_read_t - context of dpcc table readout
+ *****************************************************************************/
+typedef struct dpcc_table_read_s
+{
+    ctrl_protocol_dpcc_table_t *    table;  /**< table to fill */
+    int                             cnt;    /**< number of received pixels */
+} dpcc_table_read_t;
+
+/******************************************************************************
+ * dpcc_pixel_line - line handler of dpcc table readout
+ *****************************************************************************/
+static int dpcc_pixel_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    dpcc_table_read_t * r = (dpcc_table_read_t *)priv;
+
+    (void) len;
+
+    // get start position of command
+    char const * s = strstr( line, CMD_SYNC_DPCC_PIXEL );
+    if ( s )
+    {
+        int x = 0, y = 0;
+        int offset = 0;
+
+        // parse command
+        int res = sscanf( s, CMD_SET_DPCC_PIXELn, &x, &y, &offset );
+        if ( (res == CMD_GET_DPCC_PIXEL_NO_PARMS) && (offset != 0) && (s[offset-1] == '\n') )
+        {
+            if ( r->cnt >= r->table->size )
+            {
+                return ( -ENOMEM );
+            }
+
+            r->table->x[r->cnt] = UINT16( x );
+            r->table->y[r->cnt] = UINT16( y );
+            r->cnt++;
+        }
+    }
+
+    return ( 0 );
+}
+
 /******************************************************************************
  * get_dpcc_table - read complete dpcc table
  *****************************************************************************/
@@ -349,140 +398,36 @@ static int get_dpcc_table
 {
     (void) ctx;
 
-    char command[CMD_SINGLE_LINE_COMMAND_SIZE];
-    char buf[CMD_SINGLE_LINE_RESPONSE_SIZE];
-    char data[CMD_SINGLE_LINE_RESPONSE_SIZE*2];
-
-    ctrl_protocol_dpcc_table_t * table;
+    dpcc_table_read_t r;
+    cmd_reader_t reader;
 
-    struct timespec start, now;
-    int loop = 1;
-    int cnt = 0;
+    int res;
 
     if ( (no != sizeof(ctrl_protocol_dpcc_table_t)) || !values )
     {
         return ( -EINVAL );
     }
     
-    table = (ctrl_protocol_dpcc_table_t *)values;
-    if ( !table->size || !table->x || !table->y )
+    r.table = (ctrl_protocol_dpcc_table_t *)values;
+    r.cnt   = 0;
+    if ( !r.table->size || !r.table->x || !r.table->y )
     {
         return ( -EINVAL );
     }
 
-    // clear command buffer
-    memset( command, 0, sizeof(command) );
-
-    // create command to send
-    sprintf( command, CMD_GET_DPCC_PIXEL );
-
     // send get-command to control channel
-    ctrl_channel_send_request( channel, (uint8_t *)command, (int)strlen(command) );
-
-    // clear data buffer
-    memset( data, 0, sizeof(data) );
-    data[0] = '\0';
-
-    // counter to check for buffer overflow
-    unsigned int data_count = 0;
+    ctrl_channel_send_request( channel, (uint8_t *)CMD_GET_DPCC_PIXEL, (int)strlen(CMD_GET_DPCC_PIXEL) );
 
-    // start timer
-    get_time_monotonic( &start );
-
-    // wait for answer from COM-Port
-    while ( loop )
+    // consume pixel positions line by line, if device does not send new pixel
+    // positions after 1 second, assume table has been transmitted completely
+    cmd_reader_init( &reader, dpcc_pixel_line, &r );
+    res = cmd_reader_receive( &reader, channel, CMD_READER_WAIT_IDLE, 1000 );
+    if ( !res )
     {
-        int n;
-
-        // poll for data (NOTE: reserve last byte for '\0')
-        memset( buf, 0, sizeof(buf) );
-        n = ctrl_channel_receive_response( channel, (uint8_t *)buf, (sizeof(buf) - 1u) );
-
-        // evaluate number of received data
-        if ( n > 0 )
-        {
-            // always put a "null" at the end of a string
-            buf[n] = '\0';
-
-            // increment data counter and check for overflow
-            data_count += (unsigned int)n;
-            if ( data_count >= sizeof(data) )
-            {
-                return ( -ENOMEM );
-            }
-
-            // append poll buffer to receive buffer
-            strcat( data, buf );
-
-            // consume all commands from buffer
-            // (get start position of first command therefoe)
-            char * s = strstr( data, CMD_SYNC_DPCC_PIXEL );
-            while ( s )
-            {
-                int x =0, y = 0;
-                int offset = 0;
-
-                // parse command
-                int res = sscanf( s, CMD_SET_DPCC_PIXELn, &x, &y, &offset );
-                if ( (res == CMD_GET_DPCC_PIXEL_NO_PARMS) && (offset != 0) && (s[offset-1] == '\n') )
-                {
-                    if ( cnt >= table->size )
-                    {
-                        return ( -ENOMEM );
-                    }
-
-                    table->x[cnt] = UINT16( x );
-                    table->y[cnt] = UINT16( y );
-                    cnt++;
-
-                    // decrement data counter by bytes taken out
-                    unsigned int num_bytes_processed = (unsigned int)(s + offset - data);
-                    data_count -= num_bytes_processed;
-
-                    // move out the processed command
-                    // Note: Use memmove instead of strncpy, because dst and src overlap!
-                    memmove( data, (s+offset), data_count );
-
-                    // clear moved out data to make sure buffer is free of garbage
-                    memset((data + data_count), 0, num_bytes_processed );
-           
-                    // search next command in buffer
-                    s = strstr( data, CMD_SYNC_DPCC_PIXEL );
-                }
-                else
-                {
-                    s = NULL;
-                }
-            }
-
-            // check if string is complete and valid
-            if ( strstr( data, CMD_OK ) )
-            {
-                table->no = (uint16_t)cnt;
-                return ( 0 );
-            }
-
-            // check if string is complete and error-message
-            else if ( strstr( data, CMD_FAIL ) )
-            {
-                return ( evaluate_error_response( data, -EINVAL ) );
-            }
-
-            // reset timer
-            get_time_monotonic( &start );
-        }
-        else
-        {
-            // timeout handling, if device does not send new pixel positions after
-            // 1 second, assume table has been transmitted completely
-            // timeout handling
-            get_time_monotonic( &now );
-            int diff_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
-            loop = (diff_ms > 1000) ? 0 : 1;
-        }
+        r.table->no = (uint16_t)r.cnt;
     }
 
-    return ( -EILSEQ );
+    return ( res );
 }
 
 /******************************************************************************
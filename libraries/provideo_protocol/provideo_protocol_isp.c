@@ -130,7 +130,7 @@
 #define CMD_SET_FILTER_ENABLE_WITH_COPY_FLAG    ( "filter_enable %i %i\n" )
 #define CMD_SYNC_FILTER_ENABLE                  ( "filter_enable " )
 #define CMD_FILTER_ENABLE_NO_PARMS              ( 1 )
-#define CMD_GET_FILTER_TMO                      ( 120 ) // Default 100ms timeout is to short when using slower 57600 baudrate
+#define CMD_GET_FILTER_TMO                      ( DEFAULT_CMD_TIMEOUT ) // line time at slow baudrates is added by the reader
 
 /******************************************************************************
  * @brief command "filter_detail" 
@@ -158,7 +158,7 @@
 #define CMD_SET_FILTER_ANTIALIASING_WITH_COPY_FLAG ( "antialiasing %i %i\n" )
 #define CMD_SYNC_FILTER_ANTIALIASING               ( "antialiasing " )
 #define CMD_FILTER_ANTIALIASING_NO_PARMS           ( 1 )
-#define CMD_GET_FILTER_ANTIALIASING_TMO            ( 120 ) // Default 100ms timeout is to short when using slower 57600 baudrate
+#define CMD_GET_FILTER_ANTIALIASING_TMO            ( DEFAULT_CMD_TIMEOUT ) // line time at slow baudrates is added by the reader
 
 /******************************************************************************
  * @brief command "color_conv" 
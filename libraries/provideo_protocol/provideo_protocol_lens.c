@@ -21,6 +21,7 @@
  *
  *****************************************************************************/
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <errno.h>
 
@@ -1050,6 +1051,102 @@ static int set_lens_filter_settings
 //    return ( set_param_int_X( channel, CMD_SET_CAM_IRIS_APT, INT( pos ) ) );
 //}
 
+/******************************************************************************
+ * @brief get-command of a lens state value
+ *****************************************************************************/
+typedef struct lens_state_cmd_s
+{
+    uint32_t        flag;       /**< CTRL_PROTOCOL_LENS_STATE_* */
+    char const *    cmd_get;    /**< command string to readout value */
+    char const *    cmd_sync;   /**< command string to find response line */
+    char const *    cmd_set;    /**< formatted command string to parse response */
+    int             no;         /**< number of values */
+    size_t          offset;     /**< offset of values in ctrl_protocol_lens_state_t */
+} lens_state_cmd_t;
+
+#define LENS_STATE_CMD( flag, cmd, no, member )                                  \
+    { CTRL_PROTOCOL_LENS_STATE_##flag, CMD_GET_##cmd, CMD_SYNC_##cmd, CMD_SET_##cmd, \
+      no, offsetof( ctrl_protocol_lens_state_t, member ) }
+
+/******************************************************************************
+ * @brief lens state values in readout order
+ *****************************************************************************/
+static lens_state_cmd_t const lens_state_cmds[] =
+{
+    LENS_STATE_CMD( SETTINGS       , LENS_SETTINGS       , CMD_GET_LENS_SETTINGS_NO_PARAMS       , settings ),
+    LENS_STATE_CMD( ACTIVE         , LENS_ACTIVE         , 1                                     , active ),
+    LENS_STATE_CMD( INVERT         , LENS_INVERT         , CMD_GET_LENS_INVERT_NO_PARAMS         , invert ),
+    LENS_STATE_CMD( FOCUS_POSITION , LENS_FOCUS_POSITION , 1                                     , focus_position ),
+    LENS_STATE_CMD( FINE_FOCUS     , LENS_FINE_FOCUS     , 1                                     , fine_focus ),
+    LENS_STATE_CMD( ZOOM_POSITION  , LENS_ZOOM_POSITION  , 1                                     , zoom_position ),
+    LENS_STATE_CMD( IRIS_POSITION  , LENS_IRIS_POSITION  , 1                                     , iris_position ),
+    LENS_STATE_CMD( FILTER_POSITION, LENS_FILTER_POSITION, 1                                     , filter_position ),
+    LENS_STATE_CMD( IRIS_APERTURE  , LENS_IRIS_APERTURE  , 1                                     , iris_aperture ),
+    LENS_STATE_CMD( IRIS_SETUP     , LENS_IRIS_SETUP     , CMD_GET_LENS_IRIS_SETUP_NO_PARAMS     , iris_setup ),
+    LENS_STATE_CMD( FOCUS_SETTINGS , LENS_FOCUS_SETTINGS , CMD_GET_LENS_FOCUS_SETTINGS_NO_PARAMS , focus_settings ),
+    LENS_STATE_CMD( ZOOM_SETTINGS  , LENS_ZOOM_SETTINGS  , CMD_GET_LENS_ZOOM_SETTINGS_NO_PARAMS  , zoom_settings ),
+    LENS_STATE_CMD( IRIS_SETTINGS  , LENS_IRIS_SETTINGS  , CMD_GET_LENS_IRIS_SETTINGS_NO_PARAMS  , iris_settings ),
+    LENS_STATE_CMD( FILTER_SETTINGS, LENS_FILTER_SETTINGS, CMD_GET_LENS_FILTER_SETTINGS_NO_PARAMS, filter_settings ),
+};
+
+/******************************************************************************
+ * get_lens_state
+ *****************************************************************************/
+static int get_lens_state
+(
+    void * const                ctx,
+    ctrl_channel_handle_t const channel,
+    int const                   no,
+    uint8_t * const             values
+)
+{
+    (void) ctx;
+
+    ctrl_protocol_lens_state_t * state = (ctrl_protocol_lens_state_t *)values;
+    cmd_batch_item_t items[ARRAY_SIZE(lens_state_cmds)];
+    uint32_t flags[ARRAY_SIZE(lens_state_cmds)];
+    unsigned i;
+    int n = 0;
+    int res;
+
+    // parameter check
+    if ( !values || (no != (int)sizeof(ctrl_protocol_lens_state_t)) )
+    {
+        return ( -EINVAL );
+    }
+
+    state->valid = 0u;
+
+    for ( i = 0u; i < ARRAY_SIZE(lens_state_cmds); i++ )
+    {
+        lens_state_cmd_t const * cmd = &lens_state_cmds[i];
+
+        if ( state->request & cmd->flag )
+        {
+            items[n].cmd_get  = cmd->cmd_get;
+            items[n].cmd_sync = cmd->cmd_sync;
+            items[n].cmd_set  = cmd->cmd_set;
+            items[n].no       = cmd->no;
+            items[n].values   = (int32_t *)(values + cmd->offset);
+            flags[n]          = cmd->flag;
+            n++;
+        }
+    }
+
+    res = get_param_int_batch( channel, items, n );
+
+    // values of answered commands are valid even if the link failed later
+    for ( i = 0u; i < (unsigned)n; i++ )
+    {
+        if ( items[i].res == items[i].no )
+        {
+            state->valid |= flags[i];
+        }
+    }
+
+    return ( (res < 0) && !state->valid ? res : 0 );
+}
+
 /******************************************************************************
  * Lens protocol driver declaration
  *****************************************************************************/
@@ -1089,6 +1186,7 @@ static ctrl_protocol_lens_drv_t provideo_lens_drv =
     .get_lens_filter_settings      = get_lens_filter_settings,
     .set_lens_filter_settings      = set_lens_filter_settings,
 
+    .get_lens_state                = get_lens_state,
 
 //    .get_iris_apt               = get_iris_apt,
 //    .set_iris_apt               = set_iris_apt,
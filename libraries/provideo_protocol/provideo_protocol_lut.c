@@ -585,11 +585,8 @@ static int set_lut_sample_internal
             x_i[i+0], y_i[i+0], x_i[i+1], y_i[i+1], x_i[i+2], y_i[i+2], x_i[i+3], y_i[i+3],
             x_i[i+4], y_i[i+4], x_i[i+5], y_i[i+5], x_i[i+6], y_i[i+6], x_i[i+7], y_i[i+7] );
 
-        // send command to COM port
-        ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-        // wait for response and evaluate
-        res = evaluate_set_response_with_tmo( channel, CMD_EVALUATE_SET_RESPONSE_TMO );
+        // send command to COM port, wait for response and evaluate
+        res = send_set_request( channel, command, (int)strlen(command), CMD_EVALUATE_SET_RESPONSE_TMO );
         if ( res )
         {
             return ( res );
@@ -622,11 +619,8 @@ static int set_lut_sample_internal
         }
 
         strcat (command,"\n");
-        // send command to COM port
-        ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-        // wait for response and evaluate
-        res = evaluate_set_response_with_tmo( channel, CMD_EVALUATE_SET_RESPONSE_TMO );
+        // send command to COM port, wait for response and evaluate
+        res = send_set_request( channel, command, (int)strlen(command), CMD_EVALUATE_SET_RESPONSE_TMO );
 
         if ( res )
         {
@@ -691,11 +685,8 @@ static int set_lut_sample_internal
                 break;
         }
 
-        // send command to COM port
-        ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-        // wait for response and evaluate
-        res = evaluate_set_response_with_tmo( channel, CMD_EVALUATE_SET_RESPONSE_TMO );
+        // send command to COM port, wait for response and evaluate
+        res = send_set_request( channel, command, (int)strlen(command), CMD_EVALUATE_SET_RESPONSE_TMO );
 
         if ( res )
         {
@@ -715,11 +706,8 @@ static int set_lut_sample_internal
         sprintf( command, cmd_4,
             x_i[i+0], y_i[i+0], x_i[i+1], y_i[i+1], x_i[i+2], y_i[i+2], x_i[i+3], y_i[i+3] );
 
-        // send command to COM port
-        ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-        // wait for response and evaluate
-        res = evaluate_set_response_with_tmo( channel, CMD_EVALUATE_SET_RESPONSE_TMO );
+        // send command to COM port, wait for response and evaluate
+        res = send_set_request( channel, command, (int)strlen(command), CMD_EVALUATE_SET_RESPONSE_TMO );
         if ( res )
         {
             return ( res );
@@ -739,11 +727,8 @@ static int set_lut_sample_internal
         sprintf( command, cmd_2,
             x_i[i+0], y_i[i+0], x_i[i+1], y_i[i+1] );
         
-        // send command to COM port
-        ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-        // wait for response and evaluate
-        res = evaluate_set_response_with_tmo( channel, CMD_EVALUATE_SET_RESPONSE_TMO );
+        // send command to COM port, wait for response and evaluate
+        res = send_set_request( channel, command, (int)strlen(command), CMD_EVALUATE_SET_RESPONSE_TMO );
         if ( res )
         {
             return ( res );
@@ -762,11 +747,8 @@ static int set_lut_sample_internal
         // create command to send
         sprintf( command, cmd_1, x_i[n+0], y_i[n+0] );
         
-        // send command to COM port
-        ctrl_channel_send_request( channel, (uint8_t *)command, strlen(command) );
-
-        // wait for response and evaluate
-        res = evaluate_set_response_with_tmo( channel, CMD_EVALUATE_SET_RESPONSE_TMO );
+        // send command to COM port, wait for response and evaluate
+        res = send_set_request( channel, command, (int)strlen(command), CMD_EVALUATE_SET_RESPONSE_TMO );
         if ( res )
         {
             return ( res );
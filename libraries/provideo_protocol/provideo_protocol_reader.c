@@ -0,0 +1,438 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_reader.c
+ *
+ * @brief   Implementation of the streaming response line reader
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
+#include <provideo_protocol/provideo_protocol_timing.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define CMD_ERROR_PREFIX            ( "ERROR" )
+
+/******************************************************************************
+ * is_space - same characters as isspace() in the "C" locale
+ *****************************************************************************/
+static inline int is_space( char const c )
+{
+    return ( (c == ' ') || ((c >= '\t') && (c <= '\r')) );
+}
+
+/******************************************************************************
+ * trim - get the line content without surrounding whitespace
+ *****************************************************************************/
+static char const * trim( char const * s, int * const len )
+{
+    int n = *len;
+
+    while ( (n > 0) && is_space( *s ) )
+    {
+        s++;
+        n--;
+    }
+
+    while ( (n > 0) && is_space( s[n - 1] ) )
+    {
+        n--;
+    }
+
+    *len = n;
+
+    return ( s );
+}
+
+/******************************************************************************
+ * is_word - compare trimmed line content with a word
+ *****************************************************************************/
+static inline int is_word( char const * const s, int const len, char const * const word )
+{
+    return ( (len == (int)strlen( word )) && !memcmp( s, word, (size_t)len ) );
+}
+
+/******************************************************************************
+ * process_line - evaluate a complete line
+ *****************************************************************************/
+static void process_line( cmd_reader_t * const reader )
+{
+    int len = reader->len;
+    char const * s;
+
+    reader->line[reader->len] = '\0';
+    s = trim( reader->line, &len );
+
+    if ( (reader->state == CMD_READER_STATE_ABORT) || !len )
+    {
+        return;
+    }
+
+    if ( reader->handler )
+    {
+        int res = reader->handler( reader->priv, reader->line, reader->len );
+        if ( res < 0 )
+        {
+            reader->state = CMD_READER_STATE_ABORT;
+            reader->error = res;
+            return;
+        }
+    }
+
+    if ( is_word( s, len, CMD_OK ) )
+    {
+        reader->state = CMD_READER_STATE_OK;
+        reader->terminators++;
+    }
+    else if ( is_word( s, len, CMD_FAIL ) )
+    {
+        reader->terminators++;
+        if ( reader->state != CMD_READER_STATE_OK )
+        {
+            reader->state = CMD_READER_STATE_FAIL;
+        }
+    }
+    else if ( !strncmp( s, CMD_ERROR_PREFIX, strlen( CMD_ERROR_PREFIX ) ) )
+    {
+        reader->error = evaluate_error_response( reader->line, -EINVAL );
+    }
+}
+
+/******************************************************************************
+ * cmd_reader_init
+ *****************************************************************************/
+void cmd_reader_init
+(
+    cmd_reader_t * const    reader,
+    cmd_reader_line_t const handler,
+    void * const            priv
+)
+{
+    reader->handler     = handler;
+    reader->priv        = priv;
+    reader->len         = 0;
+    reader->discard     = 0;
+    reader->discarded   = 0;
+    reader->state       = CMD_READER_STATE_BUSY;
+    reader->error       = 0;
+    reader->terminators = 0;
+}
+
+/******************************************************************************
+ * cmd_reader_feed
+ *****************************************************************************/
+cmd_reader_state_t cmd_reader_feed
+(
+    cmd_reader_t * const    reader,
+    char const * const      data,
+    int const               len
+)
+{
+    int i = 0;
+
+    while ( i < len )
+    {
+        char const * eol = (char const *)memchr( &data[i], '\n', (size_t)(len - i) );
+        int n = eol ? ((int)(eol - &data[i]) + 1) : (len - i);
+
+        // append to current line, lines which do not fit are skipped
+        if ( !reader->discard && (n < (CMD_READER_LINE_SIZE - reader->len)) )
+        {
+            memcpy( &reader->line[reader->len], &data[i], (size_t)n );
+            reader->len += n;
+        }
+        else
+        {
+            reader->discard = 1;
+        }
+        i += n;
+
+        if ( eol )
+        {
+            if ( !reader->discard )
+            {
+                process_line( reader );
+            }
+            else
+            {
+                reader->discarded++;
+            }
+            reader->len     = 0;
+            reader->discard = 0;
+        }
+    }
+
+    // a terminator is complete even if its line end is still missing
+    if ( reader->len && !reader->discard )
+    {
+        int n = reader->len;
+        char const * s = trim( reader->line, &n );
+
+        if ( is_word( s, n, CMD_OK ) || is_word( s, n, CMD_FAIL ) )
+        {
+            process_line( reader );
+            reader->len = 0;
+        }
+    }
+
+    return ( reader->state );
+}
+
+/******************************************************************************
+ * cmd_reader_result
+ *****************************************************************************/
+int cmd_reader_result
+(
+    cmd_reader_t const * const reader
+)
+{
+    switch ( reader->state )
+    {
+        case CMD_READER_STATE_OK:
+            return ( 0 );
+
+        case CMD_READER_STATE_FAIL:
+            return ( reader->error ? reader->error : -EINVAL );
+
+        case CMD_READER_STATE_ABORT:
+            return ( reader->error );
+
+        default:
+            return ( -EILSEQ );
+    }
+}
+
+/******************************************************************************
+ * monotonic_ms - monotonic time in ms
+ *****************************************************************************/
+static int64_t monotonic_ms( void )
+{
+    struct timespec now;
+
+    get_time_monotonic( &now );
+
+    return ( (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000 );
+}
+
+/******************************************************************************
+ * skip_late_responses - drop the responses of requests which were given up
+ * at their deadline, they arrive in front of the response to the current
+ * request, returns the number of bytes dropped
+ *****************************************************************************/
+static int skip_late_responses
+(
+    cmd_reader_t * const        late,
+    ctrl_channel_handle_t const channel,
+    char const * const          data,
+    int const                   len
+)
+{
+    int i = 0;
+
+    while ( (i < len) && (ctrl_channel_get_late_responses( channel, monotonic_ms() ) > 0) )
+    {
+        char const * eol = (char const *)memchr( &data[i], '\n', (size_t)(len - i) );
+        int n = eol ? ((int)(eol - &data[i]) + 1) : (len - i);
+
+        cmd_reader_feed( late, &data[i], n );
+        i += n;
+
+        if ( late->terminators )
+        {
+            // a late response shows that the device is alive as well
+            ctrl_channel_count_response( channel );
+            ctrl_channel_skip_late_response( channel );
+            cmd_reader_init( late, NULL, NULL );
+        }
+    }
+
+    return ( i );
+}
+
+/******************************************************************************
+ * cmd_reader_receive
+ *****************************************************************************/
+int cmd_reader_receive
+(
+    cmd_reader_t * const        reader,
+    ctrl_channel_handle_t const channel,
+    cmd_reader_wait_t const     wait,
+    int const                   tmo_ms
+)
+{
+    char buf[CMD_SINGLE_LINE_RESPONSE_SIZE];
+
+    struct timespec start, now;
+    cmd_timing_t timing;
+    cmd_reader_t late;
+    int received = 0;
+    int skipped = 0;
+    int diff_ms = 0;
+    int loop = 1;
+
+    cmd_reader_init( &late, NULL, NULL );
+
+    // replies of several devices or streamed data are not timed
+    if ( wait == CMD_READER_WAIT_TERMINATOR )
+    {
+        cmd_timing_start( &timing, channel, tmo_ms );
+
+        // the device is busy rather than dead while a late response is expected
+        if ( ctrl_channel_get_late_responses( channel, monotonic_ms() ) > 0 )
+        {
+            timing.deadline = timing.timeout;
+        }
+    }
+    else
+    {
+        memset( &timing, 0, sizeof(timing) );
+        timing.deadline = tmo_ms;
+        timing.timeout  = tmo_ms;
+    }
+
+    // start timer
+    get_time_monotonic( &start );
+
+    // wait for answer from COM-Port
+    while ( loop )
+    {
+        int n = ctrl_channel_receive_response( channel, (uint8_t *)buf, (int)sizeof(buf) );
+        int skip = (n > 0) ? skip_late_responses( &late, channel, buf, n ) : 0;
+
+        if ( skip )
+        {
+            /* The device answers again, give our own response the full
+             * timeout. If the skipped response was ours after all, the
+             * request fails without noting another late response, so the
+             * stream is in step again. */
+            skipped = 1;
+            timing.deadline = timing.timeout;
+            get_time_monotonic( &start );
+        }
+
+        // evaluate number of received data
+        if ( n > skip )
+        {
+            cmd_reader_state_t state = cmd_reader_feed( reader, &buf[skip], n - skip );
+
+            received += n - skip;
+
+            if ( (state == CMD_READER_STATE_ABORT)
+                    || ((state != CMD_READER_STATE_BUSY) && (wait != CMD_READER_WAIT_TIMEOUT)) )
+            {
+                loop = 0;
+            }
+            else if ( wait == CMD_READER_WAIT_IDLE )
+            {
+                // restart timer
+                get_time_monotonic( &start );
+            }
+        }
+        else if ( n <= 0 )
+        {
+            // timeout handling, a silent line is given up at the (shorter) deadline
+            get_time_monotonic( &now );
+            diff_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+            loop = (diff_ms > (received ? timing.timeout : timing.deadline)) ? 0 : 1;
+        }
+    }
+
+    // any terminated response shows that the device is alive
+    if ( (reader->state == CMD_READER_STATE_OK) || (reader->state == CMD_READER_STATE_FAIL) )
+    {
+        ctrl_channel_count_response( channel );
+
+        get_time_monotonic( &now );
+        diff_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+        cmd_timing_finish( &timing, diff_ms, received, 1 );
+    }
+    else if ( reader->state == CMD_READER_STATE_BUSY )
+    {
+        cmd_timing_finish( &timing, diff_ms, received, 0 );
+
+        // given up before the timeout, the response may still arrive
+        if ( !received && !skipped && (diff_ms <= timing.timeout) )
+        {
+            ctrl_channel_add_late_response( channel,
+                (int64_t)start.tv_sec * 1000 + start.tv_nsec / 1000000 + timing.timeout );
+        }
+    }
+
+    return ( cmd_reader_result( reader ) );
+}
+
+/******************************************************************************
+ * cmd_reader_receive_count
+ *****************************************************************************/
+int cmd_reader_receive_count
+(
+    cmd_reader_t * const        reader,
+    ctrl_channel_handle_t const channel,
+    int const                   count,
+    int const                   tmo_ms
+)
+{
+    char buf[CMD_SINGLE_LINE_RESPONSE_SIZE];
+
+    struct timespec start, now;
+    cmd_reader_t late;
+    int diff_ms;
+    int i;
+
+    cmd_reader_init( &late, NULL, NULL );
+
+    // start timer
+    get_time_monotonic( &start );
+
+    while ( (reader->terminators < count) && (reader->state != CMD_READER_STATE_ABORT) )
+    {
+        int n = ctrl_channel_receive_response( channel, (uint8_t *)buf, (int)sizeof(buf) );
+        if ( n > 0 )
+        {
+            int skip = skip_late_responses( &late, channel, buf, n );
+
+            cmd_reader_feed( reader, &buf[skip], n - skip );
+
+            // restart timer
+            get_time_monotonic( &start );
+        }
+        else
+        {
+            get_time_monotonic( &now );
+            diff_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+            if ( diff_ms > tmo_ms )
+            {
+                break;
+            }
+        }
+    }
+
+    for ( i = 0; i < reader->terminators; i++ )
+    {
+        ctrl_channel_count_response( channel );
+    }
+
+    return ( (reader->state == CMD_READER_STATE_ABORT) ? reader->error : reader->terminators );
+}
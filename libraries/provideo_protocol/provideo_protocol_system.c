@@ -30,6 +30,7 @@
 #include <ctrl_protocol/ctrl_protocol_system.h>
 
 #include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
 
 /******************************************************************************
  * @brief command "version" 
@@ -285,6 +286,7 @@
 #define CMD_SET_SETTINGS                        ( "%s\n" )
 
 #define CMD_GET_DEVICE_SETTINGS_TMO             ( 10000 )
+#define CMD_GET_DEVICE_SETTINGS_IDLE_TMO        ( 2000 )
 
 /******************************************************************************
  * get_system_info
@@ -1376,6 +1378,57 @@ static int set_rs485_termination
     return ( set_param_int_X( channel, CMD_SET_RS485_TERMINATION, INT( enable ) ) );
 }
 
+/******************************************************************************
+ * device_list_read_t - context of device list readout
+ *****************************************************************************/
+typedef struct device_list_read_s
+{
+    ctrl_protocol_device_t *    device_list;    /**< list to fill */
+    int                         cnt;            /**< number of received devices */
+} device_list_read_t;
+
+/******************************************************************************
+ * device_list_line - line handler of device list readout
+ *****************************************************************************/
+static int device_list_line
+(
+    void * const        priv,
+    char const * const  line,
+    int const           len
+)
+{
+    device_list_read_t * r = (device_list_read_t *)priv;
+
+    (void) len;
+
+    // get start position of command
+    char const * s = strstr( line, CMD_SYNC_DEVICE_LIST );
+    if ( s )
+    {
+        // parse command
+        int offset = 0;
+        ctrl_protocol_device_t device;
+        int res = sscanf( s, CMD_GET_DEVICE_LIST_REPLY, device.device_platform,
+                                                        &device.rs485_address,
+                                                        &device.rs485_bc_address,
+                                                        &device.rs485_bc_master,
+                                                        device.device_name,
+                                                        &offset);
+        if ( res == CMD_GET_DEVICE_LIST_NO_PARAMS )
+        {
+            if ( r->cnt >= CMD_DEVICE_LIST_MAX_DEVICES )
+            {
+                return ( -ENOMEM );
+            }
+
+            memcpy( &r->device_list[r->cnt], &device, sizeof(device) );
+            r->cnt++;
+        }
+    }
+
+    return ( 0 );
+}
+
 /******************************************************************************
  * get_device_list - gets the list of devices which are connected to this com
  *                   port
@@ -1390,13 +1443,8 @@ static int get_device_list
 {
     (void) ctx;
 
-    char command[CMD_SINGLE_LINE_COMMAND_SIZE];
-    char buf[CMD_SINGLE_LINE_RESPONSE_SIZE];
-    char data[CMD_SINGLE_LINE_RESPONSE_SIZE*2];
-
-    struct timespec start, now;
-    int loop = 1;
-    int cnt = 0;
+    device_list_read_t r;
+    cmd_reader_t reader;
 
     if ( (no != sizeof(ctrl_protocol_device_t) * CMD_DEVICE_LIST_MAX_DEVICES) || !buffer )
     {
@@ -1410,122 +1458,16 @@ static int get_device_list
         timeout = CMD_GET_DEVICE_LIST_MAX_TMO;
     }
 
-    ctrl_protocol_device_t * device_list = (ctrl_protocol_device_t *)buffer;
-
-    // clear command buffer
-    memset( command, 0, sizeof(command) );
-
-    // create command to send
-    sprintf( command, CMD_GET_DEVICE_LIST );
+    r.device_list = (ctrl_protocol_device_t *)buffer;
+    r.cnt         = 0;
 
     // send get-command to control channel
-    ctrl_channel_send_request( channel, (uint8_t *)command, (int)strlen(command) );
+    ctrl_channel_send_request( channel, (uint8_t *)CMD_GET_DEVICE_LIST, (int)strlen(CMD_GET_DEVICE_LIST) );
 
-    // clear data buffer
-    memset( data, 0, sizeof(data) );
-    data[0] = '\0';
+    // all devices on the bus answer, so collect replies until timeout
+    cmd_reader_init( &reader, device_list_line, &r );
 
-    // counter to check for buffer overflow
-    unsigned int data_count = 0;
-
-    // start timer
-    get_time_monotonic( &start );
-
-    // wait for answer from COM-Port
-    while ( loop )
-    {
-        int n;
-
-        // poll for data (NOTE: reserve last byte for '\0')
-        memset( buf, 0, sizeof(buf) );
-        n = ctrl_channel_receive_response( channel, (uint8_t *)buf, (sizeof(buf) - 1u) );
-
-        // evaluate number of received data
-        if ( n > 0 )
-        {
-            // always put a "null" at the end of a string
-            buf[n] = '\0';
-
-            // increment data counter and check for overflow
-            data_count += (unsigned int)n;
-            if ( data_count >= sizeof(data) )
-            {
-                return ( -ENOMEM );
-            }
-
-            // append poll buffer to receive buffer
-            strcat( data, buf );
-
-            // consume all commands from buffer
-            // (therefore get start position of first command)
-            char * s = strstr( data, CMD_SYNC_DEVICE_LIST );
-            while ( s )
-            {
-                // parse command
-                int offset = 0;
-                ctrl_protocol_device_t device;
-                int res = sscanf( s, CMD_GET_DEVICE_LIST_REPLY, device.device_platform,
-                                                                &device.rs485_address,
-                                                                &device.rs485_bc_address,
-                                                                &device.rs485_bc_master,
-                                                                device.device_name,
-                                                                &offset);
-
-                /* Note: the check for offset != 0 is needed, because on Windows it
-                 * seems to be possible that sscanf() has a result != 0 (meaning it has
-                 * found parameters and parsed them) but still report an offset of 0. */
-                if ( (res == CMD_GET_DEVICE_LIST_NO_PARAMS) )// && (offset != 0) && (s[offset-1] == '\n') ) // TODO:check why condition "(offset != 0) && (s[offset-1] == '\n')" not working
-                {
-                    if ( cnt >= CMD_DEVICE_LIST_MAX_DEVICES )
-                    {
-                        return ( -ENOMEM );
-                    }
-
-                    memcpy(  &device_list[cnt], &device, sizeof(device) );
-                    cnt++;
-
-                    // decrement data counter by bytes taken out
-                    unsigned int num_bytes_processed = (unsigned int)(s + offset - data);
-                    data_count -= num_bytes_processed;
-
-                    // move out the processed command
-                    // Note: Use memmove instead of strncpy, because dst and src overlap!
-                    memmove( data, (s+offset), data_count );
-
-                    // clear moved out data to make sure buffer is free of garbage
-                    memset((data + data_count), 0, num_bytes_processed );
-
-                    // search next command in buffer
-                    s = strstr( data, CMD_SYNC_DEVICE_LIST );
-                }
-                else
-                {
-                    s = NULL;
-                }
-            }
-        }
-        else
-        {
-            // timeout handling
-            get_time_monotonic( &now );
-            int diff_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
-            loop = (diff_ms > (int)timeout) ? 0 : 1;
-        }
-    }
-
-    // check if last id answer was complete and valid
-    if ( strstr( data, CMD_OK ) )
-    {
-        return ( 0 );
-    }
-
-    // check if last id answer was complete and error-message
-    else if ( strstr( data, CMD_FAIL ) )
-    {
-        return ( evaluate_error_response( data, -EINVAL ) );
-    }
-
-    return ( -EILSEQ );
+    return ( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TIMEOUT, (int)timeout ) );
 }
 
 /******************************************************************************
@@ -2161,7 +2103,33 @@ static int get_device_settings
     res = get_param_settings_string( channel, CMD_GET_DEVICE_SETTINGS_RESPONSE_LINES,
             CMD_GET_DEVICE_SETTINGS, CMD_SYNC_GET_DEVICE_SETTINGS, CMD_SET_DEVICE_SETTINGS, (char *)settings );
 
-    return ( 0 );
+    return ( res );
+}
+
+/******************************************************************************
+ * read_device_settings
+ *****************************************************************************/
+static int read_device_settings
+(
+    void * const                ctx,
+    ctrl_channel_handle_t const channel,
+    int const                   no,
+    uint8_t * const             values
+)
+{
+    (void) ctx;
+
+    ctrl_protocol_line_reader_t * r = (ctrl_protocol_line_reader_t *)values;
+
+    // parameter check
+    if ( !no || !values || (no != sizeof(ctrl_protocol_line_reader_t)) || !r->handler )
+    {
+        return ( -EINVAL );
+    }
+
+    // the dump is passed on line by line, only the idle time is limited
+    return ( get_param_lines( channel, CMD_GET_DEVICE_SETTINGS, r->handler, r->priv,
+                              CMD_GET_DEVICE_SETTINGS_IDLE_TMO ) );
 }
 
 /******************************************************************************
@@ -2198,6 +2166,59 @@ static int set_device_settings
 
 }
 
+/******************************************************************************
+ * send_commands - pipelined transfer of set-commands
+ *****************************************************************************/
+static int send_commands
+(
+    void * const                ctx,
+    ctrl_channel_handle_t const channel,
+    int const                   no,
+    uint8_t * const             values
+)
+{
+    (void) ctx;
+
+    ctrl_protocol_cmd_t * cmds = (ctrl_protocol_cmd_t *)values;
+    cmd_set_item_t items[4 * CMD_BATCH_DEPTH];
+    int acked = 0;
+    int i;
+
+    // parameter check
+    if ( (no < 0) || !values )
+    {
+        return ( -EINVAL );
+    }
+
+    for ( int first = 0; first < no; first += i )
+    {
+        int res;
+
+        for ( i = 0; (i < (int)ARRAY_SIZE(items)) && ((first + i) < no); i++ )
+        {
+            items[i].cmd    = cmds[first + i].cmd;
+            items[i].len    = cmds[first + i].len;
+            items[i].tmo_ms = cmds[first + i].tmo_ms;
+        }
+
+        res = set_param_batch( channel, items, i );
+
+        for ( int k = 0; k < i; k++ )
+        {
+            cmds[first + k].res = items[k].res;
+        }
+
+        if ( res < 0 )
+        {
+            return ( res );
+        }
+
+        acked += res;
+    }
+
+    return ( acked );
+}
+
 /******************************************************************************
  * System protocol driver declaration
  *****************************************************************************/
@@ -2253,6 +2274,8 @@ static ctrl_protocol_sys_drv_t provideo_sys_drv =
     .copy_settings                = copy_settings,
     .get_device_settings          = get_device_settings,
     .set_device_settings          = set_device_settings,
+    .send_commands                = send_commands,
+    .read_device_settings         = read_device_settings,
 };
 
 /******************************************************************************
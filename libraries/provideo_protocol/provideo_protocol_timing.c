@@ -0,0 +1,250 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_timing.c
+ *
+ * @brief   Implementation of the adaptive response deadlines
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <provideo_protocol/provideo_protocol_timing.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define FNV_OFFSET_BASIS            ( 2166136261u )
+#define FNV_PRIME                   ( 16777619u )
+
+#define MAX_SAMPLE                  ( 0xffff )
+
+/******************************************************************************
+ * response statistics of a command
+ *****************************************************************************/
+typedef struct cmd_timing_entry_s
+{
+    uint32_t    key;                                /**< command and line rate */
+    uint16_t    samples[CMD_TIMING_NO_SAMPLES];     /**< response times in ms, without line time */
+    uint16_t    response_len;                       /**< longest response in bytes */
+    uint8_t     no;                                 /**< number of valid samples */
+    uint8_t     pos;                                /**< next sample to overwrite */
+} cmd_timing_entry_t;
+
+/******************************************************************************
+ * local variables
+ *****************************************************************************/
+static cmd_timing_entry_t timing_table[CMD_TIMING_TABLE_SIZE];
+
+/******************************************************************************
+ * fnv1a - FNV-1a hash step
+ *****************************************************************************/
+static inline uint32_t fnv1a( uint32_t h, uint8_t const c )
+{
+    return ( (h ^ c) * FNV_PRIME );
+}
+
+/******************************************************************************
+ * command_key - hash of the command word, whether parameters follow (a set
+ *               command takes longer than the get command of the same name)
+ *               and the line rate
+ *****************************************************************************/
+static uint32_t command_key
+(
+    uint8_t const * const   request,
+    int const               len,
+    uint32_t const          line_rate
+)
+{
+    uint32_t h = FNV_OFFSET_BASIS;
+    int n = (len < CTRL_CHANNEL_REQUEST_SIZE) ? len : CTRL_CHANNEL_REQUEST_SIZE;
+    int i = 0;
+
+    while ( (i < n) && (request[i] != ' ') && (request[i] != '\r') && (request[i] != '\n') )
+    {
+        h = fnv1a( h, request[i] );
+        i++;
+    }
+
+    h = fnv1a( h, (uint8_t)(((i < n) && (request[i] == ' ')) ? 1u : 0u) );
+    h = fnv1a( h, (uint8_t)(line_rate >>  0) );
+    h = fnv1a( h, (uint8_t)(line_rate >>  8) );
+    h = fnv1a( h, (uint8_t)(line_rate >> 16) );
+    h = fnv1a( h, (uint8_t)(line_rate >> 24) );
+
+    // 0 marks an unused entry
+    return ( h ? h : 1u );
+}
+
+/******************************************************************************
+ * add_sample - record a response time
+ *****************************************************************************/
+static void add_sample( cmd_timing_entry_t * const entry, int const ms )
+{
+    entry->samples[entry->pos] = (uint16_t)((ms < 0) ? 0 : ((ms > MAX_SAMPLE) ? MAX_SAMPLE : ms));
+    entry->pos = (uint8_t)((entry->pos + 1) % CMD_TIMING_NO_SAMPLES);
+    if ( entry->no < CMD_TIMING_NO_SAMPLES )
+    {
+        entry->no++;
+    }
+}
+
+/******************************************************************************
+ * cmd_timing_line_time
+ *****************************************************************************/
+int cmd_timing_line_time
+(
+    uint32_t const  line_rate,
+    int const       len
+)
+{
+    uint64_t bits;
+
+    if ( !line_rate || (len <= 0) )
+    {
+        return ( 0 );
+    }
+
+    bits = (uint64_t)len * CMD_TIMING_BITS_PER_BYTE * 1000u;
+
+    return ( (int)((bits + line_rate - 1u) / line_rate) );
+}
+
+/******************************************************************************
+ * cmd_timing_start
+ *****************************************************************************/
+void cmd_timing_start
+(
+    cmd_timing_t * const        timing,
+    ctrl_channel_handle_t const channel,
+    int const                   tmo_ms
+)
+{
+    cmd_timing_entry_t const * entry;
+    uint8_t const * request;
+    int len = 0;
+    int line;
+
+    memset( timing, 0, sizeof(*timing) );
+    timing->deadline = tmo_ms;
+    timing->timeout  = tmo_ms;
+
+    request = ctrl_channel_get_last_request( channel, &len );
+    if ( !request || (len <= 0) )
+    {
+        return;
+    }
+
+    timing->line_rate   = ctrl_channel_get_line_rate( channel );
+    timing->request_len = len;
+    timing->key         = command_key( request, len, timing->line_rate );
+
+    entry = &timing_table[timing->key % CMD_TIMING_TABLE_SIZE];
+    if ( entry->key != timing->key )
+    {
+        entry = NULL;
+    }
+
+    // the fixed timeouts were chosen for fast lines, add the line time
+    line = cmd_timing_line_time( timing->line_rate, len + (entry ? entry->response_len : 0) );
+    timing->timeout  = tmo_ms + line;
+    timing->deadline = timing->timeout;
+
+    if ( tmo_ms > CMD_TIMING_MAX_ADAPTIVE_TMO )
+    {
+        timing->key = 0u;
+        return;
+    }
+
+    if ( entry && (entry->no >= CMD_TIMING_MIN_SAMPLES) )
+    {
+        /* The slowest of the last CMD_TIMING_NO_SAMPLES responses is at least
+         * their 97th percentile, the factor covers the rest of the tail. */
+        int slowest = 0;
+        int deadline;
+        int i;
+
+        for ( i = 0; i < entry->no; i++ )
+        {
+            slowest = (entry->samples[i] > slowest) ? entry->samples[i] : slowest;
+        }
+
+        deadline = CMD_TIMING_FACTOR * slowest + line + CMD_TIMING_SLACK_MS;
+        deadline = (deadline < CMD_TIMING_MIN_TMO_MS) ? CMD_TIMING_MIN_TMO_MS : deadline;
+        timing->deadline = (deadline < timing->timeout) ? deadline : timing->timeout;
+    }
+}
+
+/******************************************************************************
+ * cmd_timing_finish
+ *****************************************************************************/
+void cmd_timing_finish
+(
+    cmd_timing_t const * const  timing,
+    int const                   elapsed_ms,
+    int const                   received,
+    int const                   terminated
+)
+{
+    cmd_timing_entry_t * entry;
+
+    if ( !timing->key )
+    {
+        return;
+    }
+
+    entry = &timing_table[timing->key % CMD_TIMING_TABLE_SIZE];
+
+    if ( terminated )
+    {
+        int line = cmd_timing_line_time( timing->line_rate, timing->request_len + received );
+
+        // faster than the line can carry it, the response was not read from the line
+        if ( elapsed_ms < line )
+        {
+            return;
+        }
+
+        if ( entry->key != timing->key )
+        {
+            memset( entry, 0, sizeof(*entry) );
+            entry->key = timing->key;
+        }
+
+        add_sample( entry, elapsed_ms - line );
+        if ( received > entry->response_len )
+        {
+            entry->response_len = (uint16_t)((received > MAX_SAMPLE) ? MAX_SAMPLE : received);
+        }
+    }
+    else if ( !received && (entry->key == timing->key) )
+    {
+        /* Nothing received in time, either the bus is dead or the device is
+         * slower than it used to be. Recording the deadline as a response time
+         * makes the next deadline of this command a multiple of it. */
+        add_sample( entry, elapsed_ms );
+    }
+}
+
+/******************************************************************************
+ * cmd_timing_reset
+ *****************************************************************************/
+void cmd_timing_reset( void )
+{
+    memset( timing_table, 0, sizeof(timing_table) );
+}
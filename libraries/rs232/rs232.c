@@ -40,6 +40,25 @@
 #include <linux/serial.h>   /* TIOCGSERIAL */
 #endif
 
+#if defined(__linux__)
+/* kernel termios with explicit speeds, <asm/termbits.h> collides with <termios.h> */
+struct termios2
+{
+    tcflag_t    c_iflag;
+    tcflag_t    c_oflag;
+    tcflag_t    c_cflag;
+    tcflag_t    c_lflag;
+    cc_t        c_line;
+    cc_t        c_cc[19];
+    speed_t     c_ispeed;
+    speed_t     c_ospeed;
+};
+
+#ifndef BOTHER
+#define BOTHER      ( 0010000 )
+#endif
+#endif
+
 #ifdef _WIN32
 #include <windows.h>
 #include <tchar.h>
@@ -158,6 +177,52 @@ int rs232_init( void )
     return ( 0 );
 }
 
+/******************************************************************************
+ * rs232_set_custom_speed - program a baudrate without Bxxx constant
+ *****************************************************************************/
+static int rs232_set_custom_speed( int const com, int const baudrate )
+{
+#if defined(__linux__)
+    struct termios2 tio;
+
+    if ( ioctl( com, TCGETS2, &tio ) < 0 )
+    {
+        return ( -errno );
+    }
+
+    // the adapter driver picks the closest divisor
+    tio.c_cflag &= ~CBAUD;
+    tio.c_cflag |= BOTHER;
+    tio.c_ispeed = (speed_t)baudrate;
+    tio.c_ospeed = (speed_t)baudrate;
+
+    if ( ioctl( com, TCSETS2, &tio ) < 0 )
+    {
+        return ( -errno );
+    }
+
+    return ( 0 );
+#else
+    // FreeBSD speed values are plain numbers
+    struct termios tio;
+
+    if ( tcgetattr( com, &tio ) < 0 )
+    {
+        return ( -errno );
+    }
+
+    cfsetispeed( &tio, (speed_t)baudrate );
+    cfsetospeed( &tio, (speed_t)baudrate );
+
+    if ( tcsetattr( com, TCSANOW, &tio ) < 0 )
+    {
+        return ( -errno );
+    }
+
+    return ( 0 );
+#endif
+}
+
 /******************************************************************************
  * rs232_open - opens a serial connection on a linux host 
  *****************************************************************************/
@@ -177,6 +242,7 @@ int rs232_open
     int ipar;
     int bstop;
     int speed;
+    int custom = 0;
     int status;
     int com;
     int res;
@@ -216,9 +282,35 @@ int rs232_open
            speed = B115200;
            break;
 
+#ifdef B230400
+        case 230400:
+           speed = B230400;
+           break;
+#endif
+
+#ifdef B460800
+        case 460800:
+           speed = B460800;
+           break;
+#endif
+
+#ifdef B921600
+        case 921600:
+           speed = B921600;
+           break;
+#endif
+
         default:
-           printf( "invalid baudrate: %d\n", baudrate );
-           return ( -EINVAL );
+           if ( !CTRL_CHANNEL_BAUDRATE_VALID( (unsigned)baudrate ) )
+           {
+               printf( "invalid baudrate: %d\n", baudrate );
+               return ( -EINVAL );
+           }
+
+           // programmed after the port is configured
+           speed  = B38400;
+           custom = 1;
+           break;
     }
 
     // set number of data-bits
@@ -320,6 +412,18 @@ int rs232_open
         return( -errno );
     }
 
+    if ( custom )
+    {
+        res = rs232_set_custom_speed( com, baudrate );
+        if ( res < 0 )
+        {
+            tcsetattr( com, TCSANOW, &old_settings[idx] );
+            close( com );
+            printf( "unable to set custom baudrate %d\n", baudrate );
+            return ( res );
+        }
+    }
+
     res = ioctl( com, TIOCMGET, &status );
     if ( res < 0 )
     {
@@ -510,21 +614,13 @@ int rs232_open
         return ( -EBUSY );
     }
 
-    // set baudrate
-    switch ( baudrate )
+    // set baudrate, BuildCommDCB takes any rate, the driver rejects what it can not do
+    if ( !CTRL_CHANNEL_BAUDRATE_VALID( (unsigned)baudrate ) )
     {
-        case   9600:
-        case  19200:
-        case  38400:
-        case  57600:
-        case 115200:
-            sprintf( mode_string, "baud=%i", baudrate );
-            break;
-
-        default:
-            printf( "invalid baudrate: %d\n", baudrate );
-            return ( -EINVAL );
+        printf( "invalid baudrate: %d\n", baudrate );
+        return ( -EINVAL );
     }
+    sprintf( mode_string, "baud=%i", baudrate );
 
     // set number of data-bits
     switch ( data )
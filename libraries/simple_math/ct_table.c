@@ -0,0 +1,564 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#include <errno.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#include <simple_math/xyz2ct.h>
+#include <simple_math/ct_table.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define MIRED_SCALE         ( 1.0e-3 )  // keeps the normal equations well conditioned
+
+/******************************************************************************
+ * xyz_to_uv - CIE 1960 chromaticity of a XYZ color
+ *****************************************************************************/
+static int xyz_to_uv( double const * const xyz, double * const u, double * const v )
+{
+    double d = xyz[0] + 15.0 * xyz[1] + 3.0 * xyz[2];
+
+    if ( d < 1.0e-20 )
+    {
+        return ( -EINVAL );
+    }
+
+    *u = (4.0 * xyz[0]) / d;
+    *v = (6.0 * xyz[1]) / d;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * invert3x3 - inverse of a row major 3x3 matrix
+ *****************************************************************************/
+static int invert3x3( double const * const m, double * const inv )
+{
+    double det;
+    int i;
+
+    inv[0] =   m[4] * m[8] - m[5] * m[7];
+    inv[1] = -(m[1] * m[8] - m[2] * m[7]);
+    inv[2] =   m[1] * m[5] - m[2] * m[4];
+    inv[3] = -(m[3] * m[8] - m[5] * m[6]);
+    inv[4] =   m[0] * m[8] - m[2] * m[6];
+    inv[5] = -(m[0] * m[5] - m[2] * m[3]);
+    inv[6] =   m[3] * m[7] - m[4] * m[6];
+    inv[7] = -(m[0] * m[7] - m[1] * m[6]);
+    inv[8] =   m[0] * m[4] - m[1] * m[3];
+
+    det = m[0] * inv[0] + m[1] * inv[3] + m[2] * inv[6];
+    if ( fabs( det ) < 1.0e-12 )
+    {
+        return ( -EINVAL );
+    }
+
+    for ( i = 0; i < 9; i++ )
+    {
+        inv[i] /= det;
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * gains_of - white-balance gains of a color, inv is the XYZ to camera RGB
+ *            matrix
+ *****************************************************************************/
+static int gains_of
+(
+    double const * const    inv,
+    double const * const    xyz,
+    double * const          red,
+    double * const          blue
+)
+{
+    double r = inv[0] * xyz[0] + inv[1] * xyz[1] + inv[2] * xyz[2];
+    double g = inv[3] * xyz[0] + inv[4] * xyz[1] + inv[5] * xyz[2];
+    double b = inv[6] * xyz[0] + inv[7] * xyz[1] + inv[8] * xyz[2];
+
+    if ( (r <= 0.0) || (g <= 0.0) || (b <= 0.0) )
+    {
+        return ( -ERANGE );
+    }
+
+    *red  = g / r;
+    *blue = g / b;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * along - projection of a point on the segment from entry a to entry b,
+ *         relative to a and scaled by the length of the segment
+ *****************************************************************************/
+static inline double along
+(
+    ct_table_entry_t const * const  a,
+    ct_table_entry_t const * const  b,
+    double const                    u,
+    double const                    v
+)
+{
+    return ( (u - a->u) * (b->u - a->u) + (v - a->v) * (b->v - a->v) );
+}
+
+/******************************************************************************
+ * solve - solves a n x n linear system with partial pivoting, a is row major
+ *         and destroyed, the solution is returned in b
+ *****************************************************************************/
+static int solve( int const n, double * const a, double * const b )
+{
+    int i, k, j;
+
+    for ( k = 0; k < n; k++ )
+    {
+        int p = k;
+
+        for ( i = k + 1; i < n; i++ )
+        {
+            if ( fabs( a[i * n + k] ) > fabs( a[p * n + k] ) )
+            {
+                p = i;
+            }
+        }
+
+        if ( fabs( a[p * n + k] ) < 1.0e-12 )
+        {
+            return ( -EINVAL );
+        }
+
+        if ( p != k )
+        {
+            double t;
+
+            for ( j = 0; j < n; j++ )
+            {
+                t = a[k * n + j]; a[k * n + j] = a[p * n + j]; a[p * n + j] = t;
+            }
+            t = b[k]; b[k] = b[p]; b[p] = t;
+        }
+
+        for ( i = k + 1; i < n; i++ )
+        {
+            double f = a[i * n + k] / a[k * n + k];
+
+            for ( j = k; j < n; j++ )
+            {
+                a[i * n + j] -= f * a[k * n + j];
+            }
+            b[i] -= f * b[k];
+        }
+    }
+
+    for ( k = n - 1; k >= 0; k-- )
+    {
+        for ( j = k + 1; j < n; j++ )
+        {
+            b[k] -= a[k * n + j] * b[j];
+        }
+        b[k] /= a[k * n + k];
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * fit_curve - least squares polynomial in the scaled mired
+ *****************************************************************************/
+static int fit_curve
+(
+    int const               no,
+    int const               order,
+    double const * const    x,
+    double const * const    y,
+    double * const          c
+)
+{
+    double a[(CT_FIT_MAX_ORDER + 1) * (CT_FIT_MAX_ORDER + 1)];
+    int const n = order + 1;
+    int i, k, j;
+
+    memset( a, 0, sizeof(a) );
+    memset( c, 0, sizeof(double) * n );
+
+    // normal equations
+    for ( i = 0; i < no; i++ )
+    {
+        double pk = 1.0;
+
+        for ( k = 0; k < n; k++ )
+        {
+            double pj = 1.0;
+
+            for ( j = 0; j < n; j++ )
+            {
+                a[k * n + j] += pk * pj;
+                pj *= x[i];
+            }
+            c[k] += pk * y[i];
+            pk *= x[i];
+        }
+    }
+
+    return ( solve( n, a, c ) );
+}
+
+/******************************************************************************
+ * sm_ct_table_calc
+ *****************************************************************************/
+int sm_ct_table_calc
+(
+    double const        ct_min,
+    double const        ct_max,
+    double const        ct_step,
+    ct_table_t * const  table
+)
+{
+    int size;
+    int i;
+
+    if ( !table || (ct_min < CT_TABLE_CT_MIN) || (ct_step <= 0.0) || (ct_max <= ct_min) )
+    {
+        return ( -EINVAL );
+    }
+
+    size = (int)floor( (ct_max - ct_min) / ct_step + 0.5 ) + 1;
+    if ( size > CT_TABLE_MAX_SIZE )
+    {
+        return ( -EINVAL );
+    }
+
+    table->ct_min    = ct_min;
+    table->ct_step   = ct_step;
+    table->size      = size;
+    table->has_gains = 0;
+
+    for ( i = 0; i < size; i++ )
+    {
+        ct_table_entry_t * e = &table->entry[i];
+
+        e->ct = ct_min + i * ct_step;
+        CorColorTemptoXYZ( e->ct, e->xyz );
+        xyz_to_uv( e->xyz, &e->u, &e->v );
+        e->red  = 1.0;
+        e->blue = 1.0;
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_ct_table_set_camera
+ *****************************************************************************/
+int sm_ct_table_set_camera
+(
+    ct_table_t * const      table,
+    double const * const    rgb2xyz
+)
+{
+    double inv[9];
+    int res;
+    int i;
+
+    if ( !table || !rgb2xyz )
+    {
+        return ( -EINVAL );
+    }
+
+    table->has_gains = 0;
+
+    res = invert3x3( rgb2xyz, inv );
+    if ( res )
+    {
+        return ( res );
+    }
+
+    for ( i = 0; i < table->size; i++ )
+    {
+        ct_table_entry_t * e = &table->entry[i];
+
+        res = gains_of( inv, e->xyz, &e->red, &e->blue );
+        if ( res )
+        {
+            return ( res );
+        }
+    }
+
+    table->has_gains = 1;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_ct_gains
+ *****************************************************************************/
+int sm_ct_gains
+(
+    double const * const    rgb2xyz,
+    double const * const    xyz,
+    double * const          red,
+    double * const          blue
+)
+{
+    double inv[9];
+    int res;
+
+    if ( !rgb2xyz || !xyz || !red || !blue )
+    {
+        return ( -EINVAL );
+    }
+
+    res = invert3x3( rgb2xyz, inv );
+    if ( res )
+    {
+        return ( res );
+    }
+
+    return ( gains_of( inv, xyz, red, blue ) );
+}
+
+/******************************************************************************
+ * sm_ct_table_lookup
+ *****************************************************************************/
+int sm_ct_table_lookup
+(
+    ct_table_t const * const    table,
+    double const                ct,
+    ct_table_entry_t * const    entry
+)
+{
+    ct_table_entry_t const * a;
+    ct_table_entry_t const * b;
+    double pos;
+    double t;
+    int i;
+
+    if ( !table || !entry || (table->size < 2) )
+    {
+        return ( -EINVAL );
+    }
+
+    pos = (ct - table->ct_min) / table->ct_step;
+    if ( (pos < 0.0) || (pos > (double)(table->size - 1)) )
+    {
+        return ( -ERANGE );
+    }
+
+    i = (int)pos;
+    if ( i > table->size - 2 )
+    {
+        i = table->size - 2;
+    }
+    t = pos - i;
+
+    a = &table->entry[i];
+    b = &table->entry[i + 1];
+
+    entry->ct     = ct;
+    entry->xyz[0] = a->xyz[0] + t * (b->xyz[0] - a->xyz[0]);
+    entry->xyz[1] = a->xyz[1] + t * (b->xyz[1] - a->xyz[1]);
+    entry->xyz[2] = a->xyz[2] + t * (b->xyz[2] - a->xyz[2]);
+    entry->u      = a->u      + t * (b->u      - a->u);
+    entry->v      = a->v      + t * (b->v      - a->v);
+    entry->red    = a->red    + t * (b->red    - a->red);
+    entry->blue   = a->blue   + t * (b->blue   - a->blue);
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_ct_table_find
+ *****************************************************************************/
+int sm_ct_table_find
+(
+    ct_table_t const * const    table,
+    double const * const        xyz,
+    double * const              ct,
+    double * const              duv
+)
+{
+    double u, v;
+    double best_d;
+    double best_t = 0.0;
+    int best = 0;
+    int first, last;
+    int i;
+
+    if ( !table || !xyz || !ct || (table->size < 2) )
+    {
+        return ( -EINVAL );
+    }
+
+    if ( xyz_to_uv( xyz, &u, &v ) )
+    {
+        return ( -EINVAL );
+    }
+
+    // binary search for the segment holding the foot of the perpendicular,
+    // the projection on the locus direction changes its sign there
+    first = 0;
+    last  = table->size - 1;
+    while ( last - first > 1 )
+    {
+        int mid = (first + last) / 2;
+
+        if ( along( &table->entry[mid], &table->entry[mid + 1], u, v ) > 0.0 )
+        {
+            first = mid;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
+
+    // project on the segment found and its neighbours
+    last  = (first + 1 < table->size - 2) ? (first + 1) : (table->size - 2);
+    first = (first > 0) ? (first - 1) : 0;
+
+    best_d = DBL_MAX;
+    for ( i = first; i <= last; i++ )
+    {
+        ct_table_entry_t const * a = &table->entry[i];
+        ct_table_entry_t const * b = &table->entry[i + 1];
+
+        double du = b->u - a->u;
+        double dv = b->v - a->v;
+        double l2 = du * du + dv * dv;
+        double t  = (l2 > 0.0) ? (along( a, b, u, v ) / l2) : 0.0;
+        double pu, pv, d;
+
+        t  = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+        pu = a->u + t * du;
+        pv = a->v + t * dv;
+        d  = (u - pu) * (u - pu) + (v - pv) * (v - pv);
+
+        if ( d < best_d )
+        {
+            best_d = d;
+            best   = i;
+            best_t = t;
+        }
+    }
+
+    *ct = table->ct_min + (best + best_t) * table->ct_step;
+
+    if ( duv )
+    {
+        ct_table_entry_t const * a = &table->entry[best];
+        ct_table_entry_t const * b = &table->entry[best + 1];
+        double pv = a->v + best_t * (b->v - a->v);
+
+        *duv = (v >= pv) ? sqrt( best_d ) : -sqrt( best_d );
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_ct_fit_gains
+ *****************************************************************************/
+int sm_ct_fit_gains
+(
+    int const               no,
+    double const * const    ct,
+    double const * const    red,
+    double const * const    blue,
+    ct_fit_t * const        fit
+)
+{
+    double x[CT_FIT_MAX_POINTS];
+    int order;
+    int res;
+    int i;
+
+    if ( (no < 1) || (no > CT_FIT_MAX_POINTS) || !ct || !red || !blue || !fit )
+    {
+        return ( -EINVAL );
+    }
+
+    for ( i = 0; i < no; i++ )
+    {
+        if ( ct[i] <= 0.0 )
+        {
+            return ( -EINVAL );
+        }
+        x[i] = MIRED_SCALE * 1.0e6 / ct[i];
+    }
+
+    order = (no - 1 < CT_FIT_MAX_ORDER) ? (no - 1) : CT_FIT_MAX_ORDER;
+
+    memset( fit, 0, sizeof(*fit) );
+
+    res  = fit_curve( no, order, x, red, fit->red );
+    res |= fit_curve( no, order, x, blue, fit->blue );
+    if ( res )
+    {
+        return ( -EINVAL );
+    }
+
+    // back from the scaled mired
+    for ( i = 1; i <= order; i++ )
+    {
+        fit->red[i]  *= pow( MIRED_SCALE, i );
+        fit->blue[i] *= pow( MIRED_SCALE, i );
+    }
+
+    fit->order = order;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_ct_fit_eval
+ *****************************************************************************/
+int sm_ct_fit_eval
+(
+    ct_fit_t const * const  fit,
+    double const            ct,
+    double * const          red,
+    double * const          blue
+)
+{
+    double mired;
+    double r = 0.0;
+    double b = 0.0;
+    int i;
+
+    if ( !fit || !red || !blue || (ct <= 0.0) ||
+         (fit->order < 0) || (fit->order > CT_FIT_MAX_ORDER) )
+    {
+        return ( -EINVAL );
+    }
+
+    mired = 1.0e6 / ct;
+
+    // horner
+    for ( i = fit->order; i >= 0; i-- )
+    {
+        r = r * mired + fit->red[i];
+        b = b * mired + fit->blue[i];
+    }
+
+    *red  = r;
+    *blue = b;
+
+    return ( 0 );
+}
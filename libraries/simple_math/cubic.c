@@ -364,3 +364,70 @@ found:
     return ( 0 );
 }
 
+/******************************************************************************
+ * sm_cubic_spline_interpolation_calc_range
+ *****************************************************************************/
+int sm_cubic_spline_interpolation_calc_range
+(
+    spline_interpolation_ctx_t * const          ctx,
+    spline_interpolation_sample_type_t const    x0,
+    spline_interpolation_sample_type_t const    step,
+    spline_interpolation_sample_type_t * const  y,
+    unsigned const                              no
+)
+{
+    double a, b, c, d;   // Coefficients
+    int32_t dx, xi;
+    unsigned k, i, n;
+
+    CHECK_CSIP_HANDLE( ctx );
+    CHECK_CSIP_STATE( ctx, CSIP_STATE_RUNNING );
+
+    if ( !y || (step <= CSIP_SAMPLE_TYPE(0)) )
+    {
+        return ( -EINVAL );
+    }
+
+    n = ctx->n;
+    k = 0u;
+
+    // clip y to a horizontal line left of the first sample
+    while ( (k < no) && ((x0 + (spline_interpolation_sample_type_t)k * step) <= ctx->x[0]) )
+    {
+        y[k++] = ctx->y[0];
+    }
+
+    // walk the segments in ascending order
+    for ( i = 0u; ((i + 1u) < n) && (k < no); i++ )
+    {
+        // first x of this run (x > ctx->x[i] holds here)
+        xi = (int32_t)(x0 + (spline_interpolation_sample_type_t)k * step);
+        if ( xi > (int32_t)ctx->x[i+1] )
+        {
+            continue;
+        }
+
+        a = (double)ctx->y[i];
+        b = ((double)ctx->h[i] * ctx->z[i+1])/(-6.0f)
+                - ((double)ctx->h[i] * ctx->z[i])/3.0f
+                + ((double)(ctx->y[i+1]-ctx->y[i]))/(double)ctx->h[i];
+        c = ctx->z[i] / 2;
+        d = (ctx->z[i+1] - ctx->z[i]) / (6.0f * ctx->h[i]);
+
+        // evaluate all points of this segment with constant coefficients
+        for ( ; (k < no) && (xi <= (int32_t)ctx->x[i+1]); k++ )
+        {
+            dx = xi - (int32_t)ctx->x[i];
+            y[k] = (spline_interpolation_sample_type_t)(int32_t)(a + dx * (b + dx * (c + dx * d)) + 0.5f);
+            xi += (int32_t)step;
+        }
+    }
+
+    // clip y to a horizontal line right of the last sample
+    for ( ; k < no; k++ )
+    {
+        y[k] = ctx->y[n-1];
+    }
+
+    return ( 0 );
+}
@@ -0,0 +1,441 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <simple_math/gamma_table.h>
+
+/******************************************************************************
+ * The table loops select between precomputed branches instead of branching.
+ * GCC only if-converts (and thus vectorizes) them when floating point
+ * operations are known not to trap, which is fine as nobody here enables
+ * floating point exceptions. The loops only pay off when vectorized, at the
+ * -O2 of the GUI build they are slower than the scalar functions, so the
+ * file is compiled with -O3 regardless of the build flags. MSVC vectorizes
+ * at its default /O2 already.
+ *****************************************************************************/
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ( "O3", "no-trapping-math" )
+#elif defined(_MSC_VER)
+#pragma optimize ( "t", on )
+#endif
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define LN2                 ( 0.69314718056f )
+
+/******************************************************************************
+ * as_int - reinterpret float bits
+ *****************************************************************************/
+static inline int32_t as_int( float const x )
+{
+    int32_t i;
+    memcpy( &i, &x, sizeof(i) );
+    return ( i );
+}
+
+/******************************************************************************
+ * as_float - reinterpret integer bits
+ *****************************************************************************/
+static inline float as_float( int32_t const i )
+{
+    float x;
+    memcpy( &x, &i, sizeof(x) );
+    return ( x );
+}
+
+/******************************************************************************
+ * approx_log2 - log2(x) for x > 0 (x <= 0 returns garbage, mask it out)
+ *
+ * x = m * 2^e with m in [sqrt(0.5), sqrt(2)), then
+ * log2(m) = 2/ln2 * atanh(s) with s = (m-1)/(m+1) and |s| < 0.172,
+ * the series up to s^9 has a truncation error below 1e-9.
+ *****************************************************************************/
+static inline float approx_log2( float const x )
+{
+    int32_t i = as_int( x );
+    int32_t e = ((i >> 23) & 0xff) - 127;
+    float   m = as_float( (i & 0x007fffff) | 0x3f800000 );   // m in [1, 2)
+
+    int32_t big = (m > 1.41421356f) ? 1 : 0;
+    m *= big ? 0.5f : 1.0f;
+    e += big;
+
+    float s  = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float p  = s * (2.88539008f + s2 * (0.96179669f + s2 * (0.57707802f + s2 * (0.41219858f + s2 * 0.32059890f))));
+
+    return ( (float)e + p );
+}
+
+/******************************************************************************
+ * approx_exp2 - 2^x
+ *
+ * x = n + f with integer n and f in [-0.5, 0.5], 2^f as Taylor polynomial
+ * of degree 7 with a truncation error below 1e-8.
+ *****************************************************************************/
+static inline float approx_exp2( float x )
+{
+    x = (x < -126.0f) ? -126.0f : x;
+    x = (x >  127.0f) ?  127.0f : x;
+
+    // truncation of a positive value is floor, so n = round(x)
+    int32_t n = (int32_t)(x + 126.5f) - 126;
+    float   f = x - (float)n;
+
+    float p = 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.05550411f + f * (0.00961813f
+                   + f * (0.00133336f + f * (0.00015404f + f * 0.00001525f))))));
+
+    return ( p * as_float( (n + 127) << 23 ) );
+}
+
+/******************************************************************************
+ * approx_pow - x^p for x >= 0
+ *****************************************************************************/
+static inline float approx_pow( float const x, float const p )
+{
+    float y = approx_exp2( p * approx_log2( x ) );
+    return ( (x > 0.0f) ? y : 0.0f );
+}
+
+/******************************************************************************
+ * to_code - scale normalized value to output code value and clip
+ *****************************************************************************/
+static inline uint16_t to_code( float v, float const size_o )
+{
+    v  = v * size_o + 0.5f;
+    v  = (v < 0.0f) ? 0.0f : v;
+    v  = (v > (size_o - 1.0f)) ? (size_o - 1.0f) : v;
+
+    return ( (uint16_t)(int32_t)v );
+}
+
+/******************************************************************************
+ * gamma_value - gamma curve with linear part (see sm_gamma_float)
+ *****************************************************************************/
+static inline float gamma_value( gamma_table_params_t const * const p, float const Vin )
+{
+    float pwr = approx_pow( Vin, p->gamma );
+    float lin = Vin * p->linear_contrast + p->linear_brightness;
+
+    pwr = ((p->gamma != 1.0f) ? pwr : Vin) * p->contrast + p->brightness;
+
+    return ( (Vin < p->kink) ? lin : pwr );
+}
+
+/******************************************************************************
+ * pq_value - Rec. 2100 PQ (see sm_pq)
+ *****************************************************************************/
+static inline float pq_value( float const Vin )
+{
+    float const c1 = 0.8359375f;
+    float const c2 = 18.8515625f;
+    float const c3 = 18.6875f;
+    float const m1 = 0.1593017578125f;
+    float const m2 = 78.84375f;
+
+    float lin = 267.84f * Vin;
+    float pwr = 1.099f * approx_pow( 59.5208f * Vin, 0.45f ) - 0.099f;
+    float E   = (Vin <= 0.0003024f) ? lin : pwr;
+    float Y   = approx_pow( E, 2.4f ) / 100.0f;
+    float Ym  = approx_pow( Y, m1 );
+
+    return ( approx_pow( (c1 + c2 * Ym) / (1.0f + c3 * Ym), m2 ) );
+}
+
+/******************************************************************************
+ * hlg_value - Rec. 2100 HLG (see sm_hlg)
+ *****************************************************************************/
+static inline float hlg_value( float const Vin )
+{
+    float const a = 0.17883277f;
+    float const b = 0.28466892f;
+    float const c = 0.55991073f;
+    float const threshold = 1.0f / 12.0f;
+
+    float lo  = approx_pow( 3.0f * Vin, 0.5f );
+    float hi  = a * LN2 * approx_log2( (12.0f * Vin) - b ) + c;
+
+    return ( (Vin <= threshold) ? lo : hi );
+}
+
+/******************************************************************************
+ * calc_gamma - complete gamma table
+ *****************************************************************************/
+static void calc_gamma
+(
+    gamma_table_params_t const * const  p,
+    uint32_t const                      size,
+    uint16_t * const                    table
+)
+{
+    float const scale  = 1.0f / (float)size;
+    float const size_o = (float)size;
+    uint32_t i;
+
+    for ( i = 0u; i < size; i++ )
+    {
+        table[i] = to_code( gamma_value( p, (float)(int32_t)i * scale ), size_o );
+    }
+}
+
+/******************************************************************************
+ * calc_pq - complete PQ table
+ *****************************************************************************/
+static void calc_pq
+(
+    uint32_t const      size,
+    uint16_t * const    table
+)
+{
+    float const scale  = 1.0f / (float)size;
+    float const size_o = (float)size;
+    uint32_t i;
+
+    for ( i = 0u; i < size; i++ )
+    {
+        table[i] = to_code( pq_value( (float)(int32_t)i * scale ), size_o );
+    }
+}
+
+/******************************************************************************
+ * calc_hlg - complete HLG table
+ *****************************************************************************/
+static void calc_hlg
+(
+    uint32_t const      size,
+    uint16_t * const    table
+)
+{
+    float const scale  = 1.0f / (float)size;
+    float const size_o = (float)size;
+    uint32_t i;
+
+    for ( i = 0u; i < size; i++ )
+    {
+        table[i] = to_code( hlg_value( (float)(int32_t)i * scale ), size_o );
+    }
+}
+
+/******************************************************************************
+ * make_key - normalize the cache key (PQ and HLG have no parameters)
+ *****************************************************************************/
+static void make_key
+(
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    gamma_table_params_t * const        key
+)
+{
+    memset( key, 0, sizeof(*key) );
+    if ( (curve == GAMMA_TABLE_CURVE_GAMMA) && params )
+    {
+        *key = *params;
+    }
+}
+
+/******************************************************************************
+ * sm_gamma_table_calc
+ *****************************************************************************/
+int sm_gamma_table_calc
+(
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    uint8_t const                       bit_width,
+    uint16_t * const                    table
+)
+{
+    uint32_t size;
+
+    if ( !table || (bit_width < 1u) || (bit_width > GAMMA_TABLE_MAX_BIT_WIDTH) )
+    {
+        return ( -EINVAL );
+    }
+
+    size = (1ul << bit_width);
+
+    switch ( curve )
+    {
+        case GAMMA_TABLE_CURVE_GAMMA:
+            if ( !params )
+            {
+                return ( -EINVAL );
+            }
+            calc_gamma( params, size, table );
+            break;
+
+        case GAMMA_TABLE_CURVE_PQ:
+            calc_pq( size, table );
+            break;
+
+        case GAMMA_TABLE_CURVE_HLG:
+            calc_hlg( size, table );
+            break;
+
+        default:
+            return ( -EINVAL );
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_gamma_table_sample
+ *****************************************************************************/
+int sm_gamma_table_sample
+(
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    uint8_t const                       bit_width,
+    uint32_t const * const              x,
+    uint16_t * const                    y,
+    uint32_t const                      n
+)
+{
+    float scale;
+    float size_o;
+    uint32_t size;
+    uint32_t i;
+
+    if ( !x || !y || (bit_width < 1u) || (bit_width > GAMMA_TABLE_MAX_BIT_WIDTH) )
+    {
+        return ( -EINVAL );
+    }
+
+    if ( (curve >= GAMMA_TABLE_CURVE_MAX) || ((curve == GAMMA_TABLE_CURVE_GAMMA) && !params) )
+    {
+        return ( -EINVAL );
+    }
+
+    size   = (1ul << bit_width);
+    scale  = 1.0f / (float)size;
+    size_o = (float)size;
+
+    for ( i = 0u; i < n; i++ )
+    {
+        float Vin = (float)(int32_t)((x[i] < size) ? x[i] : (size - 1u)) * scale;
+        float Vout;
+
+        switch ( curve )
+        {
+            case GAMMA_TABLE_CURVE_GAMMA:
+                Vout = gamma_value( params, Vin );
+                break;
+
+            case GAMMA_TABLE_CURVE_PQ:
+                Vout = pq_value( Vin );
+                break;
+
+            default:
+                Vout = hlg_value( Vin );
+                break;
+        }
+
+        y[i] = to_code( Vout, size_o );
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_gamma_table_cache_reset
+ *****************************************************************************/
+int sm_gamma_table_cache_reset
+(
+    gamma_table_cache_t * const cache
+)
+{
+    uint32_t i;
+
+    if ( !cache )
+    {
+        return ( -EFAULT );
+    }
+
+    for ( i = 0u; i < GAMMA_TABLE_CACHE_SIZE; i++ )
+    {
+        cache->table[i].age = 0u;
+    }
+    cache->clock = 0u;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_gamma_table_get
+ *****************************************************************************/
+uint16_t const * sm_gamma_table_get
+(
+    gamma_table_cache_t * const         cache,
+    gamma_table_curve_t const           curve,
+    gamma_table_params_t const * const  params,
+    uint8_t const                       bit_width
+)
+{
+    gamma_table_params_t key;
+    gamma_table_t * t;
+    uint32_t lru = 0u;
+    uint32_t i;
+
+    if ( !cache )
+    {
+        return ( NULL );
+    }
+
+    make_key( curve, params, &key );
+
+    // restart the use counter before it wraps
+    if ( cache->clock == UINT32_MAX )
+    {
+        sm_gamma_table_cache_reset( cache );
+    }
+    cache->clock++;
+
+    // lookup, remember the least recently used slot on the way
+    for ( i = 0u; i < GAMMA_TABLE_CACHE_SIZE; i++ )
+    {
+        t = &cache->table[i];
+        if ( (t->age != 0u) && (t->curve == curve) && (t->bit_width == bit_width)
+                && !memcmp( &t->params, &key, sizeof(key) ) )
+        {
+            t->age = cache->clock;
+            return ( t->data );
+        }
+
+        if ( t->age < cache->table[lru].age )
+        {
+            lru = i;
+        }
+    }
+
+    // miss, recompute the least recently used table
+    t = &cache->table[lru];
+    t->age = 0u;
+    if ( sm_gamma_table_calc( curve, params, bit_width, t->data ) )
+    {
+        return ( NULL );
+    }
+
+    t->curve     = curve;
+    t->params    = key;
+    t->bit_width = bit_width;
+    t->age       = cache->clock;
+
+    return ( t->data );
+}
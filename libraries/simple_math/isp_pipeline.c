@@ -0,0 +1,619 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+
+#include <simple_math/knee.h>
+#include <simple_math/rgb2ycbcr.h>
+#include <simple_math/isp_pipeline.h>
+
+/******************************************************************************
+ * The stage loops clamp with selects instead of branches, GCC only
+ * vectorizes them when floating point operations are known not to trap,
+ * see gamma_table.c. The GUI is built with -O2, where GCC vectorizes only
+ * trivial loops, so this file asks for -O3 itself (1080p: 46 ms at -O2,
+ * 23 ms at -O3). MSVC vectorizes at its default /O2 already.
+ *****************************************************************************/
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ( "O3", "no-trapping-math" )
+#elif defined(_MSC_VER)
+#pragma optimize ( "t", on )
+#endif
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+// pixels processed per stage loop, the run buffers live on the stack
+#define RUN_LENGTH          ( 256u )
+
+#define PI                  ( 3.14159265358979f )
+#define DEG2RAD(x)          ( (x) * PI / 180.0f )
+
+#define LUT_MAX             ( (float)(ISP_PIPELINE_LUT_SIZE - 1u) )
+#define CHROMA_MAX          ( (float)(ISP_PIPELINE_CHROMA_SIZE - 1u) )
+
+/******************************************************************************
+ * clampf - limit v to [lo, hi]
+ *****************************************************************************/
+static inline float clampf( float v, float const lo, float const hi )
+{
+    v = (v < lo) ? lo : v;
+    v = (v > hi) ? hi : v;
+    return ( v );
+}
+
+/******************************************************************************
+ * mat3_mul - r = a * b
+ *****************************************************************************/
+static void mat3_mul( float * const r, float const * const a, float const * const b )
+{
+    int i, k;
+
+    for ( i = 0; i < 3; i++ )
+    {
+        for ( k = 0; k < 3; k++ )
+        {
+            r[3*i + k] = a[3*i + 0] * b[0 + k]
+                       + a[3*i + 1] * b[3 + k]
+                       + a[3*i + 2] * b[6 + k];
+        }
+    }
+}
+
+/******************************************************************************
+ * mat3_inv - r = inverse of m, -EINVAL if m is singular
+ *****************************************************************************/
+static int mat3_inv( float * const r, float const * const m )
+{
+    float det = m[0] * (m[4] * m[8] - m[5] * m[7])
+              - m[1] * (m[3] * m[8] - m[5] * m[6])
+              + m[2] * (m[3] * m[7] - m[4] * m[6]);
+
+    if ( fabsf( det ) < 1e-6f )
+    {
+        return ( -EINVAL );
+    }
+
+    r[0] =  (m[4] * m[8] - m[5] * m[7]) / det;
+    r[1] = -(m[1] * m[8] - m[2] * m[7]) / det;
+    r[2] =  (m[1] * m[5] - m[2] * m[4]) / det;
+    r[3] = -(m[3] * m[8] - m[5] * m[6]) / det;
+    r[4] =  (m[0] * m[8] - m[2] * m[6]) / det;
+    r[5] = -(m[0] * m[5] - m[2] * m[3]) / det;
+    r[6] =  (m[3] * m[7] - m[4] * m[6]) / det;
+    r[7] = -(m[0] * m[7] - m[1] * m[6]) / det;
+    r[8] =  (m[0] * m[4] - m[1] * m[3]) / det;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * knee_changed - knee settings differ
+ *****************************************************************************/
+static int knee_changed( isp_pipeline_params_t const * const a, isp_pipeline_params_t const * const b )
+{
+    return ( (a->knee_enable != b->knee_enable)
+          || (a->knee_point  != b->knee_point)
+          || (a->knee_slope  != b->knee_slope)
+          || (a->white_clip  != b->white_clip) );
+}
+
+/******************************************************************************
+ * chroma_changed - settings of the chroma table differ
+ *****************************************************************************/
+static int chroma_changed( isp_pipeline_params_t const * const a, isp_pipeline_params_t const * const b )
+{
+    return ( (a->mcc_enable != b->mcc_enable)
+          || (a->mcc_phases != b->mcc_phases)
+          || memcmp( a->mcc_saturation, b->mcc_saturation, sizeof(a->mcc_saturation) )
+          || memcmp( a->mcc_hue, b->mcc_hue, sizeof(a->mcc_hue) )
+          || (a->saturation != b->saturation)
+          || (a->hue != b->hue) );
+}
+
+/******************************************************************************
+ * calc_knee - knee gain by maximal RGB component
+ *****************************************************************************/
+static int calc_knee( isp_pipeline_t * const pipe, isp_pipeline_params_t const * const params )
+{
+    knee_interpolation_ctx_t * ctx;
+    uint32_t gain;
+    uint32_t i;
+    int res;
+
+    if ( !params->knee_enable )
+    {
+        for ( i = 0u; i < ISP_PIPELINE_LUT_SIZE; i++ )
+        {
+            pipe->knee[i] = 1.0f;
+        }
+
+        return ( 0 );
+    }
+
+    res = sm_knee_interpolation_init( &ctx );
+    if ( !res )
+    {
+        res = sm_knee_interpolation_calc_init( ctx, params->knee_point, params->knee_slope, params->white_clip );
+    }
+
+    for ( i = 0u; !res && (i < ISP_PIPELINE_LUT_SIZE); i++ )
+    {
+        // gain with 16 fractional bits
+        res = sm_knee_interpolation_calc( ctx, i, &gain, ISP_PIPELINE_LUT_BIT_WIDTH, 16u );
+        pipe->knee[i] = (float)gain / 65536.0f;
+    }
+
+    return ( res );
+}
+
+/******************************************************************************
+ * calc_lut - normalized transfer tables
+ *****************************************************************************/
+static void calc_lut( isp_pipeline_t * const pipe, isp_pipeline_params_t const * const params )
+{
+    uint32_t c, i;
+
+    for ( c = 0u; c < 3u; c++ )
+    {
+        uint16_t const * lut = params->lut[c];
+
+        for ( i = 0u; i < ISP_PIPELINE_LUT_SIZE; i++ )
+        {
+            float v = lut ? (float)lut[i] : (float)i;
+            pipe->lut[c][i] = v / LUT_MAX;
+        }
+    }
+}
+
+/******************************************************************************
+ * calc_chroma - multi colour control and colour processing of a chroma value
+ *****************************************************************************/
+static void calc_chroma
+(
+    isp_pipeline_params_t const * const params,
+    float const                         cb,
+    float const                         cr,
+    float * const                       out
+)
+{
+    float angle = atan2f( cr, cb );
+    float sat   = params->saturation;
+    float hue   = DEG2RAD( params->hue );
+
+    if ( params->mcc_enable && params->mcc_phases )
+    {
+        // phase k covers [k, k+1) * 360/n degree, interpolate between phase centers
+        float n = (float)params->mcc_phases;
+        float p = ((angle < 0.0f) ? (angle + 2.0f * PI) : angle) * n / (2.0f * PI) - 0.5f;
+        float f;
+        int   k0, k1;
+
+        if ( p < 0.0f )
+        {
+            p += n;
+        }
+
+        k0 = (int)p;
+        f  = p - (float)k0;
+        k0 = k0 % params->mcc_phases;
+        k1 = (k0 + 1) % params->mcc_phases;
+
+        sat *= params->mcc_saturation[k0] * (1.0f - f) + params->mcc_saturation[k1] * f;
+        hue += DEG2RAD( params->mcc_hue[k0] * (1.0f - f) + params->mcc_hue[k1] * f );
+    }
+
+    out[0] = sat * (cb * cosf( hue ) - cr * sinf( hue ));
+    out[1] = sat * (cb * sinf( hue ) + cr * cosf( hue ));
+}
+
+/******************************************************************************
+ * calc_chroma_table - chroma table over Cb, Cr in [-0.5, 0.5]
+ *****************************************************************************/
+static void calc_chroma_table( isp_pipeline_t * const pipe, isp_pipeline_params_t const * const params )
+{
+    uint32_t i, k;
+
+    for ( i = 0u; i < ISP_PIPELINE_CHROMA_SIZE; i++ )
+    {
+        float cb = (float)i / CHROMA_MAX - 0.5f;
+
+        for ( k = 0u; k < ISP_PIPELINE_CHROMA_SIZE; k++ )
+        {
+            float cr = (float)k / CHROMA_MAX - 0.5f;
+            calc_chroma( params, cb, cr, pipe->chroma[i * ISP_PIPELINE_CHROMA_SIZE + k] );
+        }
+    }
+}
+
+/******************************************************************************
+ * sm_isp_pipeline_params_init
+ *****************************************************************************/
+int sm_isp_pipeline_params_init
+(
+    isp_pipeline_params_t * const params
+)
+{
+    float * c;
+    uint32_t i;
+
+    if ( !params )
+    {
+        return ( -EINVAL );
+    }
+
+    memset( params, 0, sizeof(*params) );
+
+    for ( i = 0u; i < 3u; i++ )
+    {
+        params->wb_gain[i]       = 1.0f;
+        params->cross[4u * i]    = 1.0f;
+    }
+
+    for ( i = 0u; i < ISP_PIPELINE_MAX_PHASES; i++ )
+    {
+        params->mcc_saturation[i] = 1.0f;
+    }
+
+    params->contrast   = 1.0f;
+    params->saturation = 1.0f;
+
+    c = params->conv;
+    return ( cal_YCbCr_coefficients_bt709( &c[0], &c[1], &c[2], &c[3], &c[4], &c[5], &c[6], &c[7], &c[8] ) );
+}
+
+/******************************************************************************
+ * sm_isp_pipeline_reset
+ *****************************************************************************/
+int sm_isp_pipeline_reset
+(
+    isp_pipeline_t * const pipe
+)
+{
+    if ( !pipe )
+    {
+        return ( -EINVAL );
+    }
+
+    pipe->valid = 0;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_isp_pipeline_update
+ *****************************************************************************/
+int sm_isp_pipeline_update
+(
+    isp_pipeline_t * const                  pipe,
+    isp_pipeline_params_t const * const     params
+)
+{
+    float wb[9] = { 0.0f };
+    float ycbcr[9];
+    uint32_t i;
+    int res;
+
+    if ( !pipe || !params || (params->mcc_phases > ISP_PIPELINE_MAX_PHASES) )
+    {
+        return ( -EINVAL );
+    }
+
+    // display conversion first, nothing is changed for a singular matrix
+    res = mat3_inv( pipe->display, params->conv );
+    if ( res )
+    {
+        pipe->valid = 0;
+        return ( res );
+    }
+
+    // white balance is a diagonal matrix in front of the colour correction
+    wb[0] = params->wb_gain[0];
+    wb[4] = params->wb_gain[1];
+    wb[8] = params->wb_gain[2];
+    mat3_mul( pipe->rgb, params->cross, wb );
+
+    for ( i = 0u; i < 3u; i++ )
+    {
+        pipe->rgb_offset[i] = params->cross_offset[i];
+    }
+
+    if ( !pipe->valid || knee_changed( &pipe->params, params ) )
+    {
+        res = calc_knee( pipe, params );
+        if ( res )
+        {
+            pipe->valid = 0;
+            return ( res );
+        }
+    }
+
+    calc_lut( pipe, params );
+
+    // contrast scales the luma row, chroma is done by the chroma table
+    memcpy( ycbcr, params->conv, sizeof(ycbcr) );
+    for ( i = 0u; i < 3u; i++ )
+    {
+        ycbcr[i] *= params->contrast;
+    }
+    memcpy( pipe->ycbcr, ycbcr, sizeof(ycbcr) );
+    pipe->y_offset = params->brightness;
+
+    if ( !pipe->valid || chroma_changed( &pipe->params, params ) )
+    {
+        calc_chroma_table( pipe, params );
+    }
+
+    // transfer tables are copied, do not keep the callers pointers
+    pipe->params = *params;
+    for ( i = 0u; i < 3u; i++ )
+    {
+        pipe->params.lut[i] = NULL;
+    }
+    pipe->valid = 1;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * process_stages - run r, g, b of up to RUN_LENGTH pixels through the
+ *                  pipeline, the result is display RGB (not clamped)
+ *****************************************************************************/
+static void process_stages
+(
+    isp_pipeline_t const * const    pipe,
+    float * const                   r,
+    float * const                   g,
+    float * const                   b,
+    uint32_t const                  n
+)
+{
+    float y[RUN_LENGTH], cb[RUN_LENGTH], cr[RUN_LENGTH];
+    int   idx[RUN_LENGTH];
+
+    float const * m = pipe->rgb;
+    float const * o = pipe->rgb_offset;
+    float const * c = pipe->ycbcr;
+    float const * d = pipe->display;
+    uint32_t i;
+
+    // white balance and colour correction
+    for ( i = 0u; i < n; i++ )
+    {
+        float ri = r[i];
+        float gi = g[i];
+        float bi = b[i];
+
+        r[i] = m[0] * ri + m[1] * gi + m[2] * bi + o[0];
+        g[i] = m[3] * ri + m[4] * gi + m[5] * bi + o[1];
+        b[i] = m[6] * ri + m[7] * gi + m[8] * bi + o[2];
+    }
+
+    // knee, the gain depends on the maximal component
+    for ( i = 0u; i < n; i++ )
+    {
+        float v = (r[i] > g[i]) ? r[i] : g[i];
+        v = (b[i] > v) ? b[i] : v;
+        idx[i] = (int)(clampf( v, 0.0f, 1.0f ) * LUT_MAX + 0.5f);
+    }
+
+    for ( i = 0u; i < n; i++ )
+    {
+        float k = pipe->knee[idx[i]];
+        r[i] *= k;
+        g[i] *= k;
+        b[i] *= k;
+    }
+
+    // transfer tables
+    for ( i = 0u; i < n; i++ )
+    {
+        idx[i] = (int)(clampf( r[i], 0.0f, 1.0f ) * LUT_MAX + 0.5f);
+    }
+    for ( i = 0u; i < n; i++ )
+    {
+        r[i] = pipe->lut[0][idx[i]];
+    }
+
+    for ( i = 0u; i < n; i++ )
+    {
+        idx[i] = (int)(clampf( g[i], 0.0f, 1.0f ) * LUT_MAX + 0.5f);
+    }
+    for ( i = 0u; i < n; i++ )
+    {
+        g[i] = pipe->lut[1][idx[i]];
+    }
+
+    for ( i = 0u; i < n; i++ )
+    {
+        idx[i] = (int)(clampf( b[i], 0.0f, 1.0f ) * LUT_MAX + 0.5f);
+    }
+    for ( i = 0u; i < n; i++ )
+    {
+        b[i] = pipe->lut[2][idx[i]];
+    }
+
+    // colour conversion with contrast and brightness
+    for ( i = 0u; i < n; i++ )
+    {
+        y[i]  = c[0] * r[i] + c[1] * g[i] + c[2] * b[i] + pipe->y_offset;
+        cb[i] = c[3] * r[i] + c[4] * g[i] + c[5] * b[i];
+        cr[i] = c[6] * r[i] + c[7] * g[i] + c[8] * b[i];
+    }
+
+    // multi colour control, saturation and hue
+    for ( i = 0u; i < n; i++ )
+    {
+        int ib = (int)((clampf( cb[i], -0.5f, 0.5f ) + 0.5f) * CHROMA_MAX + 0.5f);
+        int ir = (int)((clampf( cr[i], -0.5f, 0.5f ) + 0.5f) * CHROMA_MAX + 0.5f);
+        idx[i] = ib * (int)ISP_PIPELINE_CHROMA_SIZE + ir;
+    }
+    for ( i = 0u; i < n; i++ )
+    {
+        cb[i] = pipe->chroma[idx[i]][0];
+        cr[i] = pipe->chroma[idx[i]][1];
+    }
+
+    // back to RGB
+    for ( i = 0u; i < n; i++ )
+    {
+        r[i] = d[0] * y[i] + d[1] * cb[i] + d[2] * cr[i];
+        g[i] = d[3] * y[i] + d[4] * cb[i] + d[5] * cr[i];
+        b[i] = d[6] * y[i] + d[7] * cb[i] + d[8] * cr[i];
+    }
+}
+
+/******************************************************************************
+ * process_run - process a run of up to RUN_LENGTH pixels
+ *****************************************************************************/
+static void process_run
+(
+    isp_pipeline_t const * const    pipe,
+    uint16_t const * const          in,
+    float const                     scale,
+    uint32_t * const                out,
+    uint32_t const                  n
+)
+{
+    float r[RUN_LENGTH], g[RUN_LENGTH], b[RUN_LENGTH];
+    uint32_t i;
+
+    for ( i = 0u; i < n; i++ )
+    {
+        r[i] = (float)in[3u*i + 0u] * scale;
+        g[i] = (float)in[3u*i + 1u] * scale;
+        b[i] = (float)in[3u*i + 2u] * scale;
+    }
+
+    process_stages( pipe, r, g, b, n );
+
+    // 8 bit RGB for display
+    for ( i = 0u; i < n; i++ )
+    {
+        uint32_t ro8 = (uint32_t)(clampf( r[i], 0.0f, 1.0f ) * 255.0f + 0.5f);
+        uint32_t go8 = (uint32_t)(clampf( g[i], 0.0f, 1.0f ) * 255.0f + 0.5f);
+        uint32_t bo8 = (uint32_t)(clampf( b[i], 0.0f, 1.0f ) * 255.0f + 0.5f);
+
+        out[i] = 0xff000000u | (ro8 << 16) | (go8 << 8) | bo8;
+    }
+}
+
+/******************************************************************************
+ * sm_isp_pipeline_process
+ *****************************************************************************/
+int sm_isp_pipeline_process
+(
+    isp_pipeline_t const * const    pipe,
+    uint16_t const * const          in,
+    uint32_t const                  in_stride,
+    uint8_t const                   bit_width,
+    uint32_t * const                out,
+    uint32_t const                  out_stride,
+    uint32_t const                  width,
+    uint32_t const                  height
+)
+{
+    float scale;
+    uint32_t x, y;
+
+    if ( !pipe || !pipe->valid || !in || !out || (bit_width < 8u) || (bit_width > 16u) )
+    {
+        return ( -EINVAL );
+    }
+
+    if ( (in_stride < 3u * width) || (out_stride < width) )
+    {
+        return ( -EINVAL );
+    }
+
+    scale = 1.0f / (float)((1ul << bit_width) - 1ul);
+
+    for ( y = 0u; y < height; y++ )
+    {
+        uint16_t const * src = &in[(size_t)y * in_stride];
+        uint32_t       * dst = &out[(size_t)y * out_stride];
+
+        for ( x = 0u; x < width; x += RUN_LENGTH )
+        {
+            uint32_t n = ((width - x) < RUN_LENGTH) ? (width - x) : RUN_LENGTH;
+            process_run( pipe, &src[3u * x], scale, &dst[x], n );
+        }
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * sm_isp_pipeline_bake_cube
+ *****************************************************************************/
+int sm_isp_pipeline_bake_cube
+(
+    isp_pipeline_t const * const    pipe,
+    uint32_t const                  size,
+    uint32_t const                  first,
+    uint32_t const                  count,
+    float * const                   out
+)
+{
+    float r[RUN_LENGTH], g[RUN_LENGTH], b[RUN_LENGTH];
+    float scale;
+    uint32_t total;
+    uint32_t pos;
+
+    if ( !pipe || !pipe->valid || !out )
+    {
+        return ( -EINVAL );
+    }
+
+    if ( (size < ISP_PIPELINE_CUBE_MIN_SIZE) || (size > ISP_PIPELINE_CUBE_MAX_SIZE)
+      || (first > size) || (count > (size - first)) )
+    {
+        return ( -EINVAL );
+    }
+
+    scale = 1.0f / (float)(size - 1u);
+    total = count * size * size;
+
+    // red changes fastest, then green, then blue (.cube order)
+    for ( pos = 0u; pos < total; pos += RUN_LENGTH )
+    {
+        uint32_t n = ((total - pos) < RUN_LENGTH) ? (total - pos) : RUN_LENGTH;
+        float *  dst = &out[3u * pos];
+        uint32_t i;
+
+        for ( i = 0u; i < n; i++ )
+        {
+            uint32_t p = pos + i;
+            r[i] = (float)(p % size) * scale;
+            g[i] = (float)((p / size) % size) * scale;
+            b[i] = (float)(first + p / (size * size)) * scale;
+        }
+
+        process_stages( pipe, r, g, b, n );
+
+        for ( i = 0u; i < n; i++ )
+        {
+            dst[3u*i + 0u] = clampf( r[i], 0.0f, 1.0f );
+            dst[3u*i + 1u] = clampf( g[i], 0.0f, 1.0f );
+            dst[3u*i + 2u] = clampf( b[i], 0.0f, 1.0f );
+        }
+    }
+
+    return ( 0 );
+}
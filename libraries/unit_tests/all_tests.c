@@ -38,6 +38,10 @@
 extern TestRef xyz_tests(void);                         /* implemented in xyz_tests.c */
 extern TestRef conv_tests(void);                        /* implemented in conv_tests.c */
 extern TestRef cubic_tests(void);                       /* implemented in cubic_tests.c */
+extern TestRef gamma_table_tests(void);                 /* implemented in gamma_table_tests.c */
+extern TestRef ct_table_tests(void);                    /* implemented in ct_table_tests.c */
+extern TestRef isp_pipeline_tests(void);                /* implemented in isp_pipeline_tests.c */
+extern TestRef profile_tests(void);                     /* implemented in profile_tests.c */
 extern TestRef rgb2ycbcr_tests(void);                   /* implemented in rgb2ycbcr_tests.c */
 extern TestRef ctrl_channel_tests(void);                /* implemented in ctrl_channel_test.c */
 extern TestRef ctrl_protocol_tests(void);               /* implemented in ctrl_protocol_test.c */
@@ -54,6 +58,9 @@ extern TestRef provideo_protocol_fpnc_tests(void);      /* implemented in provid
 extern TestRef provideo_protocol_playback_tests(void);  /* implemented in provideo_protocol_playback_tests.c */
 extern TestRef provideo_protocol_osd_tests(void);       /* implemented in provideo_protocol_osd_tests.c */
 extern TestRef provideo_protocol_dpcc_tests(void);      /* implemented in provideo_protocol_dpcc_tests.c */
+extern TestRef provideo_protocol_codec_tests(void);     /* implemented in provideo_protocol_codec_tests.c */
+extern TestRef provideo_protocol_reader_tests(void);    /* implemented in provideo_protocol_reader_tests.c */
+extern TestRef provideo_protocol_timing_tests(void);    /* implemented in provideo_protocol_timing_tests.c */
 
 uint8_t g_com_port = 4;
 uint32_t g_com_speed = 57600u;
@@ -141,6 +148,10 @@ int main( int argc, char ** argv )
     //TestRunner_runTest( xyz_tests() );
     //TestRunner_runTest( conv_tests() );
     //TestRunner_runTest( cubic_tests() );
+    //TestRunner_runTest( gamma_table_tests() );
+    //TestRunner_runTest( ct_table_tests() );
+    //TestRunner_runTest( isp_pipeline_tests() );
+    //TestRunner_runTest( profile_tests() );
     //TestRunner_runTest( rgb2ycbcr_tests() );
 
     // test control channel library
@@ -150,6 +161,9 @@ int main( int argc, char ** argv )
     //TestRunner_runTest( ctrl_protocol_tests() );
    
     // test provideo protocol
+    //TestRunner_runTest( provideo_protocol_codec_tests() );
+    //TestRunner_runTest( provideo_protocol_reader_tests() );
+    //TestRunner_runTest( provideo_protocol_timing_tests() );
     //TestRunner_runTest( provideo_protocol_system_tests() );
     //TestRunner_runTest( provideo_protocol_isp_tests() );
     //TestRunner_runTest( provideo_protocol_cproc_tests() );
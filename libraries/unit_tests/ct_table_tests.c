@@ -0,0 +1,330 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    ct_table_tests.c
+ *
+ * @brief   Implementation of unit tests and micro-benchmark for the color
+ *          temperature table and the white-balance gain fit
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#include <simple_math/xyz2ct.h>
+#include <simple_math/ct_table.h>
+
+#include <embUnit/embUnit.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define CT_MIN                  ( CT_TABLE_CT_MIN )
+#define CT_MAX                  ( 12000.0 )
+#define CT_STEP                 ( 10.0 )
+
+#define BENCHMARK_RUNS          ( 100000 )
+#define BENCHMARK_SAMPLES       ( 100 )
+
+static ct_table_t table;
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+    memset( &table, 0, sizeof(table) );
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+}
+
+/******************************************************************************
+ * test_ct_table_invalid
+ *****************************************************************************/
+static void test_ct_table_invalid( void )
+{
+    double const singular[9] = { 1.0, 2.0, 3.0, 2.0, 4.0, 6.0, 0.0, 0.0, 1.0 };
+    double xyz[3] = { 0.0, 0.0, 0.0 };
+    ct_table_entry_t e;
+    ct_fit_t fit;
+    double ct = 5000.0;
+
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, CT_STEP, NULL ) == -EINVAL );
+    TEST_ASSERT( sm_ct_table_calc( CT_MAX, CT_MIN, CT_STEP, &table ) == -EINVAL );
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, 0.0, &table ) == -EINVAL );
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, 1.0, &table ) == -EINVAL );
+    TEST_ASSERT( sm_ct_table_calc( 2000.0, CT_MAX, CT_STEP, &table ) == -EINVAL );
+
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, CT_STEP, &table ) == 0 );
+    TEST_ASSERT( sm_ct_table_set_camera( &table, singular ) == -EINVAL );
+    TEST_ASSERT( table.has_gains == 0 );
+    TEST_ASSERT( sm_ct_table_lookup( &table, CT_MIN - 1.0, &e ) == -ERANGE );
+    TEST_ASSERT( sm_ct_table_lookup( &table, CT_MAX + 1.0, &e ) == -ERANGE );
+    TEST_ASSERT( sm_ct_table_find( &table, xyz, &ct, NULL ) == -EINVAL );
+
+    // two points at the same temperature do not define a line
+    TEST_ASSERT( sm_ct_fit_gains( 0, &ct, &ct, &ct, &fit ) == -EINVAL );
+    {
+        double const cts[2]  = { 5000.0, 5000.0 };
+        double const gain[2] = { 1.0, 2.0 };
+        TEST_ASSERT( sm_ct_fit_gains( 2, cts, gain, gain, &fit ) == -EINVAL );
+    }
+}
+
+/******************************************************************************
+ * test_ct_table_calc
+ *****************************************************************************/
+static void test_ct_table_calc( void )
+{
+    ct_table_entry_t e;
+    double xyz[3];
+    int i;
+
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, CT_STEP, &table ) == 0 );
+    TEST_ASSERT( table.size == 951 );
+    TEST_ASSERT( table.entry[0].ct == CT_MIN );
+    TEST_ASSERT( table.entry[table.size - 1].ct == CT_MAX );
+
+    // every entry is the xyz of CorColorTemptoXYZ
+    for ( i = 0; i < table.size; i += 37 )
+    {
+        CorColorTemptoXYZ( table.entry[i].ct, xyz );
+        TEST_ASSERT( table.entry[i].xyz[0] == xyz[0] );
+        TEST_ASSERT( table.entry[i].xyz[1] == xyz[1] );
+        TEST_ASSERT( table.entry[i].xyz[2] == xyz[2] );
+    }
+
+    // D65 in CIE 1960
+    TEST_ASSERT( sm_ct_table_lookup( &table, 6504.0, &e ) == 0 );
+    TEST_ASSERT( fabs( e.u - 0.1978 ) < 0.0005 );
+    TEST_ASSERT( fabs( e.v - 0.3122 ) < 0.0005 );
+
+    // interpolation between two entries
+    TEST_ASSERT( sm_ct_table_lookup( &table, 5005.0, &e ) == 0 );
+    CorColorTemptoXYZ( 5005.0, xyz );
+    TEST_ASSERT( fabs( e.xyz[0] - xyz[0] ) < 1.0e-5 );
+    TEST_ASSERT( fabs( e.xyz[2] - xyz[2] ) < 1.0e-5 );
+}
+
+/******************************************************************************
+ * test_ct_table_find
+ *****************************************************************************/
+static void test_ct_table_find( void )
+{
+    double xyz[3];
+    double ct, duv;
+    double ct_robertson;
+    double t;
+
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, CT_STEP, &table ) == 0 );
+
+    // points on the locus are found at their own temperature
+    for ( t = CT_MIN + 3.0; t < CT_MAX; t += 97.0 )
+    {
+        CorColorTemptoXYZ( t, xyz );
+        TEST_ASSERT( sm_ct_table_find( &table, xyz, &ct, &duv ) == 0 );
+        TEST_ASSERT( fabs( ct - t ) < 0.5 );
+        TEST_ASSERT( fabs( duv ) < 1.0e-5 );
+    }
+
+    // above and below the locus, close to Robertson's temperature
+    CorColorTemptoXYZ( 5000.0, xyz );
+    xyz[1] *= 1.02;
+    TEST_ASSERT( sm_ct_table_find( &table, xyz, &ct, &duv ) == 0 );
+    TEST_ASSERT( duv > 0.0 );
+    TEST_ASSERT( XYZtoCorColorTemp_Robertson( xyz, &ct_robertson ) == 0 );
+    TEST_ASSERT( fabs( ct - ct_robertson ) < 0.05 * ct_robertson );
+
+    xyz[1] /= (1.02 * 1.02);
+    TEST_ASSERT( sm_ct_table_find( &table, xyz, &ct, &duv ) == 0 );
+    TEST_ASSERT( duv < 0.0 );
+
+    // out of range is clamped to the ends of the table
+    CorColorTemptoXYZ( 20000.0, xyz );
+    TEST_ASSERT( sm_ct_table_find( &table, xyz, &ct, NULL ) == 0 );
+    TEST_ASSERT( ct == CT_MAX );
+}
+
+/******************************************************************************
+ * test_ct_table_gains
+ *****************************************************************************/
+static void test_ct_table_gains( void )
+{
+    double const identity[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+    double const camera[9]   = { 0.6, 0.3, 0.1, 0.25, 0.7, 0.05, 0.0, 0.1, 0.9 };
+    ct_table_entry_t e;
+    int i;
+
+    TEST_ASSERT( sm_ct_table_calc( CT_MIN, CT_MAX, CT_STEP, &table ) == 0 );
+    TEST_ASSERT( table.entry[0].red == 1.0 );
+    TEST_ASSERT( table.has_gains == 0 );
+
+    // camera rgb is xyz
+    TEST_ASSERT( sm_ct_table_set_camera( &table, identity ) == 0 );
+    TEST_ASSERT( table.has_gains == 1 );
+    for ( i = 0; i < table.size; i += 50 )
+    {
+        TEST_ASSERT( fabs( table.entry[i].red  - table.entry[i].xyz[1] / table.entry[i].xyz[0] ) < 1.0e-12 );
+        TEST_ASSERT( fabs( table.entry[i].blue - table.entry[i].xyz[1] / table.entry[i].xyz[2] ) < 1.0e-12 );
+    }
+
+    // the gains turn the illuminant grey, i.e. the camera rgb of the
+    // illuminant is (1/red, 1, 1/blue)
+    TEST_ASSERT( sm_ct_table_set_camera( &table, camera ) == 0 );
+    TEST_ASSERT( sm_ct_table_lookup( &table, 3200.0, &e ) == 0 );
+    {
+        double rgb[3] = { 1.0 / e.red, 1.0, 1.0 / e.blue };
+        double xyz[3];
+        double ill[3];
+
+        for ( i = 0; i < 3; i++ )
+        {
+            xyz[i] = camera[3 * i] * rgb[0] + camera[3 * i + 1] * rgb[1] + camera[3 * i + 2] * rgb[2];
+        }
+
+        CorColorTemptoXYZ( 3200.0, ill );
+        TEST_ASSERT( fabs( xyz[0] / xyz[1] - ill[0] / ill[1] ) < 1.0e-9 );
+        TEST_ASSERT( fabs( xyz[2] / xyz[1] - ill[2] / ill[1] ) < 1.0e-9 );
+    }
+
+    // a single color gets the gains of its table entry
+    {
+        double r, b;
+
+        TEST_ASSERT( sm_ct_gains( camera, table.entry[100].xyz, &r, &b ) == 0 );
+        TEST_ASSERT( fabs( r - table.entry[100].red ) < 1.0e-12 );
+        TEST_ASSERT( fabs( b - table.entry[100].blue ) < 1.0e-12 );
+    }
+
+    // lower temperatures need less red and more blue
+    TEST_ASSERT( table.entry[0].red  < table.entry[table.size - 1].red );
+    TEST_ASSERT( table.entry[0].blue > table.entry[table.size - 1].blue );
+}
+
+/******************************************************************************
+ * test_ct_fit
+ *****************************************************************************/
+static void test_ct_fit( void )
+{
+    double const ct[4] = { 2800.0, 4000.0, 5600.0, 7500.0 };
+    double red[4], blue[4];
+    double r, b;
+    ct_fit_t fit;
+    int i;
+
+    // quadratic curves in mired are reproduced
+    for ( i = 0; i < 4; i++ )
+    {
+        double m = 1.0e6 / ct[i];
+        red[i]  = 2.5 - 3.0e-3 * m + 1.0e-6 * m * m;
+        blue[i] = 0.6 + 2.0e-3 * m + 2.0e-6 * m * m;
+    }
+
+    TEST_ASSERT( sm_ct_fit_gains( 4, ct, red, blue, &fit ) == 0 );
+    TEST_ASSERT( fit.order == 2 );
+    TEST_ASSERT( fabs( fit.red[0] - 2.5 ) < 1.0e-9 );
+    TEST_ASSERT( fabs( fit.blue[2] - 2.0e-6 ) < 1.0e-12 );
+
+    TEST_ASSERT( sm_ct_fit_eval( &fit, 3200.0, &r, &b ) == 0 );
+    TEST_ASSERT( fabs( r - (2.5 - 3.0e-3 * 312.5 + 1.0e-6 * 312.5 * 312.5) ) < 1.0e-9 );
+    TEST_ASSERT( fabs( b - (0.6 + 2.0e-3 * 312.5 + 2.0e-6 * 312.5 * 312.5) ) < 1.0e-9 );
+
+    // one point is a constant, two points a line
+    TEST_ASSERT( sm_ct_fit_gains( 1, ct, red, blue, &fit ) == 0 );
+    TEST_ASSERT( fit.order == 0 );
+    TEST_ASSERT( sm_ct_fit_eval( &fit, 9000.0, &r, &b ) == 0 );
+    TEST_ASSERT( r == red[0] );
+
+    TEST_ASSERT( sm_ct_fit_gains( 2, ct, red, blue, &fit ) == 0 );
+    TEST_ASSERT( fit.order == 1 );
+    TEST_ASSERT( sm_ct_fit_eval( &fit, ct[1], &r, &b ) == 0 );
+    TEST_ASSERT( fabs( r - red[1] ) < 1.0e-9 );
+    TEST_ASSERT( fabs( b - blue[1] ) < 1.0e-9 );
+}
+
+/******************************************************************************
+ * test_ct_table_benchmark - table search against Robertson's method
+ *****************************************************************************/
+static void test_ct_table_benchmark( void )
+{
+    double xyz[BENCHMARK_SAMPLES][3];
+    double ct, sum_table = 0.0, sum_robertson = 0.0;
+    double t_calc, t_table, t_robertson;
+    clock_t start;
+    int const n = BENCHMARK_SAMPLES;
+    int i;
+
+    start = clock();
+    for ( i = 0; i < 100; i++ )
+    {
+        sm_ct_table_calc( CT_MIN, CT_MAX, CT_STEP, &table );
+    }
+    t_calc = (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / 100;
+
+    for ( i = 0; i < n; i++ )
+    {
+        CorColorTemptoXYZ( 2500.0 + 80.0 * i, xyz[i] );
+        xyz[i][1] *= 1.0 + 0.001 * (i % 11);
+    }
+
+    start = clock();
+    for ( i = 0; i < BENCHMARK_RUNS; i++ )
+    {
+        sm_ct_table_find( &table, xyz[i % n], &ct, NULL );
+        sum_table += ct;
+    }
+    t_table = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / BENCHMARK_RUNS;
+
+    start = clock();
+    for ( i = 0; i < BENCHMARK_RUNS; i++ )
+    {
+        XYZtoCorColorTemp_Robertson( xyz[i % n], &ct );
+        sum_robertson += ct;
+    }
+    t_robertson = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / BENCHMARK_RUNS;
+
+    printf( "ct table: calc %.0f us, find %.0f ns, robertson %.0f ns (mean ct %.0f / %.0f K)\n",
+            t_calc, t_table, t_robertson, sum_table / BENCHMARK_RUNS, sum_robertson / BENCHMARK_RUNS );
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef ct_table_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "ct_table_invalid"  , test_ct_table_invalid ),
+        new_TestFixture( "ct_table_calc"     , test_ct_table_calc ),
+        new_TestFixture( "ct_table_find"     , test_ct_table_find ),
+        new_TestFixture( "ct_table_gains"    , test_ct_table_gains ),
+        new_TestFixture( "ct_fit"            , test_ct_fit ),
+        new_TestFixture( "ct_table_benchmark", test_ct_table_benchmark ),
+    };
+    EMB_UNIT_TESTCALLER( ct_table_tests, "Color temperature table tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&ct_table_tests );
+}
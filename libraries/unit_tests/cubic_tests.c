@@ -437,6 +437,66 @@ static void test_cubic_square_interpolation( void )
     TEST_ASSERT( mse < 1.5f );
 }
 
+/******************************************************************************
+ * test_cubic_range_interpolation
+ * - checks if range interpolation matches the single point interpolation
+ *   including the clipping left and right of the sample points
+ *****************************************************************************/
+static void test_cubic_range_interpolation( void )
+{
+    // non-linear curve with unequal segment lengths
+    spline_interpolation_sample_type_t x_0[6]
+        = { CSIP_SAMPLE_TYPE(10), CSIP_SAMPLE_TYPE(40), CSIP_SAMPLE_TYPE(50), CSIP_SAMPLE_TYPE(200), CSIP_SAMPLE_TYPE(700), CSIP_SAMPLE_TYPE(1000) };
+    spline_interpolation_sample_type_t y_0[6]
+        = { CSIP_SAMPLE_TYPE(0), CSIP_SAMPLE_TYPE(300), CSIP_SAMPLE_TYPE(350), CSIP_SAMPLE_TYPE(600), CSIP_SAMPLE_TYPE(1000), CSIP_SAMPLE_TYPE(1023) };
+
+    spline_interpolation_sample_type_t steps[3] = { CSIP_SAMPLE_TYPE(1), CSIP_SAMPLE_TYPE(3), CSIP_SAMPLE_TYPE(64) };
+    spline_interpolation_sample_type_t y_range[1100];
+    spline_interpolation_sample_type_t y;
+
+    int res;
+
+    uint32_t i, j;
+
+    // declare interpolation context
+    spline_interpolation_ctx_t * ctx = NULL;
+
+    // init interpolation context
+    res = sm_cubic_spline_interpolation_init( &ctx );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( ctx != NULL );
+
+    // range interpolation needs an initialized calculation
+    res = sm_cubic_spline_interpolation_calc_range( ctx, CSIP_SAMPLE_TYPE(0), CSIP_SAMPLE_TYPE(1), y_range, 1 );
+    TEST_ASSERT_EQUAL_INT( -EFAULT, res );
+
+    res = sm_cubic_spline_interpolation_set_samples( ctx, x_0, y_0, ARRAY_SIZE(x_0) );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    res = sm_cubic_spline_interpolation_calc_init( ctx );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    // invalid step width
+    res = sm_cubic_spline_interpolation_calc_range( ctx, CSIP_SAMPLE_TYPE(0), CSIP_SAMPLE_TYPE(0), y_range, 1 );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    // run from before x_0 to after x_n with different step widths
+    for ( j = 0u; j<ARRAY_SIZE(steps); j++ )
+    {
+        uint32_t no = 1050u / (uint32_t)steps[j];
+
+        res = sm_cubic_spline_interpolation_calc_range( ctx, CSIP_SAMPLE_TYPE(0), steps[j], y_range, no );
+        TEST_ASSERT_EQUAL_INT( 0, res );
+
+        for ( i = 0u; i<no; i++ )
+        {
+            res = sm_cubic_spline_interpolation_calc( ctx, CSIP_SAMPLE_TYPE(i * steps[j]), &y );
+            TEST_ASSERT_EQUAL_INT( 0, res );
+            TEST_ASSERT( y_range[i] == y );
+        }
+    }
+}
+
 /******************************************************************************
  * test group definition used in all_tests.c
  *****************************************************************************/
@@ -451,6 +511,7 @@ TestRef cubic_tests( void )
         new_TestFixture( "cubic_set_samples"         , test_cubic_set_samples ),
         new_TestFixture( "cubic_linear_interpolation", test_cubic_linear_interpolation ),
         new_TestFixture( "cubic_square_interpolation", test_cubic_square_interpolation ),
+        new_TestFixture( "cubic_range_interpolation" , test_cubic_range_interpolation ),
     };
     EMB_UNIT_TESTCALLER( cubic_tests, "CUBIC SPLINE INTERPOLATION", setup, teardown, fixtures );
 
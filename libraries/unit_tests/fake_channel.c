@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    fake_channel.c
+ *
+ * @brief   Implementation of the fake control channel
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <provideo_protocol/provideo_protocol_common.h>
+
+#include "fake_channel.h"
+
+/******************************************************************************
+ * fake_open
+ *****************************************************************************/
+static int fake_open( void * const handle, void * const param, int const size )
+{
+    (void) param;
+    (void) size;
+
+    ((fake_channel_t *)handle)->pos = 0;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * fake_send
+ *****************************************************************************/
+static int fake_send( void * const handle, uint8_t * const data, int const len )
+{
+    fake_channel_t * fake = (fake_channel_t *)handle;
+    size_t used = strlen( fake->sent );
+
+    if ( !fake->no_requests )
+    {
+        get_time_monotonic( &fake->first_request );
+    }
+
+    if ( (used + (size_t)len) < sizeof(fake->sent) )
+    {
+        memcpy( &fake->sent[used], data, (size_t)len );
+        fake->sent[used + (size_t)len] = '\0';
+    }
+    fake->no_requests++;
+
+    return ( len );
+}
+
+/******************************************************************************
+ * fake_receive
+ *****************************************************************************/
+static int fake_receive( void * const handle, uint8_t * const data, int const len )
+{
+    fake_channel_t * fake = (fake_channel_t *)handle;
+    int n;
+
+    if ( fake->delay_ms )
+    {
+        struct timespec now;
+
+        get_time_monotonic( &now );
+        if ( ((now.tv_sec - fake->first_request.tv_sec) * 1000
+                + (now.tv_nsec - fake->first_request.tv_nsec) / 1000000) < fake->delay_ms )
+        {
+            return ( 0 );
+        }
+    }
+
+    n = (int)strlen( &fake->response[fake->pos] );
+    n = (n < len) ? n : len;
+    memcpy( data, &fake->response[fake->pos], (size_t)n );
+    fake->pos += n;
+
+    return ( n );
+}
+
+/******************************************************************************
+ * fake_channel_open
+ *****************************************************************************/
+int fake_channel_open( ctrl_channel_handle_t const channel, fake_channel_t * const fake )
+{
+    int res;
+
+    memset( fake, 0, sizeof(*fake) );
+    fake->response = "";
+
+    res = ctrl_channel_register( channel, fake, NULL, NULL, fake_open, NULL,
+                                 NULL, NULL, fake_send, fake_receive );
+    if ( res )
+    {
+        return ( res );
+    }
+
+    return ( ctrl_channel_open( channel, NULL, 0 ) );
+}
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    fake_channel.h
+ *
+ * @brief   Control channel without device for the protocol unit tests
+ *
+ * @note    The fake channel records all requests and returns a canned
+ *          response once, optionally held back for a while after the first
+ *          request. Without response it never answers.
+ *
+ *****************************************************************************/
+#ifndef __FAKE_CHANNEL_H__
+#define __FAKE_CHANNEL_H__
+
+#include <time.h>
+
+#include <ctrl_channel/ctrl_channel.h>
+
+/******************************************************************************
+ * state of a fake channel
+ *****************************************************************************/
+typedef struct fake_channel_s
+{
+    char const *    response;       /**< canned response, returned once */
+    int             pos;            /**< bytes of the response already returned */
+    int             delay_ms;       /**< response is held back this long after the first request */
+    struct timespec first_request;  /**< time of the first request */
+    char            sent[1024];     /**< requests, concatenated */
+    int             no_requests;    /**< number of requests */
+} fake_channel_t;
+
+/******************************************************************************
+ * fake_channel_open - registers and opens a channel on a fake, the channel
+ * memory has to be cleared, returns 0 on success
+ *****************************************************************************/
+int fake_channel_open( ctrl_channel_handle_t const channel, fake_channel_t * const fake );
+
+#endif /* __FAKE_CHANNEL_H__ */
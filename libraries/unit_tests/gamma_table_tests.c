@@ -0,0 +1,433 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    gamma_table_tests.c
+ *
+ * @brief   Implementation of unit tests and micro-benchmark for the
+ *          transfer-function tables
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#include <simple_math/gamma.h>
+#include <simple_math/gamma_table.h>
+
+#include <embUnit/embUnit.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define ARRAY_SIZE(x)           ( sizeof(x)/sizeof(x[0]) )
+
+#define BENCHMARK_RUNS          ( 20 )
+
+/******************************************************************************
+ * Rec. 709 parameters as used by the LUT widget
+ *****************************************************************************/
+static gamma_table_params_t const rec709 =
+{
+    .kink               = 0.018f,
+    .linear_contrast    = 4.5f,
+    .linear_brightness  = 0.0f,
+    .contrast           = 1.099f,
+    .gamma              = 1.0f / 2.2f,
+    .brightness         = -0.099f,
+};
+
+static uint8_t const bit_widths[3] = { 10u, 12u, 16u };
+
+static uint16_t table[GAMMA_TABLE_MAX_SIZE];
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+}
+
+/******************************************************************************
+ * to_code - scale a normalized reference value to an output code value
+ *****************************************************************************/
+static int32_t to_code( double v, uint8_t const bit_width )
+{
+    double  size = (double)(1ul << bit_width);
+    int32_t res  = (int32_t)(v * size + 0.5);
+
+    clip( res, 0, (int32_t)(size - 1.0) );
+
+    return ( res );
+}
+
+/******************************************************************************
+ * double precision references
+ *****************************************************************************/
+static int32_t ref_gamma( uint32_t i, uint8_t const bit_width )
+{
+    double Vin = (double)i / (double)(1ul << bit_width);
+    double Vout = ( Vin < rec709.kink )
+                ? Vin * rec709.linear_contrast + rec709.linear_brightness
+                : pow( Vin, rec709.gamma ) * rec709.contrast + rec709.brightness;
+
+    return ( to_code( Vout, bit_width ) );
+}
+
+static int32_t ref_pq( uint32_t i, uint8_t const bit_width )
+{
+    double Vin = (double)i / (double)(1ul << bit_width);
+    double E   = ( Vin <= 0.0003024 ) ? (267.84 * Vin) : (1.099 * pow( 59.5208 * Vin, 0.45 ) - 0.099);
+    double Y   = pow( E, 2.4 ) / 100.0;
+    double Ym  = pow( Y, 0.1593017578125 );
+
+    return ( to_code( pow( (0.8359375 + 18.8515625 * Ym) / (1.0 + 18.6875 * Ym), 78.84375 ), bit_width ) );
+}
+
+static int32_t ref_hlg( uint32_t i, uint8_t const bit_width )
+{
+    double Vin = (double)i / (double)(1ul << bit_width);
+    double Vout = ( Vin <= (1.0 / 12.0) )
+                ? sqrt( 3.0 * Vin )
+                : 0.17883277 * log( (12.0 * Vin) - 0.28466892 ) + 0.55991073;
+
+    return ( to_code( Vout, bit_width ) );
+}
+
+/******************************************************************************
+ * scalar implementations from gamma.c
+ *****************************************************************************/
+static int32_t scalar_gamma_float( uint32_t i, uint8_t const bit_width )
+{
+    return ( (int32_t)sm_gamma_float( i, rec709.kink, rec709.linear_contrast, rec709.linear_brightness,
+                                      rec709.contrast, rec709.gamma, rec709.brightness, bit_width, bit_width ) );
+}
+
+static int32_t scalar_gamma( uint32_t i, uint8_t const bit_width )
+{
+    // integer interface of sm_gamma, unit 100000
+    return ( (int32_t)sm_gamma( i, 1800, 450000, 0, 109900, 45455, -9900, 100000, bit_width, bit_width ) );
+}
+
+static int32_t scalar_pq( uint32_t i, uint8_t const bit_width )
+{
+    return ( (int32_t)sm_pq( i, bit_width, bit_width ) );
+}
+
+static int32_t scalar_hlg( uint32_t i, uint8_t const bit_width )
+{
+    return ( (int32_t)sm_hlg( i, bit_width, bit_width ) );
+}
+
+typedef int32_t (* sample_func_t)( uint32_t i, uint8_t const bit_width );
+
+/******************************************************************************
+ * max_error - maximal deviation of table from reference in LSB
+ *****************************************************************************/
+static int32_t max_error
+(
+    gamma_table_curve_t const   curve,
+    sample_func_t const         ref,
+    uint8_t const               bit_width
+)
+{
+    int32_t err = 0;
+    uint32_t i;
+
+    if ( sm_gamma_table_calc( curve, &rec709, bit_width, table ) )
+    {
+        return ( INT32_MAX );
+    }
+
+    for ( i = 0u; i < (1ul << bit_width); i++ )
+    {
+        int32_t d = abs( (int32_t)table[i] - ref( i, bit_width ) );
+        err = (d > err) ? d : err;
+    }
+
+    return ( err );
+}
+
+/******************************************************************************
+ * max_scalar_error - maximal deviation of scalar function from reference
+ *****************************************************************************/
+static int32_t max_scalar_error
+(
+    sample_func_t const         func,
+    sample_func_t const         ref,
+    uint8_t const               bit_width
+)
+{
+    int32_t err = 0;
+    uint32_t i;
+
+    for ( i = 0u; i < (1ul << bit_width); i++ )
+    {
+        int32_t d = abs( func( i, bit_width ) - ref( i, bit_width ) );
+        err = (d > err) ? d : err;
+    }
+
+    return ( err );
+}
+
+/******************************************************************************
+ * elapsed_us - time of BENCHMARK_RUNS complete 16 bit tables in us per table
+ *****************************************************************************/
+static double elapsed_us_table( gamma_table_curve_t const curve )
+{
+    clock_t start = clock();
+    int i;
+
+    for ( i = 0; i < BENCHMARK_RUNS; i++ )
+    {
+        sm_gamma_table_calc( curve, &rec709, 16u, table );
+    }
+
+    return ( (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / BENCHMARK_RUNS );
+}
+
+static double elapsed_us_scalar( sample_func_t const func )
+{
+    clock_t start = clock();
+    int i;
+    uint32_t k;
+
+    for ( i = 0; i < BENCHMARK_RUNS; i++ )
+    {
+        for ( k = 0u; k < GAMMA_TABLE_MAX_SIZE; k++ )
+        {
+            table[k] = (uint16_t)func( k, 16u );
+        }
+    }
+
+    return ( (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC / BENCHMARK_RUNS );
+}
+
+/******************************************************************************
+ * test_gamma_table_invalid
+ *****************************************************************************/
+static void test_gamma_table_invalid( void )
+{
+    int res;
+
+    res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_GAMMA, &rec709, 12u, NULL );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_GAMMA, NULL, 12u, table );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_PQ, NULL, 17u, table );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_MAX, NULL, 12u, table );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_HLG, NULL, 12u, table );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+}
+
+/******************************************************************************
+ * test_gamma_table_accuracy
+ * - all tables stay within 1 LSB of a double precision reference
+ *****************************************************************************/
+static void test_gamma_table_accuracy( void )
+{
+    uint32_t i;
+
+    for ( i = 0u; i < ARRAY_SIZE(bit_widths); i++ )
+    {
+        int32_t err_gamma = max_error( GAMMA_TABLE_CURVE_GAMMA, ref_gamma, bit_widths[i] );
+        int32_t err_pq    = max_error( GAMMA_TABLE_CURVE_PQ   , ref_pq   , bit_widths[i] );
+        int32_t err_hlg   = max_error( GAMMA_TABLE_CURVE_HLG  , ref_hlg  , bit_widths[i] );
+
+        printf( "%2d bit: max. error gamma=%d, pq=%d, hlg=%d LSB\n",
+                bit_widths[i], err_gamma, err_pq, err_hlg );
+
+        TEST_ASSERT( err_gamma <= 1 );
+        TEST_ASSERT( err_pq    <= 1 );
+        TEST_ASSERT( err_hlg   <= 1 );
+    }
+}
+
+/******************************************************************************
+ * test_gamma_table_cache
+ *****************************************************************************/
+static void test_gamma_table_cache( void )
+{
+    gamma_table_cache_t * cache = malloc( sizeof(gamma_table_cache_t) );
+    gamma_table_params_t params = rec709;
+    uint16_t const * t0;
+    uint16_t const * t1;
+    uint16_t const * t2;
+    int res;
+    uint32_t i;
+
+    TEST_ASSERT( cache != NULL );
+
+    res = sm_gamma_table_cache_reset( cache );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    // same key, same table
+    t0 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &params, 12u );
+    t1 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &params, 12u );
+    TEST_ASSERT( t0 != NULL );
+    TEST_ASSERT( t0 == t1 );
+
+    // cached table matches a computed one
+    res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_GAMMA, &params, 12u, table );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( !memcmp( t0, table, (1u << 12) * sizeof(uint16_t) ) );
+
+    // parameters are ignored for PQ
+    t1 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_PQ, &params, 12u );
+    t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_PQ, NULL, 12u );
+    TEST_ASSERT( t1 != NULL );
+    TEST_ASSERT( t1 != t0 );
+    TEST_ASSERT( t1 == t2 );
+
+    // other bit-width and parameters are other tables
+    t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &params, 10u );
+    TEST_ASSERT( (t2 != t0) && (t2 != t1) );
+
+    params.gamma = 1.0f / 2.4f;
+    t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &params, 12u );
+    TEST_ASSERT( (t2 != t0) && (t2 != t1) );
+
+    // t0 is still cached, touch it and push out the others
+    t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &rec709, 12u );
+    TEST_ASSERT( t2 == t0 );
+    for ( i = 0u; i < (GAMMA_TABLE_CACHE_SIZE - 1u); i++ )
+    {
+        params.gamma = 1.0f / (3.0f + (float)i);
+        t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &params, 12u );
+        TEST_ASSERT( t2 != t0 );
+    }
+    t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, &rec709, 12u );
+    TEST_ASSERT( t2 == t0 );
+
+    // invalid requests
+    t2 = sm_gamma_table_get( cache, GAMMA_TABLE_CURVE_GAMMA, NULL, 12u );
+    TEST_ASSERT( t2 == NULL );
+    t2 = sm_gamma_table_get( NULL, GAMMA_TABLE_CURVE_PQ, NULL, 12u );
+    TEST_ASSERT( t2 == NULL );
+
+    free( cache );
+}
+
+/******************************************************************************
+ * test_gamma_table_sample
+ * - sampled values are the table entries at the same input code values
+ *****************************************************************************/
+static void test_gamma_table_sample( void )
+{
+    gamma_table_curve_t const curves[3] = { GAMMA_TABLE_CURVE_GAMMA, GAMMA_TABLE_CURVE_PQ, GAMMA_TABLE_CURVE_HLG };
+    uint32_t x[130];
+    uint16_t y[130];
+    uint32_t i, k;
+    int res;
+
+    // 128 plot samples, one extra in between and one out of range
+    for ( i = 0u; i < 128u; i++ )
+    {
+        x[i] = i * ((1u << 12) / 128u);
+    }
+    x[128] = 75u;
+    x[129] = (1u << 12) + 5u;
+
+    for ( k = 0u; k < ARRAY_SIZE(curves); k++ )
+    {
+        res = sm_gamma_table_calc( curves[k], &rec709, 12u, table );
+        TEST_ASSERT_EQUAL_INT( 0, res );
+
+        res = sm_gamma_table_sample( curves[k], &rec709, 12u, x, y, ARRAY_SIZE(x) );
+        TEST_ASSERT_EQUAL_INT( 0, res );
+
+        for ( i = 0u; i < (ARRAY_SIZE(x) - 1u); i++ )
+        {
+            TEST_ASSERT_EQUAL_INT( table[x[i]], y[i] );
+        }
+        TEST_ASSERT_EQUAL_INT( table[(1u << 12) - 1u], y[129] );
+    }
+
+    // invalid requests
+    res = sm_gamma_table_sample( GAMMA_TABLE_CURVE_GAMMA, NULL, 12u, x, y, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+    res = sm_gamma_table_sample( GAMMA_TABLE_CURVE_MAX, NULL, 12u, x, y, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+    res = sm_gamma_table_sample( GAMMA_TABLE_CURVE_PQ, NULL, 0u, x, y, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+    res = sm_gamma_table_sample( GAMMA_TABLE_CURVE_PQ, NULL, 12u, NULL, y, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+}
+
+/******************************************************************************
+ * test_gamma_table_benchmark
+ * - compares speed and accuracy of the tables with the scalar functions
+ *****************************************************************************/
+static void test_gamma_table_benchmark( void )
+{
+    double t_table, t_scalar;
+
+    printf( "16 bit table  : time/us (table, scalar) | max. error/LSB (table, scalar)\n" );
+
+    t_table  = elapsed_us_table( GAMMA_TABLE_CURVE_GAMMA );
+    t_scalar = elapsed_us_scalar( scalar_gamma );
+    printf( "sm_gamma      : %8.0f %8.0f | %d %d\n", t_table, t_scalar,
+            max_error( GAMMA_TABLE_CURVE_GAMMA, ref_gamma, 16u ), max_scalar_error( scalar_gamma, ref_gamma, 16u ) );
+
+    t_scalar = elapsed_us_scalar( scalar_gamma_float );
+    printf( "sm_gamma_float: %8.0f %8.0f | %d %d\n", t_table, t_scalar,
+            max_error( GAMMA_TABLE_CURVE_GAMMA, ref_gamma, 16u ), max_scalar_error( scalar_gamma_float, ref_gamma, 16u ) );
+
+    t_table  = elapsed_us_table( GAMMA_TABLE_CURVE_PQ );
+    t_scalar = elapsed_us_scalar( scalar_pq );
+    printf( "sm_pq         : %8.0f %8.0f | %d %d\n", t_table, t_scalar,
+            max_error( GAMMA_TABLE_CURVE_PQ, ref_pq, 16u ), max_scalar_error( scalar_pq, ref_pq, 16u ) );
+
+    t_table  = elapsed_us_table( GAMMA_TABLE_CURVE_HLG );
+    t_scalar = elapsed_us_scalar( scalar_hlg );
+    printf( "sm_hlg        : %8.0f %8.0f | %d %d\n", t_table, t_scalar,
+            max_error( GAMMA_TABLE_CURVE_HLG, ref_hlg, 16u ), max_scalar_error( scalar_hlg, ref_hlg, 16u ) );
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef gamma_table_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "gamma_table_invalid"  , test_gamma_table_invalid ),
+        new_TestFixture( "gamma_table_accuracy" , test_gamma_table_accuracy ),
+        new_TestFixture( "gamma_table_cache"    , test_gamma_table_cache ),
+        new_TestFixture( "gamma_table_sample"   , test_gamma_table_sample ),
+        new_TestFixture( "gamma_table_benchmark", test_gamma_table_benchmark ),
+    };
+    EMB_UNIT_TESTCALLER( gamma_table_tests, "Gamma table tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&gamma_table_tests );
+}
@@ -0,0 +1,546 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    isp_pipeline_tests.c
+ *
+ * @brief   Implementation of unit tests and benchmark for the colour
+ *          pipeline model
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+
+#include <simple_math/gamma_table.h>
+#include <simple_math/isp_pipeline.h>
+
+#include <embUnit/embUnit.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define ARRAY_SIZE(x)           ( sizeof(x)/sizeof(x[0]) )
+
+#define BENCHMARK_RUNS          ( 5 )
+
+#define TEST_WIDTH              ( 64u )
+#define TEST_BIT_WIDTH          ( 12u )
+#define TEST_MAX                ( (1u << TEST_BIT_WIDTH) - 1u )
+
+#define RED(p)                  ( (int)(((p) >> 16) & 0xffu) )
+#define GREEN(p)                ( (int)(((p) >>  8) & 0xffu) )
+#define BLUE(p)                 ( (int)(((p) >>  0) & 0xffu) )
+
+static isp_pipeline_t * pipe;
+static isp_pipeline_params_t params;
+
+static uint16_t in[3u * TEST_WIDTH];
+static uint32_t out[TEST_WIDTH];
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+    pipe = malloc( sizeof(isp_pipeline_t) );
+    sm_isp_pipeline_reset( pipe );
+    sm_isp_pipeline_params_init( &params );
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+    free( pipe );
+    pipe = NULL;
+}
+
+/******************************************************************************
+ * fill_grey - grey ramp from black to white
+ *****************************************************************************/
+static void fill_grey( void )
+{
+    uint32_t i;
+
+    for ( i = 0u; i < TEST_WIDTH; i++ )
+    {
+        uint16_t v = (uint16_t)(i * TEST_MAX / (TEST_WIDTH - 1u));
+        in[3u*i + 0u] = v;
+        in[3u*i + 1u] = v;
+        in[3u*i + 2u] = v;
+    }
+}
+
+/******************************************************************************
+ * fill_colour - saturated colours of all hues at half level
+ *****************************************************************************/
+static void fill_colour( void )
+{
+    uint32_t i;
+
+    for ( i = 0u; i < TEST_WIDTH; i++ )
+    {
+        uint32_t h = i * 6u * 256u / TEST_WIDTH;
+        uint32_t f = h & 0xffu;
+        uint32_t r, g, b;
+
+        switch ( h >> 8 )
+        {
+            case 0:  r = 255u;       g = f;          b = 0u;         break;
+            case 1:  r = 255u - f;   g = 255u;       b = 0u;         break;
+            case 2:  r = 0u;         g = 255u;       b = f;          break;
+            case 3:  r = 0u;         g = 255u - f;   b = 255u;       break;
+            case 4:  r = f;          g = 0u;         b = 255u;       break;
+            default: r = 255u;       g = 0u;         b = 255u - f;   break;
+        }
+
+        in[3u*i + 0u] = (uint16_t)(r * TEST_MAX / 510u);
+        in[3u*i + 1u] = (uint16_t)(g * TEST_MAX / 510u);
+        in[3u*i + 2u] = (uint16_t)(b * TEST_MAX / 510u);
+    }
+}
+
+/******************************************************************************
+ * expected - input sample scaled to 8 bit
+ *****************************************************************************/
+static int expected( uint16_t const v )
+{
+    return ( (int)(((uint32_t)v * 255u + TEST_MAX / 2u) / TEST_MAX) );
+}
+
+/******************************************************************************
+ * run - update pipeline and process the test line
+ *****************************************************************************/
+static int run( void )
+{
+    int res = sm_isp_pipeline_update( pipe, &params );
+    if ( res )
+    {
+        return ( res );
+    }
+
+    return ( sm_isp_pipeline_process( pipe, in, 3u * TEST_WIDTH, TEST_BIT_WIDTH,
+                                      out, TEST_WIDTH, TEST_WIDTH, 1u ) );
+}
+
+/******************************************************************************
+ * test_isp_pipeline_invalid
+ *****************************************************************************/
+static void test_isp_pipeline_invalid( void )
+{
+    int res;
+
+    // not computed yet
+    res = sm_isp_pipeline_process( pipe, in, 3u * TEST_WIDTH, TEST_BIT_WIDTH, out, TEST_WIDTH, TEST_WIDTH, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_isp_pipeline_update( pipe, NULL );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    params.mcc_phases = ISP_PIPELINE_MAX_PHASES + 1u;
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    // singular colour conversion
+    sm_isp_pipeline_params_init( &params );
+    memset( params.conv, 0, sizeof(params.conv) );
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    // invalid knee
+    sm_isp_pipeline_params_init( &params );
+    params.knee_enable = 1u;
+    params.knee_slope  = 50u;
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    sm_isp_pipeline_params_init( &params );
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    res = sm_isp_pipeline_process( pipe, in, 3u * TEST_WIDTH, 7u, out, TEST_WIDTH, TEST_WIDTH, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_isp_pipeline_process( pipe, in, TEST_WIDTH, TEST_BIT_WIDTH, out, TEST_WIDTH, TEST_WIDTH, 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+}
+
+/******************************************************************************
+ * test_isp_pipeline_neutral
+ * - a neutral pipeline only rescales the input
+ *****************************************************************************/
+static void test_isp_pipeline_neutral( void )
+{
+    uint32_t i;
+    int res;
+
+    fill_grey();
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    for ( i = 0u; i < TEST_WIDTH; i++ )
+    {
+        TEST_ASSERT_EQUAL_INT( expected( in[3u*i] ), RED( out[i] ) );
+        TEST_ASSERT_EQUAL_INT( expected( in[3u*i] ), GREEN( out[i] ) );
+        TEST_ASSERT_EQUAL_INT( expected( in[3u*i] ), BLUE( out[i] ) );
+        TEST_ASSERT( (out[i] >> 24) == 0xffu );
+    }
+
+    // colours are kept within the resolution of the chroma table
+    fill_colour();
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    for ( i = 0u; i < TEST_WIDTH; i++ )
+    {
+        TEST_ASSERT( abs( expected( in[3u*i + 0u] ) - RED( out[i] ) ) <= 1 );
+        TEST_ASSERT( abs( expected( in[3u*i + 1u] ) - GREEN( out[i] ) ) <= 1 );
+        TEST_ASSERT( abs( expected( in[3u*i + 2u] ) - BLUE( out[i] ) ) <= 1 );
+    }
+}
+
+/******************************************************************************
+ * test_isp_pipeline_stages
+ *****************************************************************************/
+static void test_isp_pipeline_stages( void )
+{
+    static uint16_t lut[ISP_PIPELINE_LUT_SIZE];
+    uint32_t i;
+    int res;
+
+    // white balance: doubled red on grey
+    fill_grey();
+    params.wb_gain[0] = 2.0f;
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT_EQUAL_INT( 255, RED( out[TEST_WIDTH - 1u] ) );
+    TEST_ASSERT( RED( out[TEST_WIDTH / 4u] ) > GREEN( out[TEST_WIDTH / 4u] ) );
+
+    // transfer table: inverted red
+    sm_isp_pipeline_params_init( &params );
+    for ( i = 0u; i < ISP_PIPELINE_LUT_SIZE; i++ )
+    {
+        lut[i] = (uint16_t)(ISP_PIPELINE_LUT_SIZE - 1u - i);
+    }
+    params.lut[0] = lut;
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT_EQUAL_INT( 255, RED( out[0] ) );
+    TEST_ASSERT( GREEN( out[0] ) <= 1 );
+
+    // gamma table brightens the mid tones
+    sm_isp_pipeline_params_init( &params );
+    {
+        gamma_table_params_t const rec709 = { 0.018f, 4.5f, 0.0f, 1.099f, 1.0f / 2.2f, -0.099f };
+        res = sm_gamma_table_calc( GAMMA_TABLE_CURVE_GAMMA, &rec709, ISP_PIPELINE_LUT_BIT_WIDTH, lut );
+        TEST_ASSERT_EQUAL_INT( 0, res );
+    }
+    params.lut[0] = params.lut[1] = params.lut[2] = lut;
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( GREEN( out[TEST_WIDTH / 4u] ) > expected( in[3u * (TEST_WIDTH / 4u)] ) + 32 );
+
+    // colour processing: no saturation turns colours grey
+    sm_isp_pipeline_params_init( &params );
+    fill_colour();
+    params.saturation = 0.0f;
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    for ( i = 0u; i < TEST_WIDTH; i++ )
+    {
+        TEST_ASSERT( abs( RED( out[i] ) - GREEN( out[i] ) ) <= 1 );
+        TEST_ASSERT( abs( BLUE( out[i] ) - GREEN( out[i] ) ) <= 1 );
+    }
+
+    // multi colour control: same, one phase at a time
+    sm_isp_pipeline_params_init( &params );
+    params.mcc_enable = 1u;
+    params.mcc_phases = 12u;
+    for ( i = 0u; i < params.mcc_phases; i++ )
+    {
+        params.mcc_saturation[i] = 0.0f;
+    }
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    for ( i = 0u; i < TEST_WIDTH; i++ )
+    {
+        TEST_ASSERT( abs( RED( out[i] ) - GREEN( out[i] ) ) <= 1 );
+    }
+
+    // brightness lifts black
+    sm_isp_pipeline_params_init( &params );
+    fill_grey();
+    params.brightness = 0.25f;
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( abs( GREEN( out[0] ) - 64 ) <= 1 );
+
+    // knee compresses highlights, settings as used by the knee widget
+    sm_isp_pipeline_params_init( &params );
+    params.knee_enable = 1u;
+    params.knee_point  = 80u;
+    params.knee_slope  = 200u;
+    params.white_clip  = 105u;
+    res = run();
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    for ( i = 1u; i < TEST_WIDTH; i++ )
+    {
+        TEST_ASSERT( GREEN( out[i] ) >= GREEN( out[i - 1u] ) );
+    }
+}
+
+/******************************************************************************
+ * test_isp_pipeline_update
+ * - tweaking the white balance does not recompute the chroma table
+ *****************************************************************************/
+static void test_isp_pipeline_update( void )
+{
+    int res;
+
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    pipe->chroma[0][0] = 42.0f;
+
+    params.wb_gain[2] = 1.5f;
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( pipe->chroma[0][0] == 42.0f );
+
+    params.hue = 10.0f;
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( pipe->chroma[0][0] != 42.0f );
+
+    // reset forces a complete update
+    pipe->chroma[0][0] = 42.0f;
+    sm_isp_pipeline_reset( pipe );
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT( pipe->chroma[0][0] != 42.0f );
+}
+
+/******************************************************************************
+ * test_isp_pipeline_benchmark
+ * - time per frame at 1080p and 4K on one core, the strips of a frame can
+ *   be processed on several cores at once
+ *****************************************************************************/
+static void test_isp_pipeline_benchmark( void )
+{
+    static struct { char const * name; uint32_t width; uint32_t height; } const sizes[] =
+    {
+        { "1080p", 1920u, 1080u },
+        { "4K   ", 3840u, 2160u },
+    };
+
+    uint32_t i, k;
+    int res;
+
+    params.wb_gain[0]  = 1.3f;
+    params.wb_gain[2]  = 1.8f;
+    params.knee_enable = 1u;
+    params.knee_point  = 80u;
+    params.knee_slope  = 200u;
+    params.white_clip  = 105u;
+    params.mcc_enable  = 1u;
+    params.mcc_phases  = 24u;
+    params.saturation  = 1.2f;
+
+    clock_t start = clock();
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    printf( "update  : %8.2f ms\n", (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC );
+
+    for ( i = 0u; i < ARRAY_SIZE(sizes); i++ )
+    {
+        size_t    n   = (size_t)sizes[i].width * sizes[i].height;
+        uint16_t * src = malloc( 3u * n * sizeof(uint16_t) );
+        uint32_t * dst = malloc( n * sizeof(uint32_t) );
+        double     ms;
+        int        r;
+
+        TEST_ASSERT( (src != NULL) && (dst != NULL) );
+
+        for ( k = 0u; k < 3u * n; k++ )
+        {
+            src[k] = (uint16_t)((k * 2654435761u) >> 20);
+        }
+
+        start = clock();
+        for ( r = 0; r < BENCHMARK_RUNS; r++ )
+        {
+            res = sm_isp_pipeline_process( pipe, src, 3u * sizes[i].width, TEST_BIT_WIDTH,
+                                           dst, sizes[i].width, sizes[i].width, sizes[i].height );
+            TEST_ASSERT_EQUAL_INT( 0, res );
+        }
+        ms = (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC / BENCHMARK_RUNS;
+
+        printf( "%s   : %8.2f ms/frame per core, %6.1f Mpixel/s\n",
+                sizes[i].name, ms, (double)n / ms / 1e3 );
+
+        free( src );
+        free( dst );
+    }
+}
+
+/******************************************************************************
+ * test_isp_pipeline_cube
+ * - a neutral lattice is the identity, slices baked separately match a
+ *   cube baked at once
+ *****************************************************************************/
+static void test_isp_pipeline_cube( void )
+{
+    uint32_t const size = 17u;
+    size_t const   n    = (size_t)size * size * size;
+    float * all   = malloc( 3u * n * sizeof(float) );
+    float * slice = malloc( 3u * n * sizeof(float) );
+    uint32_t i, k;
+    int res;
+
+    TEST_ASSERT( (all != NULL) && (slice != NULL) );
+
+    res = sm_isp_pipeline_bake_cube( pipe, size, 0u, size, all );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    res = sm_isp_pipeline_bake_cube( pipe, 1u, 0u, 1u, all );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+    res = sm_isp_pipeline_bake_cube( pipe, size, 10u, 8u, all );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = sm_isp_pipeline_bake_cube( pipe, size, 0u, size, all );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    // red fastest, then green, then blue
+    for ( i = 0u; i < n; i++ )
+    {
+        float r = (float)(i % size) / (float)(size - 1u);
+        float g = (float)((i / size) % size) / (float)(size - 1u);
+        float b = (float)(i / (size * size)) / (float)(size - 1u);
+
+        TEST_ASSERT( fabsf( all[3u*i + 0u] - r ) < 0.01f );
+        TEST_ASSERT( fabsf( all[3u*i + 1u] - g ) < 0.01f );
+        TEST_ASSERT( fabsf( all[3u*i + 2u] - b ) < 0.01f );
+    }
+
+    params.wb_gain[0]  = 1.3f;
+    params.knee_enable = 1u;
+    params.knee_point  = 80u;
+    params.knee_slope  = 200u;
+    params.white_clip  = 105u;
+    params.saturation  = 1.2f;
+    params.hue         = 10.0f;
+
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    res = sm_isp_pipeline_bake_cube( pipe, size, 0u, size, all );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    for ( k = 0u; k < size; k += 4u )
+    {
+        uint32_t count = ((size - k) < 4u) ? (size - k) : 4u;
+
+        res = sm_isp_pipeline_bake_cube( pipe, size, k, count, &slice[3u * k * size * size] );
+        TEST_ASSERT_EQUAL_INT( 0, res );
+    }
+
+    TEST_ASSERT( !memcmp( all, slice, 3u * n * sizeof(float) ) );
+
+    for ( i = 0u; i < 3u * n; i++ )
+    {
+        TEST_ASSERT( (all[i] >= 0.0f) && (all[i] <= 1.0f) );
+    }
+
+    free( all );
+    free( slice );
+}
+
+/******************************************************************************
+ * test_isp_pipeline_cube_benchmark
+ * - time to bake 33^3 and 65^3 lattices on one core
+ *****************************************************************************/
+static void test_isp_pipeline_cube_benchmark( void )
+{
+    static uint32_t const sizes[] = { 33u, 65u };
+
+    uint32_t i;
+    int res;
+
+    params.wb_gain[0]  = 1.3f;
+    params.wb_gain[2]  = 1.8f;
+    params.knee_enable = 1u;
+    params.knee_point  = 80u;
+    params.knee_slope  = 200u;
+    params.white_clip  = 105u;
+    params.mcc_enable  = 1u;
+    params.mcc_phases  = 24u;
+    params.saturation  = 1.2f;
+
+    res = sm_isp_pipeline_update( pipe, &params );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    for ( i = 0u; i < ARRAY_SIZE(sizes); i++ )
+    {
+        size_t  n   = (size_t)sizes[i] * sizes[i] * sizes[i];
+        float * dst = malloc( 3u * n * sizeof(float) );
+        clock_t start;
+        double  ms;
+        int     r;
+
+        TEST_ASSERT( dst != NULL );
+
+        start = clock();
+        for ( r = 0; r < BENCHMARK_RUNS; r++ )
+        {
+            res = sm_isp_pipeline_bake_cube( pipe, sizes[i], 0u, sizes[i], dst );
+            TEST_ASSERT_EQUAL_INT( 0, res );
+        }
+        ms = (double)(clock() - start) * 1e3 / CLOCKS_PER_SEC / BENCHMARK_RUNS;
+
+        printf( "cube %2u : %8.2f ms per core\n", sizes[i], ms );
+
+        free( dst );
+    }
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef isp_pipeline_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "isp_pipeline_invalid"       , test_isp_pipeline_invalid ),
+        new_TestFixture( "isp_pipeline_neutral"       , test_isp_pipeline_neutral ),
+        new_TestFixture( "isp_pipeline_stages"        , test_isp_pipeline_stages ),
+        new_TestFixture( "isp_pipeline_update"        , test_isp_pipeline_update ),
+        new_TestFixture( "isp_pipeline_benchmark"     , test_isp_pipeline_benchmark ),
+        new_TestFixture( "isp_pipeline_cube"          , test_isp_pipeline_cube ),
+        new_TestFixture( "isp_pipeline_cube_benchmark", test_isp_pipeline_cube_benchmark ),
+    };
+    EMB_UNIT_TESTCALLER( isp_pipeline_tests, "ISP pipeline tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&isp_pipeline_tests );
+}
@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    profile_tests.c
+ *
+ * @brief   Implementation of unit tests for the binary profile container
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <profile/profile.h>
+
+#include <embUnit/embUnit.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define ARRAY_SIZE(x)           ( sizeof(x)/sizeof(x[0]) )
+
+#define TEST_BUFFER_SIZE        ( 1024u )
+
+static uint8_t buffer[TEST_BUFFER_SIZE];
+static size_t  length;
+
+static uint8_t const payload_lut[]  = { 1u, 2u, 3u, 4u, 5u, 6u, 7u };
+static uint8_t const payload_knee[] = { 0x55u, 0xaau };
+
+static profile_section_t const sections[] =
+{
+    { PROFILE_SUBSYSTEM_LUT , 4u, sizeof(payload_lut) , "LUT0", payload_lut  },
+    { PROFILE_SUBSYSTEM_KNEE, 4u, sizeof(payload_knee), "KNEE", payload_knee },
+    { PROFILE_SUBSYSTEM_MCC , 3u, 0u                  , "MCC" , NULL         },
+};
+
+/******************************************************************************
+ * write_profile - write the test sections into buffer
+ *****************************************************************************/
+static void write_profile( void )
+{
+    size_t offset = PROFILE_HEADER_SIZE;
+    uint32_t i;
+    int res;
+
+    memset( buffer, 0xee, sizeof(buffer) );
+
+    for ( i = 0u; i < ARRAY_SIZE(sections); i++ )
+    {
+        res = profile_write_section( &buffer[offset], &sections[i] );
+        TEST_ASSERT_EQUAL_INT( (int)profile_section_size( sections[i].name_len, sections[i].size ), res );
+        TEST_ASSERT( (res % 4) == 0 );
+        offset += (size_t)res;
+    }
+
+    res = profile_write_header( buffer, ARRAY_SIZE(sections), (uint32_t)offset );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    length = offset;
+}
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+    write_profile();
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+}
+
+/******************************************************************************
+ * test_profile_crc32
+ * - standard check value of CRC-32, incremental update
+ *****************************************************************************/
+static void test_profile_crc32( void )
+{
+    static char const check[] = "123456789";
+    uint32_t crc;
+
+    TEST_ASSERT( profile_crc32( 0u, check, 9u ) == 0xcbf43926u );
+
+    crc = profile_crc32( 0u, check, 4u );
+    crc = profile_crc32( crc, &check[4], 5u );
+    TEST_ASSERT( crc == 0xcbf43926u );
+
+    TEST_ASSERT( profile_crc32( 0u, check, 0u ) == 0u );
+}
+
+/******************************************************************************
+ * test_profile_roundtrip
+ * - sections are read back in order, pointing into the buffer
+ *****************************************************************************/
+static void test_profile_roundtrip( void )
+{
+    profile_section_t section;
+    size_t offset = PROFILE_HEADER_SIZE;
+    uint16_t count = 0u;
+    uint32_t i;
+    int res;
+
+    res = profile_read_header( buffer, length, &count );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT_EQUAL_INT( (int)ARRAY_SIZE(sections), count );
+
+    for ( i = 0u; i < count; i++ )
+    {
+        res = profile_read_section( buffer, length, &offset, &section );
+        TEST_ASSERT_EQUAL_INT( 0, res );
+        TEST_ASSERT_EQUAL_INT( sections[i].subsystem, section.subsystem );
+        TEST_ASSERT_EQUAL_INT( sections[i].name_len, section.name_len );
+        TEST_ASSERT_EQUAL_INT( (int)sections[i].size, (int)section.size );
+        TEST_ASSERT( !memcmp( sections[i].name, section.name, section.name_len ) );
+        TEST_ASSERT( !section.size || !memcmp( sections[i].data, section.data, section.size ) );
+        TEST_ASSERT( (section.data >= buffer) && (section.data <= &buffer[length]) );
+    }
+
+    TEST_ASSERT_EQUAL_INT( (int)length, (int)offset );
+
+    res = profile_read_section( buffer, length, &offset, &section );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+}
+
+/******************************************************************************
+ * test_profile_corrupt
+ * - a damaged section is reported and skipped, the others stay readable
+ *****************************************************************************/
+static void test_profile_corrupt( void )
+{
+    profile_section_t section;
+    size_t offset = PROFILE_HEADER_SIZE;
+    uint16_t count = 0u;
+    int res;
+
+    // flip a payload bit of the first section
+    buffer[PROFILE_HEADER_SIZE + PROFILE_SECTION_HEADER_SIZE + 4u + 2u] ^= 0x10u;
+
+    res = profile_read_header( buffer, length, &count );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+
+    res = profile_read_section( buffer, length, &offset, &section );
+    TEST_ASSERT_EQUAL_INT( -EILSEQ, res );
+
+    res = profile_read_section( buffer, length, &offset, &section );
+    TEST_ASSERT_EQUAL_INT( 0, res );
+    TEST_ASSERT_EQUAL_INT( PROFILE_SUBSYSTEM_KNEE, section.subsystem );
+
+    // damaged header
+    buffer[6] ^= 0x01u;
+    res = profile_read_header( buffer, length, &count );
+    TEST_ASSERT_EQUAL_INT( -EILSEQ, res );
+}
+
+/******************************************************************************
+ * test_profile_invalid
+ * - no profile, truncated files and sections exceeding the file
+ *****************************************************************************/
+static void test_profile_invalid( void )
+{
+    profile_section_t section;
+    size_t offset = PROFILE_HEADER_SIZE;
+    uint16_t count = 0u;
+    int res;
+
+    res = profile_read_header( buffer, PROFILE_HEADER_SIZE - 1u, &count );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = profile_read_header( buffer, length - 1u, &count );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    res = profile_read_section( buffer, PROFILE_HEADER_SIZE + PROFILE_SECTION_HEADER_SIZE, &offset, &section );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+    TEST_ASSERT_EQUAL_INT( PROFILE_HEADER_SIZE, (int)offset );
+
+    res = profile_write_header( buffer, 0u, PROFILE_HEADER_SIZE - 1u );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+
+    memcpy( buffer, "[MAIN]\n", 7u );
+    res = profile_read_header( buffer, length, &count );
+    TEST_ASSERT_EQUAL_INT( -EINVAL, res );
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef profile_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "profile_crc32"    , test_profile_crc32 ),
+        new_TestFixture( "profile_roundtrip", test_profile_roundtrip ),
+        new_TestFixture( "profile_corrupt"  , test_profile_corrupt ),
+        new_TestFixture( "profile_invalid"  , test_profile_invalid ),
+    };
+    EMB_UNIT_TESTCALLER( profile_tests, "Profile tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&profile_tests );
+}
@@ -0,0 +1,364 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_codec_tests.c
+ *
+ * @brief   Implementation of unit tests and micro-benchmark for the
+ *          command encoder and decoder
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <ctrl_channel/ctrl_channel.h>
+#include <provideo_protocol/provideo_protocol_codec.h>
+
+#include <embUnit/embUnit.h>
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define ARRAY_SIZE(x)           ( sizeof(x)/sizeof(x[0]) )
+
+#define BENCHMARK_RUNS          ( 200000 )
+
+// command formats as defined in the protocol modules
+#define CMD_SET_GAIN_RED        ( "gain_red %i\n" )
+#define CMD_SET_LSC             ( "lsc %i %i %i %i %i\n" )
+#define CMD_SET_MCC_PHASE       ( "mcc_set %i %i %i\n" )
+#define CMD_SET_ROI_OFFSET      ( "stat_roi_offset %u %u\n" )
+#define CMD_SET_CHAIN_GENLOCK   ( "genlock_offset %i %i\n" )
+#define CMD_SET_DEVICE_ID       ( "id %x\n" )
+#define CMD_SET_NAME            ( "name %s\n" )
+#define CMD_SET_VERSION         ( "version 0x%08x\n" )
+
+static char const * const formats[] =
+{
+    CMD_SET_GAIN_RED,
+    CMD_SET_LSC,
+    CMD_SET_MCC_PHASE,
+    CMD_SET_ROI_OFFSET,
+    CMD_SET_CHAIN_GENLOCK,
+    CMD_SET_DEVICE_ID,
+};
+
+static int32_t const values[] =
+{
+    0, 1, -1, 9, 10, 255, -4096, 65535, 100000, INT32_MAX, INT32_MIN,
+};
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+}
+
+/******************************************************************************
+ * reference_encode - snprintf with up to 5 parameters
+ *****************************************************************************/
+static int reference_encode( char * buf, int size, char const * fmt, int32_t const * v )
+{
+    return ( snprintf( buf, size, fmt, v[0], v[1], v[2], v[3], v[4] ) );
+}
+
+/******************************************************************************
+ * reference_decode - sscanf with up to 5 parameters
+ *****************************************************************************/
+static int reference_decode( char const * s, char const * fmt, int32_t * v )
+{
+    return ( sscanf( s, fmt, &v[0], &v[1], &v[2], &v[3], &v[4] ) );
+}
+
+/******************************************************************************
+ * test_codec_compile
+ * - checks descriptors and the detection of unsupported formats
+ *****************************************************************************/
+static void test_codec_compile( void )
+{
+    cmd_desc_t desc;
+    cmd_desc_t tmp;
+    cmd_desc_t const * d;
+
+    TEST_ASSERT( cmd_desc_compile( NULL, &desc ) == -EINVAL );
+    TEST_ASSERT( cmd_desc_compile( CMD_SET_LSC, NULL ) == -EINVAL );
+
+    TEST_ASSERT( cmd_desc_compile( CMD_SET_LSC, &desc ) == 0 );
+    TEST_ASSERT( desc.supported );
+    TEST_ASSERT( desc.no == 5u );
+    TEST_ASSERT( desc.lit_length[0] == 4u );
+    TEST_ASSERT( desc.lit_length[5] == 1u );
+
+    TEST_ASSERT( cmd_desc_compile( "plain\n", &desc ) == 0 );
+    TEST_ASSERT( desc.no == 0u );
+
+    TEST_ASSERT( cmd_desc_compile( CMD_SET_NAME, &desc ) == -ENOSYS );
+    TEST_ASSERT( cmd_desc_compile( CMD_SET_VERSION, &desc ) == -ENOSYS );
+    TEST_ASSERT( cmd_desc_compile( "a %n\n", &desc ) == -ENOSYS );
+    TEST_ASSERT( cmd_desc_compile( "100%%\n", &desc ) == -ENOSYS );
+
+    // cached descriptors are returned by address
+    d = cmd_desc_get( CMD_SET_LSC, &tmp );
+    TEST_ASSERT( d != NULL );
+    TEST_ASSERT( d != &tmp );
+    TEST_ASSERT( cmd_desc_get( CMD_SET_LSC, &tmp ) == d );
+    TEST_ASSERT( cmd_desc_get( CMD_SET_NAME, &tmp ) == NULL );
+    TEST_ASSERT( cmd_desc_get( CMD_SET_NAME, &tmp ) == NULL );
+    TEST_ASSERT( cmd_desc_get( NULL, &tmp ) == NULL );
+}
+
+/******************************************************************************
+ * test_codec_encode
+ * - compares the encoder with snprintf
+ *****************************************************************************/
+static void test_codec_encode( void )
+{
+    char buf[128];
+    char ref[128];
+    int32_t v[5];
+    unsigned f, i, k;
+
+    for ( f = 0u; f < ARRAY_SIZE(formats); f++ )
+    {
+        cmd_desc_t desc;
+        TEST_ASSERT( cmd_desc_compile( formats[f], &desc ) == 0 );
+
+        for ( i = 0u; i < ARRAY_SIZE(values); i++ )
+        {
+            for ( k = 0u; k < ARRAY_SIZE(v); k++ )
+            {
+                v[k] = values[(i + k) % ARRAY_SIZE(values)];
+            }
+
+            TEST_ASSERT( cmd_encode_int( &desc, buf, sizeof(buf), v ) == reference_encode( ref, sizeof(ref), formats[f], v ) );
+            TEST_ASSERT( !strcmp( buf, ref ) );
+        }
+    }
+}
+
+/******************************************************************************
+ * test_codec_encode_overflow
+ * - checks that the encoder never writes beyond the buffer
+ *****************************************************************************/
+static void test_codec_encode_overflow( void )
+{
+    int32_t v[5] = { -100000, 2, 3, 4, 5 };
+    char buf[32];
+    cmd_desc_t desc;
+    int len;
+    int size;
+
+    TEST_ASSERT( cmd_desc_compile( CMD_SET_LSC, &desc ) == 0 );
+
+    // "lsc -100000 2 3 4 5\n"
+    len = cmd_encode_int( &desc, buf, sizeof(buf), v );
+    TEST_ASSERT( len == 20 );
+
+    for ( size = 1; size <= len; size++ )
+    {
+        memset( buf, 'x', sizeof(buf) );
+        TEST_ASSERT( cmd_encode_int( &desc, buf, size, v ) == -EFAULT );
+        TEST_ASSERT( buf[size] == 'x' );
+    }
+
+    TEST_ASSERT( cmd_encode_int( &desc, buf, len + 1, v ) == len );
+    TEST_ASSERT( cmd_encode_int( &desc, buf, 0, v ) == -EINVAL );
+}
+
+/******************************************************************************
+ * test_codec_decode
+ * - compares the decoder with sscanf for valid and malformed responses
+ *****************************************************************************/
+static void test_codec_decode( void )
+{
+    static struct
+    {
+        char const * fmt;
+        char const * s;
+    } const cases[] =
+    {
+        { CMD_SET_GAIN_RED,     "gain_red 1234\r\nOK\r\n"       },
+        { CMD_SET_GAIN_RED,     "gain_red   -17\r\n"            },
+        { CMD_SET_GAIN_RED,     "gain_red +17\r\n"              },
+        { CMD_SET_GAIN_RED,     "gain_red 0x1f\r\n"             },
+        { CMD_SET_GAIN_RED,     "gain_red 017\r\n"              },
+        { CMD_SET_GAIN_RED,     "gain_red 09\r\n"               },
+        { CMD_SET_GAIN_RED,     "gain_red x\r\n"                },
+        { CMD_SET_GAIN_RED,     "gain_red "                     },
+        { CMD_SET_GAIN_RED,     "gain_re"                       },
+        { CMD_SET_GAIN_RED,     "gain_blue 3\r\n"               },
+        { CMD_SET_GAIN_RED,     ""                              },
+        { CMD_SET_LSC,          "lsc 1 2 3 4 5\r\nOK\r\n"       },
+        { CMD_SET_LSC,          "lsc 1\t2\r\n3 4 5"             },
+        { CMD_SET_LSC,          "lsc 1 2 3\r\n"                 },
+        { CMD_SET_LSC,          "lsc 1 2 a 4 5\r\n"             },
+        { CMD_SET_ROI_OFFSET,   "stat_roi_offset 1920 -1\r\n"   },
+        { CMD_SET_DEVICE_ID,    "id 0xDEADbeef\r\n"             },
+        { CMD_SET_DEVICE_ID,    "id ff\r\n"                     },
+        { CMD_SET_DEVICE_ID,    "id 0x\r\n"                     },
+    };
+
+    int32_t v[5];
+    int32_t ref[5];
+    unsigned i;
+
+    for ( i = 0u; i < ARRAY_SIZE(cases); i++ )
+    {
+        cmd_desc_t desc;
+        int res;
+        int k;
+
+        TEST_ASSERT( cmd_desc_compile( cases[i].fmt, &desc ) == 0 );
+
+        memset( v, 0, sizeof(v) );
+        memset( ref, 0, sizeof(ref) );
+
+        res = cmd_decode_int( &desc, cases[i].s, v );
+        TEST_ASSERT( res == reference_decode( cases[i].s, cases[i].fmt, ref ) );
+        for ( k = 0; k < res; k++ )
+        {
+            TEST_ASSERT( v[k] == ref[k] );
+        }
+    }
+}
+
+/******************************************************************************
+ * test_codec_scratch_buffer
+ * - checks the reusable response buffer of a control channel
+ *****************************************************************************/
+static void test_codec_scratch_buffer( void )
+{
+    uint8_t mem[ctrl_channel_get_instance_size()];
+    ctrl_channel_handle_t channel = (ctrl_channel_handle_t)mem;
+    uint8_t * buf;
+
+    memset( channel, 0, ctrl_channel_get_instance_size() );
+
+    buf = ctrl_channel_get_scratch_buffer( channel, 2 * 200 );
+    TEST_ASSERT( buf != NULL );
+    TEST_ASSERT( ctrl_channel_get_scratch_buffer( channel, 13 * 200 ) == buf );
+    TEST_ASSERT( ctrl_channel_get_scratch_buffer( channel, CTRL_CHANNEL_SCRATCH_SIZE ) == buf );
+    TEST_ASSERT( ctrl_channel_get_scratch_buffer( channel, CTRL_CHANNEL_SCRATCH_SIZE + 1 ) == NULL );
+    TEST_ASSERT( ctrl_channel_get_scratch_buffer( channel, 0 ) == NULL );
+    TEST_ASSERT( ctrl_channel_get_scratch_buffer( NULL, 1 ) == NULL );
+}
+
+/******************************************************************************
+ * elapsed_ns - time per call of a benchmark loop
+ *****************************************************************************/
+static double elapsed_ns( clock_t const start )
+{
+    return ( (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / BENCHMARK_RUNS );
+}
+
+/******************************************************************************
+ * test_codec_benchmark
+ * - compares encode and decode time with snprintf and sscanf
+ *****************************************************************************/
+static void test_codec_benchmark( void )
+{
+    static char const * const responses[] =
+    {
+        "gain_red 1234\r\nOK\r\n",
+        "lsc 1 -2 300 4000 50000\r\nOK\r\n",
+    };
+    static char const * const fmts[] =
+    {
+        CMD_SET_GAIN_RED,
+        CMD_SET_LSC,
+    };
+
+    int32_t v[5] = { 1234, -2, 300, 4000, 50000 };
+    volatile int sink = 0;
+    char buf[128];
+    unsigned f;
+    int i;
+
+    printf( "command       : encode/ns (codec, snprintf) | decode/ns (codec, sscanf)\n" );
+
+    for ( f = 0u; f < ARRAY_SIZE(fmts); f++ )
+    {
+        double t_enc, t_enc_ref, t_dec, t_dec_ref;
+        cmd_desc_t tmp;
+        clock_t start;
+
+        start = clock();
+        for ( i = 0; i < BENCHMARK_RUNS; i++ )
+        {
+            v[0] = i;
+            sink += cmd_encode_int( cmd_desc_get( fmts[f], &tmp ), buf, sizeof(buf), v );
+        }
+        t_enc = elapsed_ns( start );
+
+        start = clock();
+        for ( i = 0; i < BENCHMARK_RUNS; i++ )
+        {
+            v[0] = i;
+            sink += reference_encode( buf, sizeof(buf), fmts[f], v );
+        }
+        t_enc_ref = elapsed_ns( start );
+
+        start = clock();
+        for ( i = 0; i < BENCHMARK_RUNS; i++ )
+        {
+            sink += cmd_decode_int( cmd_desc_get( fmts[f], &tmp ), responses[f], v );
+        }
+        t_dec = elapsed_ns( start );
+
+        start = clock();
+        for ( i = 0; i < BENCHMARK_RUNS; i++ )
+        {
+            sink += reference_decode( responses[f], fmts[f], v );
+        }
+        t_dec_ref = elapsed_ns( start );
+
+        printf( "%-14.*s: %6.0f %6.0f | %6.0f %6.0f\n", (int)(strchr( fmts[f], ' ' ) - fmts[f]), fmts[f],
+                t_enc, t_enc_ref, t_dec, t_dec_ref );
+    }
+
+    (void)sink;
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef provideo_protocol_codec_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "codec_compile"        , test_codec_compile ),
+        new_TestFixture( "codec_encode"         , test_codec_encode ),
+        new_TestFixture( "codec_encode_overflow", test_codec_encode_overflow ),
+        new_TestFixture( "codec_decode"         , test_codec_decode ),
+        new_TestFixture( "codec_scratch_buffer" , test_codec_scratch_buffer ),
+        new_TestFixture( "codec_benchmark"      , test_codec_benchmark ),
+    };
+    EMB_UNIT_TESTCALLER( provideo_protocol_codec_tests, "Provideo protocol codec tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&provideo_protocol_codec_tests );
+}
@@ -0,0 +1,510 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_reader_tests.c
+ *
+ * @brief   Implementation of unit tests for the streaming response reader
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
+
+#include <embUnit/embUnit.h>
+
+#include "fake_channel.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define DUMP_LINES              ( 20000 )
+
+/******************************************************************************
+ * collected lines
+ *****************************************************************************/
+typedef struct lines_s
+{
+    char    data[4096];
+    int     len;
+    int     no;
+    int     abort_at;
+    int     bad_len;    /* lines whose length does not match the string */
+} lines_t;
+
+static lines_t lines;
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+    memset( &lines, 0, sizeof(lines) );
+    lines.abort_at = -1;
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+}
+
+/******************************************************************************
+ * collect_line - line handler collecting all lines
+ *****************************************************************************/
+static int collect_line( void * const priv, char const * const line, int const len )
+{
+    lines_t * l = (lines_t *)priv;
+
+    // TEST_ASSERT returns without a value, it is checked in the test body
+    if ( (int)strlen( line ) != len )
+    {
+        l->bad_len++;
+    }
+
+    if ( l->no == l->abort_at )
+    {
+        return ( -EFAULT );
+    }
+
+    if ( (l->len + len) < (int)sizeof(l->data) )
+    {
+        memcpy( &l->data[l->len], line, len );
+        l->len += len;
+        l->data[l->len] = '\0';
+    }
+    l->no++;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * feed_split - feed a response in two chunks
+ *****************************************************************************/
+static cmd_reader_state_t feed_split( cmd_reader_t * reader, char const * s, int split )
+{
+    int len = (int)strlen( s );
+
+    cmd_reader_init( reader, collect_line, &lines );
+    setup();
+
+    cmd_reader_feed( reader, s, split );
+    return ( cmd_reader_feed( reader, &s[split], len - split ) );
+}
+
+/******************************************************************************
+ * test_reader_lines
+ * - checks line assembly for every possible chunk boundary
+ *****************************************************************************/
+static void test_reader_lines( void )
+{
+    static char const response[] = "lsc 1 2 3 4 5\r\n\r\nid: 2 3\nOK\r\n";
+    static char const expected[] = "lsc 1 2 3 4 5\r\nid: 2 3\nOK";
+    cmd_reader_t reader;
+    int split;
+
+    for ( split = 0; split <= (int)strlen( response ); split++ )
+    {
+        TEST_ASSERT( feed_split( &reader, response, split ) == CMD_READER_STATE_OK );
+        TEST_ASSERT( cmd_reader_result( &reader ) == 0 );
+        TEST_ASSERT( lines.no == 3 );
+        TEST_ASSERT( lines.bad_len == 0 );
+        // the terminator is passed on as soon as it is complete
+        TEST_ASSERT( !strncmp( lines.data, expected, strlen( expected ) ) );
+    }
+}
+
+/******************************************************************************
+ * test_reader_terminators
+ * - checks OK, FAIL and ERROR detection
+ *****************************************************************************/
+static void test_reader_terminators( void )
+{
+    cmd_reader_t reader;
+
+    // terminator without line end
+    TEST_ASSERT( feed_split( &reader, "gain 3\r\nOK", 3 ) == CMD_READER_STATE_OK );
+
+    // no terminator
+    TEST_ASSERT( feed_split( &reader, "gain 3\r\nOKAY\r\nO", 3 ) == CMD_READER_STATE_BUSY );
+    TEST_ASSERT( cmd_reader_result( &reader ) == -EILSEQ );
+
+    // FAIL without and with error message
+    TEST_ASSERT( feed_split( &reader, "FAIL\r\n", 2 ) == CMD_READER_STATE_FAIL );
+    TEST_ASSERT( cmd_reader_result( &reader ) == -EINVAL );
+
+    TEST_ASSERT( feed_split( &reader, "ERROR: resource busy\r\nFAIL\r\n", 10 ) == CMD_READER_STATE_FAIL );
+    TEST_ASSERT( cmd_reader_result( &reader ) == -EBUSY );
+
+    TEST_ASSERT( feed_split( &reader, "ERROR: invalid chain\r\nFAIL\r\n", 30 ) == CMD_READER_STATE_FAIL );
+    TEST_ASSERT( cmd_reader_result( &reader ) == -ENODEV );
+
+    // an OK of another device overrides FAIL
+    TEST_ASSERT( feed_split( &reader, "FAIL\r\nid: 1\r\nOK\r\n", 8 ) == CMD_READER_STATE_OK );
+    TEST_ASSERT( lines.no == 3 );
+    TEST_ASSERT( lines.bad_len == 0 );
+}
+
+/******************************************************************************
+ * test_reader_overflow_abort
+ * - checks that too long lines are skipped and handler errors abort
+ *****************************************************************************/
+static void test_reader_overflow_abort( void )
+{
+    char response[2 * CMD_READER_LINE_SIZE];
+    cmd_reader_t reader;
+
+    memset( response, 'x', sizeof(response) );
+    strcpy( &response[CMD_READER_LINE_SIZE + 10], "\nline\nOK\n" );
+
+    TEST_ASSERT( feed_split( &reader, response, 100 ) == CMD_READER_STATE_OK );
+    TEST_ASSERT( lines.no == 2 );
+    TEST_ASSERT( lines.bad_len == 0 );
+    TEST_ASSERT( !strcmp( lines.data, "line\nOK\n" ) );
+
+    cmd_reader_init( &reader, collect_line, &lines );
+    setup();
+    lines.abort_at = 1;
+    TEST_ASSERT( cmd_reader_feed( &reader, "a\nb\nc\nOK\n", 9 ) == CMD_READER_STATE_ABORT );
+    TEST_ASSERT( cmd_reader_result( &reader ) == -EFAULT );
+    TEST_ASSERT( lines.no == 1 );
+    TEST_ASSERT( lines.bad_len == 0 );
+}
+
+/******************************************************************************
+ * count_line - line handler only counting lines
+ *****************************************************************************/
+static int count_line( void * const priv, char const * const line, int const len )
+{
+    (void) line;
+    (void) len;
+
+    (*(int *)priv)++;
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * test_reader_large_response
+ * - feeds a large dump in small chunks, time has to grow linearly
+ *****************************************************************************/
+static void test_reader_large_response( void )
+{
+    static char const line[] = "dump_settings gain_red 1024 gain_blue 1024\r\n";
+    int const line_len = (int)strlen( line );
+    int const size = DUMP_LINES * line_len + 4;
+    char * data = (char *)malloc( size );
+    cmd_reader_t reader;
+    clock_t start;
+    int no = 0;
+    int i;
+
+    TEST_ASSERT( data != NULL );
+
+    for ( i = 0; i < DUMP_LINES; i++ )
+    {
+        memcpy( &data[i * line_len], line, line_len );
+    }
+    memcpy( &data[DUMP_LINES * line_len], "OK\r\n", 4 );
+
+    start = clock();
+
+    cmd_reader_init( &reader, count_line, &no );
+    for ( i = 0; i < size; i += 64 )
+    {
+        cmd_reader_feed( &reader, &data[i], ((size - i) < 64) ? (size - i) : 64 );
+    }
+
+    printf( "%d lines (%d bytes) in %.0f us\n", DUMP_LINES, size,
+            (double)(clock() - start) * 1e6 / CLOCKS_PER_SEC );
+
+    TEST_ASSERT( cmd_reader_result( &reader ) == 0 );
+    TEST_ASSERT( no == DUMP_LINES + 1 );
+
+    free( data );
+}
+
+/******************************************************************************
+ * test_reader_response_count
+ * - checks that terminated responses are counted at the channel
+ *****************************************************************************/
+static void test_reader_response_count( void )
+{
+    uint8_t mem[ctrl_channel_get_instance_size()];
+    ctrl_channel_handle_t channel = (ctrl_channel_handle_t)mem;
+    fake_channel_t fake;
+    cmd_reader_t reader;
+
+    memset( mem, 0, sizeof(mem) );
+    TEST_ASSERT( fake_channel_open( channel, &fake ) == 0 );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 0u );
+
+    fake.response = "prompt 0\r\nOK\r\n";
+    fake.pos      = 0;
+    cmd_reader_init( &reader, NULL, NULL );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, 10 ) == 0 );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 1u );
+
+    // a failed command is an answer as well
+    fake.response = "ERROR: resource busy\r\nFAIL\r\n";
+    fake.pos      = 0;
+    cmd_reader_init( &reader, NULL, NULL );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, 10 ) == -EBUSY );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 2u );
+
+    // no terminator, nothing counted
+    fake.response = "prompt 0\r\n";
+    fake.pos      = 0;
+    cmd_reader_init( &reader, NULL, NULL );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, 10 ) == -EILSEQ );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 2u );
+
+    // counter restarts with the connection
+    TEST_ASSERT( ctrl_channel_open( channel, NULL, 0 ) == 0 );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 0u );
+
+    ctrl_channel_unregister( channel );
+}
+
+/******************************************************************************
+ * test_reader_receive_count
+ * - checks that pipelined responses are read up to the expected terminator
+ *****************************************************************************/
+static void test_reader_receive_count( void )
+{
+    uint8_t mem[ctrl_channel_get_instance_size()];
+    ctrl_channel_handle_t channel = (ctrl_channel_handle_t)mem;
+    fake_channel_t fake;
+    cmd_reader_t reader;
+
+    memset( mem, 0, sizeof(mem) );
+    TEST_ASSERT( fake_channel_open( channel, &fake ) == 0 );
+
+    // a failed command does not end the batch
+    fake.response = "zoom 1\r\nOK\r\nERROR: resource busy\r\nFAIL\r\niris 3\r\nOK\r\n";
+    fake.pos      = 0;
+    cmd_reader_init( &reader, collect_line, &lines );
+    setup();
+    TEST_ASSERT( cmd_reader_receive_count( &reader, channel, 3, 10 ) == 3 );
+    TEST_ASSERT( lines.no == 6 );
+    TEST_ASSERT( lines.bad_len == 0 );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 3u );
+
+    // missing responses end at the idle timeout
+    fake.response = "zoom 1\r\nOK\r\n";
+    fake.pos      = 0;
+    cmd_reader_init( &reader, collect_line, &lines );
+    setup();
+    TEST_ASSERT( cmd_reader_receive_count( &reader, channel, 2, 10 ) == 1 );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 4u );
+
+    // handler errors abort
+    fake.response = "zoom 1\r\nOK\r\n";
+    fake.pos      = 0;
+    cmd_reader_init( &reader, collect_line, &lines );
+    setup();
+    lines.abort_at = 0;
+    TEST_ASSERT( cmd_reader_receive_count( &reader, channel, 1, 10 ) == -EFAULT );
+
+    ctrl_channel_unregister( channel );
+}
+
+/******************************************************************************
+ * test_reader_set_batch
+ * - set-commands share requests, every command gets its own result and a
+ *   slow command is sent alone
+ *****************************************************************************/
+static void test_reader_set_batch( void )
+{
+    uint8_t mem[ctrl_channel_get_instance_size()];
+    ctrl_channel_handle_t channel = (ctrl_channel_handle_t)mem;
+    fake_channel_t fake;
+    cmd_set_item_t items[] =
+    {
+        { "gain_red 1\n"   , 11, DEFAULT_CMD_TIMEOUT, 1 },
+        { "gain_blue 2\n"  , 12, DEFAULT_CMD_TIMEOUT, 1 },
+        { "video_mode 3\n" , 13, 15000              , 1 },
+        { "genlock 1\n"    , 10, DEFAULT_CMD_TIMEOUT, 1 },
+    };
+
+    memset( mem, 0, sizeof(mem) );
+    TEST_ASSERT( fake_channel_open( channel, &fake ) == 0 );
+
+    // the fake answers the first request only, holding the first two commands
+    fake.response = "OK\r\nERROR: resource busy\r\nFAIL\r\n";
+    TEST_ASSERT( set_param_batch( channel, items, 2 ) == 1 );
+    TEST_ASSERT( fake.no_requests == 1 );
+    TEST_ASSERT( !strcmp( fake.sent, "gain_red 1\ngain_blue 2\n" ) );
+    TEST_ASSERT( items[0].res == 0 );
+    TEST_ASSERT( items[1].res == -EBUSY );
+
+    // the mode change goes alone, the link stays silent afterwards
+    fake.response    = "OK\r\n";
+    fake.pos         = 0;
+    fake.sent[0]     = '\0';
+    fake.no_requests = 0;
+    TEST_ASSERT( set_param_batch( channel, &items[2], 2 ) == -EILSEQ );
+    TEST_ASSERT( !strcmp( fake.sent, "video_mode 3\ngenlock 1\n" ) );
+    TEST_ASSERT( fake.no_requests == 2 );
+    TEST_ASSERT( items[2].res == 0 );
+    TEST_ASSERT( items[3].res == -EILSEQ );
+
+    ctrl_channel_unregister( channel );
+}
+
+/******************************************************************************
+ * deferred set-commands of test_reader_deferred_set
+ *****************************************************************************/
+typedef struct deferred_s
+{
+    char    cmds[256];
+    int     no;
+    int     flushed;
+} deferred_t;
+
+static int defer_cmd( void * const priv, uint8_t const * const data, int const len, int const tmo_ms )
+{
+    deferred_t * d = (deferred_t *)priv;
+
+    (void) tmo_ms;
+
+    strncat( d->cmds, (char const *)data, (size_t)len );
+    d->no++;
+
+    return ( 0 );
+}
+
+static void flush_cmds( void * const priv )
+{
+    ((deferred_t *)priv)->flushed++;
+}
+
+/******************************************************************************
+ * test_reader_deferred_set
+ * - set-commands go to the receiver, any other request flushes it first
+ *****************************************************************************/
+static void test_reader_deferred_set( void )
+{
+    uint8_t mem[ctrl_channel_get_instance_size()];
+    ctrl_channel_handle_t channel = (ctrl_channel_handle_t)mem;
+    fake_channel_t fake;
+    deferred_t deferred;
+
+    memset( mem, 0, sizeof(mem) );
+    memset( &deferred, 0, sizeof(deferred) );
+    TEST_ASSERT( fake_channel_open( channel, &fake ) == 0 );
+    TEST_ASSERT( ctrl_channel_set_defer( channel, defer_cmd, flush_cmds, &deferred ) == 0 );
+
+    TEST_ASSERT( set_param_int_X( channel, (char *)"gain_red %i\n", 256 ) == 0 );
+    TEST_ASSERT( set_param_0( channel, (char *)"lut_interpolate\n" ) == 0 );
+    TEST_ASSERT( !strcmp( deferred.cmds, "gain_red 256\nlut_interpolate\n" ) );
+    TEST_ASSERT( fake.no_requests == 0 );
+    TEST_ASSERT( deferred.flushed == 0 );
+
+    // a get-command is sent after the deferred commands
+    ctrl_channel_send_request( channel, (uint8_t *)"gain_red\n", 9 );
+    TEST_ASSERT( deferred.flushed == 1 );
+    TEST_ASSERT( fake.no_requests == 1 );
+
+    // without receiver set-commands are sent again
+    TEST_ASSERT( ctrl_channel_set_defer( channel, NULL, NULL, NULL ) == 0 );
+    fake.response = "OK\r\n";
+    fake.pos      = 0;
+    TEST_ASSERT( set_param_0( channel, (char *)"lut_interpolate\n" ) == 0 );
+    TEST_ASSERT( fake.no_requests == 2 );
+    TEST_ASSERT( deferred.no == 2 );
+
+    ctrl_channel_unregister( channel );
+}
+
+/******************************************************************************
+ * test_reader_settings_stream
+ * - a settings dump of any size is passed on line by line, without the
+ *   terminator, into a bounded buffer it fails, as with a too long line
+ *****************************************************************************/
+static void test_reader_settings_stream( void )
+{
+    static char const line[] = "dump_settings gain_red 1024\r\n";
+    int const line_len = (int)strlen( line );
+    uint8_t mem[ctrl_channel_get_instance_size()];
+    ctrl_channel_handle_t channel = (ctrl_channel_handle_t)mem;
+    char response[200 * sizeof(line) + 8];
+    char buffer[1000];
+    fake_channel_t fake;
+    int no = 0;
+    int i;
+
+    for ( i = 0; i < 200; i++ )
+    {
+        memcpy( &response[i * line_len], line, line_len );
+    }
+    strcpy( &response[200 * line_len], "OK\r\n" );
+
+    memset( mem, 0, sizeof(mem) );
+    TEST_ASSERT( fake_channel_open( channel, &fake ) == 0 );
+
+    fake.response = response;
+    TEST_ASSERT( get_param_lines( channel, (char *)"dump_settings\n", count_line, &no, 10 ) == 0 );
+    TEST_ASSERT( no == 200 );
+    TEST_ASSERT( !strcmp( fake.sent, "dump_settings\n" ) );
+    TEST_ASSERT( ctrl_channel_get_response_count( channel ) == 1u );
+
+    // the same dump does not fit into a fixed buffer
+    fake.pos = 0;
+    TEST_ASSERT( get_param_settings_string( channel, (int)sizeof(buffer), (char *)"dump_settings\n",
+                                            NULL, NULL, buffer ) == -EINVAL );
+    TEST_ASSERT( !strncmp( buffer, line, (size_t)line_len ) );
+
+    // a line too long for the reader is missing, the dump fails
+    memcpy( response, line, (size_t)line_len );
+    memset( &response[line_len], 'x', CMD_READER_LINE_SIZE + 10 );
+    strcpy( &response[line_len + CMD_READER_LINE_SIZE + 10], "\r\nOK\r\n" );
+    fake.pos = 0;
+    no       = 0;
+    TEST_ASSERT( get_param_lines( channel, (char *)"dump_settings\n", count_line, &no, 10 ) == -ENOMEM );
+    TEST_ASSERT( no == 1 );
+
+    ctrl_channel_unregister( channel );
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef provideo_protocol_reader_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "reader_lines"         , test_reader_lines ),
+        new_TestFixture( "reader_terminators"   , test_reader_terminators ),
+        new_TestFixture( "reader_overflow_abort", test_reader_overflow_abort ),
+        new_TestFixture( "reader_large_response", test_reader_large_response ),
+        new_TestFixture( "reader_response_count", test_reader_response_count ),
+        new_TestFixture( "reader_receive_count" , test_reader_receive_count ),
+        new_TestFixture( "reader_set_batch"     , test_reader_set_batch ),
+        new_TestFixture( "reader_deferred_set"  , test_reader_deferred_set ),
+        new_TestFixture( "reader_settings_stream", test_reader_settings_stream ),
+    };
+    EMB_UNIT_TESTCALLER( provideo_protocol_reader_tests, "Provideo protocol reader tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&provideo_protocol_reader_tests );
+}
@@ -0,0 +1,324 @@
+/******************************************************************************
+ * Copyright (C) 2017 Dream Chip Technologies GmbH
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * @file    provideo_protocol_timing_tests.c
+ *
+ * @brief   Implementation of unit tests for the adaptive response deadlines
+ *
+ *****************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <provideo_protocol/provideo_protocol_common.h>
+#include <provideo_protocol/provideo_protocol_reader.h>
+#include <provideo_protocol/provideo_protocol_timing.h>
+
+#include <embUnit/embUnit.h>
+
+#include "fake_channel.h"
+
+/******************************************************************************
+ * local definitions
+ *****************************************************************************/
+#define LINE_RATE               ( 115200u )
+#define GET_REQUEST             ( "filter_enable\n" )
+#define SET_REQUEST             ( "filter_enable 1\n" )
+#define RESPONSE_LEN            ( 20 )
+
+/******************************************************************************
+ * fake channel - accepts every request, never answers unless told to
+ *****************************************************************************/
+static ctrl_channel_handle_t channel;
+static fake_channel_t fake;
+
+/******************************************************************************
+ * first_line - line handler keeping the first line of a response
+ *****************************************************************************/
+static int first_line( void * const priv, char const * const line, int const len )
+{
+    char * first = (char *)priv;
+
+    if ( !first[0] && (len < CMD_READER_LINE_SIZE) )
+    {
+        memcpy( first, line, (size_t)len );
+        first[len] = '\0';
+    }
+
+    return ( 0 );
+}
+
+/******************************************************************************
+ * monotonic_ms - monotonic time in ms
+ *****************************************************************************/
+static int64_t monotonic_ms( void )
+{
+    struct timespec now;
+
+    get_time_monotonic( &now );
+
+    return ( (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000 );
+}
+
+/******************************************************************************
+ * send - send a request over the fake channel
+ *****************************************************************************/
+static void send( char const * const request )
+{
+    ctrl_channel_send_request( channel, (uint8_t *)request, (int)strlen( request ) );
+}
+
+/******************************************************************************
+ * train - answer a command n times after elapsed_ms
+ *****************************************************************************/
+static void train( char const * const request, int const n, int const elapsed_ms )
+{
+    cmd_timing_t timing;
+    int i;
+
+    for ( i = 0; i < n; i++ )
+    {
+        send( request );
+        cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+        cmd_timing_finish( &timing, elapsed_ms, RESPONSE_LEN, 1 );
+    }
+}
+
+/******************************************************************************
+ * called by test-framework before test-procedure
+ *****************************************************************************/
+static void setup( void )
+{
+    channel = (ctrl_channel_handle_t)calloc( 1, (size_t)ctrl_channel_get_instance_size() );
+    TEST_ASSERT( channel != NULL );
+
+    TEST_ASSERT( fake_channel_open( channel, &fake ) == 0 );
+    ctrl_channel_set_line_rate( channel, LINE_RATE );
+
+    cmd_timing_reset();
+}
+
+/******************************************************************************
+ * called by test-framework after test-procedure
+ *****************************************************************************/
+static void teardown( void )
+{
+    ctrl_channel_unregister( channel );
+    free( channel );
+}
+
+/******************************************************************************
+ * test_timing_line_time
+ * - checks the serialization time of 8N1 data
+ *****************************************************************************/
+static void test_timing_line_time( void )
+{
+    TEST_ASSERT( cmd_timing_line_time( 0u, 100 ) == 0 );
+    TEST_ASSERT( cmd_timing_line_time( 57600u, 0 ) == 0 );
+
+    // 1000 bits at 57600 bit/s are 17.4 ms
+    TEST_ASSERT( cmd_timing_line_time( 57600u, 100 ) == 18 );
+    TEST_ASSERT( cmd_timing_line_time( 9600u, 96 ) == 100 );
+}
+
+/******************************************************************************
+ * test_timing_adapt
+ * - checks that deadlines follow the observed response times
+ *****************************************************************************/
+static void test_timing_adapt( void )
+{
+    int const line = cmd_timing_line_time( LINE_RATE, (int)strlen( GET_REQUEST ) + RESPONSE_LEN );
+    cmd_timing_t timing;
+
+    // unknown command, the fixed timeout plus the time to send the request
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == timing.timeout );
+    TEST_ASSERT( timing.timeout == DEFAULT_CMD_TIMEOUT
+                    + cmd_timing_line_time( LINE_RATE, (int)strlen( GET_REQUEST ) ) );
+
+    // not enough responses yet
+    train( GET_REQUEST, CMD_TIMING_MIN_SAMPLES - 1, line + 10 );
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == timing.timeout );
+    TEST_ASSERT( timing.timeout == DEFAULT_CMD_TIMEOUT + line );
+
+    // adapted to the slowest response
+    train( GET_REQUEST, 1, line + 20 );
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == CMD_TIMING_FACTOR * 20 + line + CMD_TIMING_SLACK_MS );
+    TEST_ASSERT( timing.timeout == DEFAULT_CMD_TIMEOUT + line );
+
+    // fast commands are floored
+    cmd_timing_reset();
+    train( GET_REQUEST, CMD_TIMING_MIN_SAMPLES, line );
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == CMD_TIMING_MIN_TMO_MS );
+
+    // responses faster than the line are not from the device
+    cmd_timing_reset();
+    train( GET_REQUEST, CMD_TIMING_MIN_SAMPLES, 0 );
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == timing.timeout );
+}
+
+/******************************************************************************
+ * test_timing_commands
+ * - checks that commands are told apart and long commands are not adapted
+ *****************************************************************************/
+static void test_timing_commands( void )
+{
+    int const line = cmd_timing_line_time( LINE_RATE, (int)strlen( GET_REQUEST ) + RESPONSE_LEN );
+    cmd_timing_t timing;
+
+    train( GET_REQUEST, CMD_TIMING_NO_SAMPLES, line + 5 );
+
+    // set command of the same name
+    send( SET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == timing.timeout );
+
+    // other line rate
+    ctrl_channel_set_line_rate( channel, 57600u );
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == timing.timeout );
+    ctrl_channel_set_line_rate( channel, LINE_RATE );
+
+    // long running command
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, CMD_TIMING_MAX_ADAPTIVE_TMO + 1 );
+    TEST_ASSERT( timing.deadline == timing.timeout );
+    TEST_ASSERT( timing.key == 0u );
+
+    // a missed deadline extends the next one
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == CMD_TIMING_FACTOR * 5 + line + CMD_TIMING_SLACK_MS );
+    cmd_timing_finish( &timing, timing.deadline, 0, 0 );
+
+    send( GET_REQUEST );
+    cmd_timing_start( &timing, channel, DEFAULT_CMD_TIMEOUT );
+    TEST_ASSERT( timing.deadline == CMD_TIMING_FACTOR * (CMD_TIMING_FACTOR * 5 + line + CMD_TIMING_SLACK_MS)
+                                        + line + CMD_TIMING_SLACK_MS );
+}
+
+/******************************************************************************
+ * test_timing_dead_bus
+ * - checks that a silent line is detected at the adapted deadline
+ *****************************************************************************/
+static void test_timing_dead_bus( void )
+{
+    int const line = cmd_timing_line_time( LINE_RATE, (int)strlen( GET_REQUEST ) + RESPONSE_LEN );
+    struct timespec start, now;
+    cmd_reader_t reader;
+    int elapsed_ms;
+
+    train( GET_REQUEST, CMD_TIMING_NO_SAMPLES, line + 2 );
+
+    send( GET_REQUEST );
+    cmd_reader_init( &reader, NULL, NULL );
+
+    get_time_monotonic( &start );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, DEFAULT_CMD_TIMEOUT ) == -EILSEQ );
+    get_time_monotonic( &now );
+
+    elapsed_ms = (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+    printf( "dead bus detected after %d ms (timeout %d ms)\n", elapsed_ms, DEFAULT_CMD_TIMEOUT );
+
+    TEST_ASSERT( elapsed_ms < (DEFAULT_CMD_TIMEOUT / 4) );
+}
+
+/******************************************************************************
+ * test_timing_late_response
+ * - a response which arrives after the deadline is skipped, the following
+ *   request reads its own response
+ *****************************************************************************/
+static void test_timing_late_response( void )
+{
+    int const line = cmd_timing_line_time( LINE_RATE, (int)strlen( GET_REQUEST ) + RESPONSE_LEN );
+    char first[CMD_READER_LINE_SIZE];
+    cmd_reader_t reader;
+    int64_t start;
+
+    train( GET_REQUEST, CMD_TIMING_NO_SAMPLES, line + 2 );
+
+    // the device pauses, e.g. while it writes to flash
+    fake.no_requests = 0;
+    fake.response    = "filter_enable 1\r\nOK\r\nfilter_enable 0\r\nOK\r\n";
+    fake.delay_ms    = 4 * CMD_TIMING_MIN_TMO_MS;
+
+    send( GET_REQUEST );
+    cmd_reader_init( &reader, NULL, NULL );
+    start = monotonic_ms();
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, DEFAULT_CMD_TIMEOUT ) == -EILSEQ );
+    TEST_ASSERT( (monotonic_ms() - start) < fake.delay_ms );
+    TEST_ASSERT( ctrl_channel_get_late_responses( channel, monotonic_ms() ) == 1 );
+
+    send( GET_REQUEST );
+    first[0] = '\0';
+    cmd_reader_init( &reader, first_line, first );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, DEFAULT_CMD_TIMEOUT ) == 0 );
+    TEST_ASSERT( !strncmp( first, "filter_enable 0", 15 ) );
+    TEST_ASSERT( ctrl_channel_get_late_responses( channel, monotonic_ms() ) == 0 );
+
+    // the late response got lost, the response of the next request is
+    // skipped once, that request fails at its full timeout
+    fake.pos      = 0;
+    fake.response = "filter_enable 1\r\nOK\r\n";
+    fake.delay_ms = 0;
+    ctrl_channel_add_late_response( channel, monotonic_ms() + DEFAULT_CMD_TIMEOUT );
+
+    send( GET_REQUEST );
+    cmd_reader_init( &reader, NULL, NULL );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, DEFAULT_CMD_TIMEOUT ) == -EILSEQ );
+    TEST_ASSERT( ctrl_channel_get_late_responses( channel, monotonic_ms() ) == 0 );
+
+    fake.pos      = 0;
+    fake.response = "filter_enable 0\r\nOK\r\n";
+
+    send( GET_REQUEST );
+    first[0] = '\0';
+    cmd_reader_init( &reader, first_line, first );
+    TEST_ASSERT( cmd_reader_receive( &reader, channel, CMD_READER_WAIT_TERMINATOR, DEFAULT_CMD_TIMEOUT ) == 0 );
+    TEST_ASSERT( !strncmp( first, "filter_enable 0", 15 ) );
+}
+
+/******************************************************************************
+ * test group definition used in all_tests.c
+ *****************************************************************************/
+TestRef provideo_protocol_timing_tests( void )
+{
+    EMB_UNIT_TESTFIXTURES( fixtures )
+    {
+        new_TestFixture( "timing_line_time", test_timing_line_time ),
+        new_TestFixture( "timing_adapt"    , test_timing_adapt ),
+        new_TestFixture( "timing_commands" , test_timing_commands ),
+        new_TestFixture( "timing_dead_bus" , test_timing_dead_bus ),
+        new_TestFixture( "timing_late"     , test_timing_late_response ),
+    };
+    EMB_UNIT_TESTCALLER( provideo_protocol_timing_tests, "Provideo protocol timing tests", setup, teardown, fixtures );
+
+    return ( (TestRef)&provideo_protocol_timing_tests );
+}